@@ -10,6 +10,10 @@
  * - Synchronous transmit (via syscall)
  * - Blocking receive (via mailbox)
  * - Event-driven RX with callbacks (via mailbox)
+ *
+ * Received frames that pass the acceptance filters are delivered as packed
+ * hsx_can_rx_event_t records (20 bytes each); one mailbox message may carry
+ * several, so divide the message length by sizeof(hsx_can_rx_event_t).
  */
 
 /* CAN frame types */
@@ -17,6 +21,11 @@
 #define HSX_CAN_EXT_FRAME  0x01  /* Extended 29-bit ID */
 #define HSX_CAN_RTR_FRAME  0x02  /* Remote transmission request */
 
+/* hsx_can_get_status() flags */
+#define HSX_CAN_STATUS_TX_PENDING_MASK 0x00FF  /* Frames waiting for arbitration */
+#define HSX_CAN_STATUS_RX_OVERFLOW     0x0100  /* RX events dropped since last read */
+#define HSX_CAN_STATUS_TX_FULL         0x0200  /* Transmit queue full */
+
 /* CAN bitrates */
 typedef enum {
     HSX_CAN_BITRATE_125K  = 125000,
@@ -39,7 +48,7 @@ typedef struct {
     uint8_t dlc;
     uint8_t flags;
     uint8_t data[8];
-    uint32_t timestamp;
+    uint32_t timestamp;  /* End of frame, bus time in microseconds */
 } hsx_can_rx_event_t;
 
 /**
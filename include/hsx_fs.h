@@ -8,6 +8,7 @@
  * 
  * Provides POSIX-like filesystem API:
  * - File operations: open, read, write, close (via syscall)
+ * - Asynchronous read/write (via syscall, completion via mailbox)
  * - Directory operations: listdir, mkdir, delete, rename (via syscall)
  */
 
@@ -22,6 +23,20 @@
 /* File descriptor type */
 typedef int hsx_fd_t;
 
+/* Async operation codes (hsx_fs_completion_t.op) */
+#define HSX_FS_OP_READ   0x01
+#define HSX_FS_OP_WRITE  0x02
+
+/* Async completion record (posted to the caller's mailbox, 16 bytes, little-endian) */
+typedef struct {
+    uint32_t request_id; /* Value returned by the *_async call */
+    uint32_t tag;        /* Caller cookie passed at submission */
+    int32_t result;      /* Bytes transferred, or negative error code */
+    uint16_t fd;         /* File descriptor */
+    uint8_t op;          /* HSX_FS_OP_* */
+    uint8_t merged;      /* Requests coalesced into the same device write */
+} hsx_fs_completion_t;
+
 /**
  * Open file (synchronous, uses syscall).
  * 
@@ -59,6 +74,37 @@ int hsx_fs_write(hsx_fd_t fd, const void* data, uint32_t length);
  */
 int hsx_fs_close(hsx_fd_t fd);
 
+/**
+ * Queue a read (asynchronous, uses syscall; completion via mailbox).
+ * Returns immediately; the executive performs the read later and copies
+ * the data into buffer before posting an hsx_fs_completion_t to mailbox.
+ * buffer must stay valid until the completion arrives. A synchronous call
+ * on the same descriptor first completes its queued requests.
+ *
+ * @param fd File descriptor
+ * @param buffer Pointer to receive buffer
+ * @param length Maximum bytes to read
+ * @param mailbox Mailbox handle owned by the caller
+ * @param tag Cookie echoed in the completion record
+ * @return Request id (> 0), HSX_HAL_BUSY if the I/O queue is full, or negative error code
+ */
+int hsx_fs_read_async(hsx_fd_t fd, void* buffer, uint32_t length, int mailbox, uint32_t tag);
+
+/**
+ * Queue a write (asynchronous, uses syscall; completion via mailbox).
+ * The data is copied when queued, so buffer may be reused on return.
+ * Adjacent queued writes to one descriptor may be merged into a single
+ * device write; each request still receives its own completion.
+ *
+ * @param fd File descriptor
+ * @param data Pointer to data buffer
+ * @param length Number of bytes to write
+ * @param mailbox Mailbox handle owned by the caller
+ * @param tag Cookie echoed in the completion record
+ * @return Request id (> 0), HSX_HAL_BUSY if the I/O queue is full, or negative error code
+ */
+int hsx_fs_write_async(hsx_fd_t fd, const void* data, uint32_t length, int mailbox, uint32_t tag);
+
 /**
  * List directory contents (synchronous, uses syscall).
  * 
@@ -41,6 +41,23 @@ typedef struct {
     uint32_t timestamp;
 } hsx_gpio_event_t;
 
+/*
+ * Coalesced edge event (delivered via mailbox).  The executive debounces
+ * input pins and folds edges that arrive within the pin's coalesce window
+ * into one event, so a bouncing contact or a fast encoder produces at most
+ * one message per window.  Edges are counted even while an event cannot be
+ * delivered; none are lost.
+ */
+typedef struct {
+    uint8_t pin;
+    uint8_t edges;          /* HSX_GPIO_EDGE_* kinds seen in this event */
+    uint8_t value;          /* debounced level after the last edge */
+    uint8_t reserved;
+    uint32_t count;         /* edges folded into this event */
+    uint32_t first_us;      /* time of the first edge */
+    uint32_t last_us;       /* time of the last edge */
+} hsx_gpio_edge_event_t;
+
 /**
  * Configure GPIO pin mode and pull resistor.
  * 
@@ -97,6 +114,28 @@ int hsx_gpio_set_interrupt(uint8_t pin, hsx_gpio_edge_t edge, bool enable);
  */
 int hsx_gpio_set_interrupt_callback(uint8_t pin, hsx_hal_event_callback_t callback, void* user_data);
 
+/**
+ * Configure executive-side edge filtering for an input pin.
+ * A level change is accepted once the input has been stable for
+ * debounce_us; accepted edges within coalesce_us of the previous event are
+ * reported together in one hsx_gpio_edge_event_t.
+ * 
+ * @param pin GPIO pin number
+ * @param debounce_us Debounce window in microseconds (0 = off)
+ * @param coalesce_us Minimum spacing of events in microseconds (0 = every edge)
+ * @return HSX_HAL_OK on success, error code otherwise
+ */
+int hsx_gpio_set_debounce(uint8_t pin, uint32_t debounce_us, uint32_t coalesce_us);
+
+/**
+ * Read the number of debounced edges (matching the interrupt edge mask)
+ * seen on a pin since boot.  Wraps at 2^32; encoder tasks take differences.
+ * 
+ * @param pin GPIO pin number
+ * @return Edge count
+ */
+uint32_t hsx_gpio_edge_count(uint8_t pin);
+
 /**
  * Wait for GPIO interrupt (blocking, uses mailbox).
  * Blocks until interrupt occurs or timeout.
@@ -0,0 +1,52 @@
+#ifndef HSX_HAL_BATCH_H
+#define HSX_HAL_BATCH_H
+
+#include "hsx_hal_types.h"
+
+/*
+ * HSX batched HAL submission
+ *
+ * A task queues HAL calls in a ring in its own memory and submits them all
+ * with one EXEC_HAL_SUBMIT trap instead of one SVC per call.  The executive
+ * runs the requests in order through the same handlers as the individual
+ * SVCs, writes each status into the request and advances head past what it
+ * consumed.  UART (except exit), CAN, timer and GPIO calls may be batched;
+ * other modules complete with HSX_HAL_UNSUPPORTED.
+ */
+
+/* Request flags */
+#define HSX_HAL_REQ_STOP_ON_ERROR 0x0001  /* a failure ends the batch; later requests stay queued */
+
+/* One queued HAL call (24 bytes) */
+typedef struct {
+    uint8_t module;         /* SVC module, e.g. 0x09 for GPIO */
+    uint8_t fn;             /* SVC function within the module */
+    uint16_t flags;         /* HSX_HAL_REQ_* */
+    uint32_t args[4];       /* R1-R4 as for the individual SVC */
+    int32_t result;         /* R0 of the call, written by the executive */
+} hsx_hal_req_t;
+
+/*
+ * Ring header, followed in memory by `entries` hsx_hal_req_t slots.
+ * `entries` must be a power of two; head and tail are free-running and
+ * index slot (index & (entries - 1)).  The task owns tail, the executive
+ * owns head.
+ */
+typedef struct {
+    uint16_t head;
+    uint16_t tail;
+    uint16_t entries;
+    uint16_t flags;         /* reserved, 0 */
+} hsx_hal_ring_t;
+
+/**
+ * Execute the requests queued between head and tail (EXEC_HAL_SUBMIT).
+ * 
+ * @param ring Ring header; slots follow it directly
+ * @param max_requests Upper bound for this call (0 = all queued)
+ * @param failed Optional; set to the number of requests that failed
+ * @return Requests completed, or HSX_HAL_INVALID_PARAM for a malformed ring
+ */
+int hsx_hal_submit(hsx_hal_ring_t* ring, uint16_t max_requests, uint16_t* failed);
+
+#endif /* HSX_HAL_BATCH_H */
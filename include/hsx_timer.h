@@ -21,13 +21,30 @@ typedef enum {
 /* Timer handle (opaque) */
 typedef uint16_t hsx_timer_t;
 
-/* Timer event data (delivered via mailbox) */
+/*
+ * Timer event data (delivered via mailbox, 12 bytes).  Periodic timers are
+ * rescheduled from their due time, so they do not drift; periods that went
+ * by before the executive serviced the timer, and earlier events the mailbox
+ * had no room for, are counted in overruns (saturating at 255).
+ */
 typedef struct {
     uint16_t timer_id;
-    uint32_t tick;
+    uint16_t reserved0;
+    uint32_t tick;          /* expiry time in microseconds (low 32 bits) */
     uint8_t overruns;
+    uint8_t reserved1[3];
 } hsx_timer_event_t;
 
+/* Per-timer statistics (hsx_timer_get_stats) */
+typedef struct {
+    uint32_t fires;         /* expiries so far */
+    uint32_t missed;        /* periods skipped because the timer fired late */
+    uint32_t dropped;       /* events the mailbox could not take */
+    uint32_t jitter_min_us; /* how late an expiry fired: minimum */
+    uint32_t jitter_max_us; /* ... maximum */
+    uint32_t jitter_mean_us; /* ... mean */
+} hsx_timer_stats_t;
+
 /**
  * Get current monotonic tick count (microseconds).
  * 
@@ -94,4 +111,13 @@ int hsx_timer_wait(hsx_timer_t timer, uint32_t timeout_ms);
  */
 int hsx_timer_set_callback(hsx_timer_t timer, hsx_hal_event_callback_t callback, void* user_data);
 
+/**
+ * Read a timer's expiry and jitter statistics.
+ * 
+ * @param timer Timer handle
+ * @param stats Filled on success
+ * @return HSX_HAL_OK on success, error code otherwise
+ */
+int hsx_timer_get_stats(hsx_timer_t timer, hsx_timer_stats_t* stats);
+
 #endif /* HSX_TIMER_H */
@@ -24,6 +24,10 @@ typedef enum {
     HSX_UART_BAUD_38400  = 38400,
     HSX_UART_BAUD_57600  = 57600,
     HSX_UART_BAUD_115200 = 115200,
+    HSX_UART_BAUD_230400 = 230400,
+    HSX_UART_BAUD_460800 = 460800,
+    HSX_UART_BAUD_921600 = 921600,
+    HSX_UART_BAUD_1000000 = 1000000,
 } hsx_uart_baud_t;
 
 typedef enum {
@@ -48,6 +52,9 @@ typedef struct {
 #define HSX_UART_STATUS_RX_READY   0x02
 #define HSX_UART_STATUS_OVERRUN    0x04
 #define HSX_UART_STATUS_PARITY_ERR 0x08
+/* Bits 16-31: bytes dropped by RX overrun since the last status read (saturating) */
+#define HSX_UART_STATUS_OVERRUN_SHIFT 16
+#define HSX_UART_STATUS_OVERRUN_COUNT(status) ((uint16_t)((status) >> HSX_UART_STATUS_OVERRUN_SHIFT))
 
 /* UART RX event data (delivered via mailbox) */
 typedef struct {
@@ -57,6 +64,23 @@ typedef struct {
     uint8_t flags;
 } hsx_uart_rx_event_t;
 
+/*
+ * Batched RX delivery: a subscribed mailbox gets one message per burst
+ * (idle line for two character times, or RX ring half full), holding this
+ * header followed by `length` data bytes.  Bursts larger than the mailbox
+ * capacity are split across consecutive messages.
+ */
+#define HSX_UART_RX_IDLE    0x01  /* burst ended by an idle line */
+#define HSX_UART_RX_OVERRUN 0x04  /* bytes were dropped before this data */
+
+typedef struct {
+    uint8_t port;
+    uint8_t flags;          /* HSX_UART_RX_* */
+    uint16_t length;        /* data bytes following the header */
+    uint32_t timestamp_us;  /* end of the last received character */
+    /* uint8_t data[length]; */
+} hsx_uart_rx_burst_t;
+
 /**
  * Initialize UART port with default configuration (115200 8N1).
  * 
@@ -76,7 +100,8 @@ int hsx_uart_config(uint8_t port, const hsx_uart_config_t* config);
 
 /**
  * Write data to UART (synchronous, uses syscall).
- * Blocks until all data is written or timeout occurs.
+ * The whole buffer is copied into the TX ring in one call; the return value
+ * is short when the ring is full, and callers retry with the remainder.
  * 
  * @param port UART port number
  * @param data Pointer to data buffer
@@ -121,6 +146,8 @@ int hsx_uart_set_rx_callback(uint8_t port, hsx_hal_event_callback_t callback, vo
 
 /**
  * Get UART status flags.
+ * Reading the status clears HSX_UART_STATUS_OVERRUN and the dropped-byte
+ * count in bits 16-31 (see HSX_UART_STATUS_OVERRUN_COUNT).
  * 
  * @param port UART port number
  * @return Status flags (HSX_UART_STATUS_*)
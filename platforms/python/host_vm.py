@@ -27,6 +27,22 @@ try:
     from python import hsx_value_constants as val_const
     from python import hsx_command_constants as cmd_const
     from python.disasm_util import OPCODE_NAMES, format_operands
+    from python.bp_predicate import LOG as BP_LOG, STOP as BP_STOP, BreakpointSpec, compile_breakpoint
+    from python.bp_predicate import evaluate as bp_evaluate
+    from python.time_travel import PAGE_SIZE as TT_PAGE_SIZE, TaskTimeline
+    from python.profiler import SampleProfiler, aggregate as profile_aggregate
+    from python.pc_counters import BRANCH_OPCODES, PCCounters
+    from python.flash_fs import FlashFS
+    from python.fs_ioqueue import OP_READ as FS_OP_READ, OP_WRITE as FS_OP_WRITE, FSIOQueue, IORequest
+    from python.can_bus import EXT_ID_MASK as CAN_EXT_ID_MASK, HSX_CAN_EXT_FRAME, RX_EVENT as CAN_RX_EVENT
+    from python.can_bus import STD_ID_MASK as CAN_STD_ID_MASK, CANBus, CANFrame, CANNode, CANSocketServer, live_bus
+    from python.isotp import ImageLoaderBridge, ISOTPEndpoint
+    from python.gpio_hal import GPIOBank, live_bank, load_waveform
+    from python import hal_batch
+    from python.hal_batch import HSX_HAL_INVALID_PARAM, HSX_HAL_UNSUPPORTED
+    from python.svc_stats import SnapshotWriter, SVCStats
+    from python.timer_wheel import TimerService, live_service as live_timer_service
+    from python.uart_hal import PORTS as UART_PORTS, RX_BURST as UART_RX_BURST, HSX_UART_RX_OVERRUN, UARTPort, live_port, make_backend
 except ImportError as exc:  # pragma: no cover - require repo sources
     raise ImportError("HSX repo modules not found; ensure repository root on PYTHONPATH") from exc
 
@@ -466,6 +482,12 @@ DEFAULT_STACK_BYTES = 0x1000  # 4 KiB per task (tunable)
 REGISTER_REGION_START = 0x1000  # leave lower memory for code/data
 VM_ADDRESS_SPACE_SIZE = 0x10000  # 64 KiB
 STACK_ALIGNMENT = 4
+MEM_DIRTY_GRANULE_SHIFT = 6  # dirty tracking granule: 64 bytes
+MEM_DIRTY_GRANULE = 1 << MEM_DIRTY_GRANULE_SHIFT
+# Observational event types the executive may switch off with ``event_filter``.
+# Everything else (debug stops, sleeps, mailbox waits/wakes, value and command
+# events) drives executive state and is always emitted.
+FILTERABLE_EVENT_TYPES = frozenset({"trace_step", "mailbox_send", "mailbox_recv"})
 
 FLAG_Z = 0x01  # Zero
 FLAG_C = 0x02  # Carry / !borrow
@@ -479,6 +501,46 @@ def _align_down(value: int, alignment: int) -> int:
     return value - (value % alignment)
 
 
+def _new_dirty_map(mem_size: int = VM_ADDRESS_SPACE_SIZE) -> bytearray:
+    return bytearray((mem_size + MEM_DIRTY_GRANULE - 1) >> MEM_DIRTY_GRANULE_SHIFT)
+
+
+def _mark_dirty(dirty: Optional[bytearray], addr: int, length: int) -> None:
+    """Flag every granule touched by [addr, addr+length) as written."""
+
+    if dirty is None or length <= 0:
+        return
+    first = addr >> MEM_DIRTY_GRANULE_SHIFT
+    last = min((addr + length - 1) >> MEM_DIRTY_GRANULE_SHIFT, len(dirty) - 1)
+    if first == last:
+        dirty[first] = 1
+    elif first < last:
+        dirty[first : last + 1] = b"\x01" * (last - first + 1)
+
+
+# Task summary fields that change on nearly every step; they ride along with
+# a delta but do not trigger one on their own.
+TASK_DELTA_VOLATILE_FIELDS = frozenset({"pc", "accounted_steps", "accounted_cycles"})
+# Summary fields _store_active_state refreshes; a change marks the task for task_deltas.
+TASK_DELTA_STORED_FIELDS = ("state", "sleep_pending", "sleep_pending_ms", "sleep_deadline", "exit_status")
+
+
+def _dirty_ranges(dirty: Optional[bytes]) -> List[List[int]]:
+    """Collapse a granule map into coalesced [addr, length] byte ranges."""
+
+    ranges: List[List[int]] = []
+    if not dirty:
+        return ranges
+    idx = dirty.find(1)
+    while idx != -1:
+        end = dirty.find(0, idx)
+        if end == -1:
+            end = len(dirty)
+        ranges.append([idx << MEM_DIRTY_GRANULE_SHIFT, (end - idx) << MEM_DIRTY_GRANULE_SHIFT])
+        idx = dirty.find(1, end)
+    return ranges
+
+
 
 
 @dataclass
@@ -510,6 +572,7 @@ class TaskContext:
 class DebugState:
     attached: bool = False
     breakpoints: Set[int] = field(default_factory=set)
+    conditions: Dict[int, BreakpointSpec] = field(default_factory=dict)
     halted: bool = False
     last_stop: Optional[Dict[str, Any]] = None
 
@@ -616,6 +679,7 @@ class RegisterFile:
             if offset + 4 > len(self._vm.mem):
                 raise RuntimeError("register window outside VM memory")
             self._vm.mem[offset:offset + 4] = val.to_bytes(4, "little")
+            _mark_dirty(self._vm.mem_dirty, offset, 4)
         regs = _ensure_reg_list(ctx)
         regs[idx] = val
 
@@ -774,6 +838,14 @@ class FSStub:
         start = ent["pos"]; end = min(start+n, len(data))
         ent["pos"] = end
         return bytes(data[start:end])
+    def readinto(self, fd, dest):
+        if fd not in self.fds: return 0
+        ent = self.fds[fd]; data = self.files[ent["path"]]
+        start = ent["pos"]; end = min(start+len(dest), len(data))
+        with memoryview(data) as src:
+            dest[: end-start] = src[start:end]
+        ent["pos"] = end
+        return end - start
     def write(self, fd, buf):
         if fd not in self.fds: return 0
         ent = self.fds[fd]; data = self.files[ent["path"]]
@@ -820,7 +892,17 @@ class MiniVM:
         self.code = bytearray(code)
         self.entry = entry
         self.mem = bytearray(64 * 1024)
+        self.mem_dirty = _new_dirty_map(len(self.mem))
         self.fs = FSStub()
+        self.fs_queue: Optional[FSIOQueue] = None  # set by the controller
+        self.can_node: Optional[CANNode] = None  # set by the controller when a CAN bus is attached
+        self.can_subscribers: Dict[int, int] = {}  # pid -> mailbox handle for RX events
+        self.uart_ports: Dict[int, UARTPort] = {}  # set by the controller when UART ports are attached
+        self.uart_subscribers: Dict[int, Tuple[int, int]] = {}  # port -> (pid, mailbox handle)
+        self.gpio: Optional[GPIOBank] = None  # set by the controller when a GPIO bank is attached
+        self.gpio_subscribers: Dict[int, Tuple[int, int]] = {}  # pin -> (pid, mailbox handle)
+        self.timers: Optional[TimerService] = None  # set by the controller
+        self.svc_stats: Optional[SVCStats] = None  # set by the controller
         self.trace = trace
         self.svc_trace = svc_trace
         self.dev_libm = dev_libm
@@ -846,12 +928,16 @@ class MiniVM:
         self._legacy_exec_module_warned: bool = False
         self.debug_enabled: bool = False
         self.debug_breakpoints: Set[int] = set()
+        self.debug_conditions: Dict[int, BreakpointSpec] = {}
         self.debug_temp_breakpoints: Set[int] = set()
         self.debug_skip_bp_once: Optional[int] = None
         self.debug_single_step_remaining: int = 0
         self.debug_async_break: bool = False
         self.debug_halted: bool = False
         self.debug_last_stop: Optional[Dict[str, Any]] = None
+        self.svc_tape: Optional[TaskTimeline] = None
+        self.pc_counters: Optional[PCCounters] = None
+        self.muted_events: frozenset = frozenset()
         self.context: TaskContext = TaskContext(pc=entry)
         self.running = True
         self.steps = 0
@@ -878,10 +964,17 @@ class MiniVM:
         self.pc = entry
         self.context.pc = entry
 
-    def configure_debug(self, *, enabled: bool, breakpoints: Optional[Set[int]] = None) -> None:
+    def configure_debug(
+        self,
+        *,
+        enabled: bool,
+        breakpoints: Optional[Set[int]] = None,
+        conditions: Optional[Dict[int, BreakpointSpec]] = None,
+    ) -> None:
         self.debug_enabled = bool(enabled)
         if not enabled:
             self.debug_breakpoints.clear()
+            self.debug_conditions = {}
             self.debug_temp_breakpoints.clear()
             self.debug_skip_bp_once = None
             self.debug_single_step_remaining = 0
@@ -890,10 +983,16 @@ class MiniVM:
             self.debug_last_stop = None
             return
         if breakpoints is not None:
-            self.set_debug_breakpoints(breakpoints)
+            self.set_debug_breakpoints(breakpoints, conditions)
 
-    def set_debug_breakpoints(self, breakpoints: Set[int]) -> None:
+    def set_debug_breakpoints(
+        self,
+        breakpoints: Set[int],
+        conditions: Optional[Dict[int, BreakpointSpec]] = None,
+    ) -> None:
         self.debug_breakpoints = {addr & 0xFFFF for addr in breakpoints}
+        # Shared with the controller's DebugState so hit counts survive task switches.
+        self.debug_conditions = conditions if conditions is not None else {}
 
     def request_debug_break(self) -> None:
         if self.debug_enabled:
@@ -1078,6 +1177,7 @@ class MiniVM:
             "context": context_to_dict(ctx),
             "code": bytearray(self.code),
             "mem": bytearray(self.mem),
+            "mem_dirty": self.mem_dirty,
             "running": self.running,
             "sleep_until": self.sleep_until,
             "sleep_pending_ms": self.sleep_pending_ms,
@@ -1092,6 +1192,13 @@ class MiniVM:
         mem_state = state.get("mem")
         if mem_state is not None:
             self.mem = bytearray(mem_state)
+        dirty_state = state.get("mem_dirty")
+        dirty_len = (len(self.mem) + MEM_DIRTY_GRANULE - 1) >> MEM_DIRTY_GRANULE_SHIFT
+        if isinstance(dirty_state, bytearray) and len(dirty_state) == dirty_len:
+            self.mem_dirty = dirty_state
+        else:
+            self.mem_dirty = _new_dirty_map(len(self.mem))
+            state["mem_dirty"] = self.mem_dirty
         self.steps = int(state.get("steps", state.get("cycles", self.steps)))
         self.cycles = self.steps
         self.sleep_until = state.get("sleep_until")
@@ -1109,6 +1216,8 @@ class MiniVM:
         self.debug_single_step_remaining = 0
 
     def emit_event(self, event: Dict[str, Any]) -> None:
+        if self.muted_events and event.get("type") in self.muted_events:
+            return
         self.pending_events.append(event)
 
     def consume_events(self) -> List[Dict[str, Any]]:
@@ -1144,6 +1253,7 @@ class MiniVM:
         a = addr & 0xFFFF
         end = min(a + len(data), len(self.mem))
         self.mem[a:end] = data[: end - a]
+        _mark_dirty(self.mem_dirty, a, end - a)
 
     def step(self):
         if self.debug_enabled:
@@ -1159,8 +1269,19 @@ class MiniVM:
                     self._debug_halt("breakpoint", halt_pc=self.pc)
                     return
                 if current_pc16 in self.debug_breakpoints:
-                    self._debug_halt("breakpoint", halt_pc=self.pc)
-                    return
+                    spec = self.debug_conditions.get(current_pc16)
+                    if spec is None:
+                        self._debug_halt("breakpoint", halt_pc=self.pc)
+                        return
+                    action = spec.evaluate(self)
+                    if action == BP_STOP:
+                        self._debug_halt("breakpoint", halt_pc=self.pc, extra={"hits": spec.hits, "conditional": True})
+                        return
+                    if action == BP_LOG:
+                        event = {"type": "debug_log", "pc": self.pc & 0xFFFFFFFF, "hits": spec.hits, "message": spec.format_log(self)}
+                        if self.context is not None and self.context.pid is not None:
+                            event["pid"] = self.context.pid
+                        self.emit_event(event)
         if self.sleep_until is not None:
             remaining = self.sleep_until - time.monotonic()
             if remaining > 0:
@@ -1172,6 +1293,8 @@ class MiniVM:
             self.sleep_pending_ms = None
             self.context.state = "ready"
             self.running = True
+            if self.svc_tape is not None:
+                self.svc_tape.note_timer(self.steps)
             self.emit_event({"type": "sleep_complete"})
 
         prev_pc = self.pc
@@ -1198,6 +1321,13 @@ class MiniVM:
 
         ins = be32(self.code, self.pc)
         op = (ins >> 24) & 0xFF
+        counters = self.pc_counters
+        if counters is not None:
+            slot = prev_pc >> 2
+            if slot < counters.slots:
+                hits = counters.hits
+                if hits[slot] < counters.limit:
+                    hits[slot] += 1
         rd = (ins >> 20) & 0x0F
         rs1 = (ins >> 16) & 0x0F
         rs2 = (ins >> 12) & 0x0F
@@ -1280,6 +1410,8 @@ class MiniVM:
             self.mem[a + 1] = (val >> 8) & 0xFF
             self.mem[a + 2] = (val >> 16) & 0xFF
             self.mem[a + 3] = (val >> 24) & 0xFF
+            self.mem_dirty[a >> MEM_DIRTY_GRANULE_SHIFT] = 1
+            self.mem_dirty[(a + 3) >> MEM_DIRTY_GRANULE_SHIFT] = 1
 
         def ld8(addr):
             a = addr & 0xFFFF
@@ -1290,6 +1422,7 @@ class MiniVM:
             a = addr & 0xFFFF
             ensure_range(a, 1)
             self.mem[a] = v & 0xFF
+            self.mem_dirty[a >> MEM_DIRTY_GRANULE_SHIFT] = 1
 
         def ld16(addr):
             a = addr & 0xFFFF
@@ -1301,6 +1434,8 @@ class MiniVM:
             ensure_range(a, 2)
             self.mem[a] = v & 0xFF
             self.mem[a + 1] = (v >> 8) & 0xFF
+            self.mem_dirty[a >> MEM_DIRTY_GRANULE_SHIFT] = 1
+            self.mem_dirty[(a + 1) >> MEM_DIRTY_GRANULE_SHIFT] = 1
 
         def trap_memory_fault():
             if self.trace or self.trace_out:
@@ -1337,17 +1472,6 @@ class MiniVM:
             )
         self._last_pc = self.pc & 0xFFFFFFFF
         self._last_opcode = ins & 0xFFFFFFFF
-        qb = {
-            "type": "trace_step",
-            "pc": self._last_pc,
-            "opcode": self._last_opcode,
-            "flags": self.flags & 0xFF,
-            "regs": [self.regs[i] & 0xFFFFFFFF for i in range(16)],
-            "steps": self.steps,
-        }
-        ctx = self.context
-        if ctx and ctx.pid is not None:
-            qb["pid"] = ctx.pid
         mem_access = None
 
         adv = 4
@@ -1628,7 +1752,16 @@ class MiniVM:
             fn = imm_raw & 0xFF
             if self.svc_trace:
                 self._log(f"[SVC] mod=0x{mod:X} fn=0x{fn:X} R0..R3={self.regs[:4]}")
-            self.handle_svc(mod, fn)
+            svc_stats = self.svc_stats
+            start_ns = time.perf_counter_ns() if svc_stats is not None else 0
+            if self.svc_tape is not None:
+                self.svc_tape.svc(self, mod, fn)
+            else:
+                self.handle_svc(mod, fn)
+            if svc_stats is not None:
+                ctx = self.context
+                blocked = self.sleep_until is not None or (ctx is not None and ctx.state == "waiting_mbx")
+                svc_stats.record(self.pid, mod, fn, start_ns, time.perf_counter_ns(), self.regs[0], blocked)
         elif op == 0x40:  # PUSH
             raw_sp = self.sp - 4
             if raw_sp < 0 or raw_sp < (self.context.stack_limit or 0) or raw_sp + 4 > len(self.mem):
@@ -1715,6 +1848,11 @@ class MiniVM:
             adv = 4
 
         self.pc = (self.pc + adv) & 0xFFFFFFFF
+        if counters is not None and op in BRANCH_OPCODES and counters.taken is not None:
+            if self.pc != (prev_pc + 4) & 0xFFFFFFFF and (prev_pc >> 2) < counters.slots:
+                taken = counters.taken
+                if taken[prev_pc >> 2] < counters.limit:
+                    taken[prev_pc >> 2] += 1
         self.steps += 1
         self.cycles = self.steps
         ctx = self.context
@@ -1755,7 +1893,7 @@ class MiniVM:
         self._last_opcode = ins & 0xFFFFFFFF
         self._last_regs = last_regs_snapshot
 
-        if self.trace or self.trace_out:
+        if (self.trace or self.trace_out) and "trace_step" not in self.muted_events:
             event = {
                 "type": "trace_step",
                 "pc": self._last_pc,
@@ -1798,20 +1936,12 @@ class MiniVM:
             exit_code = self.regs[0] & 0xFFFFFFFF
             self._log(f"[EXIT {exit_code}]")
             self.running = False
-        elif mod == 0x1 and fn == 1:
-            ptr = self.regs[1] & 0xFFFF
-            ln = self.regs[2] & 0xFFFF
-            data = bytes(self.mem[ptr : ptr + ln])
-            text = data.decode("utf-8", errors="ignore")
-            self._log(f"[UART.tx] {text}")
-            self.regs[0] = ln
-        elif mod == 0x2 and fn == 0:
-            can_id = self.regs[1] & 0x7FF
-            ptr = self.regs[2] & 0xFFFF
-            ln = self.regs[3] & 0xFF
-            data = bytes(self.mem[ptr : ptr + ln])
-            self._log(f"[CAN.tx] id=0x{can_id:03X} data={data.hex()}")
-            self.regs[0] = 0
+        elif mod == 0x1:
+            self._svc_uart(fn)
+        elif mod == 0x2:
+            self._svc_can(fn)
+        elif mod == 0x3:
+            self._svc_timer(fn)
         elif self.dev_libm and mod == 0xE:
             import math
             funcs = {0: math.sin, 1: math.cos, 2: math.exp}
@@ -1832,6 +1962,8 @@ class MiniVM:
             self._svc_command(fn)
         elif mod == 0x4:
             self._svc_fs(fn)
+        elif mod == 0x9:
+            self._svc_gpio(fn)
         else:
             self._log(f"[SVC] mod=0x{mod:X} fn=0x{fn:X} (stub)")
             self.regs[0] = HSX_ERR_ENOSYS
@@ -1849,12 +1981,221 @@ class MiniVM:
             ms = self.regs[0] & 0xFFFFFFFF
             self.request_sleep(ms)
             self.regs[0] = 0
+        elif fn == 1:  # hal_submit(ring_ptr, max_requests)
+            self._exec_hal_submit(self.regs[1] & 0xFFFF, self.regs[2] & 0xFFFF)
         else:
             self._log(f"[EXEC] fn={fn} not implemented")
             self.regs[0] = HSX_ERR_ENOSYS
 
 
+    def _exec_hal_submit(self, ring_ptr: int, limit: int) -> None:
+        """Drain a task's HAL request ring through the ordinary SVC handlers."""
+
+        saved = [self.regs[idx] for idx in range(16)]
+
+        def execute(module: int, fn: int, args: Tuple[int, int, int, int]) -> int:
+            for idx, value in enumerate(args, start=1):
+                self.regs[idx] = value
+            start_ns = time.perf_counter_ns()
+            self.handle_svc(module, fn)
+            if self.svc_stats is not None:  # batched calls are counted like traps
+                self.svc_stats.record(self.pid, module, fn, start_ns, time.perf_counter_ns(), self.regs[0], False)
+            return self.regs[0]
+
+        try:
+            completed, failed = hal_batch.drain(self.mem, ring_ptr, execute, limit=limit)
+        except ValueError as exc:
+            self._log(f"[EXEC] hal_submit rejected ring at 0x{ring_ptr:04X}: {exc}")
+            self.regs[0] = HSX_HAL_INVALID_PARAM
+            self.regs[1] = 0  # nothing failed; the ring itself was rejected
+            return
+        finally:
+            for idx in range(2, 16):
+                self.regs[idx] = saved[idx]
+        entries = int.from_bytes(self.mem[ring_ptr + 4 : ring_ptr + 6], "little")
+        _mark_dirty(self.mem_dirty, ring_ptr, hal_batch.RING_HEADER.size + entries * hal_batch.REQUEST.size)
+        if self.svc_trace:
+            self._log(f"[EXEC] hal_submit ring=0x{ring_ptr:04X} completed={completed} failed={failed}")
+        self.regs[0] = completed
+        self.regs[1] = failed
+
+    def _svc_uart(self, fn: int) -> None:
+        if fn in (1, 3):  # write(ptr, len) on the console / write(port, ptr, len)
+            if fn == 1:
+                index, ptr, ln = 0, self.regs[1] & 0xFFFF, self.regs[2] & 0xFFFF
+            else:
+                index, ptr, ln = self.regs[1] & 0xFF, self.regs[2] & 0xFFFF, self.regs[3] & 0xFFFF
+            port = self.uart_ports.get(index)
+            if port is None:
+                text = bytes(self.mem[ptr : ptr + ln]).decode("utf-8", errors="ignore")
+                self._log(f"[UART.tx] {text}" if index == 0 else f"[UART{index}.tx] {text}")
+                self.regs[0] = ln
+                return
+            with memoryview(self.mem) as mem, mem[ptr : ptr + ln] as src:
+                self.regs[0] = port.write(src)
+            return
+        if fn not in (2, 4, 5, 6):
+            self._log(f"[UART] fn={fn} not implemented")
+            self.regs[0] = HSX_ERR_ENOSYS
+            return
+        index = self.regs[1] & 0xFF
+        port = self.uart_ports.get(index)
+        if port is None:
+            self.regs[0] = HSX_HAL_UNSUPPORTED  # port not attached
+        elif fn == 2:  # config(port, baud, parity, stop_bits)
+            self.regs[0] = port.configure(self.regs[2], self.regs[3] & 0xFF, self.regs[4] & 0xFF)
+        elif fn == 4:  # read_poll(port, ptr, max_len)
+            ptr = self.regs[2] & 0xFFFF
+            ln = self.regs[3] & 0xFFFF
+            with memoryview(self.mem) as mem, mem[ptr : ptr + ln] as dest:
+                count = port.read(dest)
+            if count > 0:
+                _mark_dirty(self.mem_dirty, ptr, count)
+            self.regs[0] = count
+        elif fn == 5:  # rx_subscribe(port, mbx_handle)
+            pid = self.pid or 0
+            handle = self.regs[2] & 0xFFFF
+            try:
+                self.mailboxes.descriptor_for_handle(pid, handle)
+            except MailboxError:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            self.uart_subscribers[index] = (pid, handle)
+            self.regs[0] = 0
+        else:  # get_status(port)
+            self.regs[0] = port.status()
+
+    def _svc_gpio(self, fn: int) -> None:
+        bank = self.gpio
+        pin = self.regs[1] & 0xFF
+        if bank is None:
+            self.regs[0] = HSX_HAL_UNSUPPORTED  # no GPIO bank attached
+        elif fn == 0:  # config(pin, mode, pull)
+            self.regs[0] = bank.configure(pin, self.regs[2] & 0xFF, self.regs[3] & 0xFF)
+        elif fn == 1:  # read(pin)
+            self.regs[0] = bank.read(pin)
+        elif fn == 2:  # write(pin, value)
+            self.regs[0] = bank.write(pin, self.regs[2] & 0x1)
+        elif fn == 3:  # toggle(pin)
+            value = bank.read(pin)
+            self.regs[0] = value if value < 0 else bank.write(pin, value ^ 1)
+        elif fn == 4:  # set_interrupt(pin, edge, enable)
+            self.regs[0] = bank.set_interrupt(pin, self.regs[2] & 0xFF, bool(self.regs[3] & 0xFF))
+        elif fn == 5:  # subscribe(pin, mbx_handle)
+            pid = self.pid or 0
+            handle = self.regs[2] & 0xFFFF
+            try:
+                self.mailboxes.descriptor_for_handle(pid, handle)
+            except MailboxError:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            if bank.read(pin) < 0:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            self.gpio_subscribers[pin] = (pid, handle)
+            self.regs[0] = 0
+        elif fn == 6:  # set_debounce(pin, debounce_us, coalesce_us)
+            self.regs[0] = bank.set_debounce(pin, self.regs[2], self.regs[3])
+        elif fn == 7:  # edge_count(pin)
+            self.regs[0] = bank.edge_count(pin)
+        else:
+            self._log(f"[GPIO] fn={fn} not implemented")
+            self.regs[0] = HSX_ERR_ENOSYS
+
+    def _svc_timer(self, fn: int) -> None:
+        service = self.timers
+        if service is None:
+            self.regs[0] = HSX_HAL_UNSUPPORTED  # no timer service
+            return
+        pid = self.pid or 0
+        if fn == 0:  # get_tick -> microseconds, high word in R1
+            now_us = service.current_ns() // 1000
+            self.regs[0] = now_us & 0xFFFFFFFF
+            self.regs[1] = (now_us >> 32) & 0xFFFFFFFF
+        elif fn == 1:  # get_freq
+            self.regs[0] = 1_000_000
+        elif fn == 2:  # create(period_us, type)
+            self.regs[0] = service.create(self.regs[1], self.regs[2] & 0xFF, owner=pid)
+        elif fn == 3:  # set_callback(timer_id, mbx_handle)
+            handle = self.regs[2] & 0xFFFF
+            try:
+                self.mailboxes.descriptor_for_handle(pid, handle)
+            except MailboxError:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            self.regs[0] = service.set_target(self.regs[1] & 0xFFFF, (pid, handle), owner=pid)
+        elif fn == 4:  # cancel(timer_id)
+            self.regs[0] = service.cancel(self.regs[1] & 0xFFFF, owner=pid)
+        elif fn == 5:  # stats(timer_id, ptr) -> hsx_timer_stats_t
+            info = service.timer_stats(self.regs[1] & 0xFFFF)
+            if info is None or info["owner"] != pid:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            ptr = self.regs[2] & 0xFFFF
+            record = struct.pack(
+                "<6I",
+                *(
+                    min(int(value), 0xFFFFFFFF)
+                    for value in (
+                        info["fires"],
+                        info["missed"],
+                        info["dropped"],
+                        info["jitter_min_us"],
+                        info["jitter_max_us"],
+                        info["jitter_mean_us"],
+                    )
+                ),
+            )
+            self.mem[ptr : ptr + len(record)] = record
+            _mark_dirty(self.mem_dirty, ptr, len(record))
+            self.regs[0] = 0
+        else:
+            self._log(f"[TIMER] fn={fn} not implemented")
+            self.regs[0] = HSX_ERR_ENOSYS
+
+    def _svc_can(self, fn: int) -> None:
+        node = self.can_node
+        if fn == 0:  # tx(can_id, ptr, len, flags)
+            flags = self.regs[4] & 0xFF if node is not None else 0
+            can_id = self.regs[1] & (CAN_EXT_ID_MASK if flags & HSX_CAN_EXT_FRAME else CAN_STD_ID_MASK)
+            ptr = self.regs[2] & 0xFFFF
+            ln = self.regs[3] & 0xFF
+            data = bytes(self.mem[ptr : ptr + ln])
+            if node is None:
+                self._log(f"[CAN.tx] id=0x{can_id:03X} data={data.hex()}")
+                self.regs[0] = 0
+                return
+            try:
+                frame = CANFrame(can_id, data, flags)
+            except ValueError:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            self.regs[0] = node.send(frame)
+        elif node is None:
+            self.regs[0] = HSX_HAL_UNSUPPORTED  # no bus attached
+        elif fn == 1:  # set_filter(bank, mask, id)
+            self.regs[0] = node.set_filter(self.regs[1] & 0xFF, self.regs[2], self.regs[3])
+        elif fn == 2:  # rx_subscribe(mbx_handle)
+            pid = self.pid or 0
+            handle = self.regs[1] & 0xFFFF
+            try:
+                self.mailboxes.descriptor_for_handle(pid, handle)
+            except MailboxError:
+                self.regs[0] = HSX_HAL_INVALID_PARAM
+                return
+            self.can_subscribers[pid] = handle
+            self.regs[0] = 0
+        elif fn == 3:  # get_status()
+            self.regs[0] = node.status()
+        else:
+            self._log(f"[CAN] fn={fn} not implemented")
+            self.regs[0] = HSX_ERR_ENOSYS
+
     def _svc_fs(self, fn):
+        fs_queue = self.fs_queue
+        if fs_queue is not None and fn in (1, 2, 3) and fs_queue.has_pending(self.regs[1] & 0xFFFF):
+            # Synchronous calls see the effects of earlier async requests.
+            fs_queue.service(self.fs, fd=self.regs[1] & 0xFFFF)
         if fn == 0:  # open(path, flags)
             path = self._read_c_string(self.regs[1]) or "/unnamed"
             flags = self.regs[2] & 0xFFFF
@@ -1863,14 +2204,16 @@ class MiniVM:
             fd = self.regs[1] & 0xFFFF
             ptr = self.regs[2] & 0xFFFF
             ln = self.regs[3] & 0xFFFF
-            data = self.fs.read(fd, ln)
-            self.mem[ptr : ptr + len(data)] = data
-            self.regs[0] = len(data)
+            # The backend copies straight from its page cache into task memory.
+            with memoryview(self.mem) as mem, mem[ptr : ptr + ln] as dest:
+                count = self.fs.readinto(fd, dest)
+            if count > 0:
+                _mark_dirty(self.mem_dirty, ptr, count)
+            self.regs[0] = count
         elif fn == 2:  # write(fd, ptr, len)
             fd = self.regs[1] & 0xFFFF
             ptr = self.regs[2] & 0xFFFF
             ln = self.regs[3] & 0xFFFF
-            buf = bytes(self.mem[ptr : ptr + ln])
             ctx = self.context
             mailbox_handle = None
             if ctx is not None and ctx.fd_table:
@@ -1881,6 +2224,7 @@ class MiniVM:
                     flags |= mbx_const.HSX_MBX_FLAG_STDOUT
                 elif fd == 2:
                     flags |= mbx_const.HSX_MBX_FLAG_STDERR
+                buf = bytes(self.mem[ptr : ptr + ln])  # the mailbox keeps the payload
                 try:
                     ok, descriptor_id = self.mailboxes.send(
                         pid=self.pid or 0,
@@ -1910,16 +2254,24 @@ class MiniVM:
                     return
                 self.regs[0] = 0
                 return
-            self.regs[0] = self.fs.write(fd, buf)
+            with memoryview(self.mem) as mem, mem[ptr : ptr + ln] as src:
+                self.regs[0] = self.fs.write(fd, src)
         elif fn == 3:  # close(fd)
             fd = self.regs[1] & 0xFFFF
             self.regs[0] = self.fs.close(fd)
+        elif fn in (4, 5):  # read_async / write_async(fd, ptr, len, mbx_handle, tag)
+            self.regs[0] = self._fs_submit_async(FS_OP_READ if fn == 4 else FS_OP_WRITE)
         elif fn == 10:  # listdir(path, out, max)
             path = self._read_c_string(self.regs[1]) or "/"
             out_ptr = self.regs[2] & 0xFFFF
             mx = self.regs[3] & 0xFFFF
-            data = self.fs.listdir(path)[:mx]
+            data = self.fs.listdir(path)
+            if isinstance(data, int):
+                self.regs[0] = data
+                return
+            data = data[:mx]
             self.mem[out_ptr : out_ptr + len(data)] = data
+            _mark_dirty(self.mem_dirty, out_ptr, len(data))
             self.regs[0] = len(data)
         elif fn == 11:  # delete(path)
             path = self._read_c_string(self.regs[1])
@@ -1936,6 +2288,24 @@ class MiniVM:
             self.regs[0] = -1
 
 
+    def _fs_submit_async(self, op: int) -> int:
+        fs_queue = self.fs_queue
+        if fs_queue is None:
+            return HSX_HAL_UNSUPPORTED  # no executive I/O queue
+        pid = self.pid or 0
+        fd = self.regs[1] & 0xFFFF
+        ptr = self.regs[2] & 0xFFFF
+        ln = self.regs[3] & 0xFFFF
+        handle = self.regs[4] & 0xFFFF
+        if fd not in self.fs.fds:
+            return HSX_HAL_INVALID_PARAM
+        try:
+            self.mailboxes.descriptor_for_handle(pid, handle)
+        except MailboxError:
+            return HSX_HAL_INVALID_PARAM
+        data = bytes(self.mem[ptr : ptr + ln]) if op == FS_OP_WRITE else b""
+        return fs_queue.submit(pid=pid, op=op, fd=fd, length=ln, handle=handle, tag=self.regs[5], ptr=ptr, data=data)
+
     def _svc_mailbox(self, fn: int) -> None:
         handler = self._mailbox_handler
         if handler is not None:
@@ -1991,6 +2361,7 @@ class MiniVM:
                     return
                 length = min(max_len, msg.length)
                 self.mem[ptr : ptr + length] = msg.payload[:length]
+                _mark_dirty(self.mem_dirty, ptr, length)
                 self.regs[0] = mbx_const.HSX_MBX_STATUS_OK
                 self.regs[1] = length
                 self.regs[2] = msg.flags
@@ -2074,6 +2445,14 @@ class VMController:
         svc_trace: bool = False,
         dev_libm: bool = False,
         mailbox_profile: Optional[Dict[str, Any]] = None,
+        filesystem: Optional[FlashFS] = None,
+        can_bus: Optional[CANBus] = None,
+        can_node: str = "vm",
+        uart_ports: Optional[List[UARTPort]] = None,
+        gpio: Optional[GPIOBank] = None,
+        timers: Optional[TimerService] = None,
+        svc_stats_path: Optional[str] = None,
+        svc_stats_interval: float = 10.0,
     ):
         self.trace = trace
         self.svc_trace = svc_trace
@@ -2096,6 +2475,35 @@ class VMController:
         self.mailbox_profile: Dict[str, Any] = profile_config
         fram_path = os.environ.get("HSX_FRAM_PATH")
         self.persistence_store = PersistenceStore(fram_path)
+        # Shared flash filesystem; None keeps each VM's in-memory FSStub.
+        self.filesystem: Optional[FlashFS] = filesystem
+        self.fs_queue = FSIOQueue(self._deliver_fs_completion)
+        # Virtual CAN bus shared with other executives; None logs CAN_TX only.
+        self.can_bus: Optional[CANBus] = None
+        self.can_node: Optional[CANNode] = None
+        self.can_server: Optional[CANSocketServer] = None
+        self.can_loader: Optional[ImageLoaderBridge] = None
+        self.can_subscribers: Dict[int, int] = {}
+        if can_bus is not None:
+            self._attach_can(can_bus, can_node)
+        # Simulated UART ports by index; tasks on other ports only log writes.
+        self.uart_ports: Dict[int, UARTPort] = {}
+        self.uart_subscribers: Dict[int, Tuple[int, int]] = {}
+        for port in uart_ports or []:
+            self._attach_uart(port)
+        # Input pins with debounce and edge coalescing; None answers UNSUPPORTED.
+        self.gpio: Optional[GPIOBank] = None
+        self.gpio_subscribers: Dict[int, Tuple[int, int]] = {}
+        if gpio is not None:
+            self._attach_gpio(gpio)
+        # Timing wheel for TIMER_CREATE; pass a clockless service for virtual time.
+        self.timers: TimerService = timers if timers is not None else live_timer_service()
+        self.timers.deliver = self._deliver_timer_event
+        # Per-SVC counters and latency histograms; optionally written to a file periodically.
+        self.svc_stats = SVCStats()
+        self.svc_snapshot: Optional[SnapshotWriter] = None
+        if svc_stats_path:
+            self.svc_snapshot = SnapshotWriter(self.svc_stats, svc_stats_path, svc_stats_interval)
         self.mailboxes = self._create_mailbox_manager()
         self.valcmd = self._create_valcmd_registry()
         self.waiting_tasks: Dict[int, Dict[str, Any]] = {}
@@ -2112,6 +2520,15 @@ class VMController:
         self.mailbox_counters: Dict[int, Dict[str, int]] = defaultdict(dict)
         self.streaming_sessions: Dict[int, Dict[str, Any]] = {}
         self.metadata_by_pid: Dict[int, HXEMetadata] = {}
+        self.task_delta_seq = 0
+        self._task_published: Dict[int, Dict[str, Any]] = {}
+        self._task_dirty: Set[int] = set()
+        self.time_travel: Dict[int, TaskTimeline] = {}
+        self.profiler: Optional[SampleProfiler] = None
+        self.pc_counters: Dict[int, PCCounters] = {}
+        # Executive-pushed union of subscription filters: event type (or "*")
+        # -> PIDs (None for all).  None means nothing is filtered.
+        self.event_filter_spec: Optional[Dict[str, Optional[frozenset]]] = None
 
     def _create_mailbox_manager(self) -> MailboxManager:
         profile = getattr(self, "mailbox_profile", {}) or {}
@@ -2564,6 +2981,8 @@ class VMController:
         self.program_path = None
         self.attached = False
         self.paused = False
+        self._task_dirty.update(self.tasks)
+        self._task_dirty.update(self._task_published)
         self.tasks.clear()
         self.task_states.clear()
         self.waiting_tasks.clear()
@@ -2572,6 +2991,18 @@ class VMController:
         self.current_pid = None
         self.next_pid = 1
         self.debug_sessions.clear()
+        self.time_travel.clear()
+        self.profiler = None
+        self.pc_counters.clear()
+        self.fs_queue.clear()
+        self.can_subscribers.clear()
+        self.uart_subscribers.clear()
+        self.gpio_subscribers.clear()
+        for timer_id in list(self.timers.timers):
+            self.timers.cancel(timer_id)
+        self.svc_stats.pending.clear()
+        if self.filesystem is not None:
+            self.filesystem.close_all()
         self._reg_alloc_next = REGISTER_REGION_START
         self._stack_alloc_next = VM_ADDRESS_SPACE_SIZE
         self._reg_free_list.clear()
@@ -3006,16 +3437,17 @@ class VMController:
                 if ok:
                     vm.regs[0] = mbx_const.HSX_MBX_STATUS_OK
                     vm.regs[1] = len(payload)
-                    vm.emit_event({
-                        "type": "mailbox_send",
-                        "pid": pid,
-                        "descriptor": descriptor_id,
-                        "handle": handle,
-                        "length": len(payload),
-                        "flags": flags,
-                        "channel": channel,
-                        "src_pid": pid,
-                    })
+                    if "mailbox_send" not in vm.muted_events:
+                        vm.emit_event({
+                            "type": "mailbox_send",
+                            "pid": pid,
+                            "descriptor": descriptor_id,
+                            "handle": handle,
+                            "length": len(payload),
+                            "flags": flags,
+                            "channel": channel,
+                            "src_pid": pid,
+                        })
                     self._deliver_mailbox_messages(descriptor_id)
                     self._trace_mailbox_regs(
                         "svc_send_done",
@@ -3071,6 +3503,7 @@ class VMController:
                 desc = self.mailboxes.descriptor_for_handle(pid, handle)
                 descriptor_id = desc.descriptor_id
                 vm.mem[ptr : ptr + length] = msg.payload[:length]
+                _mark_dirty(vm.mem_dirty, ptr, length)
                 vm.regs[0] = mbx_const.HSX_MBX_STATUS_OK
                 vm.regs[1] = length
                 vm.regs[2] = msg.flags
@@ -3092,16 +3525,17 @@ class VMController:
                     fn,
                     extra={"status": hex(vm.regs[0] & 0xFFFF), "length": length, "flags": hex(msg.flags), "src": msg.src_pid},
                 )
-                vm.emit_event({
-                    "type": "mailbox_recv",
-                    "pid": pid,
-                    "descriptor": descriptor_id,
-                    "handle": handle,
-                    "length": length,
-                    "flags": msg.flags,
-                    "channel": msg.channel,
-                    "src_pid": msg.src_pid,
-                })
+                if "mailbox_recv" not in vm.muted_events:
+                    vm.emit_event({
+                        "type": "mailbox_recv",
+                        "pid": pid,
+                        "descriptor": descriptor_id,
+                        "handle": handle,
+                        "length": length,
+                        "flags": msg.flags,
+                        "channel": msg.channel,
+                        "src_pid": msg.src_pid,
+                    })
                 try:
                     with open("/tmp/hsx_mailbox_trace.log", "a", encoding="utf-8") as trace_fp:
                         trace_fp.write(f"[MAILBOX] recv ok pid={pid} handle={handle} len={length} src={msg.src_pid}\n")
@@ -3166,6 +3600,7 @@ class VMController:
             state["wait_info"] = wait_info
         task = self.tasks.get(pid)
         if task:
+            self._task_dirty.add(pid)
             task["state"] = "waiting_mbx"
             task["wait_mailbox"] = descriptor_id
             task["wait_deadline"] = deadline
@@ -3194,6 +3629,7 @@ class VMController:
         wait_info = self.waiting_tasks.pop(pid, None)
         if wait_info is None:
             return
+        self._tt_note_external(pid, "mailbox")
         handle_value = wait_info.get("handle")
         if descriptor_id is None:
             descriptor_id = wait_info.get("descriptor_id")
@@ -3221,8 +3657,10 @@ class VMController:
             if mem is None:
                 mem = bytearray(64 * 1024)
                 state["mem"] = mem
+            dirty = self._state_dirty_map(state)
             if payload:
                 mem[buffer_ptr : buffer_ptr + length] = payload
+                _mark_dirty(dirty, buffer_ptr, length)
             ctx_dict = self._ensure_task_memory(pid, state)
             regs = list(ctx_dict.get("regs", [0] * 16))
             while len(regs) < 16:
@@ -3239,6 +3677,7 @@ class VMController:
                     offset = reg_base + idx * 4
                     if offset + 4 <= len(mem):
                         mem[offset:offset + 4] = (int(value) & 0xFFFFFFFF).to_bytes(4, "little")
+                        _mark_dirty(dirty, offset, 4)
             ctx_dict["state"] = "ready"
             ctx_dict["wait_kind"] = None
             ctx_dict["wait_mailbox"] = None
@@ -3251,6 +3690,7 @@ class VMController:
             self.task_states[pid] = state
         task = self.tasks.get(pid)
         if task:
+            self._task_dirty.add(pid)
             task["state"] = "ready"
             task["wait_mailbox"] = None
             task["wait_deadline"] = None
@@ -3259,6 +3699,7 @@ class VMController:
         if self.current_pid == pid and self.vm is not None and self.vm.context.pid == pid:
             if payload:
                 self.vm.mem[buffer_ptr : buffer_ptr + length] = payload
+                _mark_dirty(self.vm.mem_dirty, buffer_ptr, length)
             self.vm.regs[0] = status & 0xFFFF
             self.vm.regs[1] = length & 0xFFFF
             self.vm.regs[2] = flags & 0xFFFF
@@ -3326,11 +3767,13 @@ class VMController:
         if isinstance(mem, bytearray):
             if end <= len(mem):
                 mem[offset:end] = data
+                _mark_dirty(self._state_dirty_map(container), offset, end - offset)
         elif isinstance(mem, bytes):
             if end <= len(mem):
                 buf = bytearray(mem)
                 buf[offset:end] = data
                 container["mem"] = buf
+                _mark_dirty(self._state_dirty_map(container), offset, end - offset)
 
     def _write_bytes_to_task_mem(self, pid: int, ptr: int, data: bytes) -> None:
         if ptr == 0 or not data:
@@ -3342,6 +3785,7 @@ class VMController:
         if self.vm is not None and self.vm.context.pid == pid:
             if end <= len(self.vm.mem):
                 self.vm.mem[offset:end] = data
+                _mark_dirty(self.vm.mem_dirty, offset, end - offset)
         state = self.task_states.get(pid)
         if isinstance(state, dict):
             self._write_bytes_into_container(state, offset, end, data)
@@ -3542,6 +3986,7 @@ class VMController:
                 for idx in range(count):
                     offset = out_ptr + idx * 2
                     vm.mem[offset : offset + 2] = (oids[idx] & 0xFFFF).to_bytes(2, "little")
+                _mark_dirty(vm.mem_dirty, out_ptr, count * 2)
                 vm.regs[0] = val_const.HSX_VAL_STATUS_OK
                 vm.regs[1] = count
                 return
@@ -3696,6 +4141,7 @@ class VMController:
                 write_len = min(len(encoded), max_len - 1, len(vm.mem) - out_ptr - 1)
                 vm.mem[out_ptr : out_ptr + write_len] = encoded[:write_len]
                 vm.mem[out_ptr + write_len] = 0
+                _mark_dirty(vm.mem_dirty, out_ptr, write_len + 1)
                 vm.regs[0] = cmd_const.HSX_CMD_STATUS_OK
                 vm.regs[1] = write_len
                 return
@@ -3982,6 +4428,7 @@ class VMController:
         if pid in self._task_memory:
             self._release_task_memory(pid)
         self.tasks.pop(pid, None)
+        self._task_dirty.add(pid)
         self.task_states.pop(pid, None)
         self.metadata_by_pid.pop(pid, None)
         return {"status": "ok"}
@@ -4008,7 +4455,7 @@ class VMController:
             return
         dbg = self.debug_sessions.get(pid)
         if dbg and dbg.attached:
-            vm.configure_debug(enabled=True, breakpoints=dbg.breakpoints)
+            vm.configure_debug(enabled=True, breakpoints=dbg.breakpoints, conditions=dbg.conditions)
             if dbg.halted:
                 vm.debug_halted = True
                 vm.running = False
@@ -4031,6 +4478,7 @@ class VMController:
         self.task_states[self.current_pid] = state
         task = self.tasks.get(self.current_pid)
         if task:
+            published = tuple(task.get(key) for key in TASK_DELTA_STORED_FIELDS)
             task["vm_state"] = state
             task["pc"] = ctx.get("pc", task.get("pc"))
             task["sleep_pending"] = bool(self.vm.sleep_until or self.vm.sleep_pending_ms)
@@ -4072,6 +4520,8 @@ class VMController:
                     new_state = "stopped"
             task["state"] = new_state
             ctx["state"] = new_state
+            if tuple(task.get(key) for key in TASK_DELTA_STORED_FIELDS) != published:
+                self._task_dirty.add(self.current_pid)
             if self.vm.sleep_pending_ms is not None:
                 ctx["sleep_pending_ms"] = int(self.vm.sleep_pending_ms)
             else:
@@ -4114,6 +4564,8 @@ class VMController:
                 dev_libm=self.dev_libm,
                 mailboxes=self.mailboxes,
             )
+            if self.filesystem is not None:
+                self.vm.fs = self.filesystem
             self._flush_pending_mailbox_events()
         else:
             preserved_events = list(self.vm.pending_events)
@@ -4121,6 +4573,18 @@ class VMController:
         self.vm.set_value_handler(lambda fn, vm=self.vm: self._svc_value_controller(vm, fn))
         self.vm.set_command_handler(lambda fn, vm=self.vm: self._svc_command_controller(vm, fn))
         self.vm.restore_state(state)
+        self.vm.svc_tape = self.time_travel.get(pid)
+        self.vm.pc_counters = self.pc_counters.get(pid)
+        self.vm.fs_queue = self.fs_queue
+        self.vm.can_node = self.can_node
+        self.vm.can_subscribers = self.can_subscribers
+        self.vm.uart_ports = self.uart_ports
+        self.vm.uart_subscribers = self.uart_subscribers
+        self.vm.gpio = self.gpio
+        self.vm.gpio_subscribers = self.gpio_subscribers
+        self.vm.timers = self.timers
+        self.vm.svc_stats = self.svc_stats
+        self.vm.muted_events = self._muted_events_for(pid)
         if preserved_events:
             self.vm.pending_events.extend(preserved_events)
         self.vm.trace = trace_enabled
@@ -4132,6 +4596,7 @@ class VMController:
         task["pc"] = ctx.get("pc", task.get("pc"))
         task["state"] = "running" if self.vm.running else ctx.get("state", task.get("state", "stopped"))
         task["trace"] = trace_enabled
+        self._task_dirty.add(pid)
         ctx["trace"] = trace_enabled
         state["context"] = ctx
         self.task_states[pid] = state
@@ -4207,6 +4672,7 @@ class VMController:
         task = self.tasks.get(pid)
         if task is not None:
             task["trace"] = trace_enabled
+            self._task_dirty.add(pid)
         state = self.task_states.get(pid)
         if state is not None:
             ctx = state.get("context", {})
@@ -4221,6 +4687,17 @@ class VMController:
 
     def step(self, steps: int, pid: Optional[int] = None) -> Dict[str, Any]:
         self._check_mailbox_timeouts()
+        if self.fs_queue.pending or self.fs_queue.backlog:
+            self._service_fs_queue()
+        if self.can_bus is not None:
+            self.can_bus.poll()
+        for port in self.uart_ports.values():
+            port.poll()
+        if self.gpio is not None:
+            self.gpio.poll()
+        self.timers.poll()
+        if self.svc_snapshot is not None:
+            self.svc_snapshot.poll()
         requested_pid = int(pid) if pid is not None else None
         if not self.tasks:
             return {
@@ -4240,6 +4717,7 @@ class VMController:
         last_pid: Optional[int] = None
 
         step_budget = max(int(steps), 0)
+        profiler = self.profiler if self.profiler is not None and self.profiler.active else None
         while executed < step_budget:
             runnable = self._runnable_pids()
             if not runnable:
@@ -4257,8 +4735,16 @@ class VMController:
                 aggregated_events.extend(vm.consume_events())
                 last_pid = target_pid
                 break
+            timeline = self.time_travel.get(target_pid)
+            if timeline is not None and timeline.due(vm.steps):
+                self._tt_checkpoint(target_pid, timeline)
+            if target_pid in self.svc_stats.pending:
+                self.svc_stats.resume(target_pid, vm.regs[0])
             vm.step()
             executed += 1
+            self.svc_stats.instructions += 1
+            if profiler is not None:
+                profiler.observe(vm, target_pid)
             events = vm.consume_events()
             aggregated_events.extend(events)
             for event in events:
@@ -4272,6 +4758,8 @@ class VMController:
                 pc=last_snapshot.get("pc") if last_snapshot else None,
             )
             self._store_active_state()
+            if timeline is not None:
+                self._tt_after_step(target_pid, timeline)
             self._check_mailbox_timeouts()
             if debug_event is not None:
                 self.paused = True
@@ -4325,6 +4813,14 @@ class VMController:
         }
         if trace_last:
             result["trace_last"] = trace_last
+        result["task_deltas"] = self.task_deltas()
+        if last_pid is not None and last_pid in self.tasks:
+            ctx = self.task_states.get(last_pid, {}).get("context", {})
+            result["task_deltas"]["active"] = {
+                "pid": last_pid,
+                "pc": ctx.get("pc"),
+                "accounted_steps": ctx.get("accounted_steps", 0),
+            }
         return result
 
     def trace_last_snapshot(self, pid: Optional[int] = None) -> Dict[str, Any]:
@@ -4440,6 +4936,7 @@ class VMController:
         if pid != self.current_pid:
             self._activate_task(pid)
         vm = self._require_vm()
+        self._tt_note_external(pid, "regs")
         resp = vm.restore_registers(payload or {})
         self._store_active_state()
         return resp
@@ -4450,11 +4947,74 @@ class VMController:
 
     def write_mem(self, addr: int, data: bytes) -> None:
         vm = self._require_vm()
+        if self.current_pid is not None:
+            self._tt_note_external(self.current_pid, "poke")
         vm.write_mem(addr, data)
 
     def task_list(self) -> Dict[str, Any]:
         tasks = [self._task_summary(pid) for pid in sorted(self.tasks)]
-        return {"tasks": tasks, "current_pid": self.current_pid}
+        return {"tasks": tasks, "current_pid": self.current_pid, "task_seq": self.task_delta_seq}
+
+    def task_deltas(self) -> Dict[str, Any]:
+        """Publish task summaries that changed since the previous call.
+
+        Each delta carries a sequence number; ``base_seq`` is the sequence the
+        receiver must already hold for the batch to apply cleanly.  Anything
+        else means deltas were consumed elsewhere and the receiver should
+        resync from ``ps``.  Only tasks marked in ``_task_dirty`` (state,
+        priority, wait or trace changes, creation and removal) are examined.
+        """
+
+        base_seq = self.task_delta_seq
+        deltas: List[Dict[str, Any]] = []
+        dirty, self._task_dirty = self._task_dirty, set()
+        live = sorted(pid for pid in dirty if pid in self.tasks)
+        for pid in live:
+            summary = self._task_summary(pid)
+            stable = {key: value for key, value in summary.items() if key not in TASK_DELTA_VOLATILE_FIELDS}
+            published = self._task_published.get(pid)
+            if published == stable:
+                continue
+            self._task_published[pid] = stable
+            old_state = published.get("state") if published else None
+            if published is None:
+                reason = "created"
+            elif old_state != summary.get("state"):
+                reason = "state"
+            else:
+                reason = "update"
+            self.task_delta_seq += 1
+            deltas.append(
+                {
+                    "seq": self.task_delta_seq,
+                    "pid": pid,
+                    "old": old_state,
+                    "new": summary.get("state"),
+                    "reason": reason,
+                    "pc": summary.get("pc"),
+                    "task": summary,
+                }
+            )
+        for pid in sorted(pid for pid in dirty if pid not in self.tasks and pid in self._task_published):
+            published = self._task_published.pop(pid)
+            self.task_delta_seq += 1
+            deltas.append(
+                {
+                    "seq": self.task_delta_seq,
+                    "pid": pid,
+                    "old": published.get("state"),
+                    "new": "terminated",
+                    "reason": "removed",
+                    "pc": None,
+                    "removed": True,
+                }
+            )
+        return {
+            "base_seq": base_seq,
+            "seq": self.task_delta_seq,
+            "current_pid": self.current_pid,
+            "deltas": deltas,
+        }
 
     def pause_task(self, pid: int) -> Dict[str, Any]:
         task = self._get_task(pid)
@@ -4463,6 +5023,7 @@ class VMController:
             self.vm = None
             self.current_pid = None
         task["state"] = "paused"
+        self._task_dirty.add(pid)
         state = self.task_states.get(pid)
         if state:
             state["context"]["state"] = "paused"
@@ -4471,6 +5032,7 @@ class VMController:
     def resume_task(self, pid: int) -> Dict[str, Any]:
         task = self._get_task(pid)
         task["state"] = "running"
+        self._task_dirty.add(pid)
         state = self.task_states.get(pid)
         if state:
             state["context"]["state"] = "running"
@@ -4486,8 +5048,19 @@ class VMController:
             self.current_pid = None
         self._release_task_memory(pid)
         self.tasks.pop(pid, None)
+        self._task_dirty.add(pid)
         self.task_states.pop(pid, None)
         self.debug_sessions.pop(pid, None)
+        self.time_travel.pop(pid, None)
+        self.pc_counters.pop(pid, None)
+        self.fs_queue.drop_pid(pid)
+        self.can_subscribers.pop(pid, None)
+        for subscribers in (self.uart_subscribers, self.gpio_subscribers):
+            for index, (owner, _handle) in list(subscribers.items()):
+                if owner == pid:
+                    del subscribers[index]
+        self.timers.cancel_owner(pid)
+        self.svc_stats.drop(pid)
         self.metadata_by_pid.pop(pid, None)
         summary["state"] = "terminated"
         if self.tasks:
@@ -4497,6 +5070,7 @@ class VMController:
 
     def set_task_attrs(self, pid: int, *, priority: Optional[int] = None, quantum: Optional[int] = None) -> Dict[str, Any]:
         task = self._get_task(pid)
+        self._task_dirty.add(pid)
         state = self.task_states.get(pid)
         if priority is not None:
             pr = max(0, int(priority))
@@ -4532,6 +5106,7 @@ class VMController:
         return bytes(mem[a:end])
 
     def request_poke(self, pid: int, addr: int, data: bytes) -> None:
+        self._tt_note_external(pid, "poke")
         if pid == self.current_pid and self.vm is not None:
             self.vm.write_mem(addr, data)
             self._store_active_state()
@@ -4546,11 +5121,91 @@ class VMController:
         a = addr & 0xFFFF
         end = min(a + len(data), len(mem))
         mem[a:end] = data[: end - a]
+        _mark_dirty(self._state_dirty_map(state), a, end - a)
         self.task_states[pid] = state
         task = self.tasks.get(pid)
         if task:
             task["vm_state"] = state
 
+    def _state_dirty_map(self, state: Dict[str, Any]) -> bytearray:
+        dirty = state.get("mem_dirty")
+        if not isinstance(dirty, bytearray):
+            mem = state.get("mem")
+            dirty = _new_dirty_map(len(mem) if mem is not None else VM_ADDRESS_SPACE_SIZE)
+            state["mem_dirty"] = dirty
+        return dirty
+
+    def mem_dirty(self, pid: int, *, clear: bool = False) -> Dict[str, Any]:
+        """Report granules of task memory written since the last clear."""
+
+        if pid == self.current_pid and self.vm is not None:
+            dirty = self.vm.mem_dirty
+        else:
+            state = self.task_states.get(pid)
+            if not state:
+                raise ValueError(f"unknown pid {pid}")
+            dirty = self._state_dirty_map(state)
+        timeline = self.time_travel.get(pid)
+        if timeline is not None:
+            # Checkpoints consume the map too; the timeline keeps their share.
+            ranges = _dirty_ranges(timeline.report_dirty(dirty, clear=clear))
+        else:
+            ranges = _dirty_ranges(dirty)
+            if clear and ranges:
+                dirty[:] = bytes(len(dirty))
+        granules = sum(length for _, length in ranges) >> MEM_DIRTY_GRANULE_SHIFT
+        return {
+            "pid": pid,
+            "granule": MEM_DIRTY_GRANULE,
+            "ranges": ranges,
+            "granules": granules,
+            "cleared": bool(clear),
+        }
+
+    def _muted_events_for(self, pid: Optional[int]) -> frozenset:
+        spec = self.event_filter_spec
+        if spec is None:
+            return frozenset()
+        wildcard = spec.get("*", frozenset())
+        if wildcard is None or (pid is not None and pid in wildcard):
+            return frozenset()
+        muted = set()
+        for event_type in FILTERABLE_EVENT_TYPES:
+            pids = spec.get(event_type, frozenset())
+            if pids is None or (pid is not None and pid in pids):
+                continue
+            muted.add(event_type)
+        return frozenset(muted)
+
+    def event_filter(self, spec: Optional[Dict[str, Any]] = None, *, update: bool = False) -> Dict[str, Any]:
+        """Install (``update``) or report the executive's event filter.
+
+        ``spec`` maps an event type, or ``"*"`` for every type, to the PIDs that
+        want it (``None`` for all PIDs).  Filterable types that no entry covers
+        for a task are not built while that task runs; ``spec=None`` with
+        ``update`` turns filtering off.
+        """
+
+        if update:
+            if spec is None:
+                self.event_filter_spec = None
+            else:
+                parsed: Dict[str, Optional[frozenset]] = {}
+                for key, pids in spec.items():
+                    parsed[str(key)] = None if pids is None else frozenset(int(pid) for pid in pids)
+                self.event_filter_spec = parsed
+            if self.vm is not None:
+                self.vm.muted_events = self._muted_events_for(self.current_pid)
+        spec_out: Optional[Dict[str, Any]] = None
+        if self.event_filter_spec is not None:
+            spec_out = {key: None if pids is None else sorted(pids) for key, pids in self.event_filter_spec.items()}
+        muted = {pid: sorted(self._muted_events_for(pid)) for pid in sorted(self.tasks)}
+        return {
+            "filter": spec_out,
+            "filterable": sorted(FILTERABLE_EVENT_TYPES),
+            "muted": {pid: types for pid, types in muted.items() if types},
+        }
+
     def _run_debug(self, pid: int, *, step_count: int = 0, max_cycles: Optional[int] = None, assume_active: bool = False) -> Dict[str, Any]:
         dbg = self._debug_state(pid)
         if not dbg.attached:
@@ -4575,6 +5230,7 @@ class VMController:
         task = self.tasks.get(pid)
         if task is not None:
             task["state"] = "running"
+            self._task_dirty.add(pid)
         state = self.task_states.get(pid)
         if state is not None:
             ctx = state.get("context")
@@ -4628,17 +5284,35 @@ class VMController:
     def debug_list_breakpoints(self, pid: int) -> Dict[str, Any]:
         pid_int = int(pid)
         dbg = self._debug_state(pid_int)
-        return {"pid": pid_int, "breakpoints": sorted(dbg.breakpoints)}
+        info: Dict[str, Any] = {"pid": pid_int, "breakpoints": sorted(dbg.breakpoints)}
+        if dbg.conditions:
+            info["conditions"] = [
+                {"addr": addr, **spec.describe()} for addr, spec in sorted(dbg.conditions.items())
+            ]
+        return info
 
-    def debug_add_breakpoint(self, pid: int, addr: int) -> Dict[str, Any]:
+    def debug_add_breakpoint(
+        self,
+        pid: int,
+        addr: int,
+        *,
+        condition: Optional[str] = None,
+        hit_condition: Optional[str] = None,
+        log_message: Optional[str] = None,
+    ) -> Dict[str, Any]:
         pid_int = int(pid)
         dbg = self._debug_state(pid_int)
         if not dbg.attached:
             raise ValueError(f"pid {pid_int} is not attached to debugger")
         addr_int = int(addr) & 0xFFFF
+        spec = compile_breakpoint(condition=condition, hit_condition=hit_condition, log_message=log_message)
         dbg.breakpoints.add(addr_int)
+        if spec is not None:
+            dbg.conditions[addr_int] = spec
+        else:
+            dbg.conditions.pop(addr_int, None)
         if pid_int == self.current_pid and self.vm is not None:
-            self.vm.set_debug_breakpoints(dbg.breakpoints)
+            self.vm.set_debug_breakpoints(dbg.breakpoints, dbg.conditions)
         return self.debug_list_breakpoints(pid_int)
 
     def debug_remove_breakpoint(self, pid: int, addr: int) -> Dict[str, Any]:
@@ -4648,8 +5322,9 @@ class VMController:
             raise ValueError(f"pid {pid_int} is not attached to debugger")
         addr_int = int(addr) & 0xFFFF
         dbg.breakpoints.discard(addr_int)
+        dbg.conditions.pop(addr_int, None)
         if pid_int == self.current_pid and self.vm is not None:
-            self.vm.set_debug_breakpoints(dbg.breakpoints)
+            self.vm.set_debug_breakpoints(dbg.breakpoints, dbg.conditions)
         return self.debug_list_breakpoints(pid_int)
 
     def debug_continue(self, pid: int, *, max_cycles: Optional[int] = None) -> Dict[str, Any]:
@@ -4680,6 +5355,729 @@ class VMController:
         pid_int = int(pid)
         return {"pid": pid_int, "registers": self.read_regs(pid_int)}
 
+    # ------------------------------------------------------------------
+    # Reverse execution
+    # ------------------------------------------------------------------
+    def _tt_steps(self, pid: int) -> int:
+        if pid == self.current_pid and self.vm is not None:
+            return int(self.vm.steps)
+        state = self.task_states.get(pid) or {}
+        return int(state.get("steps", 0) or 0)
+
+    def _tt_checkpoint(self, pid: int, timeline: TaskTimeline, reason: str = "interval") -> None:
+        if pid == self.current_pid:
+            self._store_active_state()
+        state = self.task_states.get(pid)
+        if state is None:
+            raise ValueError(f"unknown pid {pid}")
+        timeline.checkpoint(state, self._tt_steps(pid), reason)
+
+    def _tt_after_step(self, pid: int, timeline: TaskTimeline) -> None:
+        steps = self._tt_steps(pid)
+        if timeline.in_past(steps):
+            # Replaying recorded history forward: re-apply the external input
+            # (mailbox delivery, poke, ...) captured at this point.
+            index = timeline.external_at(steps)
+            if index is not None:
+                self._tt_restore(pid, timeline, index)
+                self._apply_debug_state(pid)
+                self._store_active_state()
+        timeline.advance(steps)
+
+    def _tt_note_external(self, pid: Optional[int], kind: str) -> None:
+        timeline = self.time_travel.get(pid) if pid is not None else None
+        if timeline is None:
+            return
+        steps = self._tt_steps(pid)
+        if timeline.in_past(steps):
+            timeline.truncate(steps)
+        timeline.note_external(kind)
+
+    def _tt_restore(self, pid: int, timeline: TaskTimeline, index: int) -> MiniVM:
+        state = timeline.state_at(index)
+        self._store_active_state()
+        current = self.task_states.get(pid) or {}
+        state["code"] = current.get("code", bytearray())
+        dirty = self._state_dirty_map(current)
+        old_mem = current.get("mem") or b""
+        new_mem = state["mem"]
+        if len(old_mem) == len(new_mem):
+            for offset in range(0, len(new_mem), TT_PAGE_SIZE):
+                if new_mem[offset : offset + TT_PAGE_SIZE] != old_mem[offset : offset + TT_PAGE_SIZE]:
+                    _mark_dirty(dirty, offset, TT_PAGE_SIZE)
+        else:
+            _mark_dirty(dirty, 0, len(new_mem))
+        state["mem_dirty"] = dirty
+        running = bool(state.get("running", True))
+        self._activate_task(pid, state_override=state)
+        vm = self._require_vm()
+        vm.configure_debug(enabled=False)
+        vm.running = running
+        return vm
+
+    def _tt_run(
+        self,
+        vm: MiniVM,
+        timeline: TaskTimeline,
+        end: int,
+        observer: Optional[Callable[[MiniVM, str], None]] = None,
+    ) -> int:
+        started = time.perf_counter()
+        executed = 0
+        # Replayed instructions and SVCs were counted when they first ran.
+        counters, vm.pc_counters = vm.pc_counters, None
+        svc_stats, vm.svc_stats = vm.svc_stats, None
+        try:
+            while vm.steps < end:
+                vm.sleep_until = None
+                vm.sleep_pending_ms = None
+                if observer is not None:
+                    observer(vm, "pre")
+                before = vm.steps
+                vm.step()
+                if vm.steps == before:
+                    break
+                executed += 1
+                if observer is not None:
+                    observer(vm, "post")
+        finally:
+            vm.pc_counters = counters
+            vm.svc_stats = svc_stats
+        vm.consume_events()
+        timeline.note_replay(executed, time.perf_counter() - started, target=end)
+        return executed
+
+    def _tt_goto(self, pid: int, timeline: TaskTimeline, target: int) -> int:
+        index = timeline.nearest(target)
+        if index is None:
+            raise ValueError(f"step {target} is before recorded history for pid {pid}")
+        vm = self._tt_restore(pid, timeline, index)
+        return self._tt_run(vm, timeline, target)
+
+    def _tt_search(
+        self,
+        pid: int,
+        timeline: TaskTimeline,
+        current: int,
+        make_observer: Callable[[List[Any]], Callable[[MiniVM, str], None]],
+    ) -> Optional[Any]:
+        """Replay checkpoint segments newest-first; return the latest hit before ``current``."""
+
+        index = timeline.nearest(current - 1)
+        while index is not None and index >= 0:
+            hits: List[Any] = []
+            vm = self._tt_restore(pid, timeline, index)
+            self._tt_run(vm, timeline, timeline.segment_end(index, current), make_observer(hits))
+            if hits:
+                return hits[-1]
+            index -= 1
+        return None
+
+    def _tt_timeline(self, pid: int) -> TaskTimeline:
+        timeline = self.time_travel.get(pid)
+        if timeline is None:
+            raise ValueError(f"reverse execution not enabled for pid {pid}")
+        dbg = self._debug_state(pid)
+        if not dbg.attached:
+            raise ValueError(f"pid {pid} is not attached to debugger")
+        return timeline
+
+    def _tt_finish(self, pid: int, timeline: TaskTimeline, reason: str, **extra: Any) -> Dict[str, Any]:
+        vm = self._require_vm()
+        stop: Dict[str, Any] = {
+            "type": "debug_stop",
+            "reason": reason,
+            "pc": vm.pc & 0xFFFFFFFF,
+            "steps": vm.steps,
+            "pid": pid,
+        }
+        stop.update(extra)
+        dbg = self._debug_state(pid)
+        dbg.halted = True
+        dbg.last_stop = stop
+        self._apply_debug_state(pid)
+        self.paused = True
+        self._store_active_state()
+        return {
+            "pid": pid,
+            "stop": stop,
+            "history": {"start_step": timeline.start_step, "head_step": timeline.head_step},
+            "replay": timeline.last_replay,
+            "registers": self.read_regs(pid),
+        }
+
+    def time_travel_config(
+        self,
+        pid: int,
+        *,
+        enable: Optional[bool] = None,
+        interval: Optional[int] = None,
+        keyframe_every: Optional[int] = None,
+        max_bytes: Optional[int] = None,
+    ) -> Dict[str, Any]:
+        """Enable, reconfigure or disable checkpoint recording for ``pid``."""
+
+        pid_int = int(pid)
+        self._get_task(pid_int)
+        timeline = self.time_travel.get(pid_int)
+        if enable is False:
+            self.time_travel.pop(pid_int, None)
+            if pid_int == self.current_pid and self.vm is not None:
+                self.vm.svc_tape = None
+                if timeline is not None:
+                    timeline.release_dirty(self.vm.mem_dirty)
+            elif timeline is not None and self.task_states.get(pid_int):
+                timeline.release_dirty(self._state_dirty_map(self.task_states[pid_int]))
+            return {"pid": pid_int, "enabled": False}
+        if timeline is None:
+            if enable is None:
+                return {"pid": pid_int, "enabled": False}
+            timeline = TaskTimeline()
+            self.time_travel[pid_int] = timeline
+            timeline.configure(interval=interval, keyframe_every=keyframe_every, max_bytes=max_bytes)
+            self._tt_checkpoint(pid_int, timeline, "start")
+            if pid_int == self.current_pid and self.vm is not None:
+                self.vm.svc_tape = timeline
+        else:
+            timeline.configure(interval=interval, keyframe_every=keyframe_every, max_bytes=max_bytes)
+        return {"pid": pid_int, "enabled": True, **timeline.stats()}
+
+    def profile_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Start, stop, inspect or dump the sampling profiler.
+
+        ``dump`` returns the ring folded into unique raw stacks; symbolising
+        them is left to the executive, which owns the ``.sym`` tables.
+        """
+
+        op = str(op or "status").lower()
+        if op == "start":
+            pids = options.get("pids")
+            if pids is None and options.get("pid") is not None:
+                pids = [options["pid"]]
+            self.profiler = SampleProfiler(
+                period=options.get("period"),
+                timer_ms=options.get("timer_ms"),
+                clock_hz=options.get("clock_hz"),
+                capacity=options.get("capacity"),
+                max_depth=options.get("max_depth"),
+                pids=pids,
+            )
+            return {"op": op, **self.profiler.stats()}
+        profiler = self.profiler
+        if profiler is None:
+            if op in {"status", "stop"}:
+                return {"op": op, "active": False, "samples": 0}
+            raise ValueError("profiler not started")
+        if op == "stop":
+            profiler.stop()
+            return {"op": op, **profiler.stats()}
+        if op == "status":
+            return {"op": op, **profiler.stats()}
+        if op == "dump":
+            info = {"op": op, **profiler.stats(), "stacks": profile_aggregate(profiler.samples)}
+            if options.get("clear"):
+                profiler.clear()
+            return info
+        raise ValueError(f"unknown profile op '{op}'")
+
+    def _service_fs_queue(self) -> None:
+        fs = self.filesystem if self.filesystem is not None else (self.vm.fs if self.vm is not None else None)
+        if fs is not None:
+            self.fs_queue.service(fs)
+
+    def _deliver_fs_completion(self, request: IORequest) -> Optional[bool]:
+        """Copy read data into the task and post the completion record."""
+
+        if request.pid not in self.tasks:
+            return None
+        if request.payload:
+            self._tt_note_external(request.pid, "fs")
+            self._write_bytes_to_task_mem(request.pid, request.ptr, request.payload)
+            request.payload = b""
+        try:
+            ok, descriptor_id = self.mailboxes.send(pid=request.pid, handle=request.handle, payload=request.record())
+        except MailboxError:
+            return None
+        if not ok:
+            return False
+        self._deliver_mailbox_messages(descriptor_id)
+        return True
+
+    def _attach_can(self, bus: CANBus, name: str) -> None:
+        if self.can_bus is not None:
+            self.can_bus.detach(self.can_node.name)
+        self.can_bus = bus
+        self.can_node = bus.attach(name, deliver=self._deliver_can_events)
+        if self.vm is not None:
+            self.vm.can_node = self.can_node
+
+    def _deliver_can_events(self, batch: List[Tuple[CANFrame, int]]) -> bool:
+        """Post RX events to subscribed tasks, packing as many per message as fit."""
+
+        records = [frame.pack_rx_event(timestamp) for frame, timestamp in batch]
+        delivered = True
+        for pid, handle in list(self.can_subscribers.items()):
+            try:
+                desc = self.mailboxes.descriptor_for_handle(pid, handle)
+            except MailboxError:
+                self.can_subscribers.pop(pid, None)
+                continue
+            per_message = max((desc.capacity - 8) // CAN_RX_EVENT.size, 1)
+            for start in range(0, len(records), per_message):
+                ok, descriptor_id = self.mailboxes.send(
+                    pid=pid, handle=handle, payload=b"".join(records[start : start + per_message])
+                )
+                if not ok:
+                    delivered = False
+                    break
+                self._deliver_mailbox_messages(descriptor_id)
+        return delivered
+
+    def can_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach to, inspect or inject frames into the virtual CAN bus.
+
+        ``attach`` creates a live bus at ``bitrate`` (and a harness socket on
+        ``port`` when given) unless one is already attached; ``send`` queues a
+        frame from this executive's node; ``loader`` listens for ISO-TP image
+        downloads on ``rx_id`` (answering on ``tx_id``) and streams them into
+        ``load_stream_*``.
+        """
+
+        op = str(op or "stats").lower()
+        if op == "attach":
+            if self.can_bus is None:
+                self._attach_can(live_bus(int(options.get("bitrate") or 1_000_000)), str(options.get("node") or "vm"))
+            port = options.get("port")
+            if port is not None and self.can_server is None:
+                self.can_server = CANSocketServer(self.can_bus, (str(options.get("host") or "127.0.0.1"), int(port)))
+                self.can_server.start()
+        if self.can_bus is None:
+            raise ValueError("no CAN bus attached")
+        if op == "send":
+            frame = CANFrame(int(options.get("id", 0)), bytes.fromhex(str(options.get("data") or "")), int(options.get("flags") or 0))
+            status = self.can_node.send(frame)
+            if status != 0:
+                raise ValueError(f"CAN transmit queue full (status {status})")
+            self.can_bus.poll()
+        elif op == "loader":
+            if self.can_loader is not None:
+                self.can_bus.detach(self.can_loader.endpoint.node.name)
+            endpoint = ISOTPEndpoint(
+                self.can_bus,
+                f"{self.can_node.name}:isotp",
+                tx_id=int(options.get("tx_id", 0x7E8)),
+                rx_id=int(options.get("rx_id", 0x7E0)),
+                block_size=int(options.get("block_size", 8)),
+                st_min_us=int(options.get("st_min_us", 0)),
+            )
+            self.can_loader = ImageLoaderBridge(self, endpoint)
+        elif op not in ("attach", "stats"):
+            raise ValueError(f"unknown can op '{op}'")
+        info = {"op": op, "node": self.can_node.name, **self.can_bus.stats()}
+        if self.can_loader is not None:
+            info["loader"] = {**self.can_loader.endpoint.stats(), "pid": self.can_loader.pid, "bytes": self.can_loader.bytes}
+        if self.can_server is not None:
+            info["socket"] = "%s:%d" % self.can_server.server_address[:2]
+        info["subscribers"] = dict(self.can_subscribers)
+        return info
+
+    def _attach_uart(self, port: UARTPort) -> None:
+        old = self.uart_ports.get(port.index)
+        if old is not None and old is not port:
+            old.close()
+        port.on_rx = self._deliver_uart_rx
+        self.uart_ports[port.index] = port
+
+    def _deliver_uart_rx(self, port: UARTPort, flags: int) -> bool:
+        """Post the RX ring to the port's subscriber as few burst messages as fit.
+
+        Returns False while the mailbox lacks room, so the port retries on a
+        later poll; the bytes stay in the ring (and overrun if nobody drains it).
+        """
+
+        sub = self.uart_subscribers.get(port.index)
+        if sub is None:
+            return True  # no subscriber: data waits for UART_READ_POLL
+        pid, handle = sub
+        try:
+            desc = self.mailboxes.descriptor_for_handle(pid, handle)
+        except MailboxError:
+            self.uart_subscribers.pop(port.index, None)
+            return True
+        per_message = max(desc.capacity - 8 - UART_RX_BURST.size, 1)
+        timestamp_us = (port.rx_last_ns // 1000) & 0xFFFFFFFF
+        while port.rx.used:
+            count = min(port.rx.used, per_message)
+            if count + UART_RX_BURST.size + 8 > desc.space_remaining():
+                return False
+            payload = bytearray(UART_RX_BURST.size + count)
+            UART_RX_BURST.pack_into(payload, 0, port.index, flags, count, timestamp_us)
+            port.rx.peekinto(memoryview(payload)[UART_RX_BURST.size :])
+            ok, descriptor_id = self.mailboxes.send(pid=pid, handle=handle, payload=bytes(payload))
+            if not ok:
+                return False
+            port.rx.discard(count)
+            flags &= ~HSX_UART_RX_OVERRUN
+            self._deliver_mailbox_messages(descriptor_id)
+        return True
+
+    def uart_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach, configure, inspect or drive the simulated UART ports.
+
+        ``attach`` creates live port ``port`` at ``baud`` with a ``backend``
+        (``pty``, ``socket`` on ``host``/``listen``, or ``none``); ``config``
+        changes the line settings; ``feed`` injects hex ``data`` on the RX
+        line and ``send`` writes it to the TX ring, as a task would.
+        """
+
+        op = str(op or "stats").lower()
+        index = int(options.get("port") or 0)
+        if op in ("attach", "config", "feed", "send", "detach") and not 0 <= index < UART_PORTS:
+            raise ValueError(f"UART port {index} out of range")
+        if op == "attach":
+            backend = make_backend(
+                options.get("backend"),
+                host=str(options.get("host") or "127.0.0.1"),
+                port=int(options.get("listen") or 0),
+            )
+            settings = {key: int(options[key]) for key in ("baud", "parity", "stop_bits", "tx_size", "rx_size") if options.get(key) is not None}
+            self._attach_uart(live_port(index, backend=backend, **settings))
+        elif op == "detach":
+            port = self.uart_ports.pop(index, None)
+            if port is not None:
+                port.close()
+            self.uart_subscribers.pop(index, None)
+        elif op in ("config", "feed", "send"):
+            port = self.uart_ports.get(index)
+            if port is None:
+                raise ValueError(f"UART port {index} not attached")
+            if op == "config":
+                status = port.configure(
+                    int(options.get("baud") or port.baud),
+                    int(options.get("parity", port.parity)),
+                    int(options.get("stop_bits") or port.stop_bits),
+                )
+                if status != 0:
+                    raise ValueError(f"unsupported UART configuration (status {status})")
+            elif op == "feed":
+                port.feed(bytes.fromhex(str(options.get("data") or "")))
+            else:
+                port.write(bytes.fromhex(str(options.get("data") or "")))
+            port.poll()
+        elif op != "stats":
+            raise ValueError(f"unknown uart op '{op}'")
+        return {
+            "op": op,
+            "ports": {idx: port.stats() for idx, port in sorted(self.uart_ports.items())},
+            "subscribers": {idx: {"pid": pid, "handle": handle} for idx, (pid, handle) in sorted(self.uart_subscribers.items())},
+        }
+
+    def _attach_gpio(self, bank: GPIOBank) -> None:
+        bank.deliver = self._deliver_gpio_event
+        self.gpio = bank
+        if self.vm is not None:
+            self.vm.gpio = bank
+
+    def _deliver_gpio_event(self, pin: int, record: bytes) -> bool:
+        """Post one coalesced edge event; False keeps it pending in the bank."""
+
+        sub = self.gpio_subscribers.get(pin)
+        if sub is None:
+            return True  # counted only; tasks read it with GPIO_EDGE_COUNT
+        pid, handle = sub
+        try:
+            ok, descriptor_id = self.mailboxes.send(pid=pid, handle=handle, payload=record)
+        except MailboxError:
+            self.gpio_subscribers.pop(pin, None)
+            return True
+        if not ok:
+            return False
+        self._deliver_mailbox_messages(descriptor_id)
+        return True
+
+    def gpio_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach, drive, replay or inspect the executive's GPIO bank.
+
+        ``attach`` creates a live bank of ``pins`` inputs; ``drive`` sets the
+        raw level of ``pin`` to ``value`` now; ``replay`` queues a recorded
+        waveform (CSV ``time_us,pin,value`` or VCD) from ``path``, starting now;
+        ``debounce`` sets ``debounce_us``/``coalesce_us`` and ``edge`` on ``pin``.
+        """
+
+        op = str(op or "stats").lower()
+        if op == "attach":
+            if self.gpio is None:
+                self._attach_gpio(live_bank(int(options.get("pins") or 32)))
+        if self.gpio is None:
+            raise ValueError("no GPIO bank attached")
+        bank = self.gpio
+        info: Dict[str, Any] = {"op": op}
+        if op == "drive":
+            bank.poll()
+            bank.drive(int(options.get("pin", 0)), int(options.get("value", 0)))
+            bank.poll()
+        elif op == "replay":
+            path = options.get("path")
+            if not path:
+                raise ValueError("gpio replay requires a waveform path")
+            bank.poll()
+            info["replayed"] = bank.replay(load_waveform(str(path)))
+        elif op == "debounce":
+            pin = int(options.get("pin", 0))
+            status = bank.set_debounce(pin, int(options.get("debounce_us") or 0), int(options.get("coalesce_us") or 0))
+            if status == 0 and options.get("edge") is not None:
+                status = bank.set_interrupt(pin, int(options["edge"]), True)
+            if status != 0:
+                raise ValueError(f"invalid GPIO settings (status {status})")
+        elif op not in ("attach", "stats"):
+            raise ValueError(f"unknown gpio op '{op}'")
+        info.update(bank.stats())
+        info["subscribers"] = {pin: {"pid": pid, "handle": handle} for pin, (pid, handle) in sorted(self.gpio_subscribers.items())}
+        return info
+
+    def _deliver_timer_event(self, timer: Any, record: bytes) -> bool:
+        """Post one expiry; False makes the service count it into the next overruns."""
+
+        if timer.target is None:
+            return True  # no callback mailbox yet
+        pid, handle = timer.target
+        try:
+            ok, descriptor_id = self.mailboxes.send(pid=pid, handle=handle, payload=record)
+        except MailboxError:
+            timer.target = None
+            return True
+        if not ok:
+            return False
+        self._deliver_mailbox_messages(descriptor_id)
+        return True
+
+    def timer_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Inspect or drive the executive's timer service.
+
+        ``stats`` reports wheel counters and up to ``limit`` timers with their
+        jitter; ``advance`` moves a virtual clock on by ``us``; ``cancel``
+        stops ``timer``.
+        """
+
+        op = str(op or "stats").lower()
+        service = self.timers
+        if op == "advance":
+            if not service.virtual:
+                raise ValueError("timer advance requires a virtual clock")
+            service.run_for(int(options.get("us") or 0) * 1000)
+        elif op == "cancel":
+            if service.cancel(int(options.get("timer", 0))) != 0:
+                raise ValueError(f"unknown timer {options.get('timer')}")
+        elif op != "stats":
+            raise ValueError(f"unknown timer op '{op}'")
+        info: Dict[str, Any] = {"op": op}
+        info.update(service.stats(limit=int(options.get("limit") or 64)))
+        return info
+
+    def stats_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Report, reset or write out the per-SVC counters and latency histograms.
+
+        ``show`` lists the ``top`` SVCs by call count (all when 0), with bucket
+        counts unless ``buckets`` is false; ``snapshot`` writes the full set as
+        JSON to ``path`` or the file given by ``--svc-stats-file``.
+        """
+
+        op = str(op or "show").lower()
+        info: Dict[str, Any] = {"op": op}
+        if op == "reset":
+            self.svc_stats.reset()
+        elif op == "snapshot":
+            path = options.get("path") or (self.svc_snapshot.path if self.svc_snapshot is not None else None)
+            if not path:
+                raise ValueError("stats snapshot requires a path (or --svc-stats-file)")
+            self.svc_stats.write_snapshot(str(path))
+            info["path"] = str(path)
+        elif op != "show":
+            raise ValueError(f"unknown stats op '{op}'")
+        buckets = options.get("buckets")
+        info.update(self.svc_stats.snapshot(top=int(options.get("top") or 0), buckets=True if buckets is None else bool(buckets)))
+        if self.svc_snapshot is not None:
+            info["snapshot_file"] = self.svc_snapshot.info()
+        return info
+
+    def fs_control(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Mount, format, sync or inspect the task-visible filesystem backend.
+
+        ``mount`` with ``backend="flash"`` replaces the in-memory ``FSStub``
+        with a :class:`FlashFS` on a simulated ``nor``/``nand`` part (loaded
+        from ``image`` when that file exists); ``backend="stub"`` goes back.
+        """
+
+        op = str(op or "stats").lower()
+        if op == "mount":
+            backend = str(options.get("backend") or "flash").lower()
+            if self.filesystem is not None:
+                self.filesystem.sync()
+            if backend == "stub":
+                self.filesystem = None
+                if self.vm is not None:
+                    self.vm.fs = FSStub()
+                return {"op": op, "backend": "stub"}
+            if backend != "flash":
+                raise ValueError(f"unknown fs backend '{backend}'")
+            geometry = {
+                key: options.get(key)
+                for key in ("page_size", "pages_per_block", "blocks", "cache_pages", "readahead")
+                if options.get(key) is not None
+            }
+            self.filesystem = FlashFS.create(
+                str(options.get("type") or "nor"),
+                image_path=options.get("image"),
+                **geometry,
+            )
+            if self.vm is not None:
+                self.vm.fs = self.filesystem
+            return {"op": op, **self.filesystem.stats()}
+        fs = self.filesystem
+        if fs is None:
+            if op == "stats":
+                return {"op": op, "backend": "stub", "io_queue": self.fs_queue.stats()}
+            raise ValueError("flash filesystem not mounted")
+        if op == "format":
+            fs.format()
+        elif op == "sync":
+            if fs.sync() != 0:
+                raise ValueError("flash filesystem full; buffered data not written")
+        elif op != "stats":
+            raise ValueError(f"unknown fs op '{op}'")
+        return {"op": op, **fs.stats(), "io_queue": self.fs_queue.stats()}
+
+    def coverage_control(
+        self,
+        pid: int,
+        op: str,
+        *,
+        width: Optional[int] = None,
+        edges: Optional[bool] = None,
+    ) -> Dict[str, Any]:
+        """Enable, reset, dump or disable exact per-PC counters for ``pid``."""
+
+        pid_int = int(pid)
+        self._get_task(pid_int)
+        op = str(op or "status").lower()
+        counters = self.pc_counters.get(pid_int)
+        if op == "enable":
+            state = self.task_states.get(pid_int) or self.tasks[pid_int].get("vm_state") or {}
+            code_len = len(state.get("code") or b"")
+            if pid_int == self.current_pid and self.vm is not None:
+                code_len = len(self.vm.code)
+            counters = PCCounters(code_len, width=int(width or 32), edges=True if edges is None else bool(edges))
+            self.pc_counters[pid_int] = counters
+        elif op == "disable":
+            self.pc_counters.pop(pid_int, None)
+            counters = None
+        elif op == "reset":
+            if counters is None:
+                raise ValueError(f"coverage not enabled for pid {pid_int}")
+            counters.reset()
+        elif op not in {"status", "dump"}:
+            raise ValueError(f"unknown coverage op '{op}'")
+        if pid_int == self.current_pid and self.vm is not None:
+            self.vm.pc_counters = counters
+        if counters is None:
+            return {"pid": pid_int, "op": op, "enabled": False}
+        info: Dict[str, Any] = {"pid": pid_int, "op": op, "enabled": True}
+        if op == "dump":
+            info.update(counters.export())
+        else:
+            info.update({"width": counters.width, "slots": counters.slots, "bytes": counters.nbytes, "edge_counters": counters.taken is not None})
+        return info
+
+    def reverse_step(self, pid: int, *, count: int = 1) -> Dict[str, Any]:
+        pid_int = int(pid)
+        timeline = self._tt_timeline(pid_int)
+        current = self._tt_steps(pid_int)
+        floor = timeline.start_step or 0
+        target = max(current - max(int(count), 1), floor)
+        self._tt_goto(pid_int, timeline, target)
+        reason = "reverse_step" if target < current else "history_start"
+        return self._tt_finish(pid_int, timeline, reason)
+
+    def reverse_continue(self, pid: int) -> Dict[str, Any]:
+        """Run backwards to the most recent breakpoint hit before the current step."""
+
+        pid_int = int(pid)
+        timeline = self._tt_timeline(pid_int)
+        dbg = self._debug_state(pid_int)
+        breakpoints = set(dbg.breakpoints)
+        conditions = dict(dbg.conditions)
+        for pc16, spec in conditions.items():
+            # Hit counts only exist going forward; a past hit's number is unknown.
+            if pc16 in breakpoints and spec.log_message is None and spec.uses_hits:
+                raise ValueError(f"reverse continue does not support hit-count breakpoints (0x{pc16:04X})")
+        current = self._tt_steps(pid_int)
+
+        def make_observer(hits: List[Any]) -> Callable[[MiniVM, str], None]:
+            def observe(vm: MiniVM, phase: str) -> None:
+                pc16 = vm.pc & 0xFFFF
+                if phase != "pre" or pc16 not in breakpoints or vm.steps >= current:
+                    return
+                spec = conditions.get(pc16)
+                if spec is not None:
+                    if spec.log_message is not None:
+                        return
+                    if spec.program and not bp_evaluate(spec.program, vm, spec.hits):
+                        return
+                hits.append(vm.steps)
+
+            return observe
+
+        found = self._tt_search(pid_int, timeline, current, make_observer) if breakpoints else None
+        target = found if found is not None else (timeline.start_step or 0)
+        self._tt_goto(pid_int, timeline, target)
+        return self._tt_finish(pid_int, timeline, "breakpoint" if found is not None else "history_start", reverse=True)
+
+    def reverse_to_last_write(self, pid: int, addr: int, *, width: int = 4) -> Dict[str, Any]:
+        """Run backwards to the instruction that last wrote ``addr``..``addr+width``."""
+
+        pid_int = int(pid)
+        timeline = self._tt_timeline(pid_int)
+        start = int(addr) & 0xFFFF
+        width = max(min(int(width), 4), 1)
+        end = start + width
+        current = self._tt_steps(pid_int)
+
+        def make_observer(hits: List[Any]) -> Callable[[MiniVM, str], None]:
+            pending: Dict[str, Any] = {}
+
+            def observe(vm: MiniVM, phase: str) -> None:
+                if phase == "pre":
+                    pending["step"] = vm.steps
+                    pending["pc"] = vm.pc & 0xFFFFFFFF
+                    pending["old"] = bytes(vm.mem[start:end])
+                    return
+                new = bytes(vm.mem[start:end])
+                access = vm.get_last_mem_access()
+                wrote = new != pending["old"]
+                if not wrote and access is not None and access.get("op") == "write":
+                    a_start = int(access.get("address", 0)) & 0xFFFF
+                    wrote = a_start < end and start < a_start + int(access.get("width", 0))
+                if wrote:
+                    hits.append((pending["step"], pending["pc"], pending["old"], new))
+
+            return observe
+
+        found = self._tt_search(pid_int, timeline, current, make_observer)
+        if found is None:
+            self._tt_goto(pid_int, timeline, timeline.start_step or 0)
+            return self._tt_finish(pid_int, timeline, "history_start", watch_addr=start)
+        step, write_pc, old, new = found
+        self._tt_goto(pid_int, timeline, step)
+        return self._tt_finish(
+            pid_int,
+            timeline,
+            "last_write",
+            watch_addr=start,
+            write_pc=write_pc,
+            old_value=int.from_bytes(old, "little"),
+            new_value=int.from_bytes(new, "little"),
+        )
+
     def handle_command(self, request: Dict[str, Any]) -> Dict[str, Any]:
         if not isinstance(request, dict):
             return {"status": "error", "error": "invalid_request"}
@@ -4736,6 +6134,8 @@ class VMController:
                 return {"status": "ok", "image": self.load_from_path(str(path_value), verbose=bool(request.get("verbose")))}
             if cmd == "ps":
                 return {"status": "ok", "tasks": self.task_list()}
+            if cmd == "task_deltas":
+                return {"status": "ok", "task_deltas": self.task_deltas()}
             if cmd == "step":
                 steps_value = request.get("steps", request.get("cycles", 1))
                 steps_int = int(steps_value if steps_value is not None else 1)
@@ -4788,7 +6188,13 @@ class VMController:
                         addr_value = request.get("addr")
                         if addr_value is None:
                             raise ValueError("dbg bp add requires 'addr'")
-                        info = self.debug_add_breakpoint(pid_int, int(addr_value))
+                        info = self.debug_add_breakpoint(
+                            pid_int,
+                            int(addr_value),
+                            condition=request.get("condition"),
+                            hit_condition=request.get("hit_condition"),
+                            log_message=request.get("log_message"),
+                        )
                         return {"status": "ok", "debug": {"op": "bp", "action": "add", **info}}
                     if action in {"remove", "rm", "del", "delete"}:
                         addr_value = request.get("addr")
@@ -4798,6 +6204,91 @@ class VMController:
                         return {"status": "ok", "debug": {"op": "bp", "action": "remove", **info}}
                     raise ValueError(f"unknown dbg bp action '{action}'")
                 raise ValueError(f"unknown dbg op '{op}'")
+            if cmd == "coverage":
+                pid_value = request.get("pid")
+                if pid_value is None:
+                    raise ValueError("coverage requires 'pid'")
+                info = self.coverage_control(
+                    int(pid_value),
+                    str(request.get("op") or "status"),
+                    width=request.get("width"),
+                    edges=request.get("edges"),
+                )
+                return {"status": "ok", "coverage": info}
+            if cmd == "fs":
+                options = {
+                    key: request.get(key)
+                    for key in ("backend", "type", "image", "page_size", "pages_per_block", "blocks", "cache_pages", "readahead")
+                    if request.get(key) is not None
+                }
+                return {"status": "ok", "fs": self.fs_control(str(request.get("op") or "stats"), **options)}
+            if cmd == "can":
+                options = {
+                    key: request.get(key)
+                    for key in ("bitrate", "node", "host", "port", "id", "data", "flags", "tx_id", "rx_id", "block_size", "st_min_us")
+                    if request.get(key) is not None
+                }
+                return {"status": "ok", "can": self.can_control(str(request.get("op") or "stats"), **options)}
+            if cmd == "uart":
+                options = {
+                    key: request.get(key)
+                    for key in ("port", "baud", "parity", "stop_bits", "tx_size", "rx_size", "backend", "host", "listen", "data")
+                    if request.get(key) is not None
+                }
+                return {"status": "ok", "uart": self.uart_control(str(request.get("op") or "stats"), **options)}
+            if cmd == "gpio":
+                options = {
+                    key: request.get(key)
+                    for key in ("pins", "pin", "value", "path", "debounce_us", "coalesce_us", "edge")
+                    if request.get(key) is not None
+                }
+                return {"status": "ok", "gpio": self.gpio_control(str(request.get("op") or "stats"), **options)}
+            if cmd == "timer":
+                options = {key: request.get(key) for key in ("us", "timer", "limit") if request.get(key) is not None}
+                return {"status": "ok", "timer": self.timer_control(str(request.get("op") or "stats"), **options)}
+            if cmd == "stats":
+                options = {key: request.get(key) for key in ("top", "buckets", "path") if request.get(key) is not None}
+                return {"status": "ok", "stats": self.stats_control(str(request.get("op") or "show"), **options)}
+            if cmd == "profile":
+                options = {
+                    key: request.get(key)
+                    for key in ("pid", "pids", "period", "timer_ms", "clock_hz", "capacity", "max_depth", "clear")
+                    if request.get(key) is not None
+                }
+                return {"status": "ok", "profile": self.profile_control(str(request.get("op") or "status"), **options)}
+            if cmd == "reverse":
+                pid_value = request.get("pid")
+                if pid_value is None:
+                    raise ValueError("reverse requires 'pid'")
+                pid_int = int(pid_value)
+                op = str(request.get("op") or "stats").lower()
+                if op in {"config", "stats", "enable", "disable"}:
+                    enable_value = request.get("enable")
+                    if op == "enable":
+                        enable_value = True
+                    elif op == "disable":
+                        enable_value = False
+                    info = self.time_travel_config(
+                        pid_int,
+                        enable=None if enable_value is None else bool(enable_value),
+                        interval=request.get("interval"),
+                        keyframe_every=request.get("keyframe_every"),
+                        max_bytes=request.get("max_bytes"),
+                    )
+                    return {"status": "ok", "reverse": {"op": op, **info}}
+                if op == "step":
+                    count_value = request.get("count")
+                    info = self.reverse_step(pid_int, count=int(count_value) if count_value is not None else 1)
+                elif op in {"continue", "cont"}:
+                    info = self.reverse_continue(pid_int)
+                elif op in {"last_write", "watch"}:
+                    addr_value = request.get("addr")
+                    if addr_value is None:
+                        raise ValueError("reverse last_write requires 'addr'")
+                    info = self.reverse_to_last_write(pid_int, int(addr_value), width=int(request.get("width", 4) or 4))
+                else:
+                    raise ValueError(f"unknown reverse op '{op}'")
+                return {"status": "ok", "reverse": {"op": op, **info}}
             if cmd == "trace":
                 pid_value = request.get("pid")
                 if pid_value is None:
@@ -4890,6 +6381,16 @@ class VMController:
                     raise ValueError("poke requires 'data' hex string")
                 self.request_poke(pid, addr, bytes.fromhex(data_hex))
                 return {"status": "ok"}
+            if cmd == "event_filter":
+                update = "filter" in request
+                spec = request.get("filter")
+                if spec is not None and not isinstance(spec, dict):
+                    raise ValueError("event_filter 'filter' must be an object or null")
+                return {"status": "ok", "event_filter": self.event_filter(spec, update=update)}
+            if cmd == "mem_dirty":
+                pid = int(request.get("pid"))
+                dirty = self.mem_dirty(pid, clear=bool(request.get("clear", False)))
+                return {"status": "ok", "dirty": dirty}
             if cmd == "sched":
                 pid = int(request.get("pid"))
                 priority = request.get("priority")
@@ -5229,11 +6730,45 @@ def main():
     ap.add_argument("--dev-libm", action="store_true", help="enable sin_hsx/cos_hsx/exp_hsx soft handlers")
     ap.add_argument("--listen", type=int, help="start RPC server on given TCP port")
     ap.add_argument("--listen-host", default="127.0.0.1", help="interface for RPC server (default: 127.0.0.1)")
+    ap.add_argument("--flash-fs", choices=["nor", "nand"], help="back the FS SVCs with a simulated flash filesystem")
+    ap.add_argument("--flash-image", help="flash image file to load and sync (with --flash-fs)")
+    ap.add_argument("--can-bitrate", type=int, help="attach a virtual CAN bus at this bitrate (with --listen)")
+    ap.add_argument("--can-port", type=int, help="serve the CAN bus to test harnesses on this local port")
+    ap.add_argument("--uart", choices=["pty", "socket"], help="attach UART 0 to a pseudo terminal or local socket (with --listen)")
+    ap.add_argument("--uart-baud", type=int, default=115200, help="UART 0 baud rate (default: 115200)")
+    ap.add_argument("--uart-port", type=int, default=0, help="local TCP port for --uart socket (default: any free port)")
+    ap.add_argument("--gpio-replay", help="attach a GPIO bank and replay this recorded waveform (CSV or VCD, with --listen)")
+    ap.add_argument("--timer-tick-us", type=int, default=10, help="timer wheel resolution in microseconds (default: 10)")
+    ap.add_argument("--svc-stats-file", help="write per-SVC counters and latency histograms to this JSON file periodically")
+    ap.add_argument("--svc-stats-interval", type=float, default=10.0, help="seconds between --svc-stats-file snapshots (default: 10)")
     ap.add_argument("-v", "--verbose", action="store_true", help="print header metadata")
     args = ap.parse_args()
 
+    filesystem = None
+    if args.flash_fs:
+        filesystem = FlashFS.create(args.flash_fs, image_path=args.flash_image)
+
     if args.listen:
-        controller = VMController(trace=args.trace, svc_trace=args.svc_trace, dev_libm=args.dev_libm)
+        controller = VMController(
+            trace=args.trace,
+            svc_trace=args.svc_trace,
+            dev_libm=args.dev_libm,
+            filesystem=filesystem,
+            timers=live_timer_service(tick_ns=max(args.timer_tick_us, 1) * 1000),
+            svc_stats_path=args.svc_stats_file,
+            svc_stats_interval=args.svc_stats_interval,
+        )
+        if args.can_bitrate or args.can_port is not None:
+            info = controller.can_control("attach", bitrate=args.can_bitrate, port=args.can_port)
+            print(f"[CAN] {info['bitrate']} bit/s bus attached" + (f", harness socket {info['socket']}" if "socket" in info else ""))
+        if args.uart:
+            info = controller.uart_control("attach", port=0, backend=args.uart, baud=args.uart_baud, listen=args.uart_port)["ports"][0]
+            backend = info["backend"]
+            print(f"[UART] port 0 at {info['baud']} baud on " + (backend.get("path") or backend.get("address")))
+        if args.gpio_replay:
+            controller.gpio_control("attach")
+            info = controller.gpio_control("replay", path=args.gpio_replay)
+            print(f"[GPIO] replaying {info['replayed']} transitions from {args.gpio_replay}")
         if args.program:
             controller.load_from_path(args.program, verbose=args.verbose)
         server = VMServer((args.listen_host, args.listen), controller)
@@ -5244,6 +6779,8 @@ def main():
             print("\n[RPC] Shutting down")
         finally:
             server.server_close()
+            if controller.filesystem is not None:
+                controller.filesystem.sync()
         if controller.restart_requested:
             targets = controller.restart_targets or ["vm"]
             if "vm" in targets:
@@ -5275,6 +6812,8 @@ def main():
         dev_libm=args.dev_libm,
         trace_file=trace_fp,
     )
+    if filesystem is not None:
+        vm.fs = filesystem
 
     if args.entry_symbol:
         try:
@@ -5293,6 +6832,8 @@ def main():
     finally:
         if trace_fp:
             trace_fp.close()
+        if filesystem is not None:
+            filesystem.sync()
 
     if vm.running and max_steps is not None and vm.cycles >= max_steps:
         print(f"[VM] Max steps {max_steps} reached; halting")
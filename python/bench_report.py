@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+"""
+bench_report.py - shared output for the simulator benchmarks
+
+Each benchmark produces a list of flat row dictionaries.  :func:`report`
+prints them as an aligned text table and, when ``--json`` names a file,
+writes the same rows there.
+"""
+
+from __future__ import annotations
+
+import json
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Sequence
+
+
+def format_table(rows: List[Dict[str, Any]], columns: Optional[Sequence[str]] = None) -> str:
+    columns = list(columns or (rows[0] if rows else ()))
+    if not columns:
+        return ""
+    widths = {col: max([len(col), *(len(str(row[col])) for row in rows)]) for col in columns}
+    out = ["  ".join(col.ljust(widths[col]) for col in columns)]
+    out.append("  ".join("-" * widths[col] for col in columns))
+    for row in rows:
+        out.append("  ".join(str(row[col]).ljust(widths[col]) for col in columns))
+    return "\n".join(out)
+
+
+def report(rows: List[Dict[str, Any]], json_path: Optional[str] = None, *, columns: Optional[Sequence[str]] = None) -> None:
+    print(format_table(rows, columns))
+    if json_path:
+        Path(json_path).write_text(json.dumps(rows, indent=2), encoding="utf-8")
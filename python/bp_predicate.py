@@ -0,0 +1,381 @@
+#!/usr/bin/env python3
+"""Breakpoint conditions compiled to predicate bytecode for in-VM evaluation.
+
+A conditional breakpoint used to stop the VM unconditionally and leave the
+decision to the executive, costing an RPC round-trip and an auto-continue per
+hit.  :func:`compile_breakpoint` turns the debugger-facing strings into a
+:class:`BreakpointSpec` whose tiny postfix programs ``MiniVM.step`` runs in
+place, so the VM only halts (or emits a log-point event) when the predicate
+fires.
+
+Conditions are C-like expressions over unsigned 32-bit values::
+
+    R4 == 17
+    [R1+4] != 0 && hits >= 3
+    mem16[0x2000] & 0x80
+    sp < 0x8100
+
+``R0``..``R15``, ``pc``, ``sp`` and ``hits`` (how many times the condition has
+already been met) are the available names; ``[addr]`` is a 32-bit load and
+``mem8``/``mem16``/``mem32[addr]`` pick the width.  Hit conditions follow the
+DAP ``hitCondition`` forms ``N``, ``==N``, ``>=N``, ``>N`` and ``%N``.  Log
+messages are format strings whose ``{expr}`` / ``{expr:x}`` placeholders use
+the same expression syntax.
+"""
+
+from __future__ import annotations
+
+import re
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Union
+
+OP_CONST = 0
+OP_REG = 1
+OP_PC = 2
+OP_SP = 3
+OP_HITS = 4
+OP_LOAD = 5  # arg: width in bytes
+OP_UNARY = 6  # arg: "-", "!", "~"
+OP_BINARY = 7  # arg: operator string
+
+Instruction = Tuple[int, Any]
+Program = Tuple[Instruction, ...]
+
+_MASK = 0xFFFFFFFF
+
+_TOKEN_RE = re.compile(
+    r"\s*(?:(?P<num>0[xX][0-9A-Fa-f]+|\d+)|(?P<name>[A-Za-z_][A-Za-z_0-9]*)"
+    r"|(?P<op>==|!=|<=|>=|<<|>>|&&|\|\||[-+*/%&|^~!<>()\[\]]))"
+)
+
+# Binary operators from loosest to tightest binding.
+_PRECEDENCE: Dict[str, int] = {
+    "||": 1,
+    "&&": 2,
+    "|": 3,
+    "^": 4,
+    "&": 5,
+    "==": 6,
+    "!=": 6,
+    "<": 7,
+    "<=": 7,
+    ">": 7,
+    ">=": 7,
+    "<<": 8,
+    ">>": 8,
+    "+": 9,
+    "-": 9,
+    "*": 10,
+    "/": 10,
+    "%": 10,
+}
+
+_LOAD_WIDTHS = {"mem8": 1, "mem16": 2, "mem32": 4}
+
+
+def _binary(op: str, lhs: int, rhs: int) -> int:
+    if op == "==":
+        return int(lhs == rhs)
+    if op == "!=":
+        return int(lhs != rhs)
+    if op == "<":
+        return int(lhs < rhs)
+    if op == "<=":
+        return int(lhs <= rhs)
+    if op == ">":
+        return int(lhs > rhs)
+    if op == ">=":
+        return int(lhs >= rhs)
+    if op == "&&":
+        return int(bool(lhs) and bool(rhs))
+    if op == "||":
+        return int(bool(lhs) or bool(rhs))
+    if op == "&":
+        return lhs & rhs
+    if op == "|":
+        return lhs | rhs
+    if op == "^":
+        return lhs ^ rhs
+    if op == "+":
+        return (lhs + rhs) & _MASK
+    if op == "-":
+        return (lhs - rhs) & _MASK
+    if op == "*":
+        return (lhs * rhs) & _MASK
+    if op == "/":
+        return lhs // rhs if rhs else 0
+    if op == "%":
+        return lhs % rhs if rhs else 0
+    if op == "<<":
+        return (lhs << (rhs & 31)) & _MASK
+    if op == ">>":
+        return lhs >> (rhs & 31)
+    raise ValueError(f"unknown operator {op!r}")
+
+
+class _Parser:
+    def __init__(self, text: str) -> None:
+        self.text = text
+        self.tokens: List[Tuple[str, str]] = []
+        pos = 0
+        stripped = text.rstrip()
+        while pos < len(stripped):
+            match = _TOKEN_RE.match(stripped, pos)
+            if match is None or match.end() == pos:
+                raise ValueError(f"bad condition syntax near {stripped[pos:]!r}")
+            kind = match.lastgroup or "op"
+            self.tokens.append((kind, match.group(kind)))
+            pos = match.end()
+        self.index = 0
+        self.program: List[Instruction] = []
+
+    def peek(self) -> Optional[str]:
+        return self.tokens[self.index][1] if self.index < len(self.tokens) else None
+
+    def take(self, expected: Optional[str] = None) -> Tuple[str, str]:
+        if self.index >= len(self.tokens):
+            raise ValueError(f"unexpected end of condition {self.text!r}")
+        token = self.tokens[self.index]
+        if expected is not None and token[1] != expected:
+            raise ValueError(f"expected {expected!r} in condition {self.text!r}")
+        self.index += 1
+        return token
+
+    def parse(self) -> Program:
+        self.expression(1)
+        if self.index != len(self.tokens):
+            raise ValueError(f"unexpected {self.tokens[self.index][1]!r} in condition {self.text!r}")
+        return tuple(self.program)
+
+    def expression(self, min_prec: int) -> None:
+        self.unary()
+        while True:
+            op = self.peek()
+            prec = _PRECEDENCE.get(op or "")
+            if prec is None or prec < min_prec:
+                return
+            self.take()
+            self.expression(prec + 1)
+            self.program.append((OP_BINARY, op))
+
+    def unary(self) -> None:
+        op = self.peek()
+        if op in {"-", "!", "~"}:
+            self.take()
+            self.unary()
+            self.program.append((OP_UNARY, op))
+            return
+        self.primary()
+
+    def primary(self) -> None:
+        kind, value = self.take()
+        if kind == "num":
+            self.program.append((OP_CONST, int(value, 0) & _MASK))
+            return
+        if value == "(":
+            self.expression(1)
+            self.take(")")
+            return
+        if value == "[":
+            self.expression(1)
+            self.take("]")
+            self.program.append((OP_LOAD, 4))
+            return
+        if kind == "name":
+            lowered = value.lower()
+            if lowered in _LOAD_WIDTHS:
+                self.take("[")
+                self.expression(1)
+                self.take("]")
+                self.program.append((OP_LOAD, _LOAD_WIDTHS[lowered]))
+                return
+            if lowered == "pc":
+                self.program.append((OP_PC, None))
+                return
+            if lowered == "sp":
+                self.program.append((OP_SP, None))
+                return
+            if lowered == "hits":
+                self.program.append((OP_HITS, None))
+                return
+            if lowered[0] == "r" and lowered[1:].isdigit() and int(lowered[1:]) < 16:
+                self.program.append((OP_REG, int(lowered[1:])))
+                return
+            raise ValueError(f"unknown name {value!r} in condition")
+        raise ValueError(f"unexpected {value!r} in condition {self.text!r}")
+
+
+def compile_condition(text: str) -> Program:
+    """Compile a condition expression to a postfix program."""
+
+    if not text or not text.strip():
+        raise ValueError("empty condition")
+    return _Parser(text).parse()
+
+
+def evaluate(program: Sequence[Instruction], vm: Any, hits: int = 0) -> int:
+    """Run ``program`` against ``vm`` (``regs``, ``pc``, ``sp``, ``mem``)."""
+
+    stack: List[int] = []
+    push = stack.append
+    pop = stack.pop
+    for op, arg in program:
+        if op == OP_CONST:
+            push(arg)
+        elif op == OP_REG:
+            push(vm.regs[arg] & _MASK)
+        elif op == OP_BINARY:
+            rhs = pop()
+            push(_binary(arg, pop(), rhs))
+        elif op == OP_LOAD:
+            addr = pop() & 0xFFFF
+            mem = vm.mem
+            value = 0
+            for offset in range(arg):
+                if addr + offset < len(mem):
+                    value |= mem[addr + offset] << (8 * offset)
+            push(value)
+        elif op == OP_PC:
+            push(vm.pc & _MASK)
+        elif op == OP_SP:
+            push(vm.sp & _MASK)
+        elif op == OP_HITS:
+            push(hits & _MASK)
+        elif op == OP_UNARY:
+            value = pop()
+            if arg == "-":
+                push((-value) & _MASK)
+            elif arg == "!":
+                push(int(not value))
+            else:
+                push((~value) & _MASK)
+        else:
+            raise ValueError(f"bad predicate opcode {op}")
+    return stack[-1] if stack else 0
+
+
+_HIT_RE = re.compile(r"^\s*(==|>=|>|%)?\s*(0[xX][0-9A-Fa-f]+|\d+)\s*$")
+
+
+def compile_hit_condition(text: str) -> Tuple[str, int]:
+    match = _HIT_RE.match(text or "")
+    if match is None:
+        raise ValueError(f"bad hit condition {text!r}")
+    op = match.group(1) or "=="
+    value = int(match.group(2), 0)
+    if op == "%" and value <= 0:
+        raise ValueError("hit condition modulus must be positive")
+    return op, value
+
+
+def _hit_matches(op: str, target: int, hits: int) -> bool:
+    if op == "==":
+        return hits == target
+    if op == ">=":
+        return hits >= target
+    if op == ">":
+        return hits > target
+    return hits % target == 0
+
+
+_PLACEHOLDER_RE = re.compile(r"\{([^{}]*)\}")
+
+LogPart = Union[str, Tuple[Program, str]]
+
+
+def compile_log_message(text: str) -> Tuple[LogPart, ...]:
+    parts: List[LogPart] = []
+    pos = 0
+    for match in _PLACEHOLDER_RE.finditer(text):
+        if match.start() > pos:
+            parts.append(text[pos : match.start()])
+        expr, _, fmt = match.group(1).partition(":")
+        fmt = fmt.strip()
+        if fmt not in {"", "x", "X", "d"}:
+            raise ValueError(f"unsupported log format {fmt!r}")
+        parts.append((compile_condition(expr), fmt))
+        pos = match.end()
+    if pos < len(text):
+        parts.append(text[pos:])
+    return tuple(parts)
+
+
+STOP = "stop"
+LOG = "log"
+
+
+@dataclass
+class BreakpointSpec:
+    """Compiled condition, hit condition and log-point for one address."""
+
+    condition: Optional[str] = None
+    hit_condition: Optional[str] = None
+    log_message: Optional[str] = None
+    hits: int = 0
+    program: Program = ()
+    hit_test: Optional[Tuple[str, int]] = None
+    log_parts: Tuple[LogPart, ...] = field(default_factory=tuple)
+
+    def evaluate(self, vm: Any) -> Optional[str]:
+        """Return :data:`STOP`, :data:`LOG` or ``None`` for this pass."""
+
+        if self.program and not evaluate(self.program, vm, self.hits):
+            return None
+        self.hits += 1
+        if self.hit_test is not None and not _hit_matches(self.hit_test[0], self.hit_test[1], self.hits):
+            return None
+        return LOG if self.log_message is not None else STOP
+
+    @property
+    def uses_hits(self) -> bool:
+        """True when stopping depends on the running hit count."""
+
+        return self.hit_test is not None or any(op == OP_HITS for op, _arg in self.program)
+
+    def format_log(self, vm: Any) -> str:
+        out: List[str] = []
+        for part in self.log_parts:
+            if isinstance(part, str):
+                out.append(part)
+                continue
+            program, fmt = part
+            value = evaluate(program, vm, self.hits)
+            if fmt == "x":
+                out.append(f"0x{value:x}")
+            elif fmt == "X":
+                out.append(f"0x{value:X}")
+            else:
+                out.append(str(value))
+        return "".join(out)
+
+    def describe(self) -> Dict[str, Any]:
+        info: Dict[str, Any] = {"hits": self.hits}
+        if self.condition is not None:
+            info["condition"] = self.condition
+        if self.hit_condition is not None:
+            info["hit_condition"] = self.hit_condition
+        if self.log_message is not None:
+            info["log_message"] = self.log_message
+        return info
+
+
+def compile_breakpoint(
+    *,
+    condition: Optional[str] = None,
+    hit_condition: Optional[str] = None,
+    log_message: Optional[str] = None,
+) -> Optional[BreakpointSpec]:
+    """Build a :class:`BreakpointSpec`; ``None`` means a plain breakpoint."""
+
+    condition = condition if condition and str(condition).strip() else None
+    hit_condition = str(hit_condition) if hit_condition not in (None, "") else None
+    if condition is None and hit_condition is None and log_message is None:
+        return None
+    return BreakpointSpec(
+        condition=condition,
+        hit_condition=hit_condition,
+        log_message=log_message,
+        program=compile_condition(condition) if condition is not None else (),
+        hit_test=compile_hit_condition(hit_condition) if hit_condition is not None else None,
+        log_parts=compile_log_message(log_message) if log_message is not None else (),
+    )
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+can_benchmark.py - bus-load scenarios on the virtual CAN bus
+
+Attaches ``--nodes`` controllers to one :class:`CANBus`, each transmitting a
+periodic frame (node ``n`` uses ID ``base + n``, so lower nodes win
+arbitration) with a random phase, and every node filtering for the IDs of
+its two neighbours.  Reports bus load, frames and bits on the wire,
+arbitration losses, worst-case latency for the highest and lowest priority
+node, frames that missed their period, and the host time per simulated
+frame.
+"""
+
+from __future__ import annotations
+
+import argparse
+import random
+import time
+from typing import Any, Dict, Iterable, Optional
+
+try:
+    from . import bench_report, can_bus
+except ImportError:  # pragma: no cover - allow running as a script
+    import bench_report  # type: ignore
+    import can_bus  # type: ignore
+
+
+def run_scenario(
+    *,
+    nodes: int = 50,
+    bitrate: int = 1_000_000,
+    period_us: int = 10_000,
+    duration_ms: int = 200,
+    dlc: int = 8,
+    extended: bool = False,
+    base_id: int = 0x100,
+    seed: int = 1,
+) -> Dict[str, Any]:
+    rng = random.Random(seed)
+    bus = can_bus.CANBus(bitrate)
+    flags = can_bus.HSX_CAN_EXT_FRAME if extended else can_bus.HSX_CAN_STD_FRAME
+    received = [0] * nodes
+    members = []
+    for index in range(nodes):
+        node = bus.attach(f"n{index}", deliver=lambda batch, index=index: received.__setitem__(index, received[index] + len(batch)))
+        for bank, neighbour in enumerate(((index - 1) % nodes, (index + 1) % nodes)):
+            node.set_filter(bank, can_bus.EXT_ID_MASK if extended else can_bus.STD_ID_MASK, base_id + neighbour)
+        members.append((node, rng.randrange(period_us)))
+
+    period_ns = period_us * 1000
+    end_ns = duration_ms * 1_000_000
+    started = time.process_time()
+    missed = 0
+    for tick in range(0, end_ns, period_ns):
+        for index, (node, phase_us) in enumerate(members):
+            data = bytes(rng.getrandbits(8) for _ in range(dlc))
+            if node.send(can_bus.CANFrame(base_id + index, data, flags), at_ns=tick + phase_us * 1000) != can_bus.HSX_HAL_OK:
+                missed += 1
+        bus.run_until(tick + period_ns)
+    cpu_s = time.process_time() - started
+
+    stats = bus.stats()
+    node_stats = stats["nodes"]
+    late = sum(1 for node, _phase in members if node.max_latency_ns > period_ns)
+    return {
+        "nodes": nodes,
+        "bitrate": bitrate,
+        "period_us": period_us,
+        "frames": stats["frames"],
+        "offered": nodes * (end_ns // period_ns),
+        "load": stats["load"],
+        "bits_per_frame": round(stats["bits"] / stats["frames"], 2) if stats["frames"] else 0.0,
+        "arbitration_lost": sum(entry["arbitration_lost"] for entry in node_stats.values()),
+        "max_latency_us_first": node_stats["n0"]["max_latency_us"],
+        "max_latency_us_last": node_stats[f"n{nodes - 1}"]["max_latency_us"],
+        "late_nodes": late,
+        "tx_rejected": missed,
+        "rx_delivered": sum(received),
+        "host_us_per_frame": round(cpu_s * 1e6 / stats["frames"], 2) if stats["frames"] else 0.0,
+    }
+
+
+def main(argv: Optional[Iterable[str]] = None) -> None:
+    parser = argparse.ArgumentParser(description="Bus-load scenarios on the virtual CAN bus.")
+    parser.add_argument("--nodes", type=int, action="append", help="node count (repeatable; default 10, 50, 80)")
+    parser.add_argument("--bitrate", type=int, default=1_000_000)
+    parser.add_argument("--period-us", type=int, default=10_000, help="per-node transmit period (default 10 ms)")
+    parser.add_argument("--duration-ms", type=int, default=500)
+    parser.add_argument("--dlc", type=int, default=8)
+    parser.add_argument("--extended", action="store_true", help="use 29-bit identifiers")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--json", help="write JSON report to file")
+    args = parser.parse_args(list(argv) if argv is not None else None)
+
+    rows = [
+        run_scenario(
+            nodes=count,
+            bitrate=args.bitrate,
+            period_us=args.period_us,
+            duration_ms=args.duration_ms,
+            dlc=args.dlc,
+            extended=args.extended,
+            seed=args.seed,
+        )
+        for count in (args.nodes or [10, 50, 80])
+    ]
+    bench_report.report(rows, args.json)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,525 @@
+#!/usr/bin/env python3
+"""In-process virtual CAN bus behind the ``include/hsx_can.h`` SVCs.
+
+Any number of executives (each a :class:`CANNode`) share one
+:class:`CANBus`; external test harnesses join through
+:class:`CANSocketServer`, a local TCP socket speaking JSON lines.
+
+Timing is bit accurate: every frame is encoded (SOF, arbitration field,
+control, data, CRC-15) to count its stuff bits, so a frame occupies the bus
+for exactly ``bits * 1e9 / bitrate`` nanoseconds including the CRC delimiter,
+ACK, EOF and intermission.  Whenever the bus goes idle, every node's highest
+priority pending frame contends and the one with the lowest arbitration field
+wins (standard beats extended with the same base ID, data beats remote);
+losers retry at the next idle point.
+
+Each node has 16 acceptance-filter banks (``hsx_can_set_filter``).  Banks
+are indexed by mask, so a frame is accepted when ``id & mask`` is in the set
+of IDs for any configured mask - one hash lookup per distinct mask, usually
+one - and the decision is memoised per ID.  Accepted frames are buffered as
+``hsx_can_rx_event_t`` records and handed to the node's ``deliver`` callback
+in batches: when ``rx_batch`` frames are waiting, and at the end of every
+:meth:`CANBus.run_until` call.
+"""
+
+from __future__ import annotations
+
+import heapq
+import json
+import select
+import socket
+import socketserver
+import struct
+import threading
+import time
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, List, Optional, Set, Tuple
+
+HSX_HAL_OK = 0
+HSX_HAL_BUSY = -3
+HSX_HAL_INVALID_PARAM = -4
+
+HSX_CAN_STD_FRAME = 0x00
+HSX_CAN_EXT_FRAME = 0x01
+HSX_CAN_RTR_FRAME = 0x02
+
+# hsx_can_get_status() bits
+HSX_CAN_STATUS_TX_PENDING_MASK = 0xFF
+HSX_CAN_STATUS_RX_OVERFLOW = 0x100
+HSX_CAN_STATUS_TX_FULL = 0x200
+
+FILTER_BANKS = 16
+STD_ID_MASK = 0x7FF
+EXT_ID_MASK = 0x1FFFFFFF
+
+# hsx_can_rx_event_t: can_id, dlc, flags, data[8], (pad), timestamp in us
+RX_EVENT = struct.Struct("<IBB8s2xI")
+
+# CRC delimiter, ACK slot, ACK delimiter, EOF and intermission: never stuffed.
+_TRAILER_BITS = 1 + 2 + 7 + 3
+_CRC15_POLY = 0x4599
+
+DEFAULT_TX_DEPTH = 32
+DEFAULT_RX_BATCH = 8
+_MEMO_LIMIT = 4096
+
+
+def _bits(value: int, width: int) -> List[int]:
+    return [(value >> shift) & 1 for shift in range(width - 1, -1, -1)]
+
+
+def _crc15(bits: List[int]) -> int:
+    crc = 0
+    for bit in bits:
+        feedback = bit ^ ((crc >> 14) & 1)
+        crc = (crc << 1) & 0x7FFF
+        if feedback:
+            crc ^= _CRC15_POLY
+    return crc
+
+
+def _stuff_bits(bits: List[int]) -> int:
+    """Number of stuff bits a transmitter inserts after runs of five."""
+
+    stuffed = 0
+    last = -1
+    run = 0
+    for bit in bits:
+        if bit == last:
+            run += 1
+        else:
+            last, run = bit, 1
+        if run == 5:
+            stuffed += 1
+            last, run = bit ^ 1, 1  # the stuff bit starts the next run
+    return stuffed
+
+
+@dataclass
+class CANFrame:
+    can_id: int
+    data: bytes = b""
+    flags: int = HSX_CAN_STD_FRAME
+    dlc: Optional[int] = None
+
+    def __post_init__(self) -> None:
+        self.data = bytes(self.data)
+        if len(self.data) > 8:
+            raise ValueError("CAN frames carry at most 8 data bytes")
+        limit = EXT_ID_MASK if self.flags & HSX_CAN_EXT_FRAME else STD_ID_MASK
+        if not 0 <= self.can_id <= limit:
+            raise ValueError(f"CAN id 0x{self.can_id:X} out of range")
+        if self.dlc is None:
+            self.dlc = len(self.data)
+        if not 0 <= self.dlc <= 8:
+            raise ValueError("CAN dlc must be 0..8")
+        if self.flags & HSX_CAN_RTR_FRAME:
+            self.data = b""
+
+    @property
+    def extended(self) -> bool:
+        return bool(self.flags & HSX_CAN_EXT_FRAME)
+
+    @property
+    def remote(self) -> bool:
+        return bool(self.flags & HSX_CAN_RTR_FRAME)
+
+    def arbitration_key(self) -> Tuple[int, int, int, int]:
+        """Orders frames as the wired-AND arbitration field does (lower wins)."""
+
+        rtr = 1 if self.remote else 0
+        if self.extended:
+            return ((self.can_id >> 18) & STD_ID_MASK, 1, self.can_id & 0x3FFFF, rtr)
+        return (self.can_id, 0, 0, rtr)
+
+    def bit_length(self) -> int:
+        """Bits on the wire, including stuff bits and interframe space."""
+
+        rtr = 1 if self.remote else 0
+        bits = [0]  # SOF
+        if self.extended:
+            bits += _bits(self.can_id >> 18, 11) + [1, 1] + _bits(self.can_id & 0x3FFFF, 18) + [rtr, 0, 0]
+        else:
+            bits += _bits(self.can_id, 11) + [rtr, 0, 0]
+        bits += _bits(self.dlc or 0, 4)
+        for byte in self.data:
+            bits += _bits(byte, 8)
+        bits += _bits(_crc15(bits), 15)
+        return len(bits) + _stuff_bits(bits) + _TRAILER_BITS
+
+    def pack_rx_event(self, timestamp_us: int) -> bytes:
+        return RX_EVENT.pack(self.can_id, self.dlc or 0, self.flags, self.data.ljust(8, b"\x00"), timestamp_us & 0xFFFFFFFF)
+
+    @classmethod
+    def unpack_rx_event(cls, record: bytes) -> Tuple["CANFrame", int]:
+        can_id, dlc, flags, data, timestamp = RX_EVENT.unpack(record)
+        payload = b"" if flags & HSX_CAN_RTR_FRAME else data[: min(dlc, 8)]
+        return cls(can_id, payload, flags, dlc), timestamp
+
+    def to_json(self) -> Dict[str, Any]:
+        return {"id": self.can_id, "data": self.data.hex(), "flags": self.flags, "dlc": self.dlc}
+
+
+class AcceptanceFilter:
+    """16 mask/ID banks, indexed by mask for constant-time acceptance."""
+
+    def __init__(self) -> None:
+        self.banks: Dict[int, Tuple[int, int]] = {}
+        self._by_mask: Dict[int, Set[int]] = {}
+        self._memo: Dict[int, bool] = {}
+
+    def set(self, bank: int, mask: int, ident: int) -> int:
+        if not 0 <= bank < FILTER_BANKS:
+            return HSX_HAL_INVALID_PARAM
+        mask &= EXT_ID_MASK
+        self.banks[bank] = (mask, ident & mask)
+        self._rebuild()
+        return HSX_HAL_OK
+
+    def clear(self, bank: Optional[int] = None) -> None:
+        if bank is None:
+            self.banks.clear()
+        else:
+            self.banks.pop(bank, None)
+        self._rebuild()
+
+    def _rebuild(self) -> None:
+        self._by_mask = {}
+        for mask, ident in self.banks.values():
+            self._by_mask.setdefault(mask, set()).add(ident)
+        self._memo.clear()
+
+    def accepts(self, can_id: int) -> bool:
+        if not self.banks:
+            return True  # no banks configured: accept everything
+        hit = self._memo.get(can_id)
+        if hit is None:
+            hit = any((can_id & mask) in idents for mask, idents in self._by_mask.items())
+            if len(self._memo) >= _MEMO_LIMIT:
+                self._memo.clear()
+            self._memo[can_id] = hit
+        return hit
+
+
+# Receives a batch of (frame, timestamp_us); returns False when the batch was
+# dropped (e.g. the destination mailbox is full).
+Deliver = Callable[[List[Tuple[CANFrame, int]]], Optional[bool]]
+# Called with (frame, end_ns) once one of the node's frames has been sent.
+TxDone = Callable[[CANFrame, int], None]
+
+
+class CANNode:
+    """One controller on the bus: a priority TX queue, filters and an RX batch."""
+
+    def __init__(
+        self,
+        bus: "CANBus",
+        name: str,
+        *,
+        deliver: Optional[Deliver] = None,
+        on_tx: Optional[TxDone] = None,
+        tx_depth: int = DEFAULT_TX_DEPTH,
+        rx_batch: int = DEFAULT_RX_BATCH,
+    ) -> None:
+        self.bus = bus
+        self.name = name
+        self.deliver = deliver
+        self.on_tx = on_tx
+        self.tx_depth = max(int(tx_depth), 1)
+        self.rx_batch = max(int(rx_batch), 1)
+        self.filter = AcceptanceFilter()
+        self.tx_queue: List[Tuple[Tuple[int, int, int, int], int, int, CANFrame]] = []
+        self.rx_pending: List[Tuple[CANFrame, int]] = []
+        self.tx_frames = 0
+        self.tx_rejected = 0
+        self.rx_frames = 0
+        self.rx_filtered = 0
+        self.rx_batches = 0
+        self.rx_dropped = 0
+        self.rx_overflow = False
+        self.arbitration_lost = 0
+        self.max_latency_ns = 0
+        self.total_latency_ns = 0
+
+    def send(self, frame: CANFrame, *, at_ns: Optional[int] = None) -> int:
+        """Queue ``frame`` for arbitration from ``at_ns`` (default: bus time)."""
+
+        with self.bus.lock:
+            if len(self.tx_queue) >= self.tx_depth:
+                self.tx_rejected += 1
+                return HSX_HAL_BUSY
+            ready = self.bus.now_ns if at_ns is None else max(int(at_ns), 0)
+            heapq.heappush(self.tx_queue, (frame.arbitration_key(), self.bus._next_seq(), ready, frame))
+            return HSX_HAL_OK
+
+    def set_filter(self, bank: int, mask: int, ident: int) -> int:
+        with self.bus.lock:
+            return self.filter.set(bank, mask, ident)
+
+    def status(self) -> int:
+        flags = min(len(self.tx_queue), HSX_CAN_STATUS_TX_PENDING_MASK)
+        if self.rx_overflow:
+            flags |= HSX_CAN_STATUS_RX_OVERFLOW
+            self.rx_overflow = False  # reported once, like a latched error flag
+        if len(self.tx_queue) >= self.tx_depth:
+            flags |= HSX_CAN_STATUS_TX_FULL
+        return flags
+
+    def _receive(self, frame: CANFrame, timestamp_ns: int) -> None:
+        if not self.filter.accepts(frame.can_id):
+            self.rx_filtered += 1
+            return
+        self.rx_frames += 1
+        self.rx_pending.append((frame, timestamp_ns // 1000))
+        if len(self.rx_pending) >= self.rx_batch:
+            self.flush()
+
+    def flush(self) -> None:
+        if not self.rx_pending:
+            return
+        batch, self.rx_pending = self.rx_pending, []
+        if self.deliver is None:
+            return
+        self.rx_batches += 1
+        if self.deliver(batch) is False:
+            self.rx_dropped += len(batch)
+            self.rx_overflow = True
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "name": self.name,
+            "tx_frames": self.tx_frames,
+            "tx_pending": len(self.tx_queue),
+            "tx_rejected": self.tx_rejected,
+            "arbitration_lost": self.arbitration_lost,
+            "rx_frames": self.rx_frames,
+            "rx_filtered": self.rx_filtered,
+            "rx_batches": self.rx_batches,
+            "rx_dropped": self.rx_dropped,
+            "filters": {bank: {"mask": mask, "id": ident} for bank, (mask, ident) in sorted(self.filter.banks.items())},
+            "max_latency_us": round(self.max_latency_ns / 1000.0, 3),
+            "mean_latency_us": round(self.total_latency_ns / 1000.0 / self.tx_frames, 3) if self.tx_frames else 0.0,
+        }
+
+
+class CANBus:
+    """Shared bus: arbitration, bit timing and delivery to every other node."""
+
+    def __init__(self, bitrate: int = 1_000_000, *, clock: Optional[Callable[[], float]] = None) -> None:
+        bitrate = int(bitrate)
+        if bitrate <= 0 or 1_000_000_000 % bitrate:
+            raise ValueError(f"unsupported CAN bitrate {bitrate}")
+        self.bitrate = bitrate
+        self.bit_ns = 1_000_000_000 // bitrate
+        self.clock = clock
+        self._epoch = clock() if clock is not None else 0.0
+        self.lock = threading.RLock()
+        self.nodes: Dict[str, CANNode] = {}
+        self.now_ns = 0
+        self.idle_ns = 0  # end of the frame on the wire (or of the last one)
+        self.busy_ns = 0
+        self.frames = 0
+        self.bits = 0
+        self._seq = 0
+
+    def _next_seq(self) -> int:
+        self._seq += 1
+        return self._seq
+
+    def attach(self, name: str, **options: Any) -> CANNode:
+        with self.lock:
+            if name in self.nodes:
+                raise ValueError(f"CAN node '{name}' already attached")
+            node = CANNode(self, name, **options)
+            self.nodes[name] = node
+            return node
+
+    def detach(self, name: str) -> None:
+        with self.lock:
+            node = self.nodes.pop(name, None)
+            if node is not None:
+                node.flush()
+
+    def frame_time_ns(self, frame: CANFrame) -> int:
+        return frame.bit_length() * self.bit_ns
+
+    def run_until(self, t_ns: int) -> int:
+        """Transmit every frame that completes by ``t_ns``; returns frames sent."""
+
+        sent = 0
+        with self.lock:
+            t_ns = int(t_ns)
+            nodes = list(self.nodes.values())
+            while True:
+                ready = [node.tx_queue[0][2] for node in nodes if node.tx_queue]
+                if not ready:
+                    break
+                start = max(self.idle_ns, min(ready))
+                contenders = [node for node in nodes if node.tx_queue and node.tx_queue[0][2] <= start]
+                winner = min(contenders, key=lambda node: node.tx_queue[0][:2])
+                key, _seq, queued, frame = winner.tx_queue[0]
+                bits = frame.bit_length()
+                end = start + bits * self.bit_ns
+                if end > t_ns:
+                    break  # still on the wire; the result cannot change
+                heapq.heappop(winner.tx_queue)
+                for node in contenders:
+                    if node is not winner:
+                        node.arbitration_lost += 1
+                winner.tx_frames += 1
+                latency = end - queued
+                winner.total_latency_ns += latency
+                winner.max_latency_ns = max(winner.max_latency_ns, latency)
+                self.idle_ns = end
+                for node in nodes:
+                    if node is not winner:
+                        node._receive(frame, end)
+                if winner.on_tx is not None:
+                    winner.on_tx(frame, end)
+                self.busy_ns += bits * self.bit_ns
+                self.bits += bits
+                self.frames += 1
+                sent += 1
+            self.now_ns = max(self.now_ns, t_ns)
+            for node in nodes:
+                node.flush()
+        return sent
+
+    def run_for(self, duration_ns: int) -> int:
+        return self.run_until(self.now_ns + int(duration_ns))
+
+    def poll(self) -> int:
+        """Advance to the bus clock (live buses only)."""
+
+        if self.clock is None:
+            return 0
+        return self.run_until(int((self.clock() - self._epoch) * 1e9))
+
+    def stats(self) -> Dict[str, Any]:
+        with self.lock:
+            return {
+                "bitrate": self.bitrate,
+                "time_us": self.now_ns // 1000,
+                "frames": self.frames,
+                "bits": self.bits,
+                "load": round(self.busy_ns / self.now_ns, 4) if self.now_ns else 0.0,
+                "nodes": {name: node.stats() for name, node in self.nodes.items()},
+            }
+
+
+class _CANSocketHandler(socketserver.StreamRequestHandler):
+    """One external node per connection.
+
+    Lines in: ``{"id": 0x123, "data": "0102", "flags": 0}`` to transmit or
+    ``{"filter": [bank, mask, id]}``.  Lines out: received frames as
+    ``{"id", "data", "flags", "dlc", "ts_us"}``, or ``{"error": ...}``.
+
+    ``deliver`` runs under :attr:`CANBus.lock`, so it only queues frames in
+    this connection's outbox and wakes the handler thread, which does the
+    socket writes.  A slow harness backs up its own outbox (frames beyond
+    ``outbox_limit`` count as ``rx_dropped``), never the bus.
+    """
+
+    outbox_limit = 4096
+
+    def setup(self) -> None:
+        super().setup()
+        self._outbox: List[Tuple[CANFrame, int]] = []
+        self._outbox_lock = threading.Lock()
+        self._wake_r, self._wake_w = socket.socketpair()
+        self._wake_w.setblocking(False)
+
+    def finish(self) -> None:
+        try:
+            super().finish()
+        finally:
+            self._wake_r.close()
+            self._wake_w.close()
+
+    def handle(self) -> None:
+        bus: CANBus = self.server.bus  # type: ignore[attr-defined]
+        name = f"socket:{self.client_address[1]}"
+        node = bus.attach(name, deliver=self._forward)
+        pending = b""
+        try:
+            while True:
+                readable, _, _ = select.select([self.connection, self._wake_r], [], [])
+                if self._wake_r in readable:
+                    self._wake_r.recv(4096)
+                    self._drain()
+                if self.connection not in readable:
+                    continue
+                chunk = self.connection.recv(65536)
+                if not chunk:
+                    break
+                *lines, pending = (pending + chunk).split(b"\n")
+                for raw in lines:
+                    line = raw.strip()
+                    if line:
+                        self._handle_line(bus, node, line)
+        except OSError:
+            pass
+        finally:
+            bus.detach(name)
+
+    def _handle_line(self, bus: CANBus, node: CANNode, line: bytes) -> None:
+        try:
+            message = json.loads(line)
+            if "filter" in message:
+                bank, mask, ident = message["filter"]
+                status = node.set_filter(int(bank), int(mask), int(ident))
+            else:
+                frame = CANFrame(int(message["id"]), bytes.fromhex(message.get("data", "")), int(message.get("flags", 0)))
+                status = node.send(frame)
+        except (ValueError, KeyError, TypeError) as exc:
+            self._write({"error": str(exc)})
+            return
+        if status != HSX_HAL_OK:
+            self._write({"error": "rejected", "status": status})
+        bus.poll()
+
+    def _forward(self, batch: List[Tuple[CANFrame, int]]) -> bool:
+        with self._outbox_lock:
+            if len(self._outbox) + len(batch) > self.outbox_limit:
+                return False
+            self._outbox.extend(batch)
+        try:
+            self._wake_w.send(b"\0")
+        except OSError:
+            pass  # a wakeup is already pending, or the connection is closing
+        return True
+
+    def _drain(self) -> None:
+        with self._outbox_lock:
+            batch, self._outbox = self._outbox, []
+        for frame, timestamp_us in batch:
+            self._write({**frame.to_json(), "ts_us": timestamp_us})
+
+    def _write(self, message: Dict[str, Any]) -> None:
+        self.wfile.write((json.dumps(message) + "\n").encode("utf-8"))
+        self.wfile.flush()
+
+
+class CANSocketServer(socketserver.ThreadingTCPServer):
+    """Local socket that lets test harnesses join a live :class:`CANBus`."""
+
+    allow_reuse_address = True
+    daemon_threads = True
+
+    def __init__(self, bus: CANBus, address: Tuple[str, int] = ("127.0.0.1", 0)) -> None:
+        if bus.clock is None:
+            raise ValueError("socket harnesses need a bus with a clock")
+        self.bus = bus
+        super().__init__(address, _CANSocketHandler)
+
+    def service_actions(self) -> None:
+        self.bus.poll()
+
+    def start(self) -> threading.Thread:
+        thread = threading.Thread(target=self.serve_forever, kwargs={"poll_interval": 0.005}, daemon=True)
+        thread.start()
+        return thread
+
+
+def live_bus(bitrate: int = 1_000_000) -> CANBus:
+    return CANBus(bitrate, clock=time.monotonic)
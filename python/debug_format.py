@@ -0,0 +1,703 @@
+#!/usr/bin/env python3
+"""Compact binary encoding for HSX debug/symbol information.
+
+``hld.py`` historically emitted debug metadata as an indented JSON ``.sym``
+file which every consumer parsed in full.  ``hsx.debug/1`` stores the same
+payload as a section table over a single buffer so readers can ``mmap`` the
+file and decode only the sections they touch:
+
+* ``STRS`` – NUL-terminated string table; offset 0 is the empty/``None`` string
+* ``META`` – compact JSON with the small top-level fields (crc, regions, ...)
+* ``FUNC`` – fixed-width function records
+* ``VARS`` – fixed-width global variable records
+* ``LABL`` – address/name pairs
+* ``LINE`` – DWARF-style line program, one row per instruction
+* ``INST`` – fixed-width per-row instruction metadata (word, mvasm line, ordinal)
+* ``LOCL`` – varint-coded locals with their location ranges
+* ``UNWD`` – varint-coded per-function unwind rows keyed by FUNC index
+
+:func:`load_symbol_payload` accepts either encoding and returns the JSON-shaped
+dictionary, so tooling that wants JSON can keep using it.  The executive and
+the debug adapter read :class:`DebugInfo` sections directly instead.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import mmap
+import struct
+from pathlib import Path
+from typing import Any, Dict, Iterable, Iterator, List, Mapping, Optional, Tuple, Union
+
+DEBUG_FORMAT_VERSION = "hsx.debug/1"
+DEBUG_MAGIC = b"HSXD"
+DEBUG_VERSION = 1
+
+_HEADER = struct.Struct(">4sHHI")
+_SECTION = struct.Struct(">4sII")
+_COUNT = struct.Struct(">I")
+_FUNC = struct.Struct(">IIIIII")
+_VAR = struct.Struct(">IIIII")
+_LABEL = struct.Struct(">II")
+_INST = struct.Struct(">III")
+
+_NONE = 0xFFFFFFFF
+
+# Line program opcodes.  Every opcode except ROW updates state; ROW advances
+# the PC by its operand and emits one instruction row.
+_OP_ROW = 0
+_OP_FILE = 1
+_OP_DIR = 2
+_OP_FUNC = 3
+_OP_KIND = 4
+_OP_FILE_ID = 5
+_OP_COLUMN = 6
+_OP_LINE = 7
+_OP_SIGNED = 8  # field opcode byte, then an svarint: a negative scalar operand
+
+_LINE_FIELDS = (
+    (_OP_FILE, "file", True),
+    (_OP_DIR, "directory", True),
+    (_OP_FUNC, "function", True),
+    (_OP_KIND, "source_kind", True),
+    (_OP_FILE_ID, "file_id", False),
+    (_OP_COLUMN, "column", False),
+)
+LINE_ROW_FIELDS = ("pc", "line") + tuple(name for _, name, _ in _LINE_FIELDS)
+
+
+def _put_uvarint(out: bytearray, value: int) -> None:
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _put_svarint(out: bytearray, value: int) -> None:
+    _put_uvarint(out, (value << 1) if value >= 0 else ((-value << 1) - 1))
+
+
+def _get_uvarint(buf: Union[bytes, memoryview], pos: int) -> Tuple[int, int]:
+    result = 0
+    shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        result |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return result, pos
+        shift += 7
+
+
+def _get_svarint(buf: Union[bytes, memoryview], pos: int) -> Tuple[int, int]:
+    raw, pos = _get_uvarint(buf, pos)
+    return ((raw >> 1) ^ -(raw & 1)), pos
+
+
+def _opt_int(value: Any) -> int:
+    """Encode an optional non-negative int as ``value + 1`` (0 == None)."""
+
+    if value is None:
+        return 0
+    return int(value) + 1
+
+
+def _from_opt(value: int) -> Optional[int]:
+    return None if value == 0 else value - 1
+
+
+def _scalar_code(strings: "_StringTable", value: Any) -> int:
+    """Tag a line-program operand: 0 None, odd ints, even string offsets.
+
+    Only non-negative ints fit the odd codes; the encoder emits negative ones
+    through ``_OP_SIGNED`` instead.
+    """
+
+    if value is None:
+        return 0
+    if isinstance(value, int) and value >= 0:
+        return (value << 1) | 1
+    return (strings.add(value) << 1) + 2
+
+
+def _fixed(value: Any) -> int:
+    if value is None:
+        return _NONE
+    return int(value) & 0xFFFFFFFF
+
+
+def _unfixed(value: int) -> Optional[int]:
+    return None if value == _NONE else value
+
+
+class _StringTable:
+    def __init__(self) -> None:
+        self.blob = bytearray(b"\x00")
+        self.offsets: Dict[str, int] = {}
+
+    def add(self, text: Any) -> int:
+        if text is None:
+            return 0
+        text = str(text)
+        if not text:
+            return 0
+        offset = self.offsets.get(text)
+        if offset is None:
+            encoded = text.encode("utf-8")
+            if b"\x00" in encoded:
+                raise ValueError("debug strings may not contain NUL")
+            offset = len(self.blob)
+            self.blob.extend(encoded)
+            self.blob.append(0)
+            self.offsets[text] = offset
+        return offset
+
+
+def _encode_unwind(strings: _StringTable, functions: List[Mapping[str, Any]]) -> bytes:
+    described = [(idx, fn["unwind"]) for idx, fn in enumerate(functions) if isinstance(fn.get("unwind"), Mapping)]
+    blob = bytearray()
+    _put_uvarint(blob, len(described))
+    for idx, unwind in described:
+        _put_uvarint(blob, idx)
+        _put_uvarint(blob, int(unwind.get("frame_size") or 0))
+        _put_uvarint(blob, strings.add(unwind.get("return_address")))
+        saved_registers = list(unwind.get("saved_registers") or [])
+        _put_uvarint(blob, len(saved_registers))
+        for reg in saved_registers:
+            _put_uvarint(blob, strings.add(reg))
+        rows = list(unwind.get("rows") or [])
+        _put_uvarint(blob, len(rows))
+        for row in rows:
+            start = int(row["start"])
+            _put_uvarint(blob, start)
+            _put_uvarint(blob, int(row["end"]) - start)
+            _put_uvarint(blob, strings.add(row.get("cfa_reg")))
+            _put_svarint(blob, int(row.get("cfa_offset", 0)))
+            _put_svarint(blob, int(row.get("ra_offset", 0)))
+            saved = row.get("saved") or {}
+            _put_uvarint(blob, len(saved))
+            for reg, offset in saved.items():
+                _put_uvarint(blob, strings.add(reg))
+                _put_svarint(blob, int(offset))
+    return bytes(blob)
+
+
+def _symbols_block(payload: Mapping[str, Any]) -> Mapping[str, Any]:
+    block = payload.get("symbols")
+    return block if isinstance(block, Mapping) else {}
+
+
+def encode_debug_info(payload: Mapping[str, Any]) -> bytes:
+    """Encode a ``hld`` symbol payload dictionary as ``hsx.debug/1`` bytes."""
+
+    strings = _StringTable()
+    symbols = _symbols_block(payload)
+    sections: List[Tuple[bytes, bytes]] = []
+
+    meta = {
+        key: value
+        for key, value in payload.items()
+        if key not in {"symbols", "instructions"}
+    }
+    sections.append((b"META", json.dumps(meta, separators=(",", ":"), sort_keys=True).encode("utf-8")))
+
+    # DebugInfo.function_at bisects FUNC by start address.
+    functions = sorted(symbols.get("functions") or [], key=lambda fn: _fixed(fn.get("address")))
+    func_blob = bytearray(_COUNT.pack(len(functions)))
+    for fn in functions:
+        func_blob += _FUNC.pack(
+            strings.add(fn.get("name")),
+            strings.add(fn.get("linkage_name")),
+            _fixed(fn.get("address")),
+            _fixed(fn.get("size")),
+            strings.add(fn.get("file")),
+            _fixed(fn.get("line")),
+        )
+    sections.append((b"FUNC", bytes(func_blob)))
+    sections.append((b"UNWD", _encode_unwind(strings, functions)))
+
+    variables = list(symbols.get("variables") or [])
+    var_blob = bytearray(_COUNT.pack(len(variables)))
+    for var in variables:
+        var_blob += _VAR.pack(
+            strings.add(var.get("name")),
+            _fixed(var.get("address")),
+            _fixed(var.get("size")),
+            strings.add(var.get("scope")),
+            strings.add(var.get("type")),
+        )
+    sections.append((b"VARS", bytes(var_blob)))
+
+    labels = symbols.get("labels") or {}
+    label_rows: List[Tuple[int, int]] = []
+    for key, names in labels.items():
+        address = int(key, 0) if isinstance(key, str) else int(key)
+        for name in names or []:
+            label_rows.append((address & 0xFFFFFFFF, strings.add(name)))
+    label_blob = bytearray(_COUNT.pack(len(label_rows)))
+    for row in label_rows:
+        label_blob += _LABEL.pack(*row)
+    sections.append((b"LABL", bytes(label_blob)))
+
+    instructions = sorted(payload.get("instructions") or [], key=lambda item: int(item.get("pc", 0)))
+    program = bytearray()
+    inst_blob = bytearray(_COUNT.pack(len(instructions)))
+    state: Dict[str, Any] = {name: None for _, name, _ in _LINE_FIELDS}
+    state["line"] = None
+    pc = 0
+    for inst in instructions:
+        for opcode, name, is_string in _LINE_FIELDS:
+            value = inst.get(name)
+            if value != state[name]:
+                if not is_string and isinstance(value, int) and value < 0:
+                    program += bytes((_OP_SIGNED, opcode))
+                    _put_svarint(program, value)
+                else:
+                    program.append(opcode)
+                    _put_uvarint(program, strings.add(value) if is_string else _scalar_code(strings, value))
+                state[name] = value
+        line = inst.get("line")
+        if line != state["line"]:
+            program.append(_OP_LINE)
+            if line is None:
+                _put_svarint(program, 0)
+                program.append(0)
+            else:
+                _put_svarint(program, int(line) - int(state["line"] or 0))
+                program.append(1)
+            state["line"] = line
+        new_pc = int(inst.get("pc", 0)) & 0xFFFFFFFF
+        if new_pc < pc:
+            raise ValueError("instruction rows must be sorted by pc")
+        program.append(_OP_ROW)
+        _put_uvarint(program, new_pc - pc)
+        pc = new_pc
+        inst_blob += _INST.pack(
+            int(inst.get("word") or 0) & 0xFFFFFFFF,
+            _fixed(inst.get("mvasm_line")),
+            _fixed(inst.get("ordinal")),
+        )
+    sections.append((b"LINE", _COUNT.pack(len(instructions)) + bytes(program)))
+    sections.append((b"INST", bytes(inst_blob)))
+
+    local_entries = list(symbols.get("locals") or [])
+    local_blob = bytearray()
+    _put_uvarint(local_blob, len(local_entries))
+    for entry in local_entries:
+        for key in ("name", "function", "file", "directory", "scope"):
+            _put_uvarint(local_blob, strings.add(entry.get(key)))
+        _put_uvarint(local_blob, _opt_int(entry.get("line")))
+        locations = list(entry.get("locations") or [])
+        _put_uvarint(local_blob, len(locations))
+        for loc in locations:
+            _put_uvarint(local_blob, _opt_int(loc.get("start")))
+            _put_uvarint(local_blob, _opt_int(loc.get("end")))
+            desc = loc.get("location")
+            text = json.dumps(desc, separators=(",", ":"), sort_keys=True) if desc is not None else None
+            _put_uvarint(local_blob, strings.add(text))
+    sections.append((b"LOCL", bytes(local_blob)))
+
+    sections.insert(0, (b"STRS", bytes(strings.blob)))
+
+    header_len = _HEADER.size + _SECTION.size * len(sections)
+    out = bytearray(_HEADER.pack(DEBUG_MAGIC, DEBUG_VERSION, len(sections), 0))
+    offset = header_len
+    for tag, blob in sections:
+        out += _SECTION.pack(tag, offset, len(blob))
+        offset += len(blob)
+    for _, blob in sections:
+        out += blob
+    return bytes(out)
+
+
+def write_debug_info(path: Union[str, Path], payload: Mapping[str, Any]) -> int:
+    data = encode_debug_info(payload)
+    Path(path).write_bytes(data)
+    return len(data)
+
+
+def is_debug_info(path: Union[str, Path]) -> bool:
+    try:
+        with open(path, "rb") as handle:
+            return handle.read(len(DEBUG_MAGIC)) == DEBUG_MAGIC
+    except OSError:
+        return False
+
+
+class DebugInfo:
+    """Lazily decoded view over an ``hsx.debug/1`` buffer.
+
+    Sections are located from the header on construction; their contents are
+    decoded on first access and cached.  :meth:`open` maps the file instead of
+    reading it.
+    """
+
+    def __init__(self, data: Union[bytes, bytearray, memoryview, mmap.mmap], *, path: Optional[str] = None) -> None:
+        if isinstance(data, memoryview):
+            data = data.tobytes()
+        self._data = data
+        self._view = memoryview(data)
+        self.path = path
+        self._handle = None
+        if len(self._view) < _HEADER.size:
+            raise ValueError("debug info truncated")
+        magic, version, count, _flags = _HEADER.unpack_from(self._view, 0)
+        if magic != DEBUG_MAGIC:
+            raise ValueError("not an hsx.debug file")
+        if version != DEBUG_VERSION:
+            raise ValueError(f"unsupported debug info version {version}")
+        self.sections: Dict[str, Tuple[int, int]] = {}
+        for idx in range(count):
+            tag, offset, length = _SECTION.unpack_from(self._view, _HEADER.size + idx * _SECTION.size)
+            if offset + length > len(self._view):
+                raise ValueError(f"section {tag!r} exceeds file size")
+            self.sections[tag.decode("ascii")] = (offset, length)
+        self._cache: Dict[str, Any] = {}
+        self._strings: Dict[int, Optional[str]] = {0: None}
+
+    @classmethod
+    def open(cls, path: Union[str, Path]) -> "DebugInfo":
+        handle = open(path, "rb")
+        try:
+            mapped = mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ)
+        except ValueError:
+            handle.close()
+            raise ValueError("debug info file is empty")
+        info = cls(mapped, path=str(path))
+        info._handle = handle
+        return info
+
+    def close(self) -> None:
+        self._cache.clear()
+        self._view.release()
+        if isinstance(self._data, mmap.mmap):
+            self._data.close()
+        if self._handle is not None:
+            self._handle.close()
+            self._handle = None
+
+    def __enter__(self) -> "DebugInfo":
+        return self
+
+    def __exit__(self, *exc: Any) -> None:
+        self.close()
+
+    def _section(self, tag: str) -> memoryview:
+        location = self.sections.get(tag)
+        if location is None:
+            return self._view[0:0]
+        offset, length = location
+        return self._view[offset : offset + length]
+
+    def string(self, offset: int) -> Optional[str]:
+        cached = self._strings.get(offset, False)
+        if cached is not False:
+            return cached
+        start, length = self.sections["STRS"]
+        end = self._data.find(b"\x00", start + offset, start + length)
+        if end < 0:
+            raise ValueError("unterminated debug string")
+        text = bytes(self._view[start + offset : end]).decode("utf-8")
+        self._strings[offset] = text
+        return text
+
+    def meta(self) -> Dict[str, Any]:
+        if "META" not in self._cache:
+            raw = bytes(self._section("META"))
+            self._cache["META"] = json.loads(raw.decode("utf-8")) if raw else {}
+        return self._cache["META"]
+
+    def functions(self) -> List[Dict[str, Any]]:
+        if "FUNC" not in self._cache:
+            blob = self._section("FUNC")
+            rows = []
+            if blob:
+                (count,) = _COUNT.unpack_from(blob, 0)
+                unwind = self.unwind()
+                for idx, (name, linkage, address, size, file_off, line) in enumerate(
+                    _FUNC.iter_unpack(blob[_COUNT.size : _COUNT.size + count * _FUNC.size])
+                ):
+                    row = {
+                        "name": self.string(name),
+                        "linkage_name": self.string(linkage),
+                        "address": address,
+                        "size": _unfixed(size),
+                        "file": self.string(file_off),
+                        "line": _unfixed(line),
+                    }
+                    if idx in unwind:
+                        row["unwind"] = unwind[idx]
+                    rows.append(row)
+            self._cache["FUNC"] = rows
+        return self._cache["FUNC"]
+
+    def function_at(self, address: int) -> Optional[Dict[str, Any]]:
+        """Bisect the fixed-width FUNC records without decoding the section."""
+
+        blob = self._section("FUNC")
+        if not blob:
+            return None
+        (count,) = _COUNT.unpack_from(blob, 0)
+        lo, hi = 0, count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            start = _FUNC.unpack_from(blob, _COUNT.size + mid * _FUNC.size)[2]
+            if start <= address:
+                lo = mid + 1
+            else:
+                hi = mid
+        if lo == 0:
+            return None
+        name, linkage, start, size, file_off, line = _FUNC.unpack_from(blob, _COUNT.size + (lo - 1) * _FUNC.size)
+        if size != _NONE and address >= start + size:
+            return None
+        row = {
+            "name": self.string(name),
+            "linkage_name": self.string(linkage),
+            "address": start,
+            "size": _unfixed(size),
+            "file": self.string(file_off),
+            "line": _unfixed(line),
+        }
+        unwind = self.unwind().get(lo - 1)
+        if unwind is not None:
+            row["unwind"] = unwind
+        return row
+
+    def unwind(self) -> Dict[int, Dict[str, Any]]:
+        """Unwind tables keyed by FUNC record index."""
+
+        if "UNWD" in self._cache:
+            return self._cache["UNWD"]
+        blob = self._section("UNWD")
+        tables: Dict[int, Dict[str, Any]] = {}
+        if blob:
+            count, pos = _get_uvarint(blob, 0)
+            for _ in range(count):
+                idx, pos = _get_uvarint(blob, pos)
+                frame_size, pos = _get_uvarint(blob, pos)
+                raw, pos = _get_uvarint(blob, pos)
+                return_address = self.string(raw)
+                n_saved, pos = _get_uvarint(blob, pos)
+                saved_registers = []
+                for _ in range(n_saved):
+                    raw, pos = _get_uvarint(blob, pos)
+                    saved_registers.append(self.string(raw))
+                n_rows, pos = _get_uvarint(blob, pos)
+                rows = []
+                for _ in range(n_rows):
+                    start, pos = _get_uvarint(blob, pos)
+                    length, pos = _get_uvarint(blob, pos)
+                    raw, pos = _get_uvarint(blob, pos)
+                    cfa_offset, pos = _get_svarint(blob, pos)
+                    ra_offset, pos = _get_svarint(blob, pos)
+                    n_regs, pos = _get_uvarint(blob, pos)
+                    saved: Dict[str, int] = {}
+                    for _ in range(n_regs):
+                        reg, pos = _get_uvarint(blob, pos)
+                        offset, pos = _get_svarint(blob, pos)
+                        saved[self.string(reg) or ""] = offset
+                    rows.append(
+                        {
+                            "start": start,
+                            "end": start + length,
+                            "cfa_reg": self.string(raw),
+                            "cfa_offset": cfa_offset,
+                            "ra_offset": ra_offset,
+                            "saved": saved,
+                        }
+                    )
+                tables[idx] = {
+                    "frame_size": frame_size,
+                    "saved_registers": saved_registers,
+                    "return_address": return_address,
+                    "rows": rows,
+                }
+        self._cache["UNWD"] = tables
+        return tables
+
+    def variables(self) -> List[Dict[str, Any]]:
+        if "VARS" not in self._cache:
+            blob = self._section("VARS")
+            rows = []
+            if blob:
+                (count,) = _COUNT.unpack_from(blob, 0)
+                for name, address, size, scope, type_off in _VAR.iter_unpack(blob[_COUNT.size : _COUNT.size + count * _VAR.size]):
+                    rows.append(
+                        {
+                            "name": self.string(name),
+                            "address": address,
+                            "size": _unfixed(size),
+                            "scope": self.string(scope),
+                            "type": self.string(type_off),
+                        }
+                    )
+            self._cache["VARS"] = rows
+        return self._cache["VARS"]
+
+    def labels(self) -> Dict[str, List[str]]:
+        if "LABL" not in self._cache:
+            blob = self._section("LABL")
+            labels: Dict[str, List[str]] = {}
+            if blob:
+                (count,) = _COUNT.unpack_from(blob, 0)
+                for address, name in _LABEL.iter_unpack(blob[_COUNT.size : _COUNT.size + count * _LABEL.size]):
+                    labels.setdefault(f"0x{address:08X}", []).append(self.string(name) or "")
+            self._cache["LABL"] = labels
+        return self._cache["LABL"]
+
+    def instruction_count(self) -> int:
+        blob = self._section("INST")
+        return _COUNT.unpack_from(blob, 0)[0] if blob else 0
+
+    def line_rows(self) -> Iterator[Tuple[Any, ...]]:
+        """Run the line program, yielding one tuple per row in :data:`LINE_ROW_FIELDS` order.
+
+        Only ``LINE`` (and the strings it names) is read, so callers that map
+        PCs to source never decode the per-row ``INST`` metadata.
+        """
+
+        program = self._section("LINE")
+        if not program:
+            return
+        slots = {opcode: (idx, is_string) for idx, (opcode, _name, is_string) in enumerate(_LINE_FIELDS)}
+        state: List[Any] = [None] * len(_LINE_FIELDS)
+        line: Optional[int] = None
+        pc = 0
+        pos = _COUNT.size
+        end = len(program)
+        while pos < end:
+            opcode = program[pos]
+            pos += 1
+            if opcode == _OP_ROW:
+                delta, pos = _get_uvarint(program, pos)
+                pc += delta
+                yield (pc, line, *state)
+            elif opcode == _OP_LINE:
+                delta, pos = _get_svarint(program, pos)
+                present = program[pos]
+                pos += 1
+                line = ((line or 0) + delta) if present else None
+            elif opcode == _OP_SIGNED:
+                idx, _is_string = slots[program[pos]]
+                state[idx], pos = _get_svarint(program, pos + 1)
+            elif opcode in slots:
+                idx, is_string = slots[opcode]
+                raw, pos = _get_uvarint(program, pos)
+                if is_string:
+                    state[idx] = self.string(raw)
+                elif raw == 0:
+                    state[idx] = None
+                elif raw & 1:
+                    state[idx] = raw >> 1
+                else:
+                    state[idx] = self.string((raw - 2) >> 1)
+            else:
+                raise ValueError(f"bad line program opcode {opcode}")
+
+    def instructions(self) -> List[Dict[str, Any]]:
+        """Join the line program rows with the per-row metadata."""
+
+        if "LINE" in self._cache:
+            return self._cache["LINE"]
+        meta = self._section("INST")
+        meta_rows = _INST.iter_unpack(meta[_COUNT.size : _COUNT.size + self.instruction_count() * _INST.size])
+        names = LINE_ROW_FIELDS[2:]
+        rows: List[Dict[str, Any]] = []
+        for (pc, line, *fields), (word, mvasm_line, ordinal) in zip(self.line_rows(), meta_rows):
+            row: Dict[str, Any] = {
+                "pc": pc,
+                "word": word,
+                "mvasm_line": _unfixed(mvasm_line),
+                "ordinal": _unfixed(ordinal),
+            }
+            for name, value in zip(names, fields):
+                if value is not None:
+                    row[name] = value
+            if line is not None:
+                row["line"] = line
+            rows.append(row)
+        self._cache["LINE"] = rows
+        return rows
+
+    def locals(self) -> List[Dict[str, Any]]:
+        if "LOCL" in self._cache:
+            return self._cache["LOCL"]
+        blob = self._section("LOCL")
+        entries: List[Dict[str, Any]] = []
+        if blob:
+            count, pos = _get_uvarint(blob, 0)
+            for _ in range(count):
+                entry: Dict[str, Any] = {}
+                for key in ("name", "function", "file", "directory", "scope"):
+                    raw, pos = _get_uvarint(blob, pos)
+                    entry[key] = self.string(raw)
+                raw, pos = _get_uvarint(blob, pos)
+                entry["line"] = _from_opt(raw)
+                n_locations, pos = _get_uvarint(blob, pos)
+                locations = []
+                for _ in range(n_locations):
+                    start, pos = _get_uvarint(blob, pos)
+                    stop, pos = _get_uvarint(blob, pos)
+                    raw, pos = _get_uvarint(blob, pos)
+                    text = self.string(raw)
+                    locations.append(
+                        {
+                            "start": _from_opt(start),
+                            "end": _from_opt(stop),
+                            "location": json.loads(text) if text is not None else None,
+                        }
+                    )
+                entry["locations"] = locations
+                entries.append(entry)
+        self._cache["LOCL"] = entries
+        return entries
+
+    def to_payload(self) -> Dict[str, Any]:
+        """Rebuild the JSON-shaped ``.sym`` payload."""
+
+        payload = dict(self.meta())
+        payload["symbols"] = {
+            "functions": self.functions(),
+            "variables": self.variables(),
+            "locals": self.locals(),
+            "labels": self.labels(),
+        }
+        payload["instructions"] = self.instructions()
+        return payload
+
+
+def load_symbol_payload(path: Union[str, Path]) -> Dict[str, Any]:
+    """Return the symbol payload from either a JSON or ``hsx.debug/1`` file."""
+
+    path = Path(path)
+    if is_debug_info(path):
+        with DebugInfo.open(path) as info:
+            return info.to_payload()
+    return json.loads(path.read_text(encoding="utf-8"))
+
+
+def main(argv: Optional[Iterable[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="Convert HSX symbol files between JSON and hsx.debug/1")
+    parser.add_argument("input", help="JSON .sym or binary hsx.debug file")
+    parser.add_argument("--json", dest="json_out", help="write a JSON export")
+    parser.add_argument("--binary", dest="binary_out", help="write an hsx.debug/1 encoding")
+    args = parser.parse_args(list(argv) if argv is not None else None)
+    payload = load_symbol_payload(args.input)
+    if args.json_out:
+        Path(args.json_out).write_text(json.dumps(payload, indent=2, sort_keys=True))
+    if args.binary_out:
+        size = write_debug_info(args.binary_out, payload)
+        print(f"Wrote {args.binary_out} ({size} bytes)")
+    if not args.json_out and not args.binary_out:
+        info = {
+            "functions": len(payload.get("symbols", {}).get("functions", [])),
+            "instructions": len(payload.get("instructions", [])),
+        }
+        print(json.dumps(info))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
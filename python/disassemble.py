@@ -15,6 +15,7 @@ if str(MODULE_DIR) not in sys.path:
     sys.path.insert(0, str(MODULE_DIR))
 
 from disasm_util import OPCODE_NAMES, format_operands, instruction_size
+from trace_format import TraceFileReader
 from platforms.python.host_vm import HEADER, HEADER_FIELDS, HSX_MAGIC
 
 
@@ -165,6 +166,22 @@ def annotate(listing, symbols):
             inst['target'] = addr_to_label[imm]
 
 
+def annotate_trace(listing, trace_path: Path, pid: Optional[int] = None) -> int:
+    """Attach per-PC execution counts streamed from an hsx.tracefile/1 capture."""
+    counts: Dict[int, int] = {}
+    total = 0
+    with TraceFileReader(trace_path) as reader:
+        for record in reader.iter_records(pid=pid):
+            pc = record['pc'] & 0xFFFF
+            counts[pc] = counts.get(pc, 0) + 1
+            total += 1
+    for inst in listing:
+        hits = counts.get(inst['pc'])
+        if hits:
+            inst['hits'] = hits
+    return total
+
+
 def print_listing(header, listing, symbols, rodata):
     labels_text = symbols.get('labels_text', {})
     print(f"; entry=0x{header['entry']:08X} code_len={header['code_len']} ro_len={header['ro_len']}")
@@ -174,7 +191,8 @@ def print_listing(header, listing, symbols, rodata):
         target = f" -> {inst['target']}" if 'target' in inst else ''
         operands = inst.get('operands') or ''
         spacing = f" {operands}" if operands else ''
-        print(f"  0x{inst['pc']:04X}: 0x{inst['word']:08X} {inst['mnemonic']}{spacing}{target}")
+        hits = f"  ; hits={inst['hits']}" if 'hits' in inst else ''
+        print(f"  0x{inst['pc']:04X}: 0x{inst['word']:08X} {inst['mnemonic']}{spacing}{target}{hits}")
     if rodata:
         print()
         print('; rodata')
@@ -195,6 +213,8 @@ def main() -> None:
     ap = argparse.ArgumentParser(description='HSX disassembler prototype')
     ap.add_argument('hxe', type=Path, help='.hxe file to disassemble')
     ap.add_argument('--mvasm', type=Path, help='optional .mvasm file for labels')
+    ap.add_argument('--trace', type=Path, help='hsx.tracefile/1 capture used to annotate per-instruction hit counts')
+    ap.add_argument('--trace-pid', type=int, help='only count trace records for this pid')
     ap.add_argument('-o', '--output', type=Path, help='write JSON output instead of text')
     args = ap.parse_args()
 
@@ -204,6 +224,8 @@ def main() -> None:
     if args.mvasm and args.mvasm.exists():
         symbols = parse_mvasm(args.mvasm)
         annotate(listing, symbols)
+    if args.trace:
+        annotate_trace(listing, args.trace, pid=args.trace_pid)
 
     if args.output:
         args.output.write_text(json.dumps({'header': header, 'instructions': listing, 'symbols': symbols}, indent=2))
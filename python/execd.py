@@ -18,6 +18,18 @@ try:
     from . import trace_format
 except ImportError:
     import trace_format
+try:
+    from . import debug_format
+except ImportError:
+    import debug_format
+try:
+    from . import profiler as hsx_profiler
+except ImportError:
+    import profiler as hsx_profiler
+try:
+    from . import pc_counters
+except ImportError:
+    import pc_counters
 try:
     from .valcmd import f16_to_float, float_to_f16
 except ImportError:
@@ -42,16 +54,20 @@ import bisect
 import heapq
 import json
 import os
+import selectors
+import socket
 import socketserver
 import threading
 import time
 import sys
 import uuid
-from collections import deque
+from collections import OrderedDict, deque
+from concurrent.futures import ThreadPoolExecutor
 from dataclasses import dataclass, field
 from enum import Enum
 from pathlib import Path
-from typing import Any, Dict, Optional, List, Iterable, Deque, Set, Tuple, Mapping
+from types import MappingProxyType
+from typing import Any, Callable, Dict, Optional, List, Iterable, Deque, Set, Tuple, Mapping
 
 
 class SessionError(RuntimeError):
@@ -179,6 +195,11 @@ class SessionRecord:
     last_seen: float = field(default_factory=time.time)
 
 
+# High-rate event types that credit-starved subscriptions receive as per-interval
+# counts instead of individual events.
+CREDIT_SUMMARISED_EVENTS = frozenset({"trace_step", "scheduler"})
+
+
 @dataclass
 class EventSubscription:
     token: str
@@ -200,6 +221,20 @@ class EventSubscription:
     created_at: float = field(default_factory=time.time)
     active: bool = True
     since_seq: Optional[int] = None
+    notify: Optional[Callable[[], None]] = None
+    # Credit-based flow control: at most ``credits`` unacked events in flight.
+    credits: Optional[int] = None
+    inflight: Deque[int] = field(default_factory=deque)
+    held: Deque[Dict[str, Any]] = field(default_factory=deque)
+    suppressed: Dict[str, int] = field(default_factory=dict)
+    suppressed_since: float = 0.0
+
+    def wake(self) -> None:
+        """Wake blocked readers and the owning server's event loop, if any."""
+
+        self.condition.notify_all()
+        if self.notify is not None:
+            self.notify()
 
     def matches(self, event: Dict[str, Any]) -> bool:
         if self.pids is not None:
@@ -215,6 +250,92 @@ class EventSubscription:
     def pending(self) -> int:
         return max(0, self.delivered_seq - self.last_ack)
 
+    def has_credit(self) -> bool:
+        return self.credits is None or len(self.inflight) < self.credits
+
+    def suppress(self, event_type: str) -> None:
+        if not self.suppressed:
+            self.suppressed_since = time.time()
+        self.suppressed[event_type] = self.suppressed.get(event_type, 0) + 1
+
+
+@dataclass(frozen=True)
+class SymbolIndex:
+    """Immutable sorted lookup tables compiled once per loaded symbol file."""
+
+    addr_keys: Tuple[int, ...] = ()
+    addr_entries: Tuple[Dict[str, Any], ...] = ()
+    func_starts: Tuple[int, ...] = ()
+    func_ends: Tuple[int, ...] = ()
+    func_entries: Tuple[Dict[str, Any], ...] = ()
+    line_keys: Tuple[int, ...] = ()
+    line_entries: Tuple[Dict[str, Any], ...] = ()
+    # Exact-PC lookups stay O(1); only range queries bisect.
+    instr_by_pc: Mapping[int, Dict[str, Any]] = field(default_factory=lambda: MappingProxyType({}))
+
+    @classmethod
+    def build(
+        cls,
+        addresses: Iterable[Dict[str, Any]],
+        lines: Iterable[Dict[str, Any]],
+        instructions: Iterable[Dict[str, Any]],
+    ) -> "SymbolIndex":
+        symbols = sorted(
+            (entry for entry in addresses if isinstance(entry, dict)),
+            key=lambda item: int(item.get("address") or 0),
+        )
+        functions = [
+            entry for entry in symbols if str(entry.get("type") or "").lower() in {"function", "func", "text"}
+        ]
+        func_ends: List[int] = []
+        for idx, entry in enumerate(functions):
+            start = int(entry.get("address") or 0)
+            size = entry.get("size")
+            if isinstance(size, int) and size > 0:
+                end = start + size
+            elif idx + 1 < len(functions):
+                end = int(functions[idx + 1].get("address") or 0)
+            else:
+                end = 0x1_0000_0000
+            func_ends.append(max(end, start + 1))
+        line_list = sorted(
+            (entry for entry in lines if isinstance(entry, dict)),
+            key=lambda item: int(item.get("address") or 0),
+        )
+        return cls(
+            addr_keys=tuple(int(entry.get("address") or 0) for entry in symbols),
+            addr_entries=tuple(symbols),
+            func_starts=tuple(int(entry.get("address") or 0) for entry in functions),
+            func_ends=tuple(func_ends),
+            func_entries=tuple(functions),
+            line_keys=tuple(int(entry.get("address") or 0) for entry in line_list),
+            line_entries=tuple(line_list),
+            instr_by_pc=MappingProxyType(
+                {
+                    int(entry.get("pc") or 0) & 0xFFFFFFFF: entry
+                    for entry in instructions
+                    if isinstance(entry, dict)
+                }
+            ),
+        )
+
+    def symbol_at(self, address: int) -> Optional[Dict[str, Any]]:
+        idx = bisect.bisect_right(self.addr_keys, address) - 1
+        return self.addr_entries[idx] if idx >= 0 else None
+
+    def function_at(self, address: int) -> Optional[Dict[str, Any]]:
+        idx = bisect.bisect_right(self.func_starts, address) - 1
+        if idx < 0 or address >= self.func_ends[idx]:
+            return None
+        return self.func_entries[idx]
+
+    def line_at(self, address: int) -> Optional[Dict[str, Any]]:
+        idx = bisect.bisect_right(self.line_keys, address) - 1
+        return self.line_entries[idx] if idx >= 0 else None
+
+    def instruction_at(self, pc: int) -> Optional[Dict[str, Any]]:
+        return self.instr_by_pc.get(pc)
+
 
 
 RODATA_BASE = 0x4000
@@ -261,7 +382,9 @@ class ExecutiveState:
         self.session_supported_features = {"events", "stack", "disasm", "symbols", "memory", "watch"}
         self.debug_attached: Set[int] = set()
         self.breakpoints: Dict[int, Set[int]] = {}
+        self.breakpoint_conditions: Dict[int, Dict[int, Dict[str, Any]]] = {}
         self.event_lock = threading.RLock()
+        self._vm_event_filter: Optional[Dict[str, Optional[List[int]]]] = None
         self.event_seq = 1
         self.event_history: Deque[Dict[str, Any]] = deque(maxlen=4096)
         self.event_subscriptions: Dict[str, EventSubscription] = {}
@@ -274,7 +397,8 @@ class ExecutiveState:
         self.event_backpressure_grace = 1.0
         self.event_slow_warning_interval = 0.5
         self.symbol_tables: Dict[int, Dict[str, Any]] = {}
-        self.disasm_cache: Dict[int, Dict[Tuple[int, int], Dict[str, Any]]] = {}
+        # pid -> decoded image: {"image", "symbols", "seq", "entries": {addr: entry}, "stats"}
+        self.disasm_cache: Dict[int, Dict[str, Any]] = {}
         self.memory_layouts: Dict[int, Dict[str, int]] = {}
         self.image_metadata: Dict[int, Dict[str, Any]] = {}
         self.value_registry: Dict[int, Dict[Tuple[int, int], Dict[str, Any]]] = {}
@@ -283,15 +407,22 @@ class ExecutiveState:
         self.watchers: Dict[int, Dict[int, Dict[str, Any]]] = {}
         self._next_watch_id = 1
         self.task_state_pending: Dict[int, Dict[str, Any]] = {}
+        self.task_delta_seq: Optional[int] = None
+        self.task_delta_stats: Dict[str, int] = {"batches": 0, "applied": 0, "resyncs": 0}
         self.trace_last_regs: Dict[int, Dict[str, Any]] = {}
         self.trace_track_changed_regs = True
         self.trace_lock = threading.RLock()
         self.trace_buffer_capacity = 256
         self.trace_buffer_max = 4096
         self.trace_buffers: Dict[int, Deque[Dict[str, Any]]] = {}
+        self.trace_spills: Dict[int, trace_format.TraceFileWriter] = {}
+        self._spill_traced: Set[int] = set()  # PIDs whose VM tracing a spill turned on
         self._trace_seq = 1
+        self.mem_dirty_seq: Dict[int, int] = {}
+        self.mem_dirty_stamps: Dict[int, Dict[int, int]] = {}
         self.symbol_cache_lock = threading.RLock()
         self.default_stack_frames = 16
+        self.unwind_snapshot_bytes = 0x1000
         self.last_state_transition: Dict[int, Dict[str, Any]] = {}
         self.sleeping_heap: List[Tuple[float, int]] = []
         self.sleeping_deadlines: Dict[int, float] = {}
@@ -904,6 +1035,7 @@ class ExecutiveState:
             pass
         self.debug_attached.discard(pid)
         self.breakpoints.pop(pid, None)
+        self.breakpoint_conditions.pop(pid, None)
 
     def _extract_breakpoints(self, pid: int, debug_block: Dict[str, Any]) -> List[int]:
         raw = debug_block.get("breakpoints") if isinstance(debug_block, dict) else []
@@ -915,8 +1047,36 @@ class ExecutiveState:
                 except (TypeError, ValueError):
                     continue
         self.breakpoints[pid] = set(result)
+        conditions: Dict[int, Dict[str, Any]] = {}
+        raw_conditions = debug_block.get("conditions") if isinstance(debug_block, dict) else None
+        if isinstance(raw_conditions, list):
+            for item in raw_conditions:
+                if not isinstance(item, dict) or item.get("addr") is None:
+                    continue
+                try:
+                    conditions[self._coerce_int(item["addr"]) & 0xFFFF] = dict(item)
+                except (TypeError, ValueError):
+                    continue
+        if conditions:
+            self.breakpoint_conditions[pid] = conditions
+        else:
+            self.breakpoint_conditions.pop(pid, None)
         return sorted(result)
 
+    def _breakpoint_response(self, pid: int, breakpoints: List[int]) -> Dict[str, Any]:
+        info: Dict[str, Any] = {"pid": pid, "breakpoints": breakpoints}
+        conditions = self.breakpoint_conditions.get(pid)
+        if conditions:
+            info["conditions"] = [conditions[addr] for addr in sorted(conditions)]
+        return info
+
+    def _unconditional_breakpoints(self, pid: int) -> Set[int]:
+        """Breakpoints the executive enforces itself; conditional ones run in the VM."""
+
+        bp_set = self.breakpoints.get(pid) or set()
+        conditions = self.breakpoint_conditions.get(pid)
+        return bp_set - conditions.keys() if conditions else bp_set
+
     def breakpoint_list(self, pid: int) -> Dict[str, Any]:
         self.get_task(pid)
         self._ensure_debug_session(pid)
@@ -924,18 +1084,40 @@ class ExecutiveState:
         with self.lock:
             debug = self._vm_debug(payload)
         breakpoints = self._extract_breakpoints(pid, debug)
-        return {"pid": pid, "breakpoints": breakpoints}
+        return self._breakpoint_response(pid, breakpoints)
 
-    def breakpoint_add(self, pid: int, addr: int) -> Dict[str, Any]:
+    def breakpoint_add(
+        self,
+        pid: int,
+        addr: int,
+        *,
+        condition: Optional[str] = None,
+        hit_condition: Optional[str] = None,
+        log_message: Optional[str] = None,
+    ) -> Dict[str, Any]:
         self.get_task(pid)
         self._ensure_debug_session(pid)
         addr_int = self._coerce_int(addr) & 0xFFFF
-        payload = {"cmd": "dbg", "op": "bp", "pid": pid, "action": "add", "addr": addr_int}
+        payload: Dict[str, Any] = {"cmd": "dbg", "op": "bp", "pid": pid, "action": "add", "addr": addr_int}
+        if condition:
+            payload["condition"] = str(condition)
+        if hit_condition not in (None, ""):
+            payload["hit_condition"] = str(hit_condition)
+        if log_message is not None:
+            payload["log_message"] = str(log_message)
         with self.lock:
             debug = self._vm_debug(payload)
         breakpoints = self._extract_breakpoints(pid, debug)
-        self.log("info", "breakpoint added", pid=pid, addr=addr_int)
-        return {"pid": pid, "breakpoints": breakpoints}
+        self.log(
+            "info",
+            "breakpoint added",
+            pid=pid,
+            addr=addr_int,
+            condition=payload.get("condition"),
+            hit_condition=payload.get("hit_condition"),
+            log_message=payload.get("log_message"),
+        )
+        return self._breakpoint_response(pid, breakpoints)
 
     def breakpoint_clear(self, pid: int, addr: int) -> Dict[str, Any]:
         self.get_task(pid)
@@ -946,7 +1128,7 @@ class ExecutiveState:
             debug = self._vm_debug(payload)
         breakpoints = self._extract_breakpoints(pid, debug)
         self.log("info", "breakpoint removed", pid=pid, addr=addr_int)
-        return {"pid": pid, "breakpoints": breakpoints}
+        return self._breakpoint_response(pid, breakpoints)
 
     def breakpoint_clear_all(self, pid: int) -> Dict[str, Any]:
         # ensure session and current snapshot
@@ -987,7 +1169,7 @@ class ExecutiveState:
     def _check_breakpoint_before_step(self, pid: Optional[int]) -> Optional[Dict[str, Any]]:
         if pid is None:
             return None
-        bp_set = self.breakpoints.get(pid)
+        bp_set = self._unconditional_breakpoints(pid)
         if not bp_set:
             return None
         with self.lock:
@@ -1007,7 +1189,16 @@ class ExecutiveState:
             target_pid = current if isinstance(current, int) else None
         if target_pid is None:
             return None
-        bp_set = self.breakpoints.get(target_pid)
+        for event in result.get("events") or []:
+            if (
+                isinstance(event, dict)
+                and event.get("type") == "debug_stop"
+                and event.get("conditional")
+                and self._optional_int(event.get("pid")) in {target_pid, None}
+            ):
+                pc = self._optional_int(event.get("pc")) or 0
+                return self._handle_breakpoint_hit(target_pid, pc, phase="condition")
+        bp_set = self._unconditional_breakpoints(target_pid)
         if not bp_set:
             return None
         with self.lock:
@@ -1078,6 +1269,8 @@ class ExecutiveState:
                 "file": info.get("file") or info.get("source"),
                 "line": info.get("line"),
             }
+            if isinstance(info.get("unwind"), dict):
+                entry["unwind"] = info["unwind"]
             return entry
 
         if isinstance(data, dict):
@@ -1303,11 +1496,79 @@ class ExecutiveState:
         return locals_list, by_function
 
     def _parse_symbol_file(self, path: Path) -> Dict[str, Any]:
-        data = json.loads(path.read_text(encoding="utf-8"))
-        entries = self._extract_symbol_entries(data)
-        lines = self._extract_line_entries(data)
+        if debug_format.is_debug_info(path):
+            with debug_format.DebugInfo.open(path) as info:
+                return self._parse_debug_info(path, info)
+        data = debug_format.load_symbol_payload(path)
         instructions, instruction_lookup = self._extract_instruction_entries(data)
-        locals_entries, locals_by_function = self._extract_local_entries(data)
+        return self._symbol_table(
+            path,
+            self._extract_symbol_entries(data),
+            self._extract_line_entries(data),
+            instructions,
+            instruction_lookup,
+            *self._extract_local_entries(data),
+        )
+
+    def _parse_debug_info(self, path: Path, info: debug_format.DebugInfo) -> Dict[str, Any]:
+        """Build the symbol table from ``hsx.debug/1`` sections.
+
+        Only FUNC, VARS, LINE and LOCL are decoded; the INST metadata, labels
+        and META block are never touched on the attach path.
+        """
+
+        entries: List[Dict[str, Any]] = []
+        for rows, default_type in ((info.functions(), "function"), (info.variables(), "variable")):
+            for row in rows:
+                if not row.get("name"):
+                    continue
+                entry = {
+                    "name": row["name"],
+                    "address": int(row.get("address") or 0) & 0xFFFFFFFF,
+                    "size": row.get("size"),
+                    "type": row.get("type") or default_type,
+                    "file": row.get("file"),
+                    "line": row.get("line"),
+                }
+                if isinstance(row.get("unwind"), dict):
+                    entry["unwind"] = row["unwind"]
+                entries.append(entry)
+        lines: List[Dict[str, Any]] = []
+        instructions: List[Dict[str, Any]] = []
+        instruction_lookup: Dict[int, Dict[str, Any]] = {}
+        for pc, line, file, directory, function, source_kind, _file_id, column in info.line_rows():
+            entry = {
+                "pc": pc,
+                "source_kind": (source_kind or "").lower() or None,
+                "line": line,
+                "column": column,
+                "function": function,
+                "file": file,
+                "directory": directory,
+            }
+            instructions.append(entry)
+            instruction_lookup[pc] = entry
+            if line is not None:
+                lines.append({"address": pc, "file": file, "line": line})
+        return self._symbol_table(
+            path,
+            entries,
+            lines,
+            instructions,
+            instruction_lookup,
+            *self._extract_local_entries({"locals": info.locals()}),
+        )
+
+    @staticmethod
+    def _symbol_table(
+        path: Path,
+        entries: List[Dict[str, Any]],
+        lines: List[Dict[str, Any]],
+        instructions: List[Dict[str, Any]],
+        instruction_lookup: Dict[int, Dict[str, Any]],
+        locals_entries: List[Dict[str, Any]],
+        locals_by_function: Dict[str, List[Dict[str, Any]]],
+    ) -> Dict[str, Any]:
         by_name = {entry["name"]: entry for entry in entries if entry.get("name")}
         addresses = sorted(entries, key=lambda item: item.get("address", 0))
         line_index = sorted(lines, key=lambda item: item.get("address", 0))
@@ -1321,8 +1582,21 @@ class ExecutiveState:
             "locals_by_function": locals_by_function,
             "instructions": instructions,
             "instructions_by_pc": instruction_lookup,
+            "index": SymbolIndex.build(addresses, line_index, instructions),
         }
 
+    @staticmethod
+    def _symbol_index(table: Dict[str, Any]) -> SymbolIndex:
+        index = table.get("index")
+        if not isinstance(index, SymbolIndex):
+            instructions = table.get("instructions")
+            if not isinstance(instructions, list):
+                lookup = table.get("instructions_by_pc")
+                instructions = list(lookup.values()) if isinstance(lookup, dict) else []
+            index = SymbolIndex.build(table.get("addresses") or [], table.get("lines") or [], instructions)
+            table["index"] = index
+        return index
+
     def load_symbols_for_pid(
         self,
         pid: int,
@@ -1380,30 +1654,38 @@ class ExecutiveState:
             table = self.symbol_tables.get(pid)
             if not table:
                 return None
-            addr_list = table["addresses"]
-            if not addr_list:
+            index = self._symbol_index(table)
+            match = index.function_at(address) or index.symbol_at(address)
+            if match is None:
                 return None
-            addresses = [entry["address"] for entry in addr_list]
-            idx = bisect.bisect_right(addresses, address) - 1
-            if idx < 0:
-                return None
-            entry = dict(addr_list[idx])
+            entry = dict(match)
+            entry.pop("unwind", None)
             entry["offset"] = address - entry.get("address", 0)
             return entry
 
-    def symbol_lookup_line(self, pid: int, address: int) -> Optional[Dict[str, Any]]:
+    def _unwind_row(self, pid: int, pc: int) -> Optional[Dict[str, Any]]:
+        """Return the compiler-emitted unwind row covering ``pc``, if any."""
+
         with self.symbol_cache_lock:
             table = self.symbol_tables.get(pid)
             if not table:
                 return None
-            lines = table.get("lines", [])
-            if not lines:
-                return None
-            addresses = [item["address"] for item in lines]
-            idx = bisect.bisect_right(addresses, address) - 1
-            if idx < 0:
+            function = self._symbol_index(table).function_at(pc)
+        unwind = function.get("unwind") if function else None
+        if not isinstance(unwind, dict):
+            return None
+        for row in unwind.get("rows") or []:
+            if int(row.get("start", 0)) <= pc < int(row.get("end", 0)):
+                return row
+        return None
+
+    def symbol_lookup_line(self, pid: int, address: int) -> Optional[Dict[str, Any]]:
+        with self.symbol_cache_lock:
+            table = self.symbol_tables.get(pid)
+            if not table:
                 return None
-            return dict(lines[idx])
+            match = self._symbol_index(table).line_at(address)
+            return dict(match) if match is not None else None
 
     def symbols_list(
         self,
@@ -1779,10 +2061,7 @@ class ExecutiveState:
             table = self.symbol_tables.get(pid)
             if not table:
                 return None
-            lookup = table.get("instructions_by_pc")
-            if not isinstance(lookup, dict):
-                return None
-            return lookup.get(int(pc) & 0xFFFFFFFF)
+            return self._symbol_index(table).instruction_at(int(pc) & 0xFFFFFFFF)
 
     def _is_compiler_instruction(self, pid: Optional[int], pc: Optional[int]) -> bool:
         entry = self._instruction_entry(pid, pc)
@@ -2025,6 +2304,24 @@ class ExecutiveState:
             "imm_raw": imm_raw,
         }
 
+    _DISASM_UNSIGNED_OPS = frozenset({0x21, 0x22, 0x23, 0x30, 0x7F})
+
+    @classmethod
+    def _render_operands(cls, entry: Dict[str, Any], reg_values: Optional[List[int]]) -> str:
+        opcode = (entry["word"] >> 24) & 0xFF
+        imm_effective = entry["imm_raw"] if opcode in cls._DISASM_UNSIGNED_OPS else entry["imm"]
+        return disasm_util.format_operands(
+            entry["mnemonic"],
+            entry["rd"],
+            entry["rs1"],
+            entry["rs2"],
+            imm=imm_effective,
+            imm_raw=entry["imm_raw"],
+            reg_values=reg_values,
+            next_word=entry.get("extended_word"),
+            pc=entry["pc"],
+        )
+
     def _disassemble_bytes(
         self,
         pid: int,
@@ -2038,7 +2335,6 @@ class ExecutiveState:
         offset = 0
         truncated = False
         consumed = 0
-        unsigned_ops = {0x21, 0x22, 0x23, 0x30, 0x7F}
         data_len = len(data)
         for index in range(count):
             if offset + 4 > data_len:
@@ -2055,18 +2351,6 @@ class ExecutiveState:
                     truncated = True
                     break
                 next_word = int.from_bytes(data[offset + 4:offset + 8], "big")
-            imm_effective = decoded["imm_raw"] if opcode in unsigned_ops else decoded["imm"]
-            operands = disasm_util.format_operands(
-                mnemonic,
-                decoded["rd"],
-                decoded["rs1"],
-                decoded["rs2"],
-                imm=imm_effective,
-                imm_raw=decoded["imm_raw"],
-                reg_values=reg_values,
-                next_word=next_word,
-                pc=base_addr + offset,
-            )
             inst_addr = (base_addr + offset) & 0xFFFFFFFF
             entry: Dict[str, Any] = {
                 "index": index,
@@ -2079,12 +2363,13 @@ class ExecutiveState:
                 "rs2": decoded["rs2"],
                 "imm": decoded["imm"],
                 "imm_raw": decoded["imm_raw"],
-                "operands": operands,
                 "bytes": data[offset:offset + size].hex(),
             }
             if next_word is not None:
                 entry["extended_word"] = next_word
+            entry["operands"] = self._render_operands(entry, reg_values)
             if mnemonic in {"JMP", "JZ", "JNZ", "CALL"}:
+                imm_effective = decoded["imm_raw"] if opcode in self._DISASM_UNSIGNED_OPS else decoded["imm"]
                 target = imm_effective & 0xFFFFFFFF
                 entry["target"] = target
                 target_symbol = self.symbol_lookup_addr(pid, target)
@@ -2097,6 +2382,104 @@ class ExecutiveState:
             consumed = offset
         return listing, truncated, consumed
 
+    def _annotate_instructions(self, pid: int, instructions: List[Dict[str, Any]]) -> None:
+        for entry in instructions:
+            symbol = self.symbol_lookup_addr(pid, entry["pc"])
+            if symbol:
+                entry["symbol"] = dict(symbol)
+            line = self.symbol_lookup_line(pid, entry["pc"])
+            if line:
+                entry["line"] = dict(line)
+            offset = symbol.get("offset") if symbol else None
+            if symbol and (offset is None or offset == 0):
+                entry["label"] = symbol.get("name")
+
+    def _read_code_bytes(self, pid: int, address: int, length: int) -> bytes:
+        try:
+            with self.lock:
+                raw = self.vm.read_mem(address, length, pid=pid)
+        except Exception as exc:
+            raise ValueError(f"disassembly memory read failed: {exc}") from exc
+        if isinstance(raw, str):
+            try:
+                return bytes.fromhex(raw)
+            except ValueError:
+                return raw.encode("utf-8", errors="ignore")
+        if isinstance(raw, (bytes, bytearray)):
+            return bytes(raw)
+        raise ValueError("unexpected memory payload from VM")
+
+    def _disasm_image(self, pid: int) -> Dict[str, Any]:
+        """Return the decoded-instruction cache for ``pid``'s current image.
+
+        The cache is keyed by image (program plus symbol table, which the
+        annotations depend on) and instruction address.  Entries are dropped
+        only when the VM reports writes to the bytes they were decoded from.
+        """
+
+        task = self.tasks.get(pid) or {}
+        with self.symbol_cache_lock:
+            symbols = self.symbol_tables.get(pid)
+        image_key = task.get("program")
+        image = self.disasm_cache.get(pid)
+        if image is None or image["image"] != image_key or image["symbols"] is not symbols:
+            seq = self.mem_dirty_seq.get(pid, 0)
+            image = {
+                "image": image_key,
+                "symbols": symbols,
+                "seq": seq,
+                "entries": {},
+                "stats": {"hits": 0, "decoded": 0, "invalidated": 0},
+            }
+            self.disasm_cache[pid] = image
+        try:
+            dirty = self.mem_dirty(pid, since=image["seq"])
+        except (AttributeError, RuntimeError, NotImplementedError):
+            # VM without dirty tracking: keep entries until reload/kill.
+            return image
+        image["seq"] = int(dirty.get("seq", image["seq"]))
+        entries = image["entries"]
+        if entries:
+            for addr, length in dirty.get("ranges") or []:
+                addr = int(addr)
+                end_addr = addr + int(length)
+                # An 8-byte LDI32 starting just before the range still overlaps it.
+                for candidate in range((addr - 4) & ~0x3, end_addr, 4):
+                    entry = entries.get(candidate)
+                    if entry is not None and candidate + entry["size"] > addr:
+                        del entries[candidate]
+                        image["stats"]["invalidated"] += 1
+        return image
+
+    def _disasm_cached(self, pid: int, start_addr: int, count: int) -> Tuple[List[Dict[str, Any]], bool, int]:
+        """Serve ``count`` instructions from the image cache, decoding only the misses."""
+
+        image = self._disasm_image(pid)
+        entries = image["entries"]
+        listing: List[Dict[str, Any]] = []
+        addr = start_addr
+        truncated = False
+        decoded = 0
+        while len(listing) < count:
+            entry = entries.get(addr)
+            if entry is None:
+                remaining = count - len(listing)
+                raw = self._read_code_bytes(pid, addr, min(remaining * 8, 4096))
+                fresh, truncated, _ = self._disassemble_bytes(pid, raw, addr, remaining)
+                self._annotate_instructions(pid, fresh)
+                for item in fresh:
+                    item.pop("index", None)
+                    item.pop("operands", None)
+                    entries[item["pc"]] = item
+                decoded += len(fresh)
+                listing.extend(fresh)
+                break
+            listing.append(entry)
+            addr = (addr + entry["size"]) & 0xFFFFFFFF
+        image["stats"]["hits"] += len(listing) - decoded
+        image["stats"]["decoded"] += decoded
+        return listing, truncated, decoded
+
     def disasm_read(
         self,
         pid: int,
@@ -2112,10 +2495,9 @@ class ExecutiveState:
             raise ValueError("count must be an integer") from None
         count_value = max(1, min(count_value, 64))
 
-        mode_value = (mode or "on-demand").strip().lower()
+        mode_value = (mode or "cached").strip().lower()
         if mode_value not in {"on-demand", "cached"}:
             raise ValueError("mode must be 'on-demand' or 'cached'")
-        cache_enabled = mode_value == "cached"
 
         regs = self.request_dump_regs(pid)
         pc = regs.get("pc")
@@ -2127,37 +2509,38 @@ class ExecutiveState:
             except (TypeError, ValueError) as exc:
                 raise ValueError("address must be integer") from exc
 
-        cache_key = (start_addr, count_value)
-        if cache_enabled:
-            cache_for_pid = self.disasm_cache.get(pid, {})
-            cached_entry = cache_for_pid.get(cache_key)
-            if cached_entry:
-                result = dict(cached_entry["result"])
-                result["cached"] = True
-                return result
-
-        max_bytes = min(count_value * 8, 4096)
-        try:
-            with self.lock:
-                raw = self.vm.read_mem(start_addr, max_bytes, pid=pid)
-        except Exception as exc:
-            raise ValueError(f"disassembly memory read failed: {exc}") from exc
-
-        if isinstance(raw, str):
-            try:
-                raw_bytes = bytes.fromhex(raw)
-            except ValueError:
-                raw_bytes = raw.encode("utf-8", errors="ignore")
-        elif isinstance(raw, (bytes, bytearray)):
-            raw_bytes = bytes(raw)
-        else:
-            raise ValueError("unexpected memory payload from VM")
-
         reg_values = None
         regs_block = regs.get("regs")
         if isinstance(regs_block, list):
             reg_values = [int(val) & 0xFFFFFFFF for val in regs_block if isinstance(val, int)]
 
+        if mode_value == "cached":
+            cached_entries, truncated, decoded = self._disasm_cached(pid, start_addr, count_value)
+            instructions = []
+            for index, cached_entry in enumerate(cached_entries):
+                entry = dict(cached_entry)
+                entry["index"] = index
+                entry["operands"] = self._render_operands(entry, reg_values)
+                instructions.append(entry)
+            data_hex = "".join(entry["bytes"] for entry in instructions)
+            image_stats = self.disasm_cache[pid]["stats"]
+            return {
+                "pid": pid,
+                "address": start_addr,
+                "count": len(instructions),
+                "requested": count_value,
+                "mode": mode_value,
+                "cached": decoded == 0 and bool(instructions),
+                "decoded": decoded,
+                "truncated": truncated,
+                "bytes_read": len(data_hex) // 2,
+                "data": data_hex,
+                "instructions": instructions,
+                "cache": {"entries": len(self.disasm_cache[pid]["entries"]), **image_stats},
+            }
+
+        max_bytes = min(count_value * 8, 4096)
+        raw_bytes = self._read_code_bytes(pid, start_addr, max_bytes)
         instructions, truncated, consumed = self._disassemble_bytes(
             pid,
             raw_bytes,
@@ -2165,19 +2548,9 @@ class ExecutiveState:
             count_value,
             reg_values=reg_values,
         )
+        self._annotate_instructions(pid, instructions)
 
-        for entry in instructions:
-            symbol = self.symbol_lookup_addr(pid, entry["pc"])
-            if symbol:
-                entry["symbol"] = dict(symbol)
-            line = self.symbol_lookup_line(pid, entry["pc"])
-            if line:
-                entry["line"] = dict(line)
-            offset = symbol.get("offset") if symbol else None
-            if symbol and (offset is None or offset == 0):
-                entry["label"] = symbol.get("name")
-
-        result = {
+        return {
             "pid": pid,
             "address": start_addr,
             "count": len(instructions),
@@ -2190,15 +2563,6 @@ class ExecutiveState:
             "instructions": instructions,
         }
 
-        if cache_enabled:
-            cache_for_pid = self.disasm_cache.setdefault(pid, {})
-            cache_for_pid[cache_key] = {
-                "result": dict(result),
-                "timestamp": time.time(),
-            }
-
-        return result
-
     def stack_info(self, pid: int, *, max_frames: Optional[int] = None) -> Dict[str, Any]:
         self.get_task(pid)
         regs = self.request_dump_regs(pid)
@@ -2278,7 +2642,7 @@ class ExecutiveState:
         truncated = False
         seen_fps: set[int] = set()
 
-        for depth in range(max_frames):
+        def _frame_entry(depth: int) -> Dict[str, Any]:
             frame_entry: Dict[str, Any] = {
                 "index": depth,
                 "pc": current_pc,
@@ -2299,6 +2663,77 @@ class ExecutiveState:
                 if line.get("line") is not None:
                     frame_entry["line_num"] = line.get("line")
             frames.append(frame_entry)
+            return frame_entry
+
+        result = {
+            "pid": pid,
+            "frames": frames,
+            "truncated": truncated,
+            "errors": errors,
+            "stack_base": stack_base,
+            "stack_limit": stack_limit,
+            "stack_low": stack_low,
+            "stack_high": stack_high,
+            "initial_sp": start_sp,
+            "initial_fp": initial_fp,
+            "method": "fp_chain",
+        }
+
+        if self._unwind_row(pid, current_pc) is not None:
+            # Compiler-emitted unwind rows say exactly where each frame keeps
+            # its CFA, saved R7 and return address, so one stack snapshot is
+            # enough to walk every frame.
+            result["method"] = "cfi"
+            snapshot_len = max(0, min(stack_high - current_sp, self.unwind_snapshot_bytes)) & ~3
+            snapshot = self._read_stack_words(pid, current_sp, snapshot_len // 4) if snapshot_len else []
+            snapshot_base = current_sp
+
+            def _word_at(addr: int) -> Optional[int]:
+                idx = (addr - snapshot_base) // 4
+                if snapshot is None or addr % 4 or idx < 0 or idx >= len(snapshot):
+                    return None
+                return snapshot[idx] & 0xFFFFFFFF
+
+            for depth in range(max_frames):
+                frame_entry = _frame_entry(depth)
+                frame_entry["unwind"] = "cfi"
+                row = self._unwind_row(pid, current_pc)
+                if row is None:
+                    errors.append(f"no_unwind:0x{current_pc:08X}")
+                    truncated = True
+                    break
+                base = fp if row.get("cfa_reg") == "fp" else current_sp
+                if base is None:
+                    errors.append(f"unwind_missing_fp:0x{current_pc:08X}")
+                    truncated = True
+                    break
+                cfa = (base + int(row.get("cfa_offset", 0))) & 0xFFFFFFFF
+                ra_addr = cfa + int(row.get("ra_offset", -4))
+                frame_entry["cfa"] = cfa
+                if ra_addr + 4 > stack_high:
+                    break
+                return_pc = _word_at(ra_addr)
+                if return_pc is None:
+                    errors.append(f"stack_read_failed:0x{ra_addr:08X}")
+                    truncated = True
+                    break
+                frame_entry["return_pc"] = return_pc
+                saved_fp_offset = (row.get("saved") or {}).get("R7")
+                if saved_fp_offset is not None:
+                    fp = _word_at(cfa + int(saved_fp_offset))
+                if return_pc == 0 or cfa <= current_sp:
+                    break
+                current_sp = cfa
+                current_pc = return_pc
+            else:
+                truncated = True
+                errors.append("frame_limit_reached")
+            result["truncated"] = truncated
+            result["stack_reads"] = 1 if snapshot_len else 0
+            return result
+
+        for depth in range(max_frames):
+            frame_entry = _frame_entry(depth)
 
             if fp is None or fp == 0:
                 break
@@ -2343,18 +2778,8 @@ class ExecutiveState:
             truncated = True
             errors.append("frame_limit_reached")
 
-        return {
-            "pid": pid,
-            "frames": frames,
-            "truncated": truncated,
-            "errors": errors,
-            "stack_base": stack_base,
-            "stack_limit": stack_limit,
-            "stack_low": stack_low,
-            "stack_high": stack_high,
-            "initial_sp": start_sp,
-            "initial_fp": initial_fp,
-        }
+        result["truncated"] = truncated
+        return result
 
     def _next_event_seq(self) -> int:
         with self.event_lock:
@@ -2408,14 +2833,17 @@ class ExecutiveState:
             if not subscription.active:
                 return
             subscription.queue.append(warning_event)
-            pending = self._post_enqueue_locked(subscription, warning_event["seq"])
-            subscription.condition.notify_all()
+            # Control warnings bypass credits so a starved session still learns it is throttled.
+            pending = self._post_enqueue_locked(subscription, warning_event["seq"], control=True)
+            subscription.wake()
         # warnings are considered part of the backlog but should not recursively trigger new warnings
         # immediately, so skip back-pressure evaluation here.
 
-    def _post_enqueue_locked(self, subscription: EventSubscription, seq: int) -> int:
+    def _post_enqueue_locked(self, subscription: EventSubscription, seq: int, *, control: bool = False) -> int:
         """Update delivery metrics after enqueuing an event while the subscription lock is held."""
         subscription.delivered_seq = max(subscription.delivered_seq, seq)
+        if subscription.credits is not None and not control:
+            subscription.inflight.append(seq)
         pending = subscription.pending()
         if pending > subscription.high_water:
             subscription.high_water = pending
@@ -2479,6 +2907,9 @@ class ExecutiveState:
                     continue
                 if not sub.matches(event):
                     continue
+                if not sub.has_credit():
+                    self._hold_event_locked(sub, event)
+                    continue
                 if sub.max_events > 0 and len(sub.queue) >= sub.max_events:
                     dropped = sub.queue.popleft()
                     dropped_seq = dropped.get("seq", sub.last_ack)
@@ -2504,10 +2935,72 @@ class ExecutiveState:
                         sub.queue.popleft()
                 sub.queue.append(event)
                 pending = self._post_enqueue_locked(sub, event.get("seq", sub.delivered_seq))
-                sub.condition.notify_all()
-            if pending is not None:
+                sub.wake()
+            if pending is not None and sub.credits is None:
                 self._apply_backpressure(sub, pending)
 
+    def _hold_event_locked(self, subscription: EventSubscription, event: Dict[str, Any]) -> None:
+        """Park ``event`` for a subscription that has no credits left."""
+
+        event_type = str(event.get("type"))
+        if event_type in CREDIT_SUMMARISED_EVENTS:
+            subscription.suppress(event_type)
+            return
+        if subscription.max_events > 0 and len(subscription.held) >= subscription.max_events:
+            subscription.held.popleft()
+            subscription.drop_count += 1
+            subscription.suppress("dropped")
+        subscription.held.append(event)
+
+    def _release_credit_locked(self, subscription: EventSubscription) -> Optional[Dict[str, Any]]:
+        """Send held events as credit allows; return a pending suppression summary."""
+
+        released = False
+        while subscription.held and subscription.has_credit():
+            event = subscription.held.popleft()
+            subscription.queue.append(event)
+            self._post_enqueue_locked(subscription, event.get("seq", subscription.delivered_seq))
+            released = True
+        if released:
+            subscription.wake()
+        if not subscription.suppressed:
+            return None
+        now = time.time()
+        summary = {
+            "counts": dict(subscription.suppressed),
+            "interval_s": round(max(0.0, now - subscription.suppressed_since), 3),
+        }
+        subscription.suppressed = {}
+        subscription.suppressed_since = 0.0
+        return summary
+
+    def events_wanted(self, event_type: str, pid: Optional[int] = None) -> bool:
+        """Return False when every subscriber for this event is out of credits.
+
+        Producers of high-rate events check this before building payloads; the
+        starved subscriptions record the event in their suppression counts.
+        With no matching subscribers at all the event is still generated so it
+        lands in the replay history.
+        """
+
+        if event_type not in CREDIT_SUMMARISED_EVENTS:
+            return True
+        probe = {"type": event_type, "pid": pid}
+        with self.event_lock:
+            subscribers = list(self.event_subscriptions.values())
+            starved: List[EventSubscription] = []
+            for sub in subscribers:
+                if not sub.active or not sub.matches(probe):
+                    continue
+                if sub.has_credit():
+                    return True
+                starved.append(sub)
+            if not starved:
+                return True
+            for sub in starved:
+                sub.suppress(event_type)
+        return False
+
     def _set_task_state_pending(
         self,
         pid: int,
@@ -2600,6 +3093,8 @@ class ExecutiveState:
 
         if prev_pid is None or prev_pid == next_pid:
             return None
+        if not self.events_wanted("scheduler", next_pid):
+            return None
 
         prev_task = _fetch_task(prev_tasks, prev_pid)
         prev_state = None
@@ -2756,16 +3251,13 @@ class ExecutiveState:
         pc: Optional[int],
         flags: Optional[int],
     ) -> None:
-        if self.trace_buffer_capacity <= 0:
+        if self.trace_buffer_capacity <= 0 and pid not in self.trace_spills:
             return
         timestamp = time.time()
         with self.trace_lock:
-            if self.trace_buffer_capacity <= 0:
+            spill = self.trace_spills.get(pid)
+            if self.trace_buffer_capacity <= 0 and spill is None:
                 return
-            buffer = self.trace_buffers.get(pid)
-            if buffer is None or buffer.maxlen != self.trace_buffer_capacity:
-                buffer = deque(maxlen=self.trace_buffer_capacity)
-                self.trace_buffers[pid] = buffer
             record_dict: Dict[str, Any] = {
                 "seq": self._next_trace_seq_locked(),
                 "ts": timestamp,
@@ -2795,6 +3287,18 @@ class ExecutiveState:
             normalized = trace_format.decode_trace_records(
                 [record_dict], default_pid=pid
             )[0]
+            if spill is not None:
+                try:
+                    spill.append(normalized)
+                except (OSError, ValueError) as exc:
+                    self.trace_spills.pop(pid, None)
+                    self.log("error", "trace spill failed", pid=pid, path=str(spill.path), error=str(exc))
+            if self.trace_buffer_capacity <= 0:
+                return
+            buffer = self.trace_buffers.get(pid)
+            if buffer is None or buffer.maxlen != self.trace_buffer_capacity:
+                buffer = deque(maxlen=self.trace_buffer_capacity)
+                self.trace_buffers[pid] = buffer
             buffer.append(normalized)
 
     def _emit_trace_snapshot(self, pid: int, snapshot: Mapping[str, Any]) -> None:
@@ -2818,7 +3322,8 @@ class ExecutiveState:
         if isinstance(mem_access, dict):
             payload["mem_access"] = dict(mem_access)
         self._handle_trace_step_event(pid_value, payload)
-        self.emit_event("trace_step", pid=pid_value, data=payload)
+        if self.events_wanted("trace_step", pid_value):
+            self.emit_event("trace_step", pid=pid_value, data=payload)
 
     def _parse_event_filters(self, filters: Optional[Dict[str, Any]]) -> Tuple[Optional[Set[int]], Optional[Set[str]], Optional[int]]:
         if not isinstance(filters, dict):
@@ -2863,9 +3368,11 @@ class ExecutiveState:
         session_id: str,
         *,
         filters: Optional[Dict[str, Any]] = None,
+        credits: Optional[int] = None,
     ) -> EventSubscription:
         record = self._get_session(session_id)
         pids, categories, since_seq = self._parse_event_filters(filters)
+        credits = self._parse_event_credits(credits)
         with self.event_lock:
             existing_token = self.session_event_map.pop(session_id, None)
             if existing_token:
@@ -2873,7 +3380,7 @@ class ExecutiveState:
                 if old:
                     with old.condition:
                         old.active = False
-                        old.condition.notify_all()
+                        old.wake()
             token = f"{session_id}:{uuid.uuid4()}"
             condition = threading.Condition(self.event_lock)
             current_seq = self.event_seq - 1
@@ -2889,17 +3396,22 @@ class ExecutiveState:
                 last_ack=initial_ack,
                 delivered_seq=initial_ack,
                 since_seq=since_seq,
+                credits=credits,
             )
             # preload history if requested
             if since_seq is not None:
                 with subscription.condition:
                     for event in self.event_history:
                         if event.get("seq", 0) > since_seq and subscription.matches(event):
+                            if not subscription.has_credit():
+                                self._hold_event_locked(subscription, event)
+                                continue
                             subscription.queue.append(event)
                             self._post_enqueue_locked(subscription, event.get("seq", initial_ack))
             self.event_subscriptions[token] = subscription
             self.session_event_map[session_id] = token
-            subscription.condition.notify_all()
+            subscription.wake()
+        self._push_event_filter()
         self.log(
             "info",
             "events subscribed",
@@ -2924,11 +3436,57 @@ class ExecutiveState:
                 removed = True
                 with sub.condition:
                     sub.active = False
-                    sub.condition.notify_all()
+                    sub.wake()
         if removed:
             self.log("info", "events unsubscribed", token=token, session_id=session_id)
+            self._push_event_filter()
         return removed
 
+    def _event_filter_spec(self) -> Dict[str, Optional[List[int]]]:
+        """Union of subscription filters as event type (or ``"*"``) -> PIDs."""
+
+        spec: Dict[str, Optional[Set[int]]] = {}
+
+        def merge(key: str, pids: Optional[Set[int]]) -> None:
+            if key in spec and spec[key] is None:
+                return
+            if pids is None:
+                spec[key] = None
+            else:
+                spec.setdefault(key, set()).update(pids)
+
+        with self.event_lock:
+            subscribers = [sub for sub in self.event_subscriptions.values() if sub.active]
+        for sub in subscribers:
+            for key in sub.categories if sub.categories is not None else ("*",):
+                merge(key, sub.pids)
+        # The trace ring and spill files are fed from trace_step events, but
+        # only for tasks with tracing on or a spill running.
+        traced = set(self.trace_spills)
+        if self.trace_buffer_capacity > 0:
+            traced.update(pid for pid, task in list(self.tasks.items()) if task.get("trace"))
+        if traced:
+            merge("trace_step", traced)
+        return {key: None if pids is None else sorted(pids) for key, pids in spec.items()}
+
+    def _push_event_filter(self, *, force: bool = False) -> None:
+        """Tell the VM which observational events anyone still consumes."""
+
+        push = getattr(self.vm, "event_filter", None)
+        if not callable(push):
+            return
+        spec = self._event_filter_spec()
+        with self.event_lock:
+            if not force and spec == self._vm_event_filter:
+                return
+            self._vm_event_filter = spec
+        try:
+            push(spec)
+        except Exception as exc:
+            with self.event_lock:
+                self._vm_event_filter = None
+            self.log("debug", "event filter push failed", error=str(exc))
+
     def events_ack(self, session_id: str, seq: int) -> None:
         if seq < 0:
             raise ValueError("ack seq must be non-negative")
@@ -2943,11 +3501,52 @@ class ExecutiveState:
             subscription.last_ack = max(subscription.last_ack, seq)
             while subscription.queue and subscription.queue[0].get("seq", 0) <= seq:
                 subscription.queue.popleft()
+            if subscription.inflight:
+                subscription.inflight = deque(item for item in subscription.inflight if item > seq)
             pending_after = subscription.pending()
             if pending_after <= subscription.max_events:
                 subscription.slow_warning_active = False
                 subscription.slow_since = 0.0
-            subscription.condition.notify_all()
+            summary = self._release_credit_locked(subscription)
+            subscription.wake()
+        if summary is not None:
+            self._deliver_warning(subscription, "events_suppressed", **summary)
+
+    def events_credit(self, session_id: str, credits: Any) -> None:
+        """Change the credit window of the session's subscription."""
+
+        window = self._parse_event_credits(credits)
+        with self.event_lock:
+            token = self.session_event_map.get(session_id)
+            subscription = self.event_subscriptions.get(token) if token else None
+        if subscription is None:
+            raise SessionError("session_required")
+        with subscription.condition:
+            subscription.credits = window
+            if window is None:
+                subscription.inflight.clear()
+                while subscription.held:
+                    event = subscription.held.popleft()
+                    subscription.queue.append(event)
+                    self._post_enqueue_locked(subscription, event.get("seq", subscription.delivered_seq))
+                summary = None
+            else:
+                summary = self._release_credit_locked(subscription)
+            subscription.wake()
+        if summary is not None:
+            self._deliver_warning(subscription, "events_suppressed", **summary)
+
+    @staticmethod
+    def _parse_event_credits(value: Any) -> Optional[int]:
+        if value is None:
+            return None
+        try:
+            credits = int(value)
+        except (TypeError, ValueError):
+            raise ValueError("credits must be a positive integer")
+        if credits <= 0:
+            raise ValueError("credits must be a positive integer")
+        return credits
 
     def events_next(self, subscription: EventSubscription, timeout: float = 1.0) -> Optional[Dict[str, Any]]:
         end_time = time.time() + timeout
@@ -2984,6 +3583,10 @@ class ExecutiveState:
                 "max_events": subscription.max_events,
                 "active": subscription.active,
                 "slow_warning_active": subscription.slow_warning_active,
+                "credits": subscription.credits,
+                "inflight": len(subscription.inflight),
+                "held": len(subscription.held),
+                "suppressed": dict(subscription.suppressed),
             }
 
     def events_session_disconnected(self, session_id: str) -> None:
@@ -2999,9 +3602,11 @@ class ExecutiveState:
         if isinstance(tasks_block, dict):
             tasks = tasks_block.get("tasks", [])
             new_current_pid = tasks_block.get("current_pid")
+            self.task_delta_seq = self._optional_int(tasks_block.get("task_seq"))
         else:
             tasks = tasks_block
             new_current_pid = snapshot.get("current_pid")
+            self.task_delta_seq = None
         prev_snapshot = {
             "current_pid": prev_current_pid,
             "tasks": {pid: dict(task) for pid, task in self.tasks.items()},
@@ -3021,228 +3626,313 @@ class ExecutiveState:
             except (TypeError, ValueError):
                 continue
             self.tasks[pid] = task
-            prev_entry = prev_states.get(pid)
-            state_entry: Dict[str, Any]
-            if isinstance(prev_entry, dict):
-                state_entry = prev_entry
-            else:
-                state_entry = {}
-            context = state_entry.get("context")
-            if not isinstance(context, dict):
-                context = {}
-            prev_wait_mailbox_value = context.get("wait_mailbox")
-            prev_wait_handle_value = context.get("wait_handle")
-            prev_wait_timeout_value = context.get("wait_timeout")
-            prev_wait_deadline_value = context.get("wait_deadline")
-            context.pop("regs", None)
-            context["state"] = task.get("state")
-            if "exit_status" in task:
-                context["exit_status"] = task.get("exit_status")
-            elif "exit_status" in context and "exit_status" not in task:
-                context.pop("exit_status", None)
-            if "trace" in task:
-                context["trace"] = task.get("trace")
-            def _propagate_field(name: str) -> None:
-                val = self._optional_int(task.get(name))
-                if val is not None:
-                    context[name] = val
-                    task[name] = val
-                elif name in context:
-                    context.pop(name, None)
-            _propagate_field("reg_base")
-            _propagate_field("stack_base")
-            _propagate_field("stack_limit")
-            _propagate_field("stack_size")
-            wait_mailbox_value = task.get("wait_mailbox")
-            wait_handle_value = task.get("wait_handle")
-            wait_timeout_value = task.get("wait_timeout")
-            wait_deadline_value = task.get("wait_deadline")
-            if wait_mailbox_value is None:
-                wait_mailbox_value = prev_wait_mailbox_value
-            if wait_handle_value is None:
-                wait_handle_value = prev_wait_handle_value
-            if wait_timeout_value is None:
-                wait_timeout_value = prev_wait_timeout_value
-            if wait_deadline_value is None:
-                wait_deadline_value = prev_wait_deadline_value
-            if wait_mailbox_value is not None:
-                context["wait_mailbox"] = wait_mailbox_value
-            elif "wait_mailbox" in context:
-                context.pop("wait_mailbox", None)
-            if wait_handle_value is not None:
-                context["wait_handle"] = wait_handle_value
-            elif "wait_handle" in context:
-                context.pop("wait_handle", None)
-            if wait_timeout_value is not None:
-                context["wait_timeout"] = wait_timeout_value
-            elif "wait_timeout" in context:
-                context.pop("wait_timeout", None)
-            if wait_deadline_value is not None:
-                context["wait_deadline"] = wait_deadline_value
-            elif "wait_deadline" in context:
-                context.pop("wait_deadline", None)
-            prev_state = state_entry.get("state")
-            prev_state_enum = state_entry.get("state_enum")
-            if not isinstance(prev_state_enum, TaskState):
-                try:
-                    prev_state_enum = self._coerce_task_state(prev_state, allow_none=True)
-                except ValueError:
-                    prev_state_enum = None
-            prev_sleep = bool(state_entry.get("sleep_pending"))
-            new_state_value = task.get("state")
-            if new_state_value is None:
-                new_state_str = context.get("state") or prev_state
-            else:
-                new_state_str = str(new_state_value)
-            try:
-                new_state_enum = self._coerce_task_state(new_state_str)
-            except ValueError as exc:
-                raise ValueError(f"task_state_invalid:{new_state_str}:pid={pid}") from exc
-            self._validate_state_transition(pid, prev_state_enum, new_state_enum)
-            if new_state_enum != prev_state_enum:
-                self._record_state_transition(pid, prev_state_enum, new_state_enum)
-            new_state = new_state_enum.value
-            if new_state_enum == TaskState.SLEEPING:
-                self._track_sleep(pid, task.get("sleep_deadline"))
-            else:
-                self._untrack_sleep(pid)
-            state_entry["state"] = new_state
-            state_entry["state_enum"] = new_state_enum
-            sleep_flag = bool(task.get("sleep_pending"))
-            state_entry["sleep_pending"] = sleep_flag
-            state_entry["context"] = context
-            context["state"] = new_state
-            if self.enforce_context_isolation:
-                self._assert_context_isolation(pid, context, new_state_enum)
-            task["state"] = new_state
-            if new_state_enum == TaskState.WAIT_MBX:
-                if "wait_mailbox" in context:
-                    task["wait_mailbox"] = context.get("wait_mailbox")
-                if "wait_handle" in context:
-                    task["wait_handle"] = context.get("wait_handle")
-                if "wait_timeout" in context:
-                    task["wait_timeout"] = context.get("wait_timeout")
-                if "wait_deadline" in context:
-                    task["wait_deadline"] = context.get("wait_deadline")
-                self._track_wait_mailbox(pid, context.get("wait_deadline"))
-            else:
-                task.pop("wait_mailbox", None)
-                task.pop("wait_handle", None)
-                task.pop("wait_timeout", None)
-                task.pop("wait_deadline", None)
-                self._untrack_wait_mailbox(pid)
-            new_states[pid] = state_entry
+            new_states[pid] = self._apply_task_snapshot(pid, task, prev_states.get(pid), now)
             current_pids.add(pid)
-            bp_set = self.breakpoints.get(pid)
-            if bp_set:
-                task["breakpoints"] = sorted(bp_set)
-            elif "breakpoints" in task:
-                task.pop("breakpoints", None)
-            symbol_table = self.symbol_tables.get(pid)
-            if symbol_table:
-                task["symbols"] = {
-                    "path": symbol_table.get("path"),
-                    "count": len(symbol_table.get("symbols", [])),
-                }
-            elif "symbols" in task:
-                task.pop("symbols", None)
-
-            reason: Optional[str] = None
-            details: Optional[Dict[str, Any]] = None
-            ts: Optional[float] = None
-            emit_same_state = False
-            pending = self.task_state_pending.pop(pid, None)
-            if pending:
-                reason = pending.get("reason")
-                details_payload = pending.get("details")
-                if isinstance(details_payload, dict):
-                    details = dict(details_payload)
-                elif details_payload is not None:
-                    details = {"value": details_payload}
-                ts = pending.get("ts")
-                emit_same_state = bool(pending.get("force"))
-                expected_state = pending.get("target_state")
-                if expected_state and expected_state != new_state:
-                    merged = dict(details or {})
-                    merged.setdefault("expected_state", expected_state)
-                    details = merged
-            if reason is None and prev_entry is None:
-                reason = "loaded"
-                ts = ts or now
-            if prev_entry is not None and prev_state != new_state and reason is None:
-                inferred = self._infer_task_state_reason(prev_state, new_state, task, state_entry)
-                if inferred:
-                    reason = inferred
-            if not prev_sleep and sleep_flag:
-                sleep_details = dict(details or {}) if details else {}
-                sleep_details.setdefault("sleep_pending", True)
-                sleep_ms = task.get("sleep_pending_ms")
-                if sleep_ms is not None:
-                    sleep_details.setdefault("sleep_ms", sleep_ms)
-                if reason is None:
-                    reason = "sleep"
-                    details = sleep_details
-                else:
-                    updated = dict(details or {})
-                    updated.update(sleep_details)
-                    details = updated
-                ts = ts or now
-                emit_same_state = True
-            if reason == "returned" and task.get("exit_status") is not None:
-                exit_details = dict(details or {})
-                exit_details.setdefault("exit_status", task.get("exit_status"))
-                details = exit_details
-            if reason is not None or (prev_state != new_state) or emit_same_state:
-                self._emit_task_state_event(
-                    pid,
-                    prev_state,
-                    new_state,
-                    reason=reason,
-                    details=details,
-                    ts=ts,
-                    state_entry=state_entry,
-                )
 
         removed_pids = set(prev_states.keys()) - current_pids
         for pid in removed_pids:
-            pending = self.task_state_pending.pop(pid, None)
-            prev_entry = prev_states.get(pid)
-            if not isinstance(prev_entry, dict):
-                prev_entry = {}
-            prev_state = prev_entry.get("state")
-            reason = pending.get("reason") if pending else None
-            details_payload = pending.get("details") if pending else None
-            ts = pending.get("ts") if pending else None
-            if details_payload is not None and not isinstance(details_payload, dict):
+            self._retire_task(pid, prev_states.get(pid))
+
+        self.task_states = new_states
+        context = self._pending_scheduler_context or {}
+        self._pending_scheduler_context = None
+        self._maybe_emit_scheduler_event(prev_snapshot, context=context)
+        self._prune_task_registries(current_pids)
+        self._push_event_filter()
+
+    def _apply_task_deltas(self, block: Any) -> None:
+        """Apply task deltas pushed with a step response.
+
+        Only the tasks named in the batch (plus any with a pending state
+        reason) are re-evaluated.  A missing batch or a ``base_seq`` that does
+        not match the last applied sequence means deltas were lost, so fall
+        back to a full ``ps`` resync.
+        """
+
+        base_seq = self._optional_int(block.get("base_seq")) if isinstance(block, dict) else None
+        if base_seq is None or self.task_delta_seq is None or base_seq != self.task_delta_seq:
+            self.task_delta_stats["resyncs"] += 1
+            self._refresh_tasks()
+            return
+        prev_current_pid = self.current_pid
+        # Deltas replace task entries rather than mutate them, so a shallow
+        # copy of the table keeps every previous entry; only the active task
+        # is updated in place below and needs its own copy.
+        prev_tasks = dict(self.tasks)
+        if prev_current_pid in prev_tasks:
+            prev_tasks[prev_current_pid] = dict(prev_tasks[prev_current_pid])
+        prev_snapshot = {"current_pid": prev_current_pid, "tasks": prev_tasks}
+        self.current_pid = self._optional_int(block.get("current_pid"))
+        now = time.time()
+        touched: Dict[int, Dict[str, Any]] = {}
+        removed: List[int] = []
+        for delta in block.get("deltas") or []:
+            if not isinstance(delta, dict):
+                continue
+            pid = self._optional_int(delta.get("pid"))
+            if pid is None:
+                continue
+            if delta.get("removed"):
+                touched.pop(pid, None)
+                removed.append(pid)
+            elif isinstance(delta.get("task"), dict):
+                touched[pid] = dict(delta["task"])
+        for pid in self.task_state_pending:
+            if pid not in touched and pid in self.tasks:
+                touched[pid] = self.tasks[pid]
+        retrace = bool(removed)
+        for pid, task in touched.items():
+            retrace = retrace or bool(task.get("trace")) != bool((prev_tasks.get(pid) or {}).get("trace"))
+            self.tasks[pid] = task
+            self.task_states[pid] = self._apply_task_snapshot(pid, task, self.task_states.get(pid), now)
+        for pid in removed:
+            known = self.tasks.pop(pid, None)
+            prev_entry = self.task_states.pop(pid, None)
+            if known is None and prev_entry is None:
+                continue  # already retired by a ps resync (e.g. kill_task)
+            self._retire_task(pid, prev_entry)
+        active = block.get("active")
+        if isinstance(active, dict):
+            task = self.tasks.get(self._optional_int(active.get("pid")))
+            if task is not None:
+                if active.get("pc") is not None:
+                    task["pc"] = active.get("pc")
+                task["accounted_steps"] = active.get("accounted_steps", task.get("accounted_steps", 0))
+                task["accounted_cycles"] = task["accounted_steps"]
+        self.task_delta_seq = self._optional_int(block.get("seq"))
+        self.task_delta_stats["batches"] += 1
+        self.task_delta_stats["applied"] += len(touched) + len(removed)
+        context = self._pending_scheduler_context or {}
+        self._pending_scheduler_context = None
+        self._maybe_emit_scheduler_event(prev_snapshot, context=context)
+        if removed:
+            self._prune_task_registries(set(self.tasks))
+        if retrace:
+            self._push_event_filter()
+
+    def _apply_task_snapshot(
+        self,
+        pid: int,
+        task: Dict[str, Any],
+        prev_entry: Optional[Dict[str, Any]],
+        now: float,
+    ) -> Dict[str, Any]:
+        state_entry: Dict[str, Any]
+        if isinstance(prev_entry, dict):
+            state_entry = prev_entry
+        else:
+            state_entry = {}
+        context = state_entry.get("context")
+        if not isinstance(context, dict):
+            context = {}
+        prev_wait_mailbox_value = context.get("wait_mailbox")
+        prev_wait_handle_value = context.get("wait_handle")
+        prev_wait_timeout_value = context.get("wait_timeout")
+        prev_wait_deadline_value = context.get("wait_deadline")
+        context.pop("regs", None)
+        context["state"] = task.get("state")
+        if "exit_status" in task:
+            context["exit_status"] = task.get("exit_status")
+        elif "exit_status" in context and "exit_status" not in task:
+            context.pop("exit_status", None)
+        if "trace" in task:
+            context["trace"] = task.get("trace")
+        def _propagate_field(name: str) -> None:
+            val = self._optional_int(task.get(name))
+            if val is not None:
+                context[name] = val
+                task[name] = val
+            elif name in context:
+                context.pop(name, None)
+        _propagate_field("reg_base")
+        _propagate_field("stack_base")
+        _propagate_field("stack_limit")
+        _propagate_field("stack_size")
+        wait_mailbox_value = task.get("wait_mailbox")
+        wait_handle_value = task.get("wait_handle")
+        wait_timeout_value = task.get("wait_timeout")
+        wait_deadline_value = task.get("wait_deadline")
+        if wait_mailbox_value is None:
+            wait_mailbox_value = prev_wait_mailbox_value
+        if wait_handle_value is None:
+            wait_handle_value = prev_wait_handle_value
+        if wait_timeout_value is None:
+            wait_timeout_value = prev_wait_timeout_value
+        if wait_deadline_value is None:
+            wait_deadline_value = prev_wait_deadline_value
+        if wait_mailbox_value is not None:
+            context["wait_mailbox"] = wait_mailbox_value
+        elif "wait_mailbox" in context:
+            context.pop("wait_mailbox", None)
+        if wait_handle_value is not None:
+            context["wait_handle"] = wait_handle_value
+        elif "wait_handle" in context:
+            context.pop("wait_handle", None)
+        if wait_timeout_value is not None:
+            context["wait_timeout"] = wait_timeout_value
+        elif "wait_timeout" in context:
+            context.pop("wait_timeout", None)
+        if wait_deadline_value is not None:
+            context["wait_deadline"] = wait_deadline_value
+        elif "wait_deadline" in context:
+            context.pop("wait_deadline", None)
+        prev_state = state_entry.get("state")
+        prev_state_enum = state_entry.get("state_enum")
+        if not isinstance(prev_state_enum, TaskState):
+            try:
+                prev_state_enum = self._coerce_task_state(prev_state, allow_none=True)
+            except ValueError:
+                prev_state_enum = None
+        prev_sleep = bool(state_entry.get("sleep_pending"))
+        new_state_value = task.get("state")
+        if new_state_value is None:
+            new_state_str = context.get("state") or prev_state
+        else:
+            new_state_str = str(new_state_value)
+        try:
+            new_state_enum = self._coerce_task_state(new_state_str)
+        except ValueError as exc:
+            raise ValueError(f"task_state_invalid:{new_state_str}:pid={pid}") from exc
+        self._validate_state_transition(pid, prev_state_enum, new_state_enum)
+        if new_state_enum != prev_state_enum:
+            self._record_state_transition(pid, prev_state_enum, new_state_enum)
+        new_state = new_state_enum.value
+        if new_state_enum == TaskState.SLEEPING:
+            self._track_sleep(pid, task.get("sleep_deadline"))
+        else:
+            self._untrack_sleep(pid)
+        state_entry["state"] = new_state
+        state_entry["state_enum"] = new_state_enum
+        sleep_flag = bool(task.get("sleep_pending"))
+        state_entry["sleep_pending"] = sleep_flag
+        state_entry["context"] = context
+        context["state"] = new_state
+        if self.enforce_context_isolation:
+            self._assert_context_isolation(pid, context, new_state_enum)
+        task["state"] = new_state
+        if new_state_enum == TaskState.WAIT_MBX:
+            if "wait_mailbox" in context:
+                task["wait_mailbox"] = context.get("wait_mailbox")
+            if "wait_handle" in context:
+                task["wait_handle"] = context.get("wait_handle")
+            if "wait_timeout" in context:
+                task["wait_timeout"] = context.get("wait_timeout")
+            if "wait_deadline" in context:
+                task["wait_deadline"] = context.get("wait_deadline")
+            self._track_wait_mailbox(pid, context.get("wait_deadline"))
+        else:
+            task.pop("wait_mailbox", None)
+            task.pop("wait_handle", None)
+            task.pop("wait_timeout", None)
+            task.pop("wait_deadline", None)
+            self._untrack_wait_mailbox(pid)
+        bp_set = self.breakpoints.get(pid)
+        if bp_set:
+            task["breakpoints"] = sorted(bp_set)
+        elif "breakpoints" in task:
+            task.pop("breakpoints", None)
+        symbol_table = self.symbol_tables.get(pid)
+        if symbol_table:
+            task["symbols"] = {
+                "path": symbol_table.get("path"),
+                "count": len(symbol_table.get("symbols", [])),
+            }
+        elif "symbols" in task:
+            task.pop("symbols", None)
+
+        reason: Optional[str] = None
+        details: Optional[Dict[str, Any]] = None
+        ts: Optional[float] = None
+        emit_same_state = False
+        pending = self.task_state_pending.pop(pid, None)
+        if pending:
+            reason = pending.get("reason")
+            details_payload = pending.get("details")
+            if isinstance(details_payload, dict):
+                details = dict(details_payload)
+            elif details_payload is not None:
                 details = {"value": details_payload}
-            else:
-                details = dict(details_payload) if isinstance(details_payload, dict) else None
+            ts = pending.get("ts")
+            emit_same_state = bool(pending.get("force"))
+            expected_state = pending.get("target_state")
+            if expected_state and expected_state != new_state:
+                merged = dict(details or {})
+                merged.setdefault("expected_state", expected_state)
+                details = merged
+        if reason is None and prev_entry is None:
+            reason = "loaded"
+            ts = ts or now
+        if prev_entry is not None and prev_state != new_state and reason is None:
+            inferred = self._infer_task_state_reason(prev_state, new_state, task, state_entry)
+            if inferred:
+                reason = inferred
+        if not prev_sleep and sleep_flag:
+            sleep_details = dict(details or {}) if details else {}
+            sleep_details.setdefault("sleep_pending", True)
+            sleep_ms = task.get("sleep_pending_ms")
+            if sleep_ms is not None:
+                sleep_details.setdefault("sleep_ms", sleep_ms)
             if reason is None:
-                if prev_state == "returned":
-                    reason = "returned"
-                elif prev_state == "terminated" and prev_entry.get("last_reason"):
-                    reason = prev_entry.get("last_reason")
-                else:
-                    reason = "killed"
+                reason = "sleep"
+                details = sleep_details
+            else:
+                updated = dict(details or {})
+                updated.update(sleep_details)
+                details = updated
+            ts = ts or now
+            emit_same_state = True
+        if reason == "returned" and task.get("exit_status") is not None:
+            exit_details = dict(details or {})
+            exit_details.setdefault("exit_status", task.get("exit_status"))
+            details = exit_details
+        if reason is not None or (prev_state != new_state) or emit_same_state:
             self._emit_task_state_event(
                 pid,
                 prev_state,
-                "terminated",
+                new_state,
                 reason=reason,
                 details=details,
                 ts=ts,
-                state_entry=prev_entry,
+                state_entry=state_entry,
             )
-            self.trace_last_regs.pop(pid, None)
-            self._untrack_sleep(pid)
+        return state_entry
+
+    def _retire_task(self, pid: int, prev_entry: Optional[Dict[str, Any]]) -> None:
+        pending = self.task_state_pending.pop(pid, None)
+        if not isinstance(prev_entry, dict):
+            prev_entry = {}
+        prev_state = prev_entry.get("state")
+        reason = pending.get("reason") if pending else None
+        details_payload = pending.get("details") if pending else None
+        ts = pending.get("ts") if pending else None
+        if details_payload is not None and not isinstance(details_payload, dict):
+            details = {"value": details_payload}
+        else:
+            details = dict(details_payload) if isinstance(details_payload, dict) else None
+        if reason is None:
+            if prev_state == "returned":
+                reason = "returned"
+            elif prev_state == "terminated" and prev_entry.get("last_reason"):
+                reason = prev_entry.get("last_reason")
+            else:
+                reason = "killed"
+        self._emit_task_state_event(
+            pid,
+            prev_state,
+            "terminated",
+            reason=reason,
+            details=details,
+            ts=ts,
+            state_entry=prev_entry,
+        )
+        self.trace_last_regs.pop(pid, None)
+        self._untrack_sleep(pid)
 
-        self.task_states = new_states
-        context = self._pending_scheduler_context or {}
-        self._pending_scheduler_context = None
-        self._maybe_emit_scheduler_event(prev_snapshot, context=context)
+    def _prune_task_registries(self, current_pids: Set[int]) -> None:
         stale = set(self.breakpoints.keys()) - current_pids
         for pid in stale:
             self.breakpoints.pop(pid, None)
+            self.breakpoint_conditions.pop(pid, None)
             self.debug_attached.discard(pid)
         stale_symbols = set(self.symbol_tables.keys()) - current_pids
         for pid in stale_symbols:
@@ -3299,6 +3989,7 @@ class ExecutiveState:
     def attach(self) -> Dict[str, Any]:
         info = self.vm.attach()
         self._refresh_tasks()
+        self._push_event_filter(force=True)
         return info
 
     def detach(self) -> Dict[str, Any]:
@@ -3311,6 +4002,10 @@ class ExecutiveState:
         clock = self.get_clock_status()
         payload["auto"] = clock["running"]
         payload["clock"] = clock
+        payload["task_deltas"] = dict(self.task_delta_stats, seq=self.task_delta_seq)
+        describe = getattr(self.server, "describe", None)
+        if callable(describe):
+            payload["server"] = describe()
         return payload
 
     def load(self, path: str, verbose: bool = False, *, symbols: Optional[str] = None) -> Dict[str, Any]:
@@ -3480,7 +4175,7 @@ class ExecutiveState:
                     self._emit_trace_snapshot(pid_from_trace, trace_last)
                 except Exception:
                     pass
-        self._refresh_tasks()
+        self._apply_task_deltas(result.pop("task_deltas", None))
         watch_events = self._check_watches(pid if pid is not None else None)
         if watch_events:
             result.setdefault("events", []).extend(watch_events)
@@ -3560,6 +4255,38 @@ class ExecutiveState:
         self.get_task(pid)
         self.vm.write_mem(addr, bytes.fromhex(data_hex), pid=pid)
 
+    def mem_dirty(self, pid: int, *, since: int = 0) -> Dict[str, Any]:
+        """Return memory granules written after sync sequence ``since``.
+
+        The VM bitmap is drained on every call and folded into per-granule
+        sequence stamps so several debugger sessions can sync independently.
+        Drain and stamp happen under ``self.lock`` so concurrent sessions
+        cannot interleave and lose ranges or reuse a sequence number.
+        """
+
+        self.get_task(pid)
+        since = max(0, int(since))
+        with self.lock:
+            report = self.vm.mem_dirty(pid, clear=True) or {}
+            granule = int(report.get("granule") or 64)
+            stamps = self.mem_dirty_stamps.setdefault(pid, {})
+            seq = self.mem_dirty_seq.get(pid, 0)
+            ranges = report.get("ranges") or []
+            if ranges:
+                seq += 1
+                self.mem_dirty_seq[pid] = seq
+                for addr, length in ranges:
+                    for base in range(int(addr), int(addr) + int(length), granule):
+                        stamps[base] = seq
+            stale = sorted(addr for addr, stamp in stamps.items() if stamp > since)
+        changed: List[List[int]] = []
+        for base in stale:
+            if changed and changed[-1][0] + changed[-1][1] == base:
+                changed[-1][1] += granule
+            else:
+                changed.append([base, granule])
+        return {"pid": pid, "seq": seq, "since": since, "granule": granule, "ranges": changed}
+
     def request_dump_regs(self, pid: int) -> Dict[str, Any]:
         regs = self.vm.read_regs(pid=pid)
         task = self.tasks.get(pid)
@@ -3583,6 +4310,7 @@ class ExecutiveState:
         self.task_states[pid_val] = state_entry
         if pid_val in self.tasks:
             self.tasks[pid_val]["trace"] = result.get("enabled")
+        self._push_event_filter()
         result["buffer_size"] = self.trace_buffer_capacity
         return result
 
@@ -3604,6 +4332,7 @@ class ExecutiveState:
                     if buffer.maxlen != new_size:
                         recent = list(buffer)[-new_size:]
                         self.trace_buffers[pid] = deque(recent, maxlen=new_size)
+        self._push_event_filter()
         return {"buffer_size": self.trace_buffer_capacity}
 
     def trace_records(self, pid: int, limit: Optional[int] = None) -> Dict[str, Any]:
@@ -3677,10 +4406,310 @@ class ExecutiveState:
             self.trace_buffers[pid] = buffer
         return self.trace_records(pid)
 
+    def trace_spill_start(
+        self,
+        pid: int,
+        path: str,
+        *,
+        chunk_records: Optional[int] = None,
+        compress: bool = True,
+    ) -> Dict[str, Any]:
+        chunk = trace_format.TRACE_FILE_DEFAULT_CHUNK_RECORDS
+        if chunk_records is not None:
+            try:
+                chunk = int(chunk_records)
+            except (TypeError, ValueError) as exc:
+                raise ValueError("trace spill chunk size must be integer") from exc
+            if chunk <= 0:
+                raise ValueError("trace spill chunk size must be positive")
+        target = Path(path).expanduser()
+        with self.trace_lock:
+            previous = self.trace_spills.pop(pid, None)
+            if previous is not None:
+                previous.close()
+            writer = trace_format.TraceFileWriter(target, chunk_records=chunk, compress=compress)
+            self.trace_spills[pid] = writer
+        # The spill is fed from trace_step events, which the VM only emits
+        # for traced tasks.
+        task = self.tasks.get(pid)
+        if task is not None and not task.get("trace"):
+            self.trace_task(pid, True)
+            self._spill_traced.add(pid)
+        self._push_event_filter()
+        self.log("info", "trace spill started", pid=pid, path=str(target))
+        return {"pid": pid, "active": True, **writer.stats()}
+
+    def trace_spill_stop(self, pid: int) -> Dict[str, Any]:
+        with self.trace_lock:
+            writer = self.trace_spills.pop(pid, None)
+            if writer is None:
+                return {"pid": pid, "active": False}
+            writer.close()
+        if pid in self._spill_traced:
+            self._spill_traced.discard(pid)
+            if pid in self.tasks:
+                try:
+                    self.trace_task(pid, False)
+                except Exception as exc:
+                    self.log("warning", "trace disable after spill failed", pid=pid, error=str(exc))
+        self._push_event_filter()
+        self.log("info", "trace spill stopped", pid=pid, path=str(writer.path), records=writer.records_written)
+        return {"pid": pid, "active": False, **writer.stats()}
+
+    def trace_spill_close_all(self) -> None:
+        """Finish every open spill so its index footer is written (shutdown path)."""
+
+        with self.trace_lock:
+            writers, self.trace_spills = self.trace_spills, {}
+            self._spill_traced.clear()
+            for pid, writer in writers.items():
+                try:
+                    writer.close()
+                except OSError as exc:
+                    self.log("warning", "trace spill close failed", pid=pid, path=str(writer.path), error=str(exc))
+
+    def trace_spill_status(self, pid: int) -> Dict[str, Any]:
+        with self.trace_lock:
+            writer = self.trace_spills.get(pid)
+            if writer is None:
+                return {"pid": pid, "active": False}
+            return {"pid": pid, "active": True, **writer.stats()}
+
     def task_list(self) -> Dict[str, Any]:
         self._refresh_tasks()
         return {"tasks": list(self.tasks.values()), "current_pid": self.current_pid}
 
+    def reverse(self, pid: int, op: str, **options: Any) -> Dict[str, Any]:
+        """Configure or drive VM reverse execution (checkpoint + replay) for ``pid``.
+
+        ``op`` is ``enable``/``disable``/``config``/``stats`` or one of the
+        movement ops ``step``, ``continue`` and ``last_write``; movement leaves
+        the task paused at the reconstructed point like a breakpoint stop.
+        """
+
+        self.get_task(pid)
+        op = str(op or "stats").lower()
+        movement = op not in {"enable", "disable", "config", "stats"}
+        if movement:
+            self._ensure_debug_session(pid)
+            self.stop_auto()
+        with self.lock:
+            info = self.vm.reverse(pid, op, **options)
+        if not movement:
+            return info
+        stop = info.get("stop") or {}
+        pc = self._optional_int(stop.get("pc"))
+        self._set_task_state_pending(
+            pid,
+            "debug_break",
+            target_state="paused",
+            details={"pc": pc, "phase": "reverse"},
+            ts=time.time(),
+        )
+        self._refresh_tasks()
+        self.log("info", "reverse execution", pid=pid, op=op, reason=stop.get("reason"), steps=stop.get("steps"))
+        data: Dict[str, Any] = {"pc": pc, "phase": "reverse", "reason": stop.get("reason")}
+        for key in ("steps", "write_pc", "watch_addr"):
+            if stop.get(key) is not None:
+                data[key] = stop[key]
+        self.emit_event("debug_break", pid=pid, data=data)
+        return info
+
+    def _coverage_listing(self, pid: int, code_len: int) -> List[Dict[str, Any]]:
+        """Decoded, symbol-annotated instructions covering ``[0, code_len)``."""
+
+        listing: List[Dict[str, Any]] = []
+        addr = 0
+        while addr < code_len:
+            chunk, truncated, _ = self._disasm_cached(pid, addr, min(256, (code_len - addr + 3) // 4))
+            if not chunk:
+                break
+            for entry in chunk:
+                if entry["pc"] >= code_len:
+                    break
+                listing.append(dict(entry))
+            addr = (chunk[-1]["pc"] + chunk[-1]["size"]) & 0xFFFFFFFF
+            if truncated:
+                break
+        for entry in listing:
+            entry.setdefault("operands", self._render_operands(entry, None))
+        return listing
+
+    def coverage(
+        self,
+        pid: int,
+        op: str,
+        *,
+        width: Optional[int] = None,
+        edges: Optional[bool] = None,
+        path: Optional[str] = None,
+        annotate: bool = False,
+    ) -> Dict[str, Any]:
+        """Drive the VM's exact per-PC counters; ``dump`` builds the reports.
+
+        The dump joins the counters with the cached disassembly and the
+        ``.sym`` line table: per-line heat, optional annotated disassembly and
+        an lcov tracefile (written to ``path`` when given, else inline).
+        """
+
+        self.get_task(pid)
+        op = str(op or "status").lower()
+        with self.lock:
+            info = self.vm.coverage(pid, op, width=width, edges=edges)
+        if op != "dump" or not info.get("enabled"):
+            return info
+        hits, edge_map = pc_counters.normalise(info)
+        info.pop("counts", None)
+        info.pop("edges", None)
+        listing = self._coverage_listing(pid, int(info.get("slots") or 0) * 4)
+        covered = sum(1 for entry in listing if hits.get(entry["pc"]))
+        info.update(
+            {
+                "executed": sum(hits.values()),
+                "instructions": len(listing),
+                "covered": covered,
+                "coverage_pct": round(100.0 * covered / len(listing), 2) if listing else 0.0,
+                "branches": len(edge_map),
+                "lines": pc_counters.line_heat(listing, hits),
+            }
+        )
+        if annotate:
+            info["annotated"] = pc_counters.annotate(listing, hits, edge_map)
+        program = (self.tasks.get(pid) or {}).get("program")
+        test_name = Path(str(program)).stem if program else f"pid{pid}"
+        report = pc_counters.lcov(listing, hits, edge_map, test_name=test_name)
+        if path:
+            target = Path(path)
+            target.write_text(report, encoding="utf-8")
+            info["path"] = str(target)
+        else:
+            info["lcov"] = report
+        return info
+
+    def _profile_frame(self, pid: int, pc: int) -> Tuple[Optional[str], Optional[str], Optional[int]]:
+        symbol = self.symbol_lookup_addr(pid, pc)
+        line = self.symbol_lookup_line(pid, pc)
+        function = symbol.get("name") if symbol else None
+        if line is None:
+            return function, None, None
+        return function, line.get("file"), self._optional_int(line.get("line"))
+
+    def _profile_task_label(self, pid: int) -> str:
+        program = (self.tasks.get(pid) or {}).get("program")
+        return f"{Path(str(program)).stem}[{pid}]" if program else f"pid{pid}"
+
+    def profile(
+        self,
+        op: str,
+        *,
+        path: Optional[str] = None,
+        lines: bool = False,
+        clear: bool = False,
+        **options: Any,
+    ) -> Dict[str, Any]:
+        """Drive the VM sampling profiler; ``dump`` symbolises the samples.
+
+        The dump reports per-function self/total counts (scaled by the
+        sampling period into estimated instructions), the hottest leaf lines
+        and collapsed-stack text for flame graphs, which is written to
+        ``path`` when given instead of being returned inline.
+        """
+
+        op = str(op or "status").lower()
+        pid = options.get("pid")
+        if pid is not None:
+            self.get_task(int(pid))
+        with self.lock:
+            info = self.vm.profile(op, clear=clear if op == "dump" else None, **options)
+        if op != "dump":
+            return info
+        stacks = info.pop("stacks", None) or []
+        report = hsx_profiler.function_profile(stacks, self._profile_frame, weight=int(info.get("period") or 1))
+        collapsed = hsx_profiler.collapse_stacks(
+            stacks,
+            self._profile_frame,
+            task_label=self._profile_task_label,
+            lines=lines,
+        )
+        info.update(
+            {
+                "unique_stacks": len(stacks),
+                "functions": report["functions"],
+                "lines": report["lines"],
+            }
+        )
+        if path:
+            target = Path(path)
+            target.write_text(collapsed, encoding="utf-8")
+            info["path"] = str(target)
+        else:
+            info["collapsed"] = collapsed
+        self.log("info", "profile dump", samples=report["samples"], stacks=len(stacks), path=info.get("path"))
+        return info
+
+    def fs(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Mount, format, sync or report on the VM's filesystem backend."""
+
+        op = str(op or "stats").lower()
+        with self.lock:
+            info = self.vm.fs(op, **options)
+        if op in {"mount", "format"}:
+            self.log("info", f"fs {op}", backend=info.get("backend"), type=info.get("type"), image=info.get("image"))
+        return info
+
+    def can(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach to, report on or inject a frame into the VM's virtual CAN bus."""
+
+        op = str(op or "stats").lower()
+        with self.lock:
+            info = self.vm.can(op, **options)
+        if op == "attach":
+            self.log("info", "can attach", bitrate=info.get("bitrate"), node=info.get("node"), socket=info.get("socket"))
+        return info
+
+    def uart(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach, configure or report on the VM's simulated UART ports."""
+
+        op = str(op or "stats").lower()
+        with self.lock:
+            info = self.vm.uart(op, **options)
+        if op == "attach":
+            ports = info.get("ports") or {}
+            index = int(options.get("port") or 0)
+            port = ports.get(str(index)) or ports.get(index) or {}
+            self.log("info", "uart attach", port=port.get("port"), baud=port.get("baud"), backend=port.get("backend"))
+        return info
+
+    def gpio(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Attach, drive, replay waveforms into or report on the VM's GPIO bank."""
+
+        op = str(op or "stats").lower()
+        with self.lock:
+            info = self.vm.gpio(op, **options)
+        if op == "replay":
+            self.log("info", "gpio replay", path=options.get("path"), transitions=info.get("replayed"))
+        return info
+
+    def timer(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Report on, cancel or (on a virtual clock) advance the VM's task timers."""
+
+        op = str(op or "stats").lower()
+        with self.lock:
+            info = self.vm.timer(op, **options)
+        if op == "cancel":
+            self.log("info", "timer cancel", timer=options.get("timer"))
+        return info
+
+    def svc_stats(self, op: str, **options: Any) -> Dict[str, Any]:
+        """Per-SVC call/error counts and latency histograms from the VM."""
+
+        op = str(op or "show").lower()
+        with self.lock:
+            info = self.vm.svc_stats(op, **options)
+        if op in ("reset", "snapshot"):
+            self.log("info", f"svc stats {op}", path=info.get("path"))
+        return info
+
     def pause_task(self, pid: int) -> Dict[str, Any]:
         self.get_task(pid)
         if pid not in self.task_state_pending:
@@ -3714,6 +4743,9 @@ class ExecutiveState:
         self.command_registry.pop(pid, None)
         self.mailbox_registry.pop(pid, None)
         self.image_metadata.pop(pid, None)
+        self.trace_spill_stop(pid)
+        self.mem_dirty_seq.pop(pid, None)
+        self.mem_dirty_stamps.pop(pid, None)
         return {"pid": pid, "state": "terminated"}
 
     def set_task_attrs(self, pid: int, *, priority: Optional[int] = None, quantum: Optional[int] = None) -> Dict[str, Any]:
@@ -4219,7 +5251,8 @@ class ExecutiveState:
                 self._update_command_registry_from_event(pid, event, payload)
             if etype == "trace_step" and pid is not None:
                 self._handle_trace_step_event(pid, payload)
-            self.emit_event(event_type, pid=pid, data=payload, ts=event.get("ts"))
+            if self.events_wanted(event_type, pid):
+                self.emit_event(event_type, pid=pid, data=payload, ts=event.get("ts"))
             if etype == "mailbox_wait" and pid is not None:
                 self._mark_task_wait_mailbox(pid, event)
                 self.log(
@@ -4687,13 +5720,10 @@ class _ShellHandler(socketserver.StreamRequestHandler):
         finally:
             self.server.state.events_unsubscribe(token=subscription.token)
 
-class ExecutiveServer(socketserver.ThreadingTCPServer):
-    allow_reuse_address = True
+class ExecutiveRequestDispatcher:
+    """Command dispatch shared by the threaded and selector-based servers."""
 
-    def __init__(self, server_address, state: ExecutiveState):
-        super().__init__(server_address, _ShellHandler)
-        self.state = state
-        state.server = self
+    state: ExecutiveState
 
     def exec_state_handle(self, request: Dict[str, Any]) -> Dict[str, Any]:
         cmd = str(request.get("cmd", "")).lower()
@@ -4746,7 +5776,11 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
             if cmd == "events.subscribe":
                 if session_id is None:
                     raise SessionError("session_required")
-                subscription = self.state.events_subscribe(session_id, filters=request.get("filters"))
+                subscription = self.state.events_subscribe(
+                    session_id,
+                    filters=request.get("filters"),
+                    credits=request.get("credits"),
+                )
                 metrics = self.state.events_metrics(session_id)
                 ack_payload = {
                     "version": 1,
@@ -4763,6 +5797,8 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                 }
                 if subscription.since_seq is not None:
                     ack_payload["events"]["since_seq"] = subscription.since_seq
+                if subscription.credits is not None:
+                    ack_payload["events"]["credits"] = subscription.credits
                 return {"__stream__": {"ack": ack_payload, "subscription": subscription}}
             if cmd == "events.ack":
                 if session_id is None:
@@ -4786,6 +5822,22 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                         "last_ack": metrics.get("last_ack"),
                     },
                 }
+            if cmd == "events.credit":
+                if session_id is None:
+                    raise SessionError("session_required")
+                if "credits" not in request:
+                    raise ValueError("events.credit requires 'credits'")
+                self.state.events_credit(session_id, request.get("credits"))
+                metrics = self.state.events_metrics(session_id)
+                return {
+                    "version": 1,
+                    "status": "ok",
+                    "events": {
+                        "credits": metrics.get("credits"),
+                        "inflight": metrics.get("inflight"),
+                        "held": metrics.get("held"),
+                    },
+                }
             if cmd == "events.unsubscribe":
                 if session_id is None:
                     raise SessionError("session_required")
@@ -4958,7 +6010,10 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                 pid_int = int(pid_value)
                 if op in {"", "list", "ls"}:
                     info = self.state.breakpoint_list(pid_int)
-                    return {"version": 1, "status": "ok", "pid": pid_int, "breakpoints": info.get("breakpoints", [])}
+                    response = {"version": 1, "status": "ok", "pid": pid_int, "breakpoints": info.get("breakpoints", [])}
+                    if info.get("conditions"):
+                        response["conditions"] = info["conditions"]
+                    return response
                 if op in {"set", "add"}:
                     addr_value = request.get("addr")
                     if addr_value is None:
@@ -4968,8 +6023,17 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                     except (TypeError, ValueError) as exc:
                         raise ValueError(f"invalid breakpoint addr '{addr_value}'") from exc
                     self.state.ensure_pid_access(pid_int, session_id)
-                    info = self.state.breakpoint_add(pid_int, addr_int)
-                    return {"version": 1, "status": "ok", "pid": pid_int, "breakpoints": info.get("breakpoints", [])}
+                    info = self.state.breakpoint_add(
+                        pid_int,
+                        addr_int,
+                        condition=request.get("condition"),
+                        hit_condition=request.get("hit_condition", request.get("hitCondition")),
+                        log_message=request.get("log_message", request.get("logMessage")),
+                    )
+                    response = {"version": 1, "status": "ok", "pid": pid_int, "breakpoints": info.get("breakpoints", [])}
+                    if info.get("conditions"):
+                        response["conditions"] = info["conditions"]
+                    return response
                 if op in {"clear", "remove", "rm", "del", "delete"}:
                     addr_value = request.get("addr")
                     if addr_value is None:
@@ -5167,6 +6231,36 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                         else:
                             info = self.state.trace_records(pid_int, limit=limit_value)
                         return {"version": 1, "status": "ok", "trace": info}
+                    if op == "spill":
+                        pid_value = request.get("pid")
+                        if pid_value is None:
+                            raise ValueError("trace spill requires 'pid'")
+                        pid_int = int(pid_value)
+                        action = str(request.get("action") or ("start" if request.get("path") else "status")).lower()
+                        if action == "status":
+                            info = self.state.trace_spill_status(pid_int)
+                            return {"version": 1, "status": "ok", "trace": {"spill": info}}
+                        self.state.ensure_pid_access(pid_int, session_id)
+                        if action in {"stop", "off"}:
+                            info = self.state.trace_spill_stop(pid_int)
+                        elif action in {"start", "on"}:
+                            path_value = request.get("path")
+                            if not path_value:
+                                raise ValueError("trace spill start requires 'path'")
+                            compress_value = request.get("compress", True)
+                            if isinstance(compress_value, str):
+                                compress = compress_value.strip().lower() not in {"0", "false", "off", "no"}
+                            else:
+                                compress = bool(compress_value)
+                            info = self.state.trace_spill_start(
+                                pid_int,
+                                str(path_value),
+                                chunk_records=request.get("chunk"),
+                                compress=compress,
+                            )
+                        else:
+                            raise ValueError(f"unknown trace spill action '{action}'")
+                        return {"version": 1, "status": "ok", "trace": {"spill": info}}
                     raise ValueError(f"unknown trace op '{op}'")
                 pid_value = request.get("pid")
                 if pid_value is None:
@@ -5212,6 +6306,10 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                     raise ValueError("poke requires 'data' hex string")
                 self.state.request_poke(pid, addr, data_hex)
                 return {"version": 1, "status": "ok"}
+            if cmd == "mem_dirty":
+                pid = int(request.get("pid"))
+                dirty = self.state.mem_dirty(pid, since=int(request.get("since", 0) or 0))
+                return {"version": 1, "status": "ok", "dirty": dirty}
             if cmd == "dumpregs":
                 pid = int(request.get("pid"))
                 regs = self.state.request_dump_regs(pid)
@@ -5224,6 +6322,87 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
                 self.state.ensure_pid_access(pid_int, session_id)
                 task = self.state.pause_task(pid_int)
                 return {"version": 1, "status": "ok", "task": task}
+            if cmd == "coverage":
+                pid_value = request.get("pid")
+                if pid_value is None:
+                    raise ValueError("coverage requires 'pid'")
+                pid_int = int(pid_value)
+                self.state.ensure_pid_access(pid_int, session_id)
+                info = self.state.coverage(
+                    pid_int,
+                    str(request.get("op") or "status"),
+                    width=request.get("width"),
+                    edges=request.get("edges"),
+                    path=request.get("path"),
+                    annotate=bool(request.get("annotate", False)),
+                )
+                return {"version": 1, "status": "ok", "coverage": info}
+            if cmd == "profile":
+                options = {
+                    key: request.get(key)
+                    for key in ("pid", "pids", "period", "timer_ms", "clock_hz", "capacity", "max_depth", "path")
+                    if request.get(key) is not None
+                }
+                info = self.state.profile(
+                    str(request.get("op") or "status"),
+                    lines=bool(request.get("lines", False)),
+                    clear=bool(request.get("clear", False)),
+                    **options,
+                )
+                return {"version": 1, "status": "ok", "profile": info}
+            if cmd == "fs":
+                options = {
+                    key: request.get(key)
+                    for key in ("backend", "type", "image", "page_size", "pages_per_block", "blocks", "cache_pages", "readahead")
+                    if request.get(key) is not None
+                }
+                info = self.state.fs(str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "fs": info}
+            if cmd == "can":
+                options = {
+                    key: request.get(key)
+                    for key in ("bitrate", "node", "host", "port", "id", "data", "flags", "tx_id", "rx_id", "block_size", "st_min_us")
+                    if request.get(key) is not None
+                }
+                info = self.state.can(str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "can": info}
+            if cmd == "uart":
+                options = {
+                    key: request.get(key)
+                    for key in ("port", "baud", "parity", "stop_bits", "tx_size", "rx_size", "backend", "host", "listen", "data")
+                    if request.get(key) is not None
+                }
+                info = self.state.uart(str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "uart": info}
+            if cmd == "gpio":
+                options = {
+                    key: request.get(key)
+                    for key in ("pins", "pin", "value", "path", "debounce_us", "coalesce_us", "edge")
+                    if request.get(key) is not None
+                }
+                info = self.state.gpio(str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "gpio": info}
+            if cmd == "timer":
+                options = {key: request.get(key) for key in ("us", "timer", "limit") if request.get(key) is not None}
+                info = self.state.timer(str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "timer": info}
+            if cmd == "stats":
+                options = {key: request.get(key) for key in ("top", "buckets", "path") if request.get(key) is not None}
+                info = self.state.svc_stats(str(request.get("op") or "show"), **options)
+                return {"version": 1, "status": "ok", "stats": info}
+            if cmd == "reverse":
+                pid_value = request.get("pid")
+                if pid_value is None:
+                    raise ValueError("reverse requires 'pid'")
+                pid_int = int(pid_value)
+                self.state.ensure_pid_access(pid_int, session_id)
+                options = {
+                    key: request.get(key)
+                    for key in ("count", "addr", "width", "enable", "interval", "keyframe_every", "max_bytes")
+                    if request.get(key) is not None
+                }
+                info = self.state.reverse(pid_int, str(request.get("op") or "stats"), **options)
+                return {"version": 1, "status": "ok", "reverse": info}
             if cmd == "resume":
                 pid_value = request.get("pid")
                 if pid_value is None:
@@ -5343,6 +6522,392 @@ class ExecutiveServer(socketserver.ThreadingTCPServer):
             return {"version": 1, "status": "error", "error": str(exc)}
 
 
+class ExecutiveServer(ExecutiveRequestDispatcher, socketserver.ThreadingTCPServer):
+    """Thread-per-connection server; kept for debugging and old deployments."""
+
+    allow_reuse_address = True
+
+    def __init__(self, server_address, state: ExecutiveState):
+        super().__init__(server_address, _ShellHandler)
+        self.state = state
+        state.server = self
+
+
+class _SelectorConnection:
+    __slots__ = (
+        "sock",
+        "addr",
+        "rbuf",
+        "wbuf",
+        "wbytes",
+        "requests",
+        "busy",
+        "subscription",
+        "stream_blocked",
+        "closing",
+        "closed",
+        "mask",
+    )
+
+    def __init__(self, sock: socket.socket, addr: Any) -> None:
+        self.sock = sock
+        self.addr = addr
+        self.rbuf = bytearray()
+        self.wbuf: Deque[memoryview] = deque()
+        self.wbytes = 0
+        self.requests: Deque[bytes] = deque()
+        self.busy = False
+        self.subscription: Optional[EventSubscription] = None
+        self.stream_blocked = False
+        self.closing = False
+        self.closed = False
+        self.mask = 0
+
+
+class SelectorExecutiveServer(ExecutiveRequestDispatcher):
+    """Event-loop server: one selector thread plus a small command worker pool.
+
+    Idle sessions cost a socket and a few buffers instead of a thread.  Each
+    connection runs one command at a time, in order, on the worker pool (VM
+    RPCs block); responses and event streams are queued on a non-blocking
+    per-connection write buffer.  A stream stops draining its subscription
+    once ``write_high_water`` bytes are buffered, so a slow reader backs up
+    into the subscription queue where the ``max_events``/ack back-pressure
+    rules bound it.  Events are JSON-encoded once and shared by every stream.
+    """
+
+    max_line_bytes = 1 << 20
+    max_pipelined = 64
+    write_high_water = 256 * 1024
+    write_low_water = 64 * 1024
+    encoded_cache_size = 4096
+
+    def __init__(self, server_address, state: ExecutiveState, *, workers: int = 4):
+        self.state = state
+        self.socket = socket.create_server(server_address, backlog=1024)
+        self.socket.setblocking(False)
+        self.server_address = self.socket.getsockname()
+        self.selector = selectors.DefaultSelector()
+        self.selector.register(self.socket, selectors.EVENT_READ, "listen")
+        self._wake_r, self._wake_w = socket.socketpair()
+        self._wake_r.setblocking(False)
+        self._wake_w.setblocking(False)
+        self.selector.register(self._wake_r, selectors.EVENT_READ, "wake")
+        self._wake_lock = threading.Lock()
+        self._wake_pending = False
+        self._executor = ThreadPoolExecutor(max_workers=max(1, int(workers)), thread_name_prefix="execd-cmd")
+        self._completions: Deque[Tuple[_SelectorConnection, Dict[str, Any]]] = deque()
+        self._ready_streams: Deque[_SelectorConnection] = deque()
+        self._encoded: "OrderedDict[int, bytes]" = OrderedDict()
+        self.connections: Set[_SelectorConnection] = set()
+        self.stats = {"accepted": 0, "closed": 0, "requests": 0, "events_sent": 0, "encode_hits": 0, "write_stalls": 0}
+        self._running = False
+        self._stopped = threading.Event()
+        self._stopped.set()
+        state.server = self
+
+    # -- lifecycle -----------------------------------------------------
+    def serve_forever(self, poll_interval: float = 0.5) -> None:
+        self._running = True
+        self._stopped.clear()
+        try:
+            while self._running:
+                for key, mask in self.selector.select(timeout=poll_interval):
+                    tag = key.data
+                    if tag == "listen":
+                        self._accept()
+                    elif tag == "wake":
+                        self._drain_wake()
+                    else:
+                        if mask & selectors.EVENT_READ:
+                            self._on_readable(tag)
+                        if mask & selectors.EVENT_WRITE and not tag.closed:
+                            self._flush(tag)
+                self._process_completions()
+                self._pump_streams()
+        finally:
+            self._stopped.set()
+
+    def shutdown(self) -> None:
+        self._running = False
+        self._wake()
+        self._stopped.wait(timeout=5.0)
+
+    def server_close(self) -> None:
+        for conn in list(self.connections):
+            self._close(conn)
+        self._executor.shutdown(wait=False)
+        for sock in (self.socket, self._wake_r, self._wake_w):
+            try:
+                self.selector.unregister(sock)
+            except (KeyError, ValueError):
+                pass
+            sock.close()
+        self.selector.close()
+
+    def describe(self) -> Dict[str, Any]:
+        # Called from worker threads; tuple() copies the set without yielding the GIL.
+        connections = tuple(self.connections)
+        streaming = sum(1 for conn in connections if conn.subscription is not None)
+        buffered = sum(conn.wbytes for conn in connections)
+        return {"kind": "selector", "connections": len(connections), "streaming": streaming, "buffered_bytes": buffered, **self.stats}
+
+    # -- wakeups from worker and broadcaster threads --------------------
+    def _wake(self) -> None:
+        with self._wake_lock:
+            if self._wake_pending:
+                return
+            self._wake_pending = True
+        try:
+            self._wake_w.send(b"\0")
+        except (BlockingIOError, OSError):
+            pass
+
+    def _drain_wake(self) -> None:
+        with self._wake_lock:
+            self._wake_pending = False
+        try:
+            while self._wake_r.recv(4096):
+                pass
+        except (BlockingIOError, OSError):
+            pass
+
+    def _stream_notify(self, conn: _SelectorConnection) -> None:
+        self._ready_streams.append(conn)
+        self._wake()
+
+    # -- socket handling -------------------------------------------------
+    def _accept(self) -> None:
+        while True:
+            try:
+                sock, addr = self.socket.accept()
+            except (BlockingIOError, InterruptedError):
+                return
+            except OSError:
+                return
+            sock.setblocking(False)
+            conn = _SelectorConnection(sock, addr)
+            self.connections.add(conn)
+            self.stats["accepted"] += 1
+            self._update_interest(conn)
+
+    def _update_interest(self, conn: _SelectorConnection) -> None:
+        if conn.closed:
+            return
+        want_read = conn.subscription is not None or (
+            len(conn.requests) < self.max_pipelined and conn.wbytes < self.write_high_water
+        )
+        mask = (selectors.EVENT_READ if want_read else 0) | (selectors.EVENT_WRITE if conn.wbuf else 0)
+        if mask == conn.mask:
+            return
+        if conn.mask == 0:
+            self.selector.register(conn.sock, mask, conn)
+        elif mask == 0:
+            self.selector.unregister(conn.sock)
+        else:
+            self.selector.modify(conn.sock, mask, conn)
+        conn.mask = mask
+
+    def _close(self, conn: _SelectorConnection) -> None:
+        if conn.closed:
+            return
+        conn.closed = True
+        if conn.mask:
+            try:
+                self.selector.unregister(conn.sock)
+            except (KeyError, ValueError):
+                pass
+            conn.mask = 0
+        try:
+            conn.sock.close()
+        except OSError:
+            pass
+        self.connections.discard(conn)
+        self.stats["closed"] += 1
+        subscription = conn.subscription
+        if subscription is not None:
+            subscription.notify = None
+            self.state.events_unsubscribe(token=subscription.token)
+        conn.wbuf.clear()
+        conn.wbytes = 0
+
+    def _on_readable(self, conn: _SelectorConnection) -> None:
+        try:
+            data = conn.sock.recv(65536)
+        except (BlockingIOError, InterruptedError):
+            return
+        except OSError:
+            self._close(conn)
+            return
+        if not data:
+            self._close(conn)
+            return
+        if conn.subscription is not None:
+            # Streams are one-way once subscribed, as with the threaded server.
+            return
+        conn.rbuf += data
+        while True:
+            newline = conn.rbuf.find(b"\n")
+            if newline < 0:
+                break
+            line = bytes(conn.rbuf[:newline])
+            del conn.rbuf[: newline + 1]
+            if line.strip():
+                conn.requests.append(line)
+        if len(conn.rbuf) > self.max_line_bytes:
+            self._queue_write(conn, self._encode({"version": 1, "status": "error", "error": "request_too_large"}))
+            conn.closing = True
+            conn.rbuf.clear()
+        self._dispatch(conn)
+        self._update_interest(conn)
+
+    def _queue_write(self, conn: _SelectorConnection, data: bytes) -> None:
+        if conn.closed or not data:
+            return
+        conn.wbuf.append(memoryview(data))
+        conn.wbytes += len(data)
+
+    def _flush(self, conn: _SelectorConnection) -> None:
+        while conn.wbuf:
+            head = conn.wbuf[0]
+            try:
+                sent = conn.sock.send(head)
+            except (BlockingIOError, InterruptedError):
+                break
+            except OSError:
+                self._close(conn)
+                return
+            conn.wbytes -= sent
+            if sent < len(head):
+                conn.wbuf[0] = head[sent:]
+                break
+            conn.wbuf.popleft()
+        if not conn.wbuf and conn.closing:
+            self._close(conn)
+            return
+        if conn.stream_blocked and conn.wbytes <= self.write_low_water:
+            conn.stream_blocked = False
+            self._ready_streams.append(conn)
+        self._dispatch(conn)
+        self._update_interest(conn)
+
+    # -- commands ----------------------------------------------------------
+    @staticmethod
+    def _encode(payload: Dict[str, Any]) -> bytes:
+        return json.dumps(payload, separators=(",", ":")).encode("utf-8") + b"\n"
+
+    def _dispatch(self, conn: _SelectorConnection) -> None:
+        while not conn.busy and conn.requests and conn.subscription is None and not conn.closing:
+            if conn.wbytes >= self.write_high_water:
+                return
+            line = conn.requests.popleft()
+            try:
+                request = json.loads(line.decode("utf-8"))
+            except (json.JSONDecodeError, UnicodeDecodeError):
+                self._queue_write(conn, self._encode({"version": 1, "status": "error", "error": "invalid_json"}))
+                continue
+            if not isinstance(request, dict):
+                self._queue_write(conn, self._encode({"version": 1, "status": "error", "error": "invalid_request"}))
+                continue
+            conn.busy = True
+            self.stats["requests"] += 1
+            self._executor.submit(self._run_request, conn, request)
+        if conn.wbuf:
+            self._flush_soon(conn)
+
+    def _flush_soon(self, conn: _SelectorConnection) -> None:
+        if not conn.closed and not (conn.mask & selectors.EVENT_WRITE):
+            self._update_interest(conn)
+
+    def _run_request(self, conn: _SelectorConnection, request: Dict[str, Any]) -> None:
+        try:
+            self.state.log("debug", "shell request", command=str(request.get("cmd")), session=request.get("session"))
+        except Exception:
+            pass
+        try:
+            response = self.exec_state_handle(request)
+        except Exception as exc:  # pragma: no cover - exec_state_handle reports its own errors
+            response = {"version": 1, "status": "error", "error": str(exc)}
+        self._completions.append((conn, response))
+        self._wake()
+
+    def _process_completions(self) -> None:
+        while self._completions:
+            conn, response = self._completions.popleft()
+            conn.busy = False
+            stream_info = response.get("__stream__") if isinstance(response, dict) else None
+            subscription: Optional[EventSubscription] = stream_info.get("subscription") if stream_info else None
+            if conn.closed:
+                if subscription is not None:
+                    self.state.events_unsubscribe(token=subscription.token)
+                continue
+            if stream_info:
+                ack_payload = stream_info.get("ack")
+                if ack_payload is not None:
+                    self._queue_write(conn, self._encode(ack_payload))
+                if subscription is None:
+                    conn.closing = True
+                else:
+                    conn.subscription = subscription
+                    conn.requests.clear()
+                    conn.rbuf.clear()
+                    subscription.notify = lambda conn=conn: self._stream_notify(conn)
+                    self._ready_streams.append(conn)
+            else:
+                self._queue_write(conn, self._encode(response))
+            self._dispatch(conn)
+            self._flush(conn)
+
+    # -- event streams -------------------------------------------------
+    def _encode_event(self, event: Dict[str, Any]) -> bytes:
+        seq = event.get("seq")
+        if isinstance(seq, int):
+            cached = self._encoded.get(seq)
+            if cached is not None:
+                self.stats["encode_hits"] += 1
+                return cached
+        data = self._encode(event)
+        if isinstance(seq, int):
+            self._encoded[seq] = data
+            if len(self._encoded) > self.encoded_cache_size:
+                self._encoded.popitem(last=False)
+        return data
+
+    def _pump_streams(self) -> None:
+        while self._ready_streams:
+            conn = self._ready_streams.popleft()
+            if conn.closed or conn.subscription is None or conn.stream_blocked:
+                continue
+            self._drain_subscription(conn)
+
+    def _drain_subscription(self, conn: _SelectorConnection) -> None:
+        subscription = conn.subscription
+        if subscription is None:
+            return
+        while not conn.closed:
+            drained_all = False
+            while conn.wbytes < self.write_high_water:
+                with subscription.condition:
+                    event = subscription.queue.popleft() if subscription.queue else None
+                    active = subscription.active
+                if event is None:
+                    drained_all = True
+                    if not active:
+                        conn.closing = True
+                    break
+                self._queue_write(conn, self._encode_event(event))
+                self.stats["events_sent"] += 1
+            self._flush(conn)
+            if drained_all or conn.closed:
+                return
+            if conn.wbytes > self.write_low_water:
+                # The socket is full: leave the rest in the subscription queue
+                # and resume from _flush once the reader catches up.
+                conn.stream_blocked = True
+                self.stats["write_stalls"] += 1
+                return
+
+
 def main() -> None:
     parser = argparse.ArgumentParser(description="HSX executive daemon")
     parser.add_argument("--vm-host", default="127.0.0.1", help="HSX VM host")
@@ -5350,6 +6915,13 @@ def main() -> None:
     parser.add_argument("--listen", type=int, default=9998, help="Shell listen port")
     parser.add_argument("--listen-host", default="127.0.0.1", help="Shell listen host")
     parser.add_argument("--step", type=int, default=1, help="Instructions per auto step batch")
+    parser.add_argument(
+        "--server",
+        choices=("selector", "threaded"),
+        default="selector",
+        help="Shell server model: one event loop (default) or a thread per connection",
+    )
+    parser.add_argument("--workers", type=int, default=4, help="Command worker threads for the selector server")
     args = parser.parse_args()
 
     vm = VMClient(args.vm_host, args.vm_port)
@@ -5363,7 +6935,10 @@ def main() -> None:
             print("[execd] auto-attached to VM")
     except Exception as exc:
         print(f"[execd] auto-attach failed: {exc}", file=sys.stderr)
-    server = ExecutiveServer((args.listen_host, args.listen), state)
+    if args.server == "threaded":
+        server = ExecutiveServer((args.listen_host, args.listen), state)
+    else:
+        server = SelectorExecutiveServer((args.listen_host, args.listen), state, workers=args.workers)
     print(f"[execd] connected to VM at {args.vm_host}:{args.vm_port}")
     print(f"[execd] listening for shell on {args.listen_host}:{args.listen}")
     try:
@@ -5373,6 +6948,7 @@ def main() -> None:
     finally:
         server.server_close()
         state.stop_auto()
+        state.trace_spill_close_all()
         try:
             state.vm.detach()
         except Exception:
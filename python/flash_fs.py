@@ -0,0 +1,940 @@
+#!/usr/bin/env python3
+"""Log-structured flash filesystem simulator behind the ``hsx_fs.h`` SVCs.
+
+:class:`FlashFS` is a drop-in replacement for the VM's in-memory ``FSStub``
+that stores files on a simulated NOR or NAND part (:class:`FlashDevice`).
+The device enforces the flash rules the firmware lives with: pages can only
+be programmed once after their erase block has been erased, erases work on
+whole blocks and every erase wears the block.  Each operation is charged a
+per-part latency so I/O patterns can be compared by simulated device time.
+
+On top of the device the filesystem is a log: every change appends a page
+(inode record, data chunk or deletion tombstone) at the write head and
+supersedes older pages, which become obsolete.  Nothing is updated in place;
+when free blocks run low the garbage collector picks the block with the
+fewest live pages, copies those to the head and erases it.  New blocks are
+taken least-worn first.  The in-RAM index (rebuilt by replaying the log on
+mount) keeps each directory's entries in a sorted list searched with
+``bisect``, so path lookups cost O(log n) per component and listings come
+out ordered without sorting.  Reads go through an LRU page cache with
+sequential readahead, and partial-chunk writes are gathered in a per-file
+write buffer that is flushed when the chunk fills, on close or on ``sync``.
+"""
+
+from __future__ import annotations
+
+import struct
+from array import array
+from bisect import bisect_left
+from collections import OrderedDict
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Set, Tuple, Union
+
+# hsx_hal_types.h status codes
+HSX_HAL_OK = 0
+HSX_HAL_ERROR = -1
+HSX_HAL_BUSY = -3
+HSX_HAL_INVALID_PARAM = -4
+HSX_HAL_NO_MEMORY = -5
+
+# hsx_fs.h open flags
+HSX_FS_O_RDONLY = 0x0001
+HSX_FS_O_WRONLY = 0x0002
+HSX_FS_O_RDWR = 0x0003
+HSX_FS_O_CREAT = 0x0004
+HSX_FS_O_TRUNC = 0x0008
+HSX_FS_O_APPEND = 0x0010
+
+# Representative part geometries and latencies (microseconds per operation).
+GEOMETRIES: Dict[str, Dict[str, int]] = {
+    "nor": {"page_size": 256, "pages_per_block": 16, "blocks": 256, "read_us": 3, "program_us": 700, "erase_us": 45000},
+    "nand": {"page_size": 2048, "pages_per_block": 64, "blocks": 128, "read_us": 25, "program_us": 250, "erase_us": 2000},
+}
+
+DEFAULT_CACHE_PAGES = 32
+DEFAULT_READAHEAD = 4
+GC_RESERVE_BLOCKS = 1
+WEAR_SPREAD_LIMIT = 16  # erase-count gap that makes GC move cold blocks
+MAX_NAME = 64
+ROOT_INO = 1
+
+_MAGIC = 0x4653  # "FS"
+_KIND_INODE = 1
+_KIND_DATA = 2
+_KIND_TOMBSTONE = 3
+# magic, kind, flags, seq, ino, arg (parent or chunk), size, payload length
+_HEADER = struct.Struct("<HBBIIIIHxx")
+_INODE_META = struct.Struct("<BI")  # is_dir, truncation seq
+_META_CHUNK = -1  # owner chunk index of an inode record
+_TOMB_CHUNK = -2  # owner chunk index of a tombstone
+
+
+class FlashError(RuntimeError):
+    """Raised when the simulated part is driven outside its rules."""
+
+
+class FlashDevice:
+    """Page-programmable, block-erasable flash image with wear counters."""
+
+    def __init__(
+        self,
+        *,
+        page_size: int,
+        pages_per_block: int,
+        blocks: int,
+        read_us: int = 0,
+        program_us: int = 0,
+        erase_us: int = 0,
+        image: Optional[bytes] = None,
+    ) -> None:
+        if page_size <= _HEADER.size + _INODE_META.size + MAX_NAME:
+            raise ValueError(f"page_size must exceed {_HEADER.size + _INODE_META.size + MAX_NAME} bytes")
+        if pages_per_block < 2 or blocks < GC_RESERVE_BLOCKS + 2:
+            raise ValueError("flash needs at least 2 pages per block and 3 blocks")
+        self.page_size = int(page_size)
+        self.pages_per_block = int(pages_per_block)
+        self.blocks = int(blocks)
+        self.pages = self.pages_per_block * self.blocks
+        self.read_us = int(read_us)
+        self.program_us = int(program_us)
+        self.erase_us = int(erase_us)
+        size = self.pages * self.page_size
+        if image is None:
+            self.data = bytearray(b"\xff" * size)
+        else:
+            if len(image) != size:
+                raise ValueError(f"flash image is {len(image)} bytes, geometry needs {size}")
+            self.data = bytearray(image)
+        self.erased_page = b"\xff" * self.page_size
+        self.erase_counts = array("I", bytes(4 * self.blocks))
+        self.reads = 0
+        self.programs = 0
+        self.erases = 0
+        self.bytes_read = 0
+        self.bytes_programmed = 0
+        self.busy_us = 0
+
+    @property
+    def capacity(self) -> int:
+        return self.pages * self.page_size
+
+    def _span(self, page: int) -> Tuple[int, int]:
+        if not 0 <= page < self.pages:
+            raise FlashError(f"page {page} out of range")
+        start = page * self.page_size
+        return start, start + self.page_size
+
+    def read_page(self, page: int) -> bytes:
+        start, end = self._span(page)
+        self.reads += 1
+        self.bytes_read += self.page_size
+        self.busy_us += self.read_us
+        return bytes(self.data[start:end])
+
+    def is_erased(self, page: int) -> bool:
+        start, end = self._span(page)
+        return self.data[start:end] == self.erased_page
+
+    def program_page(self, page: int, payload: bytes) -> None:
+        start, end = self._span(page)
+        if len(payload) > self.page_size:
+            raise FlashError(f"page program of {len(payload)} bytes exceeds page size")
+        if self.data[start:end] != self.erased_page:
+            raise FlashError(f"page {page} programmed without an erase")
+        self.data[start : start + len(payload)] = payload
+        self.programs += 1
+        self.bytes_programmed += self.page_size
+        self.busy_us += self.program_us
+
+    def erase_block(self, block: int) -> None:
+        if not 0 <= block < self.blocks:
+            raise FlashError(f"block {block} out of range")
+        start = block * self.pages_per_block * self.page_size
+        end = start + self.pages_per_block * self.page_size
+        self.data[start:end] = b"\xff" * (end - start)
+        self.erase_counts[block] += 1
+        self.erases += 1
+        self.busy_us += self.erase_us
+
+    def stats(self) -> Dict[str, Any]:
+        counts = self.erase_counts
+        return {
+            "reads": self.reads,
+            "programs": self.programs,
+            "erases": self.erases,
+            "bytes_read": self.bytes_read,
+            "bytes_programmed": self.bytes_programmed,
+            "busy_us": self.busy_us,
+            "wear": {
+                "min": min(counts),
+                "max": max(counts),
+                "mean": round(sum(counts) / len(counts), 3),
+            },
+        }
+
+
+@dataclass
+class _Inode:
+    ino: int
+    parent: int
+    name: str
+    is_dir: bool
+    meta_page: Optional[int] = None
+    meta_seq: int = 0
+    trunc_seq: int = 0
+    size: int = 0
+    flushed_size: int = 0
+    chunks: Dict[int, int] = field(default_factory=dict)  # chunk -> page
+    names: List[str] = field(default_factory=list)  # sorted child names (dirs)
+    children: List[int] = field(default_factory=list)  # inos parallel to names
+
+
+class FlashFS:
+    """``hsx_fs.h`` filesystem on a :class:`FlashDevice` (``FSStub`` API)."""
+
+    err_invalid_path = HSX_HAL_INVALID_PARAM
+
+    def __init__(
+        self,
+        device: FlashDevice,
+        *,
+        cache_pages: int = DEFAULT_CACHE_PAGES,
+        readahead: int = DEFAULT_READAHEAD,
+        kind: str = "custom",
+        image_path: Optional[Union[str, Path]] = None,
+    ) -> None:
+        self.device = device
+        self.kind = kind
+        self.image_path = Path(image_path) if image_path is not None else None
+        self.payload_size = device.page_size - _HEADER.size
+        self.cache_pages = max(int(cache_pages), 0)
+        self.readahead = max(int(readahead), 0)
+        self.fds: Dict[int, Dict[str, Any]] = {}
+        self.next_fd = 3
+        self.cache_hits = 0
+        self.cache_misses = 0
+        self.readahead_pages = 0
+        self.readahead_hits = 0
+        self.gc_runs = 0
+        self.gc_pages_moved = 0
+        self.wear_moves = 0
+        self.user_bytes_written = 0
+        self.user_bytes_read = 0
+        self.mount()
+
+    @classmethod
+    def create(
+        cls,
+        kind: str = "nor",
+        *,
+        image_path: Optional[Union[str, Path]] = None,
+        cache_pages: int = DEFAULT_CACHE_PAGES,
+        readahead: int = DEFAULT_READAHEAD,
+        **geometry: Any,
+    ) -> "FlashFS":
+        """Build a filesystem on a named part, loading ``image_path`` if present."""
+
+        key = str(kind or "nor").lower()
+        if key not in GEOMETRIES:
+            raise ValueError(f"unknown flash type '{kind}' (expected one of {', '.join(sorted(GEOMETRIES))})")
+        params: Dict[str, Any] = dict(GEOMETRIES[key])
+        params.update({name: int(value) for name, value in geometry.items() if value is not None})
+        image = None
+        if image_path is not None and Path(image_path).exists():
+            image = Path(image_path).read_bytes()
+        device = FlashDevice(image=image, **params)
+        return cls(device, cache_pages=cache_pages, readahead=readahead, kind=key, image_path=image_path)
+
+    # ------------------------------------------------------------------
+    # Mount / format
+    # ------------------------------------------------------------------
+    def _reset_index(self) -> None:
+        dev = self.device
+        self.inodes: Dict[int, _Inode] = {ROOT_INO: _Inode(ROOT_INO, ROOT_INO, "", True)}
+        self.seq = 0
+        self.next_ino = ROOT_INO + 1
+        self.live = array("H", bytes(2 * dev.blocks))  # live pages per block
+        self.used = array("H", bytes(2 * dev.blocks))  # programmed pages per block
+        self.page_ino = array("I", bytes(4 * dev.pages))  # owning inode of each programmed page
+        self.owner: Dict[int, Tuple[int, int]] = {}  # live page -> (ino, chunk)
+        self.stale: Dict[int, int] = {}  # ino -> obsolete pages still on flash
+        self.tombstones: Dict[int, int] = {}  # deleted ino -> tombstone page
+        self.free_blocks: Set[int] = set()
+        self.head_block: Optional[int] = None
+        self.head_page = 0
+        self.cache: "OrderedDict[int, bytes]" = OrderedDict()
+        self._prefetched: Set[int] = set()
+        self._dirty: Dict[int, Tuple[int, bytearray]] = {}
+        self._gc_active = False
+
+    def mount(self) -> None:
+        """Rebuild the RAM index by replaying every page of the log."""
+
+        self._reset_index()
+        self.fds.clear()
+        dev = self.device
+        metas: Dict[int, Tuple[int, int, int, int, bool, int, str]] = {}  # ino -> (seq, page, parent, size, dir, trunc, name)
+        datas: Dict[Tuple[int, int], Tuple[int, int, int]] = {}  # (ino, chunk) -> (seq, page, size)
+        tombs: Dict[int, Tuple[int, int]] = {}
+        records: List[Tuple[int, int]] = []  # (page, ino) of every parsed page
+        last_seq_page = (-1, -1)
+        for block in range(dev.blocks):
+            used = 0
+            for index in range(dev.pages_per_block):
+                page = block * dev.pages_per_block + index
+                raw = dev.read_page(page)
+                if raw == dev.erased_page:
+                    continue
+                used = index + 1
+                magic, kind, _flags, seq, ino, arg, size, length = _HEADER.unpack_from(raw)
+                if magic != _MAGIC:
+                    continue
+                records.append((page, ino))
+                if seq > last_seq_page[0]:
+                    last_seq_page = (seq, page)
+                self.seq = max(self.seq, seq)
+                self.next_ino = max(self.next_ino, ino + 1)
+                if kind == _KIND_INODE:
+                    is_dir, trunc = _INODE_META.unpack_from(raw, _HEADER.size)
+                    name = raw[_HEADER.size + _INODE_META.size : _HEADER.size + length].decode("utf-8", "replace")
+                    if ino not in metas or seq > metas[ino][0]:
+                        metas[ino] = (seq, page, arg, size, bool(is_dir), trunc, name)
+                elif kind == _KIND_DATA:
+                    key = (ino, arg)
+                    if key not in datas or seq > datas[key][0]:
+                        datas[key] = (seq, page, size)
+                elif kind == _KIND_TOMBSTONE:
+                    if ino not in tombs or seq > tombs[ino][0]:
+                        tombs[ino] = (seq, page)
+            self.used[block] = used
+            if used == 0:
+                self.free_blocks.add(block)
+
+        for ino, (seq, page, parent, size, is_dir, trunc, name) in metas.items():
+            tomb = tombs.get(ino)
+            if tomb is not None and tomb[0] > seq:
+                continue
+            node = _Inode(ino, parent, name, is_dir, meta_page=page, meta_seq=seq, trunc_seq=trunc, size=size, flushed_size=size)
+            self.inodes[ino] = node
+        for (ino, chunk), (seq, page, size) in datas.items():
+            node = self.inodes.get(ino)
+            if node is None or node.is_dir or seq < node.trunc_seq:
+                continue
+            node.chunks[chunk] = page
+            if seq > node.meta_seq:
+                node.size = node.flushed_size = max(node.flushed_size, size)
+        # Link directories; anything whose parent chain is gone is an orphan.
+        for node in sorted(self.inodes.values(), key=lambda item: item.ino):
+            if node.ino == ROOT_INO:
+                continue
+            parent = self.inodes.get(node.parent)
+            if parent is None or not parent.is_dir:
+                continue
+            self._link(parent, node)
+        reachable = self._reachable()
+        for ino in [ino for ino in self.inodes if ino not in reachable]:
+            del self.inodes[ino]
+        for node in self.inodes.values():
+            node.chunks = {chunk: page for chunk, page in node.chunks.items() if chunk * self.payload_size < node.size}
+            if node.meta_page is not None:
+                self._own(node.meta_page, node.ino, _META_CHUNK)
+            for chunk, page in node.chunks.items():
+                self._own(page, node.ino, chunk)
+        for page, ino in records:
+            self.page_ino[page] = ino
+            if page not in self.owner:
+                self.stale[ino] = self.stale.get(ino, 0) + 1
+        for ino, (_seq, page) in tombs.items():
+            if ino not in self.inodes and self.stale.get(ino, 0) > 1:
+                self.stale[ino] -= 1  # the tombstone itself
+                self._own(page, ino, _TOMB_CHUNK)
+                self.tombstones[ino] = page
+        # Resume appending after the newest page when its block has room.
+        if last_seq_page[1] >= 0:
+            block = last_seq_page[1] // dev.pages_per_block
+            if self.used[block] < dev.pages_per_block:
+                self.head_block = block
+                self.head_page = self.used[block]
+
+    def _reachable(self) -> Set[int]:
+        seen = {ROOT_INO}
+        pending = [ROOT_INO]
+        while pending:
+            node = self.inodes[pending.pop()]
+            for child in node.children:
+                if child not in seen:
+                    seen.add(child)
+                    pending.append(child)
+        return seen
+
+    def format(self) -> None:
+        """Erase every block (keeping wear counters) and mount empty."""
+
+        for block in range(self.device.blocks):
+            self.device.erase_block(block)
+        self.mount()
+
+    # ------------------------------------------------------------------
+    # Log writer and garbage collector
+    # ------------------------------------------------------------------
+    def _own(self, page: int, ino: int, chunk: int) -> None:
+        self.owner[page] = (ino, chunk)
+        self.live[page // self.device.pages_per_block] += 1
+
+    def _obsolete(self, page: Optional[int]) -> None:
+        if page is None or page not in self.owner:
+            return
+        ino, chunk = self.owner.pop(page)
+        self.live[page // self.device.pages_per_block] -= 1
+        if chunk != _TOMB_CHUNK:
+            self.stale[ino] = self.stale.get(ino, 0) + 1
+
+    def _take_block(self, *, reserve: int) -> Optional[int]:
+        if len(self.free_blocks) <= reserve:
+            return None
+        counts = self.device.erase_counts
+        block = min(self.free_blocks, key=lambda item: (counts[item], item))
+        self.free_blocks.discard(block)
+        return block
+
+    def _next_page(self) -> Optional[int]:
+        dev = self.device
+        if self.head_block is None or self.head_page >= dev.pages_per_block:
+            self.head_block = None
+            if not self._gc_active:
+                self._collect()
+            block = self._take_block(reserve=0 if self._gc_active else GC_RESERVE_BLOCKS)
+            if block is None:
+                return None
+            self.head_block = block
+            self.head_page = 0
+        page = self.head_block * dev.pages_per_block + self.head_page
+        self.head_page += 1
+        self.used[self.head_block] = self.head_page
+        return page
+
+    def _program(self, raw: bytes, ino: int, chunk: int) -> Optional[int]:
+        page = self._next_page()
+        if page is None:
+            return None
+        self.device.program_page(page, raw)
+        self.page_ino[page] = ino
+        self._own(page, ino, chunk)
+        return page
+
+    def _append(self, kind: int, ino: int, arg: int, size: int, payload: bytes, chunk: int) -> Optional[int]:
+        raw = _HEADER.pack(_MAGIC, kind, 0, self.seq + 1, ino, arg, size, len(payload)) + payload
+        page = self._program(raw, ino, chunk)
+        if page is not None:
+            self.seq += 1
+        return page
+
+    def _collect(self) -> None:
+        """Greedy GC: reclaim least-live blocks until the reserve is restored."""
+
+        dev = self.device
+        self._gc_active = True
+        levelled = False
+        try:
+            while len(self.free_blocks) <= GC_RESERVE_BLOCKS:
+                candidates = [
+                    block
+                    for block in range(dev.blocks)
+                    if block not in self.free_blocks and block != self.head_block and self.used[block]
+                ]
+                if not candidates:
+                    return
+                counts = dev.erase_counts
+                victim = min(candidates, key=lambda item: (self.live[item], counts[item], item))
+                coldest = min(candidates, key=lambda item: (counts[item], item))
+                if not levelled and max(counts) - counts[coldest] > WEAR_SPREAD_LIMIT:
+                    # Static wear levelling: recycle a block pinned by cold data.
+                    victim = coldest
+                    levelled = True
+                    self.wear_moves += 1
+                elif self.live[victim] >= dev.pages_per_block:
+                    return
+                base = victim * dev.pages_per_block
+                moved = [page for page in range(base, base + dev.pages_per_block) if page in self.owner]
+                if len(moved) > self._room():
+                    return
+                self.gc_runs += 1
+                for page in moved:
+                    raw = self._read_page(page, count=False)
+                    ino, chunk = self.owner[page]
+                    self.owner.pop(page)
+                    self.live[victim] -= 1
+                    target = self._program(raw, ino, chunk)
+                    assert target is not None
+                    self._relocated(ino, chunk, target)
+                    self.page_ino[page] = 0  # moved, not stale
+                    self.gc_pages_moved += 1
+                self._erase(victim)
+        finally:
+            self._gc_active = False
+
+    def _room(self) -> int:
+        dev = self.device
+        head_room = dev.pages_per_block - self.head_page if self.head_block is not None else 0
+        return head_room + len(self.free_blocks) * dev.pages_per_block
+
+    def _relocated(self, ino: int, chunk: int, new: int) -> None:
+        if chunk == _TOMB_CHUNK:
+            self.tombstones[ino] = new
+            return
+        node = self.inodes[ino]
+        if chunk == _META_CHUNK:
+            node.meta_page = new
+        else:
+            node.chunks[chunk] = new
+
+    def _erase(self, block: int) -> None:
+        dev = self.device
+        base = block * dev.pages_per_block
+        retired: List[int] = []
+        for page in range(base, base + self.used[block]):
+            self.cache.pop(page, None)
+            self._prefetched.discard(page)
+            ino = self.page_ino[page]
+            self.page_ino[page] = 0
+            if not ino:
+                continue
+            left = self.stale.get(ino, 0) - 1
+            if left > 0:
+                self.stale[ino] = left
+                continue
+            self.stale.pop(ino, None)
+            if ino in self.tombstones:
+                retired.append(ino)
+        dev.erase_block(block)
+        self.used[block] = 0
+        self.live[block] = 0
+        self.free_blocks.add(block)
+        # A tombstone is only needed while older pages of its inode survive.
+        for ino in retired:
+            page = self.tombstones.pop(ino)
+            self._obsolete(page)
+            self.stale.pop(ino, None)
+
+    # ------------------------------------------------------------------
+    # Page cache
+    # ------------------------------------------------------------------
+    def _read_page(self, page: int, *, count: bool = True) -> bytes:
+        cached = self.cache.get(page)
+        if cached is not None:
+            self.cache.move_to_end(page)
+            if count:
+                self.cache_hits += 1
+                if page in self._prefetched:
+                    self._prefetched.discard(page)
+                    self.readahead_hits += 1
+            return cached
+        if count:
+            self.cache_misses += 1
+        raw = self.device.read_page(page)
+        self._cache_put(page, raw)
+        return raw
+
+    def _cache_put(self, page: int, raw: bytes) -> None:
+        if not self.cache_pages:
+            return
+        self.cache[page] = raw
+        self.cache.move_to_end(page)
+        while len(self.cache) > self.cache_pages:
+            evicted, _raw = self.cache.popitem(last=False)
+            self._prefetched.discard(evicted)
+
+    def _prefetch(self, node: _Inode, chunk: int) -> None:
+        for ahead in range(chunk + 1, chunk + 1 + self.readahead):
+            page = node.chunks.get(ahead)
+            if page is None:
+                return
+            if page in self.cache:
+                continue
+            self._cache_put(page, self.device.read_page(page))
+            self._prefetched.add(page)
+            self.readahead_pages += 1
+
+    def _chunk_view(self, node: _Inode, chunk: int) -> memoryview:
+        """Chunk payload as a view of its cached page (or dirty buffer), without copying."""
+
+        dirty = self._dirty.get(node.ino)
+        if dirty is not None and dirty[0] == chunk:
+            return memoryview(dirty[1])
+        page = node.chunks.get(chunk)
+        if page is None:
+            return memoryview(b"")
+        raw = self._read_page(page)
+        length = _HEADER.unpack_from(raw)[7]
+        return memoryview(raw)[_HEADER.size : _HEADER.size + length]
+
+    # ------------------------------------------------------------------
+    # Index helpers
+    # ------------------------------------------------------------------
+    @staticmethod
+    def _link(parent: _Inode, node: _Inode) -> None:
+        pos = bisect_left(parent.names, node.name)
+        parent.names.insert(pos, node.name)
+        parent.children.insert(pos, node.ino)
+
+    @staticmethod
+    def _unlink(parent: _Inode, name: str) -> None:
+        pos = bisect_left(parent.names, name)
+        if pos < len(parent.names) and parent.names[pos] == name:
+            del parent.names[pos]
+            del parent.children[pos]
+
+    @staticmethod
+    def _child(parent: _Inode, name: str) -> Optional[int]:
+        pos = bisect_left(parent.names, name)
+        if pos < len(parent.names) and parent.names[pos] == name:
+            return parent.children[pos]
+        return None
+
+    @staticmethod
+    def _split(path: Optional[str]) -> Optional[List[str]]:
+        """Path components, or ``None`` for an unsafe or malformed path."""
+
+        if path is None:
+            return None
+        candidate = str(path).strip()
+        if "\\" in candidate or ":" in candidate or "\x00" in candidate:
+            return None
+        candidate = candidate[1:] if candidate.startswith("/") else candidate
+        if not candidate:
+            return []
+        parts = candidate.rstrip("/").split("/")
+        for part in parts:
+            if part in ("", ".", "..") or len(part.encode("utf-8")) > MAX_NAME:
+                return None
+        return parts
+
+    def _resolve(self, parts: List[str]) -> Optional[_Inode]:
+        node = self.inodes[ROOT_INO]
+        for part in parts:
+            if not node.is_dir:
+                return None
+            ino = self._child(node, part)
+            if ino is None:
+                return None
+            node = self.inodes[ino]
+        return node
+
+    def _write_meta(self, node: _Inode) -> bool:
+        payload = _INODE_META.pack(1 if node.is_dir else 0, node.trunc_seq) + node.name.encode("utf-8")
+        page = self._append(_KIND_INODE, node.ino, node.parent, node.flushed_size, payload, _META_CHUNK)
+        if page is None:
+            return False
+        self._obsolete(node.meta_page)
+        node.meta_page = page
+        node.meta_seq = self.seq
+        return True
+
+    def _flush(self, ino: int) -> bool:
+        dirty = self._dirty.get(ino)
+        if dirty is None:
+            return True
+        node = self.inodes[ino]
+        chunk, buf = dirty
+        extent = chunk * self.payload_size + len(buf)
+        page = self._append(_KIND_DATA, ino, chunk, max(node.flushed_size, extent), bytes(buf), chunk)
+        if page is None:
+            return False
+        del self._dirty[ino]
+        self._obsolete(node.chunks.get(chunk))
+        node.chunks[chunk] = page
+        node.flushed_size = max(node.flushed_size, extent)
+        return True
+
+    def _create(self, parent: _Inode, name: str, *, is_dir: bool) -> Optional[_Inode]:
+        node = _Inode(self.next_ino, parent.ino, name, is_dir)
+        if not self._write_meta(node):
+            return None
+        self.next_ino += 1
+        self.inodes[node.ino] = node
+        self._link(parent, node)
+        return node
+
+    def _truncate(self, node: _Inode) -> bool:
+        self._dirty.pop(node.ino, None)
+        node.trunc_seq = self.seq + 1  # the inode record written below
+        node.size = node.flushed_size = 0
+        if not self._write_meta(node):
+            return False
+        for page in node.chunks.values():
+            self._obsolete(page)
+        node.chunks.clear()
+        return True
+
+    def _lookup_parent(self, path: Optional[str]) -> Tuple[Optional[_Inode], Optional[str], int]:
+        parts = self._split(path)
+        if not parts:
+            return None, None, HSX_HAL_INVALID_PARAM
+        parent = self._resolve(parts[:-1])
+        if parent is None or not parent.is_dir:
+            return None, None, HSX_HAL_ERROR
+        return parent, parts[-1], HSX_HAL_OK
+
+    # ------------------------------------------------------------------
+    # hsx_fs.h operations (FSStub-compatible signatures)
+    # ------------------------------------------------------------------
+    def open(self, path: str, flags: int = 0) -> int:
+        flags = int(flags)
+        if flags == 0:
+            flags = HSX_FS_O_RDWR | HSX_FS_O_CREAT  # legacy callers passed no flags
+        if not flags & HSX_FS_O_RDWR:
+            return HSX_HAL_INVALID_PARAM
+        parent, name, status = self._lookup_parent(path)
+        if parent is None:
+            return status
+        ino = self._child(parent, name)
+        if ino is None:
+            if not flags & HSX_FS_O_CREAT:
+                return HSX_HAL_ERROR
+            node = self._create(parent, name, is_dir=False)
+            if node is None:
+                return HSX_HAL_NO_MEMORY
+        else:
+            node = self.inodes[ino]
+            if node.is_dir:
+                return HSX_HAL_INVALID_PARAM
+            if flags & HSX_FS_O_TRUNC and flags & HSX_FS_O_WRONLY and node.size and not self._truncate(node):
+                return HSX_HAL_NO_MEMORY
+        fd = self.next_fd
+        self.next_fd += 1
+        self.fds[fd] = {"ino": node.ino, "pos": 0, "flags": flags, "last_chunk": None}
+        return fd
+
+    def read(self, fd: int, n: int) -> Union[bytes, int]:
+        ent = self.fds.get(fd)
+        if ent is None:
+            return HSX_HAL_INVALID_PARAM
+        remaining = self.inodes[ent["ino"]].size - ent["pos"]
+        buf = bytearray(max(min(int(n), remaining), 0))
+        count = self.readinto(fd, buf)
+        if count < 0:
+            return count
+        return bytes(buf) if count == len(buf) else bytes(buf[:count])
+
+    def readinto(self, fd: int, dest: Any) -> int:
+        """Read up to ``len(dest)`` bytes into a writable buffer; returns the count.
+
+        Each chunk is copied once, straight from its cached page into ``dest``,
+        so the VM can pass a view of task memory with no intermediate buffer.
+        """
+
+        ent = self.fds.get(fd)
+        if ent is None:
+            return HSX_HAL_INVALID_PARAM
+        if not ent["flags"] & HSX_FS_O_RDONLY:
+            return HSX_HAL_ERROR
+        out = memoryview(dest).cast("B")
+        node = self.inodes[ent["ino"]]
+        pos = ent["pos"]
+        end = min(pos + len(out), node.size)
+        payload = self.payload_size
+        done = 0
+        while pos < end:
+            chunk, offset = divmod(pos, payload)
+            data = self._chunk_view(node, chunk)
+            if ent["last_chunk"] is not None and chunk == ent["last_chunk"] + 1 and self.readahead:
+                self._prefetch(node, chunk)
+            ent["last_chunk"] = chunk
+            take = min(payload - offset, end - pos)
+            piece = data[offset : offset + take]
+            out[done : done + len(piece)] = piece
+            if len(piece) < take:  # unflushed tail after a remount
+                out[done + len(piece) : done + take] = bytes(take - len(piece))
+            piece.release()
+            data.release()
+            done += take
+            pos += take
+        ent["pos"] = pos
+        self.user_bytes_read += done
+        return done
+
+    def write(self, fd: int, buf: Any) -> int:
+        ent = self.fds.get(fd)
+        if ent is None:
+            return HSX_HAL_INVALID_PARAM
+        if not ent["flags"] & HSX_FS_O_WRONLY:
+            return HSX_HAL_ERROR
+        node = self.inodes[ent["ino"]]
+        if ent["flags"] & HSX_FS_O_APPEND:
+            ent["pos"] = node.size
+        payload = self.payload_size
+        view = memoryview(buf).cast("B")  # no copy: chunks are filled from the caller's buffer
+        written = 0
+        pos = ent["pos"]
+        while written < len(view):
+            chunk, offset = divmod(pos, payload)
+            take = min(payload - offset, len(view) - written)
+            dirty = self._dirty.get(node.ino)
+            if dirty is None or dirty[0] != chunk:
+                # A full buffer that could not be flushed stops the write short.
+                if dirty is not None and not self._flush(node.ino):
+                    break
+                whole = offset == 0 and take == payload
+                dirty = (chunk, bytearray() if whole else bytearray(self._chunk_view(node, chunk)))
+                self._dirty[node.ino] = dirty
+            chunk_buf = dirty[1]
+            if len(chunk_buf) < offset:
+                chunk_buf.extend(b"\x00" * (offset - len(chunk_buf)))
+            chunk_buf[offset : offset + take] = view[written : written + take]
+            written += take
+            pos += take
+            node.size = max(node.size, pos)
+            if len(chunk_buf) == payload:
+                self._flush(node.ino)
+        ent["pos"] = pos
+        self.user_bytes_written += written
+        if written == 0 and len(view):
+            return HSX_HAL_NO_MEMORY
+        return written
+
+    def close(self, fd: int) -> int:
+        ent = self.fds.pop(fd, None)
+        if ent is None:
+            return HSX_HAL_ERROR
+        if ent["flags"] & HSX_FS_O_WRONLY and not self._flush(ent["ino"]):
+            return HSX_HAL_NO_MEMORY
+        return HSX_HAL_OK
+
+    def listdir(self, path: Optional[str]) -> Union[bytes, int]:
+        parts = self._split(path if path else "/")
+        if parts is None:
+            return HSX_HAL_INVALID_PARAM
+        node = self._resolve(parts)
+        if node is None or not node.is_dir:
+            return HSX_HAL_ERROR
+        inodes = self.inodes
+        names = [name + "/" if inodes[ino].is_dir else name for name, ino in zip(node.names, node.children)]
+        return "\n".join(names).encode("utf-8")
+
+    def mkdir(self, path: str) -> int:
+        parent, name, status = self._lookup_parent(path)
+        if parent is None:
+            return status
+        if self._child(parent, name) is not None:
+            return HSX_HAL_ERROR
+        return HSX_HAL_OK if self._create(parent, name, is_dir=True) is not None else HSX_HAL_NO_MEMORY
+
+    def delete(self, path: str) -> int:
+        parent, name, status = self._lookup_parent(path)
+        if parent is None:
+            return status
+        ino = self._child(parent, name)
+        if ino is None:
+            return HSX_HAL_ERROR
+        node = self.inodes[ino]
+        if node.is_dir and node.names:
+            return HSX_HAL_ERROR
+        if any(ent["ino"] == ino for ent in self.fds.values()):
+            return HSX_HAL_BUSY
+        page = self._append(_KIND_TOMBSTONE, ino, 0, 0, b"", _TOMB_CHUNK)
+        if page is None:
+            return HSX_HAL_NO_MEMORY
+        self.tombstones[ino] = page
+        self._dirty.pop(ino, None)
+        self._obsolete(node.meta_page)
+        for chunk_page in node.chunks.values():
+            self._obsolete(chunk_page)
+        self._unlink(parent, name)
+        del self.inodes[ino]
+        return HSX_HAL_OK
+
+    def rename(self, old: str, new: str) -> int:
+        src_parent, src_name, status = self._lookup_parent(old)
+        if src_parent is None:
+            return status
+        dst_parent, dst_name, status = self._lookup_parent(new)
+        if dst_parent is None:
+            return status
+        ino = self._child(src_parent, src_name)
+        if ino is None or self._child(dst_parent, dst_name) is not None:
+            return HSX_HAL_ERROR
+        ancestor = dst_parent
+        while True:  # a directory cannot move below itself
+            if ancestor.ino == ino:
+                return HSX_HAL_INVALID_PARAM
+            if ancestor.ino == ROOT_INO:
+                break
+            ancestor = self.inodes[ancestor.parent]
+        node = self.inodes[ino]
+        if not self._flush(ino):
+            return HSX_HAL_NO_MEMORY
+        old_parent, old_name = node.parent, node.name
+        node.parent, node.name = dst_parent.ino, dst_name
+        if not self._write_meta(node):
+            node.parent, node.name = old_parent, old_name
+            return HSX_HAL_NO_MEMORY
+        self._unlink(src_parent, src_name)
+        self._link(dst_parent, node)
+        return HSX_HAL_OK
+
+    # ------------------------------------------------------------------
+    # Maintenance and statistics
+    # ------------------------------------------------------------------
+    def sync(self) -> int:
+        """Flush write buffers and, when backed by a file, save the image."""
+
+        status = HSX_HAL_OK
+        for ino in list(self._dirty):
+            if not self._flush(ino):
+                status = HSX_HAL_NO_MEMORY
+        if self.image_path is not None:
+            self.image_path.write_bytes(bytes(self.device.data))
+        return status
+
+    def close_all(self) -> None:
+        for fd in list(self.fds):
+            self.close(fd)
+
+    def stats(self) -> Dict[str, Any]:
+        dev = self.device
+        live = len(self.owner)
+        programmed = sum(self.used)
+        lookups = self.cache_hits + self.cache_misses
+        files = sum(1 for node in self.inodes.values() if not node.is_dir)
+        return {
+            "backend": "flash",
+            "type": self.kind,
+            "image": str(self.image_path) if self.image_path is not None else None,
+            "geometry": {
+                "page_size": dev.page_size,
+                "pages_per_block": dev.pages_per_block,
+                "blocks": dev.blocks,
+                "capacity": dev.capacity,
+                "payload_per_page": self.payload_size,
+            },
+            "files": files,
+            "dirs": len(self.inodes) - files,
+            "open_fds": len(self.fds),
+            "pages": {
+                "live": live,
+                "obsolete": programmed - live,
+                "free": dev.pages - programmed,
+                "free_blocks": len(self.free_blocks),
+            },
+            "flash": dev.stats(),
+            "gc": {
+                "runs": self.gc_runs,
+                "pages_moved": self.gc_pages_moved,
+                "wear_moves": self.wear_moves,
+                "tombstones": len(self.tombstones),
+            },
+            "cache": {
+                "pages": self.cache_pages,
+                "hits": self.cache_hits,
+                "misses": self.cache_misses,
+                "hit_rate": round(self.cache_hits / lookups, 4) if lookups else 0.0,
+                "readahead": self.readahead,
+                "readahead_pages": self.readahead_pages,
+                "readahead_hits": self.readahead_hits,
+            },
+            "user": {"bytes_written": self.user_bytes_written, "bytes_read": self.user_bytes_read},
+            "write_amplification": (
+                round(dev.bytes_programmed / self.user_bytes_written, 3) if self.user_bytes_written else 0.0
+            ),
+        }
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+fs_benchmark.py - app I/O patterns against the simulated flash filesystem
+
+Runs representative workloads on a fresh :class:`FlashFS` per pattern and
+reports throughput in simulated device time (the part's read/program/erase
+latencies), write amplification, garbage-collection work, wear spread and
+page-cache hit rate, plus the host CPU time each workload took (``cpu_ms``).
+"""
+
+from __future__ import annotations
+
+import argparse
+import random
+import time
+from typing import Any, Callable, Dict, Iterable, Optional
+
+try:
+    from . import bench_report, flash_fs
+except ImportError:  # pragma: no cover - allow running as a script
+    import bench_report  # type: ignore
+    import flash_fs  # type: ignore
+
+W = flash_fs.HSX_FS_O_WRONLY | flash_fs.HSX_FS_O_CREAT
+R = flash_fs.HSX_FS_O_RDONLY
+TABLE_COLUMNS = ["pattern", "type", "busy_ms", "kib_per_s", "cpu_ms", "write_amp", "erases", "gc_runs", "gc_moved", "wear_spread", "cache_hit_rate"]
+
+
+def _write_file(fs: flash_fs.FlashFS, path: str, data: bytes, *, flags: int = W | flash_fs.HSX_FS_O_TRUNC, chunk: int = 512) -> int:
+    fd = fs.open(path, flags)
+    if fd < 0:
+        return 0
+    written = 0
+    for start in range(0, len(data), chunk):
+        count = fs.write(fd, data[start : start + chunk])
+        if count <= 0:
+            break
+        written += count
+    fs.close(fd)
+    return written
+
+
+def _read_file(fs: flash_fs.FlashFS, path: str, *, chunk: int = 512) -> int:
+    fd = fs.open(path, R)
+    if fd < 0:
+        return 0
+    total = 0
+    buf = bytearray(chunk)  # reused, as a task's read buffer would be
+    while True:
+        count = fs.readinto(fd, buf)
+        if count <= 0:
+            break
+        total += count
+    fs.close(fd)
+    return total
+
+
+def _fits(fs: flash_fs.FlashFS, size: int) -> int:
+    # Single-file workloads stay within half the part so they never run out of space.
+    return min(size, fs.device.capacity // 2)
+
+
+def seq_write(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    size = _fits(fs, size)
+    _write_file(fs, "/seq.bin", bytes(rng.getrandbits(8) for _ in range(size)))
+
+
+def seq_read(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    size = _fits(fs, size)
+    _write_file(fs, "/seq.bin", bytes(rng.getrandbits(8) for _ in range(size)))
+    for _ in range(4):
+        _read_file(fs, "/seq.bin", chunk=64)
+
+
+def large_block(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    size = _fits(fs, size)
+    _write_file(fs, "/blob.bin", rng.randbytes(size), chunk=4096)
+    for _ in range(4):
+        _read_file(fs, "/blob.bin", chunk=4096)
+
+
+def log_append(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    size = _fits(fs, size)
+    fs.mkdir("/logs")
+    fd = fs.open("/logs/app.log", W | flash_fs.HSX_FS_O_APPEND)
+    written = 0
+    while written < size:
+        line = f"t={written:08d} temp={rng.randrange(200, 300)} ok\n".encode()
+        fs.write(fd, line)
+        written += len(line)
+    fs.close(fd)
+
+
+def small_files(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    fs.mkdir("/cfg")
+    written = 0
+    while written < size:
+        name = f"/cfg/k{rng.randrange(64):02d}"
+        value = bytes(rng.getrandbits(8) for _ in range(rng.randrange(8, 96)))
+        written += _write_file(fs, name, value)
+        if rng.random() < 0.1:
+            fs.delete(f"/cfg/k{rng.randrange(64):02d}")
+
+
+def overwrite_hot(fs: flash_fs.FlashFS, rng: random.Random, size: int) -> None:
+    _write_file(fs, "/static.bin", bytes(fs.device.capacity // 4))
+    written = 0
+    while written < size:
+        written += _write_file(fs, "/state.bin", bytes(rng.getrandbits(8) for _ in range(1024)))
+
+
+PATTERNS: Dict[str, Callable[[flash_fs.FlashFS, random.Random, int], None]] = {
+    "seq_write": seq_write,
+    "seq_read": seq_read,
+    "large_block": large_block,
+    "log_append": log_append,
+    "small_files": small_files,
+    "overwrite_hot": overwrite_hot,
+}
+
+
+def run_pattern(name: str, *, kind: str = "nor", size: int = 64 * 1024, seed: int = 1, **geometry: Any) -> Dict[str, Any]:
+    fs = flash_fs.FlashFS.create(kind, **geometry)
+    mount_us = fs.device.busy_us
+    started = time.process_time()
+    PATTERNS[name](fs, random.Random(seed), size)
+    fs.sync()
+    cpu_s = time.process_time() - started
+    stats = fs.stats()
+    flash = stats["flash"]
+    busy_us = max(flash["busy_us"] - mount_us, 1)
+    moved = stats["user"]["bytes_written"] + stats["user"]["bytes_read"]
+    return {
+        "pattern": name,
+        "type": kind,
+        "user_written": stats["user"]["bytes_written"],
+        "user_read": stats["user"]["bytes_read"],
+        "busy_ms": round(busy_us / 1000.0, 3),
+        "kib_per_s": round(moved / 1024.0 / (busy_us / 1e6), 1),
+        "cpu_ms": round(cpu_s * 1000.0, 2),
+        "write_amp": stats["write_amplification"],
+        "erases": flash["erases"],
+        "gc_runs": stats["gc"]["runs"],
+        "gc_moved": stats["gc"]["pages_moved"],
+        "wear_max": flash["wear"]["max"],
+        "wear_spread": flash["wear"]["max"] - flash["wear"]["min"],
+        "cache_hit_rate": stats["cache"]["hit_rate"],
+    }
+
+
+def main(argv: Optional[Iterable[str]] = None) -> None:
+    parser = argparse.ArgumentParser(description="Benchmark app I/O patterns on the simulated flash filesystem.")
+    parser.add_argument("--type", choices=sorted(flash_fs.GEOMETRIES), action="append", help="flash part (repeatable; default both)")
+    parser.add_argument("--pattern", choices=sorted(PATTERNS), action="append", help="workload (repeatable; default all)")
+    parser.add_argument("--size", type=int, default=256 * 1024, help="bytes each workload writes (default 256 KiB)")
+    parser.add_argument("--blocks", type=int, default=32, help="erase blocks per part (default 32, so GC runs on NOR)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--json", help="write JSON report to file")
+    args = parser.parse_args(list(argv) if argv is not None else None)
+
+    rows = [
+        run_pattern(pattern, kind=kind, size=args.size, seed=args.seed, blocks=args.blocks)
+        for kind in (args.type or sorted(flash_fs.GEOMETRIES))
+        for pattern in (args.pattern or list(PATTERNS))
+    ]
+    bench_report.report(rows, args.json, columns=TABLE_COLUMNS)
+
+
+if __name__ == "__main__":
+    main()
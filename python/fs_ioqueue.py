@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""Executive I/O queue behind ``hsx_fs_read_async`` / ``hsx_fs_write_async``.
+
+The async FS SVCs only validate and enqueue an :class:`IORequest` and return
+its request id, so a task logging to flash keeps its scheduler quantum.  The
+VM controller calls :meth:`FSIOQueue.service` once per executive tick (and
+before any synchronous call touching a descriptor with queued work, so
+per-descriptor ordering holds).  Each service pass is one batch of at most
+``batch`` device operations: requests are grouped per descriptor in
+submission order, and runs of adjacent writes to the same descriptor are
+merged into a single ``fs.write`` of up to ``merge_limit`` bytes.
+
+Every request completes with a fixed 16-byte record (:data:`COMPLETION`)
+posted to the mailbox handle supplied at submission.  Write payloads are
+copied when submitted, so the caller may reuse its buffer immediately; read
+data is copied into the caller's buffer just before the completion is posted.
+Completions that cannot be posted because the mailbox is full stay in a
+backlog and are retried on the next pass.
+"""
+
+from __future__ import annotations
+
+import struct
+from collections import deque
+from dataclasses import dataclass
+from typing import Any, Callable, Deque, Dict, List, Optional, Union
+
+HSX_HAL_BUSY = -3
+HSX_HAL_INVALID_PARAM = -4
+
+OP_READ = 1
+OP_WRITE = 2
+
+# request_id, tag, result (bytes or -HSX_HAL_*), fd, op, requests merged into the device op
+COMPLETION = struct.Struct("<IIiHBB")
+
+DEFAULT_DEPTH = 64
+DEFAULT_MAX_BYTES = 16 * 1024
+DEFAULT_BATCH = 16
+DEFAULT_MERGE_LIMIT = 4096
+
+
+@dataclass
+class IORequest:
+    request_id: int
+    pid: int
+    op: int
+    fd: int
+    length: int
+    handle: int
+    tag: int
+    ptr: int = 0
+    data: bytes = b""
+    result: int = 0
+    merged: int = 1
+    payload: Union[bytes, bytearray] = b""  # read data awaiting delivery
+
+    def record(self) -> bytes:
+        return COMPLETION.pack(
+            self.request_id,
+            self.tag & 0xFFFFFFFF,
+            self.result,
+            self.fd & 0xFFFF,
+            self.op,
+            min(self.merged, 0xFF),
+        )
+
+
+# Returns True once the completion is posted, False to retry it later and
+# None to drop it (the mailbox handle is gone).
+Deliver = Callable[[IORequest], Optional[bool]]
+
+
+class FSIOQueue:
+    """Bounded FIFO of async FS requests with per-descriptor write merging."""
+
+    def __init__(
+        self,
+        deliver: Deliver,
+        *,
+        depth: int = DEFAULT_DEPTH,
+        max_bytes: int = DEFAULT_MAX_BYTES,
+        batch: int = DEFAULT_BATCH,
+        merge_limit: int = DEFAULT_MERGE_LIMIT,
+    ) -> None:
+        self.deliver = deliver
+        self.depth = max(int(depth), 1)
+        self.max_bytes = max(int(max_bytes), 1)
+        self.batch = max(int(batch), 1)
+        self.merge_limit = max(int(merge_limit), 1)
+        self.pending: Deque[IORequest] = deque()
+        self.backlog: Deque[IORequest] = deque()
+        self.queued_bytes = 0
+        self.next_id = 1
+        self.submitted = 0
+        self.completed = 0
+        self.rejected = 0
+        self.dropped = 0
+        self.device_ops = 0
+        self.merged = 0
+        self.batches = 0
+        self.high_water = 0
+
+    def __len__(self) -> int:
+        return len(self.pending)
+
+    def submit(
+        self,
+        *,
+        pid: int,
+        op: int,
+        fd: int,
+        length: int,
+        handle: int,
+        tag: int = 0,
+        ptr: int = 0,
+        data: bytes = b"",
+    ) -> int:
+        """Queue a request; returns its id or a negative ``HSX_HAL_*`` code."""
+
+        if op not in (OP_READ, OP_WRITE) or length < 0:
+            return HSX_HAL_INVALID_PARAM
+        cost = len(data) if op == OP_WRITE else 0
+        if len(self.pending) >= self.depth or self.queued_bytes + cost > self.max_bytes:
+            self.rejected += 1
+            return HSX_HAL_BUSY
+        request_id = self.next_id
+        self.next_id = self.next_id + 1 if self.next_id < 0x7FFFFFFF else 1
+        self.pending.append(
+            IORequest(request_id, int(pid), op, int(fd), int(length), int(handle), int(tag), ptr=int(ptr), data=bytes(data))
+        )
+        self.queued_bytes += cost
+        self.submitted += 1
+        self.high_water = max(self.high_water, len(self.pending))
+        return request_id
+
+    def has_pending(self, fd: int) -> bool:
+        return any(request.fd == fd for request in self.pending)
+
+    def drop_pid(self, pid: int) -> None:
+        """Forget a killed task's requests without completing them."""
+
+        kept = [request for request in self.pending if request.pid != pid]
+        self.dropped += len(self.pending) - len(kept)
+        self.pending = deque(kept)
+        self.queued_bytes = sum(len(request.data) for request in kept)
+        self.backlog = deque(request for request in self.backlog if request.pid != pid)
+
+    def clear(self) -> None:
+        self.pending.clear()
+        self.backlog.clear()
+        self.queued_bytes = 0
+
+    def _take(self, fd: Optional[int]) -> List[List[IORequest]]:
+        """Dequeue the next batch as per-descriptor runs of device operations."""
+
+        runs: List[List[IORequest]] = []
+        last_run: Dict[int, List[IORequest]] = {}
+        ops = 0
+        keep: Deque[IORequest] = deque()
+        blocked: set = set()
+        while self.pending:
+            request = self.pending.popleft()
+            if (fd is not None and request.fd != fd) or request.fd in blocked:
+                keep.append(request)
+                continue
+            run = last_run.get(request.fd)
+            if (
+                run is not None
+                and request.op == OP_WRITE
+                and run[-1].op == OP_WRITE
+                and sum(len(item.data) for item in run) + len(request.data) <= self.merge_limit
+            ):
+                run.append(request)
+                continue
+            if ops >= self.batch:
+                # Later requests on this descriptor must wait behind this one.
+                blocked.add(request.fd)
+                keep.append(request)
+                continue
+            run = [request]
+            runs.append(run)
+            last_run[request.fd] = run
+            ops += 1
+        self.pending = keep
+        return runs
+
+    def service(self, fs: Any, *, fd: Optional[int] = None) -> int:
+        """Run one batch against ``fs`` and post completions; returns requests done.
+
+        With ``fd`` only that descriptor's requests are run (all of them, in
+        order), which the VM uses before a synchronous call on ``fd``.
+        """
+
+        self._retry_backlog()
+        done = 0
+        while self.pending:
+            runs = self._take(fd)
+            if not runs:
+                break
+            self.batches += 1
+            for run in runs:
+                self._execute(fs, run)
+                for request in run:
+                    self._post(request)
+                done += len(run)
+            if fd is None:
+                break
+        return done
+
+    def _execute(self, fs: Any, run: List[IORequest]) -> None:
+        self.device_ops += 1
+        head = run[0]
+        if head.op == OP_READ:
+            buf = bytearray(head.length)
+            count = fs.readinto(head.fd, buf) if head.fd in fs.fds else HSX_HAL_INVALID_PARAM
+            head.result = count
+            if count > 0:
+                del buf[count:]
+                head.payload = buf
+            return
+        joined = b"".join(request.data for request in run)
+        self.queued_bytes -= len(joined)
+        self.merged += len(run) - 1
+        written = fs.write(head.fd, joined) if head.fd in fs.fds else HSX_HAL_INVALID_PARAM
+        for request in run:
+            request.merged = len(run)
+            if written < 0:
+                request.result = written
+                continue
+            request.result = min(len(request.data), written)
+            written -= request.result
+            request.data = b""
+
+    def _post(self, request: IORequest) -> None:
+        status = self.deliver(request)
+        if status is False:
+            self.backlog.append(request)
+            return
+        if status is None:
+            self.dropped += 1
+            return
+        self.completed += 1
+
+    def _retry_backlog(self) -> None:
+        pending, self.backlog = self.backlog, deque()
+        for request in pending:
+            self._post(request)
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "pending": len(self.pending),
+            "queued_bytes": self.queued_bytes,
+            "backlog": len(self.backlog),
+            "depth": self.depth,
+            "high_water": self.high_water,
+            "submitted": self.submitted,
+            "completed": self.completed,
+            "rejected": self.rejected,
+            "dropped": self.dropped,
+            "batches": self.batches,
+            "device_ops": self.device_ops,
+            "merged": self.merged,
+        }
@@ -0,0 +1,441 @@
+#!/usr/bin/env python3
+"""Executive-side GPIO edge handling behind the ``include/hsx_gpio.h`` SVCs.
+
+A :class:`GPIOBank` holds the pins of one executive.  Input pins see raw
+level changes (from a replayed waveform, a test, or ``gpio drive``) and turn
+them into task-visible edges in two stages:
+
+* **Debounce.**  A raw change is accepted only once the input has stayed at
+  the new level for ``debounce_ns``; a bounce back inside the window restarts
+  it and is counted as filtered.  The accepted edge is timestamped with the
+  raw transition that stuck.
+* **Coalesce.**  Accepted edges that match the pin's interrupt edge mask are
+  counted and collected into one pending event per pin carrying the number of
+  edges, the edge kinds seen and the times of the first and last edge.  An
+  edge after a quiet period is reported at once; edges within ``coalesce_ns``
+  of the previous report are folded into the next one, so each pin produces
+  at most one event per window whatever the input does.  An event the
+  consumer cannot take (mailbox full) stays pending and keeps absorbing
+  edges; counts are never lost.
+
+Time is simulated in nanoseconds: :meth:`GPIOBank.run_until` processes raw
+transitions, debounce deadlines and coalesce deadlines in order, and a bank
+created with a ``clock`` follows it from :meth:`GPIOBank.poll`.
+:func:`load_waveform` reads recorded pin waveforms (CSV ``time_us,pin,value``
+or a logic-analyser VCD export) for :meth:`GPIOBank.replay`.
+"""
+
+from __future__ import annotations
+
+import csv
+import heapq
+import re
+import struct
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, List, Optional, Tuple
+
+HSX_HAL_OK = 0
+HSX_HAL_INVALID_PARAM = -4
+
+HSX_GPIO_MODE_INPUT = 0
+HSX_GPIO_MODE_OUTPUT = 1
+HSX_GPIO_MODE_ANALOG = 2
+
+HSX_GPIO_PULL_NONE = 0
+HSX_GPIO_PULL_UP = 1
+HSX_GPIO_PULL_DOWN = 2
+
+HSX_GPIO_EDGE_NONE = 0
+HSX_GPIO_EDGE_RISING = 1
+HSX_GPIO_EDGE_FALLING = 2
+HSX_GPIO_EDGE_BOTH = 3
+
+# hsx_gpio_edge_event_t: pin, edges seen, level after the last edge, (pad),
+# edge count, first and last edge time in us
+EDGE_EVENT = struct.Struct("<BBBxIII")
+
+DEFAULT_PINS = 32
+
+Transition = Tuple[int, int, int]  # (time_ns, pin, value)
+Deliver = Callable[[int, bytes], bool]
+
+
+class GPIOPin:
+    __slots__ = (
+        "pin",
+        "mode",
+        "pull",
+        "value",
+        "raw",
+        "edge_mask",
+        "debounce_ns",
+        "coalesce_ns",
+        "stable_at",
+        "raw_since",
+        "count",
+        "pending_count",
+        "pending_edges",
+        "first_ns",
+        "last_ns",
+        "due_ns",
+        "last_report_ns",
+        "raw_edges",
+        "filtered",
+        "events",
+        "retries",
+    )
+
+    def __init__(self, pin: int) -> None:
+        self.pin = pin
+        self.mode = HSX_GPIO_MODE_INPUT
+        self.pull = HSX_GPIO_PULL_NONE
+        self.value = 0
+        self.raw = 0
+        self.edge_mask = HSX_GPIO_EDGE_NONE
+        self.debounce_ns = 0
+        self.coalesce_ns = 0
+        self.stable_at: Optional[int] = None  # raw differs from value; accepted then
+        self.raw_since = 0
+        self.count = 0
+        self.pending_count = 0
+        self.pending_edges = 0
+        self.first_ns = 0
+        self.last_ns = 0
+        self.due_ns: Optional[int] = None
+        self.last_report_ns: Optional[int] = None
+        self.raw_edges = 0
+        self.filtered = 0
+        self.events = 0
+        self.retries = 0
+
+    def record(self) -> bytes:
+        return EDGE_EVENT.pack(
+            self.pin,
+            self.pending_edges,
+            self.value,
+            self.pending_count & 0xFFFFFFFF,
+            (self.first_ns // 1000) & 0xFFFFFFFF,
+            (self.last_ns // 1000) & 0xFFFFFFFF,
+        )
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "pin": self.pin,
+            "mode": self.mode,
+            "value": self.value,
+            "edge": self.edge_mask,
+            "debounce_us": self.debounce_ns // 1000,
+            "coalesce_us": self.coalesce_ns // 1000,
+            "raw_edges": self.raw_edges,
+            "filtered": self.filtered,
+            "edges": self.count,
+            "events": self.events,
+            "pending": self.pending_count,
+            "retries": self.retries,
+        }
+
+
+class GPIOBank:
+    """The pins of one executive, with debounce and edge coalescing."""
+
+    def __init__(
+        self,
+        pins: int = DEFAULT_PINS,
+        *,
+        deliver: Optional[Deliver] = None,
+        clock: Optional[Callable[[], float]] = None,
+    ) -> None:
+        self.pins = [GPIOPin(index) for index in range(max(int(pins), 1))]
+        self.deliver = deliver
+        self.clock = clock
+        self._epoch = clock() if clock is not None else 0.0
+        self.lock = threading.RLock()
+        self.now_ns = 0
+        self.input: List[Tuple[int, int, int, int]] = []  # heap of (time_ns, seq, pin, value)
+        self._seq = 0
+        self._retry: List[int] = []
+
+    def _pin(self, pin: int) -> Optional[GPIOPin]:
+        return self.pins[pin] if 0 <= pin < len(self.pins) else None
+
+    # -- task side ---------------------------------------------------------
+
+    def configure(self, pin: int, mode: int, pull: int = HSX_GPIO_PULL_NONE) -> int:
+        state = self._pin(pin)
+        if state is None or mode not in (0, 1, 2) or pull not in (0, 1, 2):
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            state.mode, state.pull = mode, pull
+            if mode == HSX_GPIO_MODE_INPUT and pull and not state.raw_edges:
+                state.value = state.raw = 1 if pull == HSX_GPIO_PULL_UP else 0
+        return HSX_HAL_OK
+
+    def read(self, pin: int) -> int:
+        state = self._pin(pin)
+        return HSX_HAL_INVALID_PARAM if state is None else state.value
+
+    def write(self, pin: int, value: int) -> int:
+        state = self._pin(pin)
+        if state is None or state.mode != HSX_GPIO_MODE_OUTPUT:
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            state.value = state.raw = 1 if value else 0
+        return HSX_HAL_OK
+
+    def set_interrupt(self, pin: int, edge: int, enable: bool = True) -> int:
+        state = self._pin(pin)
+        if state is None or edge not in (0, 1, 2, 3):
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            state.edge_mask = edge if enable else HSX_GPIO_EDGE_NONE
+        return HSX_HAL_OK
+
+    def set_debounce(self, pin: int, debounce_us: int, coalesce_us: int = 0) -> int:
+        state = self._pin(pin)
+        if state is None or debounce_us < 0 or coalesce_us < 0:
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            state.debounce_ns = int(debounce_us) * 1000
+            state.coalesce_ns = int(coalesce_us) * 1000
+        return HSX_HAL_OK
+
+    def edge_count(self, pin: int) -> int:
+        state = self._pin(pin)
+        return HSX_HAL_INVALID_PARAM if state is None else state.count & 0xFFFFFFFF
+
+    # -- input side --------------------------------------------------------
+
+    def drive(self, pin: int, value: int, *, at_ns: Optional[int] = None) -> None:
+        """Queue a raw level change on an input pin (default: now)."""
+
+        if self._pin(pin) is None:
+            raise ValueError(f"GPIO pin {pin} out of range")
+        with self.lock:
+            self._seq += 1
+            at = self.now_ns if at_ns is None else max(int(at_ns), self.now_ns)
+            heapq.heappush(self.input, (at, self._seq, int(pin), 1 if value else 0))
+
+    def replay(self, transitions: Iterable[Transition], *, start_ns: Optional[int] = None) -> int:
+        """Queue a recorded waveform, shifted to start at ``start_ns`` (default: now)."""
+
+        items = sorted(transitions)
+        if not items:
+            return 0
+        with self.lock:
+            offset = (self.now_ns if start_ns is None else int(start_ns)) - items[0][0]
+            for t_ns, pin, value in items:
+                self.drive(pin, value, at_ns=t_ns + offset)
+        return len(items)
+
+    def _raw(self, state: GPIOPin, t_ns: int, value: int) -> None:
+        if state.mode != HSX_GPIO_MODE_INPUT or value == state.raw:
+            return
+        state.raw = value
+        state.raw_since = t_ns
+        state.raw_edges += 1
+        if value == state.value:
+            if state.stable_at is not None:
+                state.filtered += 1  # bounced back inside the window
+            state.stable_at = None
+        elif state.debounce_ns:
+            state.stable_at = t_ns + state.debounce_ns
+        else:
+            self._accept(state, t_ns)
+
+    def _accept(self, state: GPIOPin, t_ns: int) -> None:
+        state.stable_at = None
+        state.value = state.raw
+        edge = HSX_GPIO_EDGE_RISING if state.value else HSX_GPIO_EDGE_FALLING
+        if not edge & state.edge_mask:
+            return
+        state.count += 1
+        edge_ns = state.raw_since
+        if not state.pending_count:
+            state.first_ns = edge_ns
+            quiet = state.last_report_ns is None or t_ns >= state.last_report_ns + state.coalesce_ns
+            state.due_ns = t_ns if quiet else state.last_report_ns + state.coalesce_ns
+        state.pending_count += 1
+        state.pending_edges |= edge
+        state.last_ns = edge_ns
+        if state.due_ns is not None and state.due_ns <= t_ns:
+            self._report(state, t_ns)
+
+    def _report(self, state: GPIOPin, t_ns: int) -> None:
+        state.due_ns = None
+        if self.deliver is not None and self.deliver(state.pin, state.record()) is False:
+            state.retries += 1
+            if state.pin not in self._retry:
+                self._retry.append(state.pin)
+            return
+        state.events += 1
+        state.last_report_ns = t_ns
+        state.pending_count = 0
+        state.pending_edges = 0
+
+    def _next_deadline(self) -> Optional[int]:
+        deadlines = [state.stable_at for state in self.pins if state.stable_at is not None]
+        deadlines += [state.due_ns for state in self.pins if state.due_ns is not None]
+        return min(deadlines) if deadlines else None
+
+    def run_until(self, t_ns: int) -> None:
+        """Process every input change and deadline up to ``t_ns``."""
+
+        with self.lock:
+            t_ns = int(t_ns)
+            retry, self._retry = self._retry, []
+            for pin in retry:
+                state = self.pins[pin]
+                if state.pending_count and state.due_ns is None:
+                    self._report(state, self.now_ns)
+            while True:
+                deadline = self._next_deadline()
+                next_input = self.input[0][0] if self.input else None
+                candidates = [value for value in (deadline, next_input) if value is not None and value <= t_ns]
+                if not candidates:
+                    break
+                at = min(candidates)
+                self.now_ns = max(self.now_ns, at)
+                if next_input is not None and next_input == at:
+                    _t, _seq, pin, value = heapq.heappop(self.input)
+                    self._raw(self.pins[pin], at, value)
+                    continue
+                for state in self.pins:
+                    if state.stable_at is not None and state.stable_at <= at:
+                        self._accept(state, at)
+                    if state.due_ns is not None and state.due_ns <= at:
+                        self._report(state, at)
+            self.now_ns = max(self.now_ns, t_ns)
+
+    def run_for(self, duration_ns: int) -> None:
+        self.run_until(self.now_ns + int(duration_ns))
+
+    def poll(self) -> None:
+        """Advance to the bank clock (live banks only)."""
+
+        if self.clock is None:
+            return
+        self.run_until(int((self.clock() - self._epoch) * 1e9))
+
+    def stats(self) -> Dict[str, Any]:
+        with self.lock:
+            active = [
+                state.stats()
+                for state in self.pins
+                if state.raw_edges or state.edge_mask or state.mode != HSX_GPIO_MODE_INPUT
+            ]
+            return {"time_us": self.now_ns // 1000, "pins": len(self.pins), "queued": len(self.input), "active": active}
+
+
+def live_bank(pins: int = DEFAULT_PINS, **options: Any) -> GPIOBank:
+    return GPIOBank(pins, clock=time.monotonic, **options)
+
+
+# -- recorded waveforms ------------------------------------------------------
+
+_VCD_SCALE = {"s": 1_000_000_000, "ms": 1_000_000, "us": 1000, "ns": 1, "ps": 0.001, "fs": 0.000001}
+
+
+def _load_vcd(text: str, pin_map: Optional[Dict[str, int]]) -> List[Transition]:
+    scale = 1.0
+    ids: Dict[str, int] = {}
+    transitions: List[Transition] = []
+    now = 0.0
+    tokens = iter(text.split())
+    for token in tokens:
+        if token == "$timescale":
+            spec = ""
+            for part in tokens:
+                if part == "$end":
+                    break
+                spec += part
+            match = re.fullmatch(r"(\d+)(s|ms|us|ns|ps|fs)", spec)
+            if not match:
+                raise ValueError(f"unsupported VCD timescale '{spec}'")
+            scale = int(match.group(1)) * _VCD_SCALE[match.group(2)]
+        elif token == "$var":
+            fields = []
+            for part in tokens:
+                if part == "$end":
+                    break
+                fields.append(part)
+            if len(fields) < 4 or fields[1] != "1":
+                continue  # only single-bit signals are pins
+            ident, name = fields[2], fields[3]
+            if pin_map is not None:
+                if name in pin_map:
+                    ids[ident] = pin_map[name]
+                continue
+            digits = re.search(r"(\d+)$", name)
+            if digits:
+                ids[ident] = int(digits.group(1))
+        elif token.startswith("$"):
+            if token in ("$dumpvars", "$dumpall", "$dumpon", "$dumpoff", "$end"):
+                continue
+            for part in tokens:
+                if part == "$end":
+                    break
+        elif token[0] in "bBrR":
+            next(tokens, None)  # vector or real value: its identifier follows
+        elif token.startswith("#"):
+            now = int(token[1:]) * scale
+        elif token[0] in "01xXzZ" and token[1:] in ids:
+            if token[0] in "01":
+                transitions.append((int(now), ids[token[1:]], int(token[0])))
+    return transitions
+
+
+def _load_csv(text: str) -> List[Transition]:
+    transitions: List[Transition] = []
+    for row in csv.reader(line for line in text.splitlines() if line.strip() and not line.lstrip().startswith("#")):
+        try:
+            t_us, pin, value = (float(row[0]), int(row[1], 0), int(row[2], 0))
+        except (ValueError, IndexError):
+            if not transitions:
+                continue  # header line
+            raise ValueError(f"bad waveform row {row!r}") from None
+        transitions.append((int(t_us * 1000), pin, 1 if value else 0))
+    return transitions
+
+
+def load_waveform(path: str | Path, *, pin_map: Optional[Dict[str, int]] = None) -> List[Transition]:
+    """Read ``(time_ns, pin, value)`` transitions from a CSV or VCD file."""
+
+    path = Path(path)
+    text = path.read_text(encoding="utf-8")
+    if path.suffix.lower() == ".vcd" or text.lstrip().startswith("$"):
+        return sorted(_load_vcd(text, pin_map))
+    return sorted(_load_csv(text))
+
+
+def bouncy_press(pin: int, at_us: int, *, level: int = 1, bounces: int = 10, bounce_us: int = 50, seed_us: int = 7) -> List[Transition]:
+    """A contact closing at ``at_us`` to ``level``, chattering ``bounces`` times first."""
+
+    transitions: List[Transition] = []
+    t_us = at_us
+    for index in range(bounces):
+        transitions.append((t_us * 1000, pin, level))
+        t_us += 1 + (index * seed_us) % bounce_us
+        transitions.append((t_us * 1000, pin, 1 - level))
+        t_us += 1 + (index * seed_us * 3) % bounce_us
+    transitions.append((t_us * 1000, pin, level))
+    return transitions
+
+
+def quadrature(pin_a: int, pin_b: int, steps: int, *, step_us: int, start_us: int = 0) -> List[Transition]:
+    """A rotary encoder turning ``steps`` quarter-cycles (positive: A leads B)."""
+
+    transitions: List[Transition] = []
+    a = b = 0
+    forward = steps >= 0
+    for index in range(abs(steps)):
+        t_ns = (start_us + index * step_us) * 1000
+        phase = index % 4
+        if (phase in (0, 2)) == forward:
+            a ^= 1
+            transitions.append((t_ns, pin_a, a))
+        else:
+            b ^= 1
+            transitions.append((t_ns, pin_b, b))
+    return transitions
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Batched HAL submission ring behind ``EXEC_HAL_SUBMIT``.
+
+A task that drives many pins or frames per cycle fills a ring of
+:data:`REQUEST` records in its own memory and traps once.  The ring starts
+with a :data:`RING_HEADER` (``head``, ``tail``, ``entries``, ``flags``);
+``entries`` is a power of two, ``head`` and ``tail`` are free-running 16-bit
+indices.  The task writes requests at ``tail`` and advances it; the
+executive executes requests from ``head`` in order, writes each status into
+the request's ``result`` field and advances ``head`` past everything it
+consumed, so the task reuses slots without another trap.
+
+Each request names a HAL SVC by module and function and carries R1-R4, so a
+batched request behaves exactly like the trap it replaces (pointers in the
+arguments still refer to task memory).  Only non-blocking HAL modules may be
+batched; anything else completes with ``HSX_HAL_UNSUPPORTED``.  A request
+flagged :data:`HSX_HAL_REQ_STOP_ON_ERROR` that fails ends the batch after
+its own status is written; the requests behind it stay queued.
+"""
+
+from __future__ import annotations
+
+import struct
+from typing import Callable, Dict, Iterable, Tuple
+
+HSX_HAL_INVALID_PARAM = -4
+HSX_HAL_UNSUPPORTED = -6
+
+HSX_HAL_REQ_STOP_ON_ERROR = 0x0001
+
+# head, tail, entries, flags
+RING_HEADER = struct.Struct("<HHHH")
+# module, fn, flags, R1-R4, result
+REQUEST = struct.Struct("<BBHIIIIi")
+RESULT_OFFSET = REQUEST.size - 4
+
+# module -> functions that may be batched (never exit or blocking calls)
+BATCHABLE: Dict[int, Iterable[int]] = {
+    0x1: range(1, 7),  # UART
+    0x2: range(0, 4),  # CAN
+    0x3: range(0, 6),  # timers
+    0x9: range(0, 8),  # GPIO
+}
+
+Execute = Callable[[int, int, Tuple[int, int, int, int]], int]
+
+
+def batchable(module: int, fn: int) -> bool:
+    return fn in BATCHABLE.get(module, ())
+
+
+def drain(mem: bytearray, ring_ptr: int, execute: Execute, *, limit: int = 0) -> Tuple[int, int]:
+    """Execute queued requests; returns ``(completed, failed)`` or raises ValueError.
+
+    ``limit`` bounds the requests taken in one pass (0 takes everything
+    queued).  ``execute`` runs one batchable request and returns its status.
+    """
+
+    if ring_ptr < 0 or ring_ptr + RING_HEADER.size > len(mem):
+        raise ValueError("ring header outside task memory")
+    head, tail, entries, _flags = RING_HEADER.unpack_from(mem, ring_ptr)
+    base = ring_ptr + RING_HEADER.size
+    if entries == 0 or entries & (entries - 1) or base + entries * REQUEST.size > len(mem):
+        raise ValueError("ring size must be a power of two inside task memory")
+    pending = (tail - head) & 0xFFFF
+    if pending > entries:
+        raise ValueError("ring tail is more than one ring ahead of head")
+    if limit > 0:
+        pending = min(pending, limit)
+    completed = failed = 0
+    while completed < pending:
+        offset = base + ((head + completed) & (entries - 1)) * REQUEST.size
+        module, fn, flags, r1, r2, r3, r4, _result = REQUEST.unpack_from(mem, offset)
+        if batchable(module, fn):
+            status = execute(module, fn, (r1, r2, r3, r4)) & 0xFFFFFFFF
+            status = status - (1 << 32) if status & 0x80000000 else status
+        else:
+            status = HSX_HAL_UNSUPPORTED
+        struct.pack_into("<i", mem, offset + RESULT_OFFSET, status)
+        completed += 1
+        if status < 0:
+            failed += 1
+            if flags & HSX_HAL_REQ_STOP_ON_ERROR:
+                break
+    struct.pack_into("<H", mem, ring_ptr, (head + completed) & 0xFFFF)
+    return completed, failed
@@ -19,6 +19,10 @@ try:
     from asm import RODATA_BASE, set_imm12
 except ImportError:  # pragma: no cover - allow module import when run as package
     from .asm import RODATA_BASE, set_imm12
+try:
+    import debug_format
+except ImportError:  # pragma: no cover - allow module import when run as package
+    from . import debug_format
 
 HSX_MAGIC = 0x48535845  # 'HSXE'
 HSX_VERSION_V2 = 0x0002
@@ -266,6 +270,35 @@ def _resolve_command_handler_offsets(
         entry["handler_offset"] = resolved_address & 0xFFFFFFFF
 
 
+def _relocate_unwind(unwind: Any, base_address: int) -> Optional[Dict[str, Any]]:
+    if not isinstance(unwind, dict):
+        return None
+    rows: List[Dict[str, Any]] = []
+    for row in unwind.get("rows") or []:
+        start_ord = row.get("start_ordinal")
+        end_ord = row.get("end_ordinal")
+        if start_ord is None or end_ord is None:
+            continue
+        rows.append(
+            {
+                "start": base_address + int(start_ord) * 4,
+                "end": base_address + int(end_ord) * 4,
+                "cfa_reg": row.get("cfa_reg", "sp"),
+                "cfa_offset": int(row.get("cfa_offset", 0)),
+                "ra_offset": int(row.get("ra_offset", -4)),
+                "saved": {str(reg): int(off) for reg, off in (row.get("saved") or {}).items()},
+            }
+        )
+    if not rows:
+        return None
+    return {
+        "frame_size": int(unwind.get("frame_size") or 0),
+        "saved_registers": list(unwind.get("saved_registers") or []),
+        "return_address": unwind.get("return_address"),
+        "rows": rows,
+    }
+
+
 def _generate_symbol_payload(
     modules: List[Dict[str, Any]],
     symbol_table: Dict[str, Dict[str, Any]],
@@ -326,16 +359,18 @@ def _generate_symbol_payload(
                 file_name = file_info.get("filename")
             elif isinstance(file_info, str):
                 file_name = file_info
-            functions_section.append(
-                {
-                    "name": fn_entry.get("name") or fn_entry.get("function"),
-                    "linkage_name": fn_entry.get("linkage_name"),
-                    "address": base_address + start_ord * 4,
-                    "size": size_words * 4,
-                    "file": file_name,
-                    "line": fn_entry.get("line"),
-                }
-            )
+            function_record: Dict[str, Any] = {
+                "name": fn_entry.get("name") or fn_entry.get("function"),
+                "linkage_name": fn_entry.get("linkage_name"),
+                "address": base_address + start_ord * 4,
+                "size": size_words * 4,
+                "file": file_name,
+                "line": fn_entry.get("line"),
+            }
+            unwind = _relocate_unwind(fn_entry.get("unwind"), base_address)
+            if unwind:
+                function_record["unwind"] = unwind
+            functions_section.append(function_record)
         function_ranges.sort(key=lambda item: item[0])
 
         def _function_for_ordinal(ordinal: int) -> Optional[Dict[str, Any]]:
@@ -598,6 +633,7 @@ def link_objects(
     app_name: Optional[str] = None,
     allow_multiple: bool = True,
     req_caps: int = 0,
+    sym_format: str = "json",
 ) -> Dict:
     modules = [load_hxo(Path(p)) for p in object_paths]
     if not modules:
@@ -844,7 +880,10 @@ def link_objects(
         sym_path = Path(emit_sym)
         sym_path.parent.mkdir(parents=True, exist_ok=True)
         sym_payload = _generate_symbol_payload(modules, symbol_table, final_code, final_rodata, Path(output), crc)
-        sym_path.write_text(json.dumps(sym_payload, indent=2, sort_keys=True))
+        if sym_format == "binary":
+            debug_format.write_debug_info(sym_path, sym_payload)
+        else:
+            sym_path.write_text(json.dumps(sym_payload, indent=2, sort_keys=True))
     if verbose:
         print(f"Linked {len(modules)} modules -> {output}")
         print(f"  entry=0x{entry_address or 0:08X} words={len(final_code)} rodata={len(final_rodata)}")
@@ -867,6 +906,12 @@ def main():
     ap.add_argument("-v", "--verbose", action="store_true")
     ap.add_argument("--app-name")
     ap.add_argument("--emit-sym")
+    ap.add_argument(
+        "--sym-format",
+        choices=("json", "binary"),
+        default="json",
+        help="Encoding for --emit-sym: JSON (default) or compact hsx.debug/1",
+    )
     ap.add_argument("--debug-info", nargs="+", action="append", default=[])
     ap.add_argument("--req-cap", dest="req_cap", type=int, default=0, help="Required capability mask")
     ap.add_argument(
@@ -913,6 +958,7 @@ def main():
         verbose=args.verbose,
         debug_infos=debug_info_paths or None,
         emit_sym=Path(args.emit_sym) if args.emit_sym else None,
+        sym_format=args.sym_format,
         app_name=args.app_name,
         allow_multiple=args.allow_multiple,
         req_caps=args.req_cap,
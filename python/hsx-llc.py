@@ -12,7 +12,7 @@ import math
 import struct
 from collections import defaultdict, deque
 from pathlib import Path
-from typing import Any, Dict, List, Optional, Set, Tuple
+from typing import Any, Dict, Iterable, List, Optional, Set, Tuple
 
 try:
     import hsx_mailbox_constants as mbx_const
@@ -1390,6 +1390,92 @@ def _optimize_movs(
     stage2_lines, stage2_tags = _eliminate_mov_chains_core(stage1_lines, stage1_tags)
     return stage2_lines, stage2_tags
 
+_UNWIND_STATES = {
+    # state: (cfa register, cfa offset, saved registers relative to the CFA)
+    "entry": ("sp", 4, {}),
+    "pushed": ("sp", 8, {"R7": -8}),
+    "framed": ("fp", 8, {"R7": -8}),
+    "epilogue": ("sp", 4, {}),
+}
+
+
+def _unwind_transition(state: str, instr: str) -> str:
+    text = " ".join(instr.split(";", 1)[0].upper().replace(",", " , ").split())
+    if state == "entry" and text == "PUSH R7":
+        return "pushed"
+    if state == "pushed" and text == "MOV R7 , R15":
+        return "framed"
+    if state == "framed" and text == "POP R7":
+        return "epilogue"
+    if state == "epilogue" and text == "RET":
+        return "framed"
+    return state
+
+
+def _compute_unwind_tables(
+    lines: List[str],
+    ordinals: Dict[int, int],
+    function_names: Iterable[str],
+    frame_sizes: Optional[Dict[str, int]] = None,
+) -> Dict[str, Dict[str, Any]]:
+    """Describe, per ordinal range, where each function keeps its CFA and return address.
+
+    Every lowered function follows the same frame protocol: CALL pushes the
+    return address, the prologue pushes R7 and copies SP into it, locals grow
+    below R7, and the epilogue pops R7 before RET.  The tables let a debugger
+    unwind from a single stack snapshot without frame-pointer heuristics.
+    """
+
+    names = set(function_names)
+    frame_sizes = frame_sizes or {}
+    tables: Dict[str, Dict[str, Any]] = {}
+    current: Optional[str] = None
+    state = "entry"
+    rows: List[Dict[str, Any]] = []
+
+    for idx, line in enumerate(lines):
+        stripped = line.strip()
+        if stripped.endswith(":") and stripped[:-1] in names:
+            current = stripped[:-1]
+            state = "entry"
+            rows = []
+            tables[current] = {
+                "frame_size": int(frame_sizes.get(current, 0)),
+                "saved_registers": ["R7"],
+                "return_address": "cfa-4",
+                "rows": rows,
+            }
+            continue
+        if current is None or not is_instruction_line(line):
+            continue
+        ordinal = ordinals.get(idx + 1)
+        if ordinal is None:
+            continue
+        cfa_reg, cfa_offset, saved = _UNWIND_STATES[state]
+        last = rows[-1] if rows else None
+        if (
+            last is not None
+            and last["end_ordinal"] == ordinal
+            and last["cfa_reg"] == cfa_reg
+            and last["cfa_offset"] == cfa_offset
+            and last["saved"] == saved
+        ):
+            last["end_ordinal"] = ordinal + 1
+        else:
+            rows.append(
+                {
+                    "start_ordinal": ordinal,
+                    "end_ordinal": ordinal + 1,
+                    "cfa_reg": cfa_reg,
+                    "cfa_offset": cfa_offset,
+                    "ra_offset": -4,
+                    "saved": dict(saved),
+                }
+            )
+        state = _unwind_transition(state, stripped)
+    return {name: table for name, table in tables.items() if table["rows"]}
+
+
 def lower_function(
     fn: Dict,
     trace=False,
@@ -3082,6 +3168,12 @@ def compile_ll_to_mvasm(
                 ordinal_counter += 1
 
         line_to_ordinal = dict(instruction_ordinals)
+        unwind_tables = _compute_unwind_tables(
+            out,
+            line_to_ordinal,
+            defined_names,
+            {name: stats.get("stack_bytes", 0) for name, stats in function_reg_stats.items()},
+        )
 
         debug_info = ir.get("debug", {"files": {}, "subprograms": {}, "functions": []})
         files = debug_info.get("files", {})
@@ -3200,6 +3292,8 @@ def compile_ll_to_mvasm(
             stats_entry = function_reg_stats.get(name)
             if stats_entry:
                 func_entry["register_allocation"] = stats_entry
+            if name in unwind_tables:
+                func_entry["unwind"] = unwind_tables[name]
             functions_list.append(func_entry)
         existing_names = {entry["function"] for entry in functions_list}
         for name, stats_entry in function_reg_stats.items():
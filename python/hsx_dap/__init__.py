@@ -5,6 +5,7 @@ HSX Debug Adapter implementation for VS Code (Debug Adapter Protocol).
 from __future__ import annotations
 
 import argparse
+import base64
 import json
 import logging
 import os
@@ -13,7 +14,7 @@ import threading
 from collections import defaultdict
 from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, List, Optional, Set, Tuple
 
 REPO_ROOT = Path(__file__).resolve().parents[2]
 if str(REPO_ROOT) not in sys.path:
@@ -34,10 +35,14 @@ from python.hsxdbg import (
     StdStreamEvent,
 )
 from python.hsxdbg.transport import TransportConfig
+from python.debug_format import DebugInfo, is_debug_info, load_symbol_payload
 
 
 JsonDict = Dict[str, Any]
 
+# Executive stop reasons produced by reverse execution, as DAP ``stopped`` reasons.
+_REVERSE_STOP_REASONS = {"reverse_step": "step", "last_write": "data breakpoint", "history_start": "entry"}
+
 
 class DAPProtocol:
     """Basic Debug Adapter Protocol transport over stdin/stdout."""
@@ -126,21 +131,29 @@ class SymbolMapper:
     def __init__(self, path: Path) -> None:
         self.path = path
         self._line_map: Dict[str, Dict[int, List[int]]] = defaultdict(lambda: defaultdict(list))
+        self._path_keys: Dict[Tuple[Any, Any], Set[str]] = {}
         self._load()
 
     def _load(self) -> None:
         try:
-            data = json.loads(self.path.read_text(encoding="utf-8"))
+            if is_debug_info(self.path):
+                with DebugInfo.open(self.path) as info:
+                    # Only the line program is decoded; INST/FUNC/LOCL stay untouched.
+                    for pc, line, file_value, directory, *_rest in info.line_rows():
+                        self._add(pc, line, file_value, directory)
+                return
+            data = load_symbol_payload(self.path)
         except FileNotFoundError:
             return
-        instructions = data.get("instructions") or []
-        for inst in instructions:
-            line = inst.get("line")
-            pc = inst.get("pc")
-            file_value = inst.get("file")
-            if line is None or pc is None or not file_value:
-                continue
-            directory = inst.get("directory")
+        for inst in data.get("instructions") or []:
+            self._add(inst.get("pc"), inst.get("line"), inst.get("file"), inst.get("directory"))
+
+    def _add(self, pc: Any, line: Any, file_value: Any, directory: Any) -> None:
+        if line is None or pc is None or not file_value:
+            return
+        cache_key = (file_value, directory)
+        keys = self._path_keys.get(cache_key)
+        if keys is None:
             keys = {_canonical_path(file_value), _canonical_path(Path(file_value).name)}
             if directory:
                 try:
@@ -149,9 +162,10 @@ class SymbolMapper:
                     keys.add(_canonical_path(str(full.resolve())))
                 except Exception:
                     pass
-            for key in keys:
-                lines = self._line_map[key]
-                lines.setdefault(int(line), []).append(int(pc))
+            self._path_keys[cache_key] = keys
+        for key in keys:
+            lines = self._line_map[key]
+            lines.setdefault(int(line), []).append(int(pc))
 
     def lookup(self, source_path: str, line: int) -> List[int]:
         key = _canonical_path(source_path)
@@ -172,8 +186,18 @@ class _FrameRecord:
 
 
 @dataclass
-class _ScopeRecord:
-    variables: List[JsonDict] = field(default_factory=list)
+class _VariableRef:
+    """Lazily expanded ``variablesReference``; valid for one stop."""
+
+    kind: str  # "registers", "watches", "regions" or "memory"
+    pid: int
+    base: int = 0
+    length: int = 0
+    elem: int = 4
+
+    @property
+    def count(self) -> int:
+        return (self.length + self.elem - 1) // self.elem
 
 
 class HSXDebugAdapter:
@@ -191,8 +215,10 @@ class HSXDebugAdapter:
         self._event_token: Optional[int] = None
         self._frames: Dict[int, _FrameRecord] = {}
         self._next_frame_id = 1
-        self._scopes: Dict[int, _ScopeRecord] = {}
-        self._next_scope_id = 1
+        self._var_refs: Dict[int, _VariableRef] = {}
+        self._var_ref_keys: Dict[Tuple[Any, ...], int] = {}
+        self._next_var_ref = 1
+        self._stop_generation: Optional[int] = None
         self._breakpoints: Dict[str, List[JsonDict]] = {}
         self._symbol_mapper: Optional[SymbolMapper] = None
         self._symbol_path: Optional[Path] = None
@@ -233,9 +259,11 @@ class HSXDebugAdapter:
             "supportsPauseRequest": True,
             "supportsSetVariable": False,
             "supportsEvaluateForHovers": False,
-            "supportsConditionalBreakpoints": False,
-            "supportsStepBack": False,
-            "supportsReadMemoryRequest": False,
+            "supportsConditionalBreakpoints": True,
+            "supportsHitConditionalBreakpoints": True,
+            "supportsLogPoints": True,
+            "supportsStepBack": True,
+            "supportsReadMemoryRequest": True,
             "supportsWriteMemoryRequest": False,
             "supportsTerminateRequest": True,
         }
@@ -277,6 +305,7 @@ class HSXDebugAdapter:
     def _handle_pause(self, args: JsonDict) -> JsonDict:
         self._ensure_client()
         self.client.pause(self.current_pid)
+        self._begin_stop()
         self.protocol.send_event(
             "stopped",
             {
@@ -290,6 +319,27 @@ class HSXDebugAdapter:
     def _handle_next(self, args: JsonDict) -> JsonDict:
         self._ensure_client()
         self.client.step(self.current_pid, source_only=False)
+        self._begin_stop()
+        return {}
+
+    def _handle_stepBack(self, args: JsonDict) -> JsonDict:  # noqa: N802
+        self._ensure_client()
+        self.client.reverse_step(self.current_pid)
+        self._begin_stop()
+        return {}
+
+    def _handle_reverseContinue(self, args: JsonDict) -> JsonDict:  # noqa: N802
+        self._ensure_client()
+        self.client.reverse_continue(self.current_pid)
+        self._begin_stop()
+        return {}
+
+    def _handle_reverseToLastWrite(self, args: JsonDict) -> JsonDict:  # noqa: N802
+        """Custom request: run backwards to the last write of ``address``."""
+
+        self._ensure_client()
+        address = int(str(args.get("address")), 0)
+        self.client.reverse_to_last_write(address, self.current_pid, width=int(args.get("width") or 4))
         return {}
 
     def _handle_stepIn(self, args: JsonDict) -> JsonDict:  # noqa: N802
@@ -334,20 +384,43 @@ class HSXDebugAdapter:
         frame = self._frames.get(frame_id)
         if not frame:
             return {"scopes": []}
-        scopes = []
-        self._scopes.clear()
-        self._next_scope_id = 1
-        registers = self._format_registers()
-        if registers:
-            scopes.append(self._make_scope("Registers", registers, expensive=False))
-        watches = self._format_watches()
-        scopes.append(self._make_scope("Watches", watches, expensive=False))
-        return {"scopes": scopes}
+        # Scopes only hand out references; contents are fetched by `variables`.
+        self._sync_stop()
+        pid = frame.pid
+        return {
+            "scopes": [
+                self._make_scope("Registers", _VariableRef("registers", pid), expensive=False, named=19),
+                self._make_scope("Watches", _VariableRef("watches", pid), expensive=False),
+                self._make_scope("Memory", _VariableRef("regions", pid), expensive=True),
+            ]
+        }
 
     def _handle_variables(self, args: JsonDict) -> JsonDict:
         reference = int(args.get("variablesReference"))
-        scope = self._scopes.get(reference)
-        return {"variables": scope.variables[:] if scope else []}
+        self._sync_stop()
+        ref = self._var_refs.get(reference)
+        if ref is None:
+            return {"variables": []}
+        if ref.kind == "registers":
+            return {"variables": self._format_registers()}
+        if ref.kind == "watches":
+            return {"variables": self._format_watches()}
+        if ref.kind == "regions":
+            return {"variables": self._format_regions(ref.pid)}
+        start = max(int(args.get("start") or 0), 0)
+        count = int(args.get("count") or 0)
+        if args.get("filter") == "named":
+            return {"variables": []}
+        return {"variables": self._format_memory_page(ref, start, count)}
+
+    def _handle_readMemory(self, args: JsonDict) -> JsonDict:  # noqa: N802
+        self._ensure_client()
+        address = int(str(args.get("memoryReference")), 0) + int(args.get("offset") or 0)
+        count = max(int(args.get("count") or 0), 0)
+        data = self._read_memory(self.current_pid or 0, address, count) if count else b""
+        if data is None:
+            return {"address": f"0x{address:08X}", "unreadableBytes": count}
+        return {"address": f"0x{address:08X}", "data": base64.b64encode(data).decode("ascii")}
 
     def _handle_setBreakpoints(self, args: JsonDict) -> JsonDict:  # noqa: N802
         self._ensure_client()
@@ -369,9 +442,15 @@ class HSXDebugAdapter:
                 continue
             verified_any = False
             failed_error: Optional[str] = None
+            # Conditions, hit counts and log-points are evaluated inside the VM.
+            bp_options = {
+                key: bp[field]
+                for key, field in (("condition", "condition"), ("hit_condition", "hitCondition"), ("log_message", "logMessage"))
+                if bp.get(field) not in (None, "")
+            }
             for addr in addresses:
                 try:
-                    self.client.set_breakpoint(addr, pid=self.current_pid)
+                    self.client.set_breakpoint(addr, pid=self.current_pid, **bp_options)
                     verified_any = True
                 except Exception as exc:
                     failed_error = str(exc)
@@ -426,7 +505,7 @@ class HSXDebugAdapter:
             runtime_cache=self.runtime_cache,
         )
         self.session.open()
-        self.session.subscribe_events({"pid": [pid], "categories": ["debug_break", "watch_update", "stdout", "stderr", "warning"]})
+        self.session.subscribe_events({"pid": [pid], "categories": ["debug_break", "debug_log", "watch_update", "stdout", "stderr", "warning"]})
         self.client = CommandClient(session=self.session, cache=self.runtime_cache)
         self._watch_expr_to_id.clear()
         self._watch_id_to_expr.clear()
@@ -437,7 +516,9 @@ class HSXDebugAdapter:
 
     def _handle_exec_event(self, event) -> None:
         if isinstance(event, DebugBreakEvent):
+            self._begin_stop(event.pid, event.seq)
             reason = event.reason or "breakpoint"
+            reason = _REVERSE_STOP_REASONS.get(reason, reason)
             self.protocol.send_event(
                 "stopped",
                 {
@@ -460,15 +541,63 @@ class HSXDebugAdapter:
             label = f"{expr} " if expr else ""
             text = f"watch {label}[{event.watch_id}] -> {event.new_value}\n"
             self.protocol.send_event("output", {"category": "console", "output": text})
+            self._drop_cached_watches()
             self._invalidate_variables_scope()
         elif isinstance(event, TraceStepEvent):
             # no-op; cache controller already updated registers
             return
+        elif event.type == "debug_log":
+            message = str(event.data.get("message") or "")
+            self.protocol.send_event("output", {"category": "console", "output": message + ("\n" if not message.endswith("\n") else "")})
 
     def _ensure_client(self) -> None:
         if not self.client:
             raise RuntimeError("debug session not connected")
 
+    def _begin_stop(self, pid: Optional[int] = None, seq: Optional[int] = None) -> None:
+        pid = pid if pid is not None else self.current_pid
+        if self.runtime_cache is not None and pid is not None:
+            self.runtime_cache.begin_stop(pid, seq)
+
+    def _sync_stop(self) -> None:
+        """Drop variable references handed out during an earlier stop."""
+
+        generation = self.runtime_cache.stop_generation.get(self.current_pid or 0, 0) if self.runtime_cache else None
+        if generation != self._stop_generation:
+            self._stop_generation = generation
+            self._var_refs.clear()
+            self._var_ref_keys.clear()
+
+    def _cached(self, key: Any, fallback):
+        pid = self.current_pid or 0
+        if self.runtime_cache is None:
+            return fallback()
+        return self.runtime_cache.query_variables(pid, key, fallback=fallback)
+
+    def _drop_cached_watches(self) -> None:
+        if self.runtime_cache is not None:
+            self.runtime_cache.invalidate_variables(self.current_pid or 0, "watches")
+
+    def _var_ref(self, ref: _VariableRef) -> int:
+        key = (ref.kind, ref.pid, ref.base, ref.length, ref.elem)
+        reference = self._var_ref_keys.get(key)
+        if reference is None:
+            reference = self._next_var_ref
+            self._next_var_ref += 1
+            self._var_refs[reference] = ref
+            self._var_ref_keys[key] = reference
+        return reference
+
+    def _memory_child(self, name: str, value: str, ref: _VariableRef, *, type_name: str) -> JsonDict:
+        return {
+            "name": name,
+            "value": value,
+            "type": type_name,
+            "variablesReference": self._var_ref(ref),
+            "indexedVariables": ref.count,
+            "memoryReference": f"0x{ref.base:08X}",
+        }
+
     def _format_registers(self) -> List[JsonDict]:
         if not self.client:
             return []
@@ -489,11 +618,21 @@ class HSXDebugAdapter:
     def _format_watches(self) -> List[JsonDict]:
         if not self.client:
             return []
-        watches = self.client.list_watches(self.current_pid, refresh=True)
+        pid = self.current_pid
+        watches = self._cached("watches", lambda: self.client.list_watches(pid, refresh=True))
         results = []
         for watch in watches:
             display = self._describe_watch_value(watch)
-            memory_ref = f"0x{watch.address:08X}" if getattr(watch, "address", None) is not None else None
+            address = getattr(watch, "address", None)
+            length = int(getattr(watch, "length", 0) or 0)
+            if address is not None and length > 4:
+                # Arrays and structs expand into pages of their bytes or words.
+                ref = _VariableRef("memory", pid or 0, base=int(address), length=length, elem=4 if length % 4 == 0 else 1)
+                child = self._memory_child(watch.expr or f"watch {watch.watch_id}", display, ref, type_name="watch")
+                child["evaluateName"] = watch.expr or None
+                results.append(child)
+                continue
+            memory_ref = f"0x{address:08X}" if address is not None else None
             results.append(
                 {
                     "name": watch.expr or f"watch {watch.watch_id}",
@@ -506,11 +645,59 @@ class HSXDebugAdapter:
             )
         return results
 
-    def _make_scope(self, name: str, variables: List[JsonDict], *, expensive: bool) -> JsonDict:
-        scope_id = self._next_scope_id
-        self._next_scope_id += 1
-        self._scopes[scope_id] = _ScopeRecord(variables=variables)
-        return {"name": name, "variablesReference": scope_id, "expensive": expensive}
+    def _format_regions(self, pid: int) -> List[JsonDict]:
+        if not self.client:
+            return []
+        regions = self._cached("regions", lambda: self.client.memory_regions(pid))
+        results = []
+        for region in regions:
+            start = int(region.get("start") or 0)
+            length = int(region.get("length") or 0)
+            if length <= 0:
+                continue
+            ref = _VariableRef("memory", pid, base=start, length=length, elem=4)
+            value = f"0x{start:04X}..0x{start + length:04X} ({length} bytes)"
+            results.append(self._memory_child(str(region.get("name") or f"0x{start:04X}"), value, ref, type_name=str(region.get("type") or "region")))
+        return results
+
+    def _read_memory(self, pid: int, address: int, length: int) -> Optional[bytes]:
+        # Refresh previously cached blocks once per stop from the dirty-granule report.
+        self._cached("memory_sync", lambda: self.client.sync_memory(pid))
+        return self.client.read_memory(address, length, pid=pid)
+
+    def _format_memory_page(self, ref: _VariableRef, start: int, count: int) -> List[JsonDict]:
+        if not self.client or start >= ref.count:
+            return []
+        if count <= 0:
+            count = ref.count - start
+        count = min(count, ref.count - start)
+        address = ref.base + start * ref.elem
+        length = min(count * ref.elem, ref.length - start * ref.elem)
+        data = self._read_memory(ref.pid, address, length)
+        if data is None:
+            return [{"name": f"[{start}]", "value": "<unreadable>", "variablesReference": 0}]
+        variables = []
+        for index in range(count):
+            chunk = data[index * ref.elem : (index + 1) * ref.elem]
+            if not chunk:
+                break
+            value = int.from_bytes(chunk, "little")
+            variables.append(
+                {
+                    "name": f"[{start + index}]",
+                    "value": f"0x{value:0{len(chunk) * 2}X}",
+                    "type": f"u{len(chunk) * 8}",
+                    "variablesReference": 0,
+                    "memoryReference": f"0x{address + index * ref.elem:08X}",
+                }
+            )
+        return variables
+
+    def _make_scope(self, name: str, ref: _VariableRef, *, expensive: bool, named: Optional[int] = None) -> JsonDict:
+        scope: JsonDict = {"name": name, "variablesReference": self._var_ref(ref), "expensive": expensive}
+        if named is not None:
+            scope["namedVariables"] = named
+        return scope
 
     def _parse_address(self, bp: JsonDict) -> Optional[int]:
         value = bp.get("instructionReference") or bp.get("address")
@@ -641,6 +828,7 @@ class HSXDebugAdapter:
             if watch_id:
                 self._watch_expr_to_id[expr] = watch_id
                 self._watch_id_to_expr[watch_id] = expr
+                self._drop_cached_watches()
                 self._invalidate_variables_scope()
         if not watch_id:
             return None
@@ -4,7 +4,7 @@ from __future__ import annotations
 
 import time
 from dataclasses import dataclass, field
-from typing import Any, Callable, Dict, Iterable, List, Mapping, Optional, Sequence
+from typing import Any, Callable, Dict, Iterable, List, Mapping, Optional, Sequence, Tuple
 
 from .events import (
     BaseEvent,
@@ -16,6 +16,9 @@ from .events import (
 )
 
 
+_MISS = object()
+
+
 def _to_int(value: Any) -> Optional[int]:
     try:
         if value is None:
@@ -99,11 +102,61 @@ class RuntimeCache:
 
     registers: Dict[int, RegisterState] = field(default_factory=dict)
     memory: Dict[int, Dict[int, MemoryBlock]] = field(default_factory=dict)
+    memory_sync: Dict[int, int] = field(default_factory=dict)
     callstacks: Dict[int, List[StackFrame]] = field(default_factory=dict)
     watches: Dict[int, Dict[int, WatchValue]] = field(default_factory=dict)
     mailboxes: Dict[int, Dict[str, MailboxDescriptor]] = field(default_factory=dict)
     symbols: Dict[str, Dict[str, Any]] = field(default_factory=dict)
     instructions: Dict[int, Dict[str, Any]] = field(default_factory=dict)
+    stop_generation: Dict[int, int] = field(default_factory=dict)
+    stop_event_seq: Dict[int, Optional[int]] = field(default_factory=dict)
+    variables: Dict[int, Dict[Any, Any]] = field(default_factory=dict)
+
+    # ------------------------------------------------------------------
+    # Stop generations
+    # ------------------------------------------------------------------
+    def begin_stop(self, pid: int, seq: Optional[int] = None) -> int:
+        """Start a new stop for ``pid`` and drop state tied to the previous one.
+
+        ``seq`` is the executive event sequence of the ``debug_break`` that
+        caused the stop; seeing the same event twice keeps the generation.
+        Cached memory is kept: it is refreshed precisely via ``mem_dirty``.
+        """
+
+        if seq is not None and pid in self.stop_generation and self.stop_event_seq.get(pid) == seq:
+            return self.stop_generation[pid]
+        generation = self.stop_generation.get(pid, 0) + 1
+        self.stop_generation[pid] = generation
+        self.stop_event_seq[pid] = seq
+        self.variables.pop(pid, None)
+        self.invalidate_registers(pid)
+        self.invalidate_stack(pid)
+        self.invalidate_watches(pid)
+        return generation
+
+    def cache_variables(self, pid: int, key: Any, value: Any) -> Any:
+        self.variables.setdefault(pid, {})[key] = (self.stop_generation.get(pid, 0), value)
+        return value
+
+    def lookup_variables(self, pid: int, key: Any, default: Any = None) -> Any:
+        entry = self.variables.get(pid, {}).get(key)
+        if entry is None or entry[0] != self.stop_generation.get(pid, 0):
+            return default
+        return entry[1]
+
+    def invalidate_variables(self, pid: int, key: Any = None) -> None:
+        if key is None:
+            self.variables.pop(pid, None)
+        else:
+            self.variables.get(pid, {}).pop(key, None)
+
+    def query_variables(self, pid: int, key: Any, *, fallback: Callable[[], Any]) -> Any:
+        """Serve ``key`` for the current stop, computing it once via ``fallback``."""
+
+        cached = self.lookup_variables(pid, key, _MISS)
+        if cached is not _MISS:
+            return cached
+        return self.cache_variables(pid, key, fallback())
 
     # ------------------------------------------------------------------
     # Register snapshots
@@ -182,6 +235,79 @@ class RuntimeCache:
                 self.cache_memory(pid, addr, data)
         return data
 
+    def patch_memory(self, pid: int, addr: int, data: bytes) -> int:
+        """Overwrite cached bytes in place; returns the number of bytes updated."""
+
+        updated = 0
+        end = addr + len(data)
+        for block in self.memory.get(pid, {}).values():
+            lo = max(addr, block.base)
+            hi = min(end, block.end)
+            if lo >= hi:
+                continue
+            buf = bytearray(block.data)
+            buf[lo - block.base : hi - block.base] = data[lo - addr : hi - addr]
+            block.data = bytes(buf)
+            block.timestamp = _now()
+            updated += hi - lo
+        return updated
+
+    def dirty_spans(self, pid: int, ranges: Iterable[Sequence[int]]) -> List[Tuple[int, int]]:
+        """Intersect dirty ``[addr, length]`` ranges with cached blocks."""
+
+        blocks = self.memory.get(pid)
+        if not blocks:
+            return []
+        spans: List[Tuple[int, int]] = []
+        for entry in ranges:
+            start = int(entry[0])
+            stop = start + int(entry[1])
+            for block in blocks.values():
+                lo = max(start, block.base)
+                hi = min(stop, block.end)
+                if lo < hi:
+                    spans.append((lo, hi))
+        spans.sort()
+        merged: List[Tuple[int, int]] = []
+        for lo, hi in spans:
+            if merged and lo <= merged[-1][1]:
+                merged[-1] = (merged[-1][0], max(merged[-1][1], hi))
+            else:
+                merged.append((lo, hi))
+        return [(lo, hi - lo) for lo, hi in merged]
+
+    def apply_memory_dirty(
+        self,
+        pid: int,
+        dirty: Mapping[str, Any],
+        fetch: Callable[[int, int], Optional[bytes]],
+    ) -> int:
+        """Refetch only cached bytes covered by a ``mem_dirty`` report.
+
+        Blocks whose refetch fails are dropped. Returns the number of bytes
+        refreshed.
+        """
+
+        refreshed = 0
+        for addr, length in self.dirty_spans(pid, dirty.get("ranges") or []):
+            data = fetch(addr, length)
+            if data is None or len(data) < length:
+                self._drop_blocks(pid, addr, length)
+                continue
+            refreshed += self.patch_memory(pid, addr, data[:length])
+        seq = _to_int(dirty.get("seq"))
+        if seq is not None:
+            self.memory_sync[pid] = seq
+        return refreshed
+
+    def _drop_blocks(self, pid: int, addr: int, length: int) -> None:
+        blocks = self.memory.get(pid)
+        if not blocks:
+            return
+        for base, block in list(blocks.items()):
+            if block.base < addr + length and addr < block.end:
+                blocks.pop(base, None)
+
     # ------------------------------------------------------------------
     # Stack frames
     # ------------------------------------------------------------------
@@ -310,8 +436,7 @@ class RuntimeCache:
             }
             self.update_watch(pid, payload)
         elif isinstance(event, DebugBreakEvent):
-            # force stack refresh after breakpoint
-            self.callstacks.pop(pid, None)
+            self.begin_stop(pid, event.seq)
 
     def seed_snapshot(
         self,
@@ -335,15 +460,18 @@ class RuntimeCache:
     def clear_pid(self, pid: int) -> None:
         self.registers.pop(pid, None)
         self.memory.pop(pid, None)
+        self.memory_sync.pop(pid, None)
         self.callstacks.pop(pid, None)
         self.watches.pop(pid, None)
         self.mailboxes.pop(pid, None)
+        self.variables.pop(pid, None)
 
     def invalidate_registers(self, pid: int) -> None:
         self.registers.pop(pid, None)
 
     def invalidate_memory(self, pid: int) -> None:
         self.memory.pop(pid, None)
+        self.memory_sync.pop(pid, None)
 
     def invalidate_stack(self, pid: int) -> None:
         self.callstacks.pop(pid, None)
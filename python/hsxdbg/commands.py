@@ -40,6 +40,7 @@ class CommandClient:
         target = pid or self.session.state.pid
         response = self._request({"cmd": "pause", "pid": target})
         self._invalidate_cache(target, registers=True, stack=True)
+        self.sync_memory(target)
         return response
 
     def resume(self, pid: Optional[int] = None) -> Dict:
@@ -57,10 +58,44 @@ class CommandClient:
             payload["source_only"] = True
         response = self._request(payload)
         self._invalidate_cache(payload["pid"], registers=True, stack=True)
+        self.sync_memory(payload["pid"])
         return response
 
-    def set_breakpoint(self, address: int, pid: Optional[int] = None) -> Dict:
+    def reverse(self, op: str, pid: Optional[int] = None, **options) -> Dict:
+        target = pid or self.session.state.pid
+        payload = {"cmd": "reverse", "pid": target, "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        response = self._request(payload)
+        if op not in {"enable", "disable", "config", "stats"}:
+            self._invalidate_cache(target, registers=True, stack=True, watches=True)
+            self.sync_memory(target)
+        return response
+
+    def reverse_step(self, pid: Optional[int] = None, *, count: int = 1) -> Dict:
+        return self.reverse("step", pid, count=count)
+
+    def reverse_continue(self, pid: Optional[int] = None) -> Dict:
+        return self.reverse("continue", pid)
+
+    def reverse_to_last_write(self, address: int, pid: Optional[int] = None, *, width: int = 4) -> Dict:
+        return self.reverse("last_write", pid, addr=address, width=width)
+
+    def set_breakpoint(
+        self,
+        address: int,
+        pid: Optional[int] = None,
+        *,
+        condition: Optional[str] = None,
+        hit_condition: Optional[str] = None,
+        log_message: Optional[str] = None,
+    ) -> Dict:
         payload = {"cmd": "bp.add", "pid": pid or self.session.state.pid, "address": address}
+        if condition:
+            payload["condition"] = condition
+        if hit_condition:
+            payload["hit_condition"] = hit_condition
+        if log_message is not None:
+            payload["log_message"] = log_message
         return self._request(payload)
 
     def clear_breakpoint(self, address: int, pid: Optional[int] = None) -> Dict:
@@ -182,6 +217,14 @@ class CommandClient:
             raise RuntimeError(f"sym info failed: {response}")
         return response.get("symbols") or {}
 
+    def memory_regions(self, pid: Optional[int] = None) -> List[Dict]:
+        target = pid or self.session.state.pid
+        response = self._request({"cmd": "memory", "op": "regions", "pid": target})
+        if response.get("status") != "ok":
+            raise RuntimeError(f"memory regions failed: {response}")
+        regions = (response.get("memory") or {}).get("regions") or []
+        return [dict(region) for region in regions if isinstance(region, dict)]
+
     def read_memory(
         self,
         addr: int,
@@ -204,6 +247,20 @@ class CommandClient:
 
         return self.cache.query_memory(pid, addr, length, fallback=fallback)
 
+    def sync_memory(self, pid: Optional[int] = None) -> int:
+        """Refresh cached memory using the executive's dirty-granule report."""
+
+        pid = pid or self.session.state.pid
+        if not self.cache or pid is None or not self.cache.memory.get(pid):
+            return 0
+        payload = {"cmd": "mem_dirty", "pid": pid, "since": self.cache.memory_sync.get(pid, 0)}
+        response = self._request(payload)
+        dirty = response.get("dirty") if response.get("status") == "ok" else None
+        if not isinstance(dirty, dict):
+            self.cache.invalidate_memory(pid)
+            return 0
+        return self.cache.apply_memory_dirty(pid, dirty, lambda a, l: self._peek_memory(pid, a, l))
+
     # ------------------------------------------------------------------
     # RPC fetchers
     # ------------------------------------------------------------------
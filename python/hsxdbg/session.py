@@ -174,8 +174,13 @@ class SessionManager:
         *,
         auto_ack: bool = True,
         ack_interval: float = 0.5,
+        credits: Optional[int] = None,
     ) -> Dict:
-        """Subscribe to executive events and enable automatic ACKs."""
+        """Subscribe to executive events and enable automatic ACKs.
+
+        ``credits`` caps the number of unacked events in flight; the executive
+        summarises high-rate events instead of sending them while it is spent.
+        """
 
         if not self.state.session_id:
             self.open()
@@ -186,6 +191,8 @@ class SessionManager:
             "session": self.state.session_id,
             "filters": filters or {},
         }
+        if credits is not None:
+            payload["credits"] = int(credits)
         response = self.transport.send_request(payload)
         if response.get("status") != "ok":
             raise RuntimeError(f"events.subscribe failed: {response}")
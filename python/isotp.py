@@ -0,0 +1,420 @@
+#!/usr/bin/env python3
+"""ISO-TP (ISO 15765-2) style segmented transport over the virtual CAN bus.
+
+An :class:`ISOTPEndpoint` owns one :class:`~python.can_bus.CANNode`, sends
+on ``tx_id`` and listens on ``rx_id`` (programmed into filter bank 0).
+Messages of up to 7 bytes go out as a single frame; longer ones as a first
+frame followed by consecutive frames, paced by the receiver's flow control:
+
+* the receiver answers every first frame, and every ``block_size``
+  consecutive frames after it, with a flow-control frame (clear to send,
+  wait, or overflow), so at most one block is ever unacknowledged;
+* consecutive frames within a block are spaced at least ``st_min_us``
+  apart (the receiver's value, encoded as in ISO 15765-2);
+* the receiver reassembles into a buffer from a fixed :class:`BufferPool`,
+  and answers overflow when no buffer is free or the message is too long.
+
+Frames are always padded to 8 bytes, as most ECUs require.  The endpoint is
+driven entirely by bus events (frame received, own frame sent), so all timing
+is in simulated bus time.  :class:`ImageLoaderBridge` and
+:func:`mailbox_sink` connect reassembled messages to the VM controller's
+``load_stream_*`` calls and to task mailboxes.
+"""
+
+from __future__ import annotations
+
+import struct
+from collections import deque
+from typing import Any, Callable, Deque, Dict, List, Optional, Tuple
+
+try:
+    from . import can_bus
+except ImportError:  # pragma: no cover - allow running as a script
+    import can_bus  # type: ignore
+
+PCI_SF = 0x0
+PCI_FF = 0x1
+PCI_CF = 0x2
+PCI_FC = 0x3
+
+FC_CTS = 0x0
+FC_WAIT = 0x1
+FC_OVFLW = 0x2
+
+SF_MAX = 7
+FF_SHORT_MAX = 0xFFF
+MAX_MESSAGE = 0xFFFFFFFF
+PAD_BYTE = 0xCC
+
+DEFAULT_POOL_BUFFERS = 4
+DEFAULT_POOL_SIZE = FF_SHORT_MAX
+
+
+def encode_st_min(us: int) -> int:
+    us = max(int(us), 0)
+    if us == 0:
+        return 0
+    if us < 1000:
+        return 0xF0 + max(us // 100, 1)
+    return min((us + 999) // 1000, 0x7F)
+
+
+def decode_st_min(value: int) -> int:
+    """Separation time in microseconds; reserved values mean the maximum."""
+
+    if value <= 0x7F:
+        return value * 1000
+    if 0xF1 <= value <= 0xF9:
+        return (value - 0xF0) * 100
+    return 0x7F * 1000
+
+
+class BufferPool:
+    """Fixed set of reassembly buffers shared by the endpoints of one node."""
+
+    def __init__(self, buffers: int = DEFAULT_POOL_BUFFERS, size: int = DEFAULT_POOL_SIZE) -> None:
+        self.size = max(int(size), SF_MAX + 1)
+        self.free: List[bytearray] = [bytearray(self.size) for _ in range(max(int(buffers), 1))]
+        self.capacity = len(self.free)
+        self.high_water = 0
+        self.exhausted = 0
+
+    def acquire(self, length: int) -> Optional[bytearray]:
+        if length > self.size or not self.free:
+            self.exhausted += 1
+            return None
+        buffer = self.free.pop()
+        self.high_water = max(self.high_water, self.capacity - len(self.free))
+        return buffer
+
+    def release(self, buffer: bytearray) -> None:
+        self.free.append(buffer)
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "buffers": self.capacity,
+            "size": self.size,
+            "in_use": self.capacity - len(self.free),
+            "high_water": self.high_water,
+            "exhausted": self.exhausted,
+        }
+
+
+class _Reassembly:
+    __slots__ = ("buffer", "length", "filled", "seq", "block")
+
+    def __init__(self, buffer: bytearray, length: int) -> None:
+        self.buffer = buffer
+        self.length = length
+        self.filled = 0
+        self.seq = 1
+        self.block = 0
+
+
+class ISOTPEndpoint:
+    """One side of an ISO-TP channel (``tx_id`` out, ``rx_id`` in)."""
+
+    def __init__(
+        self,
+        bus: can_bus.CANBus,
+        name: str,
+        *,
+        tx_id: int,
+        rx_id: int,
+        block_size: int = 8,
+        st_min_us: int = 0,
+        pool: Optional[BufferPool] = None,
+        on_message: Optional[Callable[[bytes], None]] = None,
+        flags: int = can_bus.HSX_CAN_STD_FRAME,
+    ) -> None:
+        self.bus = bus
+        self.tx_id = int(tx_id)
+        self.rx_id = int(rx_id)
+        self.flags = flags
+        self.block_size = max(min(int(block_size), 0xFF), 0)
+        self.st_min = encode_st_min(st_min_us)
+        self.pool = pool if pool is not None else BufferPool()
+        self.on_message = on_message
+        self.node = bus.attach(name, deliver=self._on_frames, on_tx=self._on_tx, rx_batch=1)
+        mask = can_bus.EXT_ID_MASK if flags & can_bus.HSX_CAN_EXT_FRAME else can_bus.STD_ID_MASK
+        self.node.set_filter(0, mask, self.rx_id)
+
+        self._outbox: Deque[bytes] = deque()
+        self._tx: Optional[memoryview] = None
+        self._tx_offset = 0
+        self._tx_seq = 0
+        self._tx_block_left = 0
+        self._tx_gap_ns = 0
+        self._waiting_fc = False
+        self._rx: Optional[_Reassembly] = None
+        self.last_rx_ns = 0
+
+        self.tx_messages = 0
+        self.tx_bytes = 0
+        self.tx_aborted = 0
+        self.rx_messages = 0
+        self.rx_bytes = 0
+        self.rx_aborted = 0
+        self.fc_sent = 0
+        self.fc_received = 0
+        self.fc_wait = 0
+        self.overflows = 0
+
+    # ------------------------------------------------------------------
+    # Sending
+    # ------------------------------------------------------------------
+    def send(self, payload: bytes) -> int:
+        """Queue one message; returns ``HSX_HAL_OK`` or ``HSX_HAL_INVALID_PARAM``."""
+
+        if not payload or len(payload) > MAX_MESSAGE:
+            return can_bus.HSX_HAL_INVALID_PARAM
+        with self.bus.lock:
+            self._outbox.append(bytes(payload))
+            if self._tx is None:
+                self._start_next(max(self.bus.now_ns, self.bus.idle_ns))
+        return can_bus.HSX_HAL_OK
+
+    @property
+    def busy(self) -> bool:
+        return self._tx is not None or bool(self._outbox)
+
+    def _frame(self, pci: bytes, data: bytes = b"") -> can_bus.CANFrame:
+        body = pci + data
+        return can_bus.CANFrame(self.tx_id, body.ljust(8, bytes([PAD_BYTE])), self.flags)
+
+    def _start_next(self, at_ns: int) -> None:
+        self._tx = None
+        if not self._outbox:
+            return
+        message = memoryview(self._outbox.popleft())
+        self._tx = message
+        length = len(message)
+        if length <= SF_MAX:
+            self._tx_offset = length
+            self.node.send(self._frame(bytes([(PCI_SF << 4) | length]), message.tobytes()), at_ns=at_ns)
+            return
+        if length <= FF_SHORT_MAX:
+            pci = bytes([(PCI_FF << 4) | (length >> 8), length & 0xFF])
+        else:
+            pci = bytes([PCI_FF << 4, 0]) + struct.pack(">I", length)
+        first = 8 - len(pci)
+        self._tx_offset = first
+        self._tx_seq = 1
+        self._waiting_fc = True
+        self.node.send(self._frame(pci, message[:first].tobytes()), at_ns=at_ns)
+
+    def _send_cf(self, at_ns: int) -> None:
+        message = self._tx
+        chunk = message[self._tx_offset : self._tx_offset + 7].tobytes()
+        self._tx_offset += len(chunk)
+        self.node.send(self._frame(bytes([(PCI_CF << 4) | (self._tx_seq & 0xF)]), chunk), at_ns=at_ns)
+        self._tx_seq += 1
+        if self._tx_block_left:
+            self._tx_block_left -= 1
+            if self._tx_block_left == 0 and self._tx_offset < len(message):
+                self._waiting_fc = True
+
+    def _finish_tx(self, end_ns: int) -> None:
+        self.tx_messages += 1
+        self.tx_bytes += len(self._tx)
+        self._start_next(end_ns)
+
+    def _on_tx(self, frame: can_bus.CANFrame, end_ns: int) -> None:
+        pci = frame.data[0] >> 4
+        if pci == PCI_FC or self._tx is None:
+            return
+        if self._tx_offset >= len(self._tx) and pci in (PCI_SF, PCI_CF):
+            self._finish_tx(end_ns)
+        elif pci == PCI_CF and not self._waiting_fc:
+            self._send_cf(end_ns + self._tx_gap_ns)
+
+    def _on_fc(self, data: bytes, now_ns: int) -> None:
+        if self._tx is None or not self._waiting_fc:
+            return
+        self.fc_received += 1
+        status = data[0] & 0xF
+        if status == FC_WAIT:
+            self.fc_wait += 1
+            return
+        if status != FC_CTS:
+            self.overflows += 1
+            self.tx_aborted += 1
+            self._waiting_fc = False
+            self._start_next(now_ns)
+            return
+        self._waiting_fc = False
+        self._tx_block_left = data[1]
+        self._tx_gap_ns = decode_st_min(data[2]) * 1000
+        self._send_cf(now_ns)
+
+    # ------------------------------------------------------------------
+    # Receiving
+    # ------------------------------------------------------------------
+    def _send_fc(self, status: int, now_ns: int) -> None:
+        self.fc_sent += 1
+        self.node.send(self._frame(bytes([(PCI_FC << 4) | status, self.block_size, self.st_min])), at_ns=now_ns)
+
+    def _abort_rx(self) -> None:
+        if self._rx is not None:
+            self.pool.release(self._rx.buffer)
+            self._rx = None
+            self.rx_aborted += 1
+
+    def _complete(self, payload: bytes, now_ns: int) -> None:
+        self.rx_messages += 1
+        self.rx_bytes += len(payload)
+        self.last_rx_ns = now_ns
+        if self.on_message is not None:
+            self.on_message(payload)
+
+    def _on_frames(self, batch: List[Tuple[can_bus.CANFrame, int]]) -> bool:
+        now_ns = self.bus.idle_ns  # end of the frame just received
+        for frame, _timestamp_us in batch:
+            if frame.can_id != self.rx_id or not frame.data:
+                continue
+            data = frame.data
+            pci = data[0] >> 4
+            if pci == PCI_FC:
+                self._on_fc(data, now_ns)
+            elif pci == PCI_SF:
+                length = data[0] & 0xF
+                if 0 < length <= SF_MAX:
+                    self._complete(data[1 : 1 + length], now_ns)
+            elif pci == PCI_FF:
+                self._abort_rx()
+                length = ((data[0] & 0xF) << 8) | data[1]
+                header = 2
+                if length == 0:
+                    length = struct.unpack(">I", data[2:6])[0]
+                    header = 6
+                buffer = self.pool.acquire(length)
+                if buffer is None:
+                    self.overflows += 1
+                    self._send_fc(FC_OVFLW, now_ns)
+                    continue
+                rx = _Reassembly(buffer, length)
+                piece = data[header:8]
+                buffer[: len(piece)] = piece
+                rx.filled = len(piece)
+                self._rx = rx
+                self._send_fc(FC_CTS, now_ns)
+            elif pci == PCI_CF:
+                rx = self._rx
+                if rx is None:
+                    continue
+                if data[0] & 0xF != rx.seq & 0xF:
+                    self._abort_rx()  # lost or repeated frame
+                    continue
+                take = min(7, rx.length - rx.filled)
+                rx.buffer[rx.filled : rx.filled + take] = data[1 : 1 + take]
+                rx.filled += take
+                rx.seq += 1
+                if rx.filled >= rx.length:
+                    payload = bytes(memoryview(rx.buffer)[: rx.length])
+                    self.pool.release(rx.buffer)
+                    self._rx = None
+                    self._complete(payload, now_ns)
+                    continue
+                rx.block += 1
+                if self.block_size and rx.block == self.block_size:
+                    rx.block = 0
+                    self._send_fc(FC_CTS, now_ns)
+        return True
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "name": self.node.name,
+            "tx_id": self.tx_id,
+            "rx_id": self.rx_id,
+            "block_size": self.block_size,
+            "st_min_us": decode_st_min(self.st_min),
+            "tx_messages": self.tx_messages,
+            "tx_bytes": self.tx_bytes,
+            "tx_aborted": self.tx_aborted,
+            "tx_queued": len(self._outbox) + (1 if self._tx is not None else 0),
+            "rx_messages": self.rx_messages,
+            "rx_bytes": self.rx_bytes,
+            "rx_aborted": self.rx_aborted,
+            "fc_sent": self.fc_sent,
+            "fc_received": self.fc_received,
+            "fc_wait": self.fc_wait,
+            "overflows": self.overflows,
+            "pool": self.pool.stats(),
+        }
+
+
+# ----------------------------------------------------------------------
+# Bridges into the executive
+# ----------------------------------------------------------------------
+LOADER_BEGIN = 0x01
+LOADER_DATA = 0x02
+LOADER_END = 0x03
+LOADER_ABORT = 0x04
+LOADER_REPLY = 0x80
+LOADER_CHUNK = DEFAULT_POOL_SIZE - 1  # opcode + data fit one short first frame
+
+
+def image_messages(image: bytes, label: str = "isotp", *, chunk: int = LOADER_CHUNK) -> List[bytes]:
+    """Loader protocol messages that stream ``image`` through ``load_stream_*``."""
+
+    messages = [bytes([LOADER_BEGIN]) + label.encode("utf-8")]
+    view = memoryview(image)
+    for start in range(0, len(image), chunk):
+        messages.append(bytes([LOADER_DATA]) + view[start : start + chunk].tobytes())
+    messages.append(bytes([LOADER_END]))
+    return messages
+
+
+class ImageLoaderBridge:
+    """Feeds loader messages from an endpoint into ``load_stream_begin/write/end``.
+
+    Each message starts with an opcode: ``BEGIN`` (label), ``DATA`` (image
+    bytes), ``END`` or ``ABORT``.  ``END`` and any failure are answered with
+    ``[0x80 | opcode, status, pid (u32 LE)]``; status 0 is success.
+    """
+
+    def __init__(self, controller: Any, endpoint: ISOTPEndpoint) -> None:
+        self.controller = controller
+        self.endpoint = endpoint
+        self.pid: Optional[int] = None
+        self.bytes = 0
+        self.results: List[Dict[str, Any]] = []
+        endpoint.on_message = self.handle
+
+    def _reply(self, opcode: int, ok: bool) -> None:
+        self.endpoint.send(bytes([LOADER_REPLY | opcode, 0 if ok else 1]) + struct.pack("<I", self.pid or 0))
+
+    def handle(self, message: bytes) -> None:
+        opcode, body = message[0], message[1:]
+        if opcode == LOADER_BEGIN:
+            if self.pid is not None:
+                self.controller.load_stream_abort(self.pid)
+            result = self.controller.load_stream_begin(label=body.decode("utf-8", errors="replace") or None)
+            self.pid = result.get("pid")
+            self.bytes = 0
+        elif opcode == LOADER_DATA and self.pid is not None:
+            result = self.controller.load_stream_write(self.pid, body)
+            self.bytes += len(body)
+        elif opcode == LOADER_END and self.pid is not None:
+            result = self.controller.load_stream_end(self.pid)
+            self._reply(opcode, result.get("status") == "ok")
+            self.pid = None
+        elif opcode == LOADER_ABORT and self.pid is not None:
+            result = self.controller.load_stream_abort(self.pid)
+            self.pid = None
+        else:
+            result = {"status": "error", "error": "EINVAL"}
+        self.results.append(result)
+        if result.get("status") != "ok" and opcode != LOADER_END:
+            self._reply(opcode, False)
+
+
+def mailbox_sink(controller: Any, pid: int, handle: int) -> Callable[[bytes], None]:
+    """``on_message`` callback posting each reassembled message to a task mailbox."""
+
+    def deliver(message: bytes) -> None:
+        ok, descriptor_id = controller.mailboxes.send(pid=pid, handle=handle, payload=message)
+        if ok:
+            controller._deliver_mailbox_messages(descriptor_id)
+
+    return deliver
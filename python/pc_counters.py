@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""Exact per-PC execution counters and their coverage reports.
+
+Where :mod:`python.profiler` samples, :class:`PCCounters` counts every
+dispatched instruction of one task.  Counts live in a preallocated
+``array`` indexed by ``pc >> 2`` (16- or 32-bit unsigned cells that
+saturate instead of wrapping), so a 64 KiB image costs at most 64 KiB of
+counters and ``MiniVM.step`` only bumps existing cells.  With edges
+enabled a second array counts how often each conditional branch was taken;
+the fall-through count is the branch's hit count minus that.
+
+The report helpers turn the exported counts plus a decoded instruction
+listing (``pc``, ``size``, ``mnemonic``, ``operands`` and optional ``symbol``
+/ ``line`` annotations, as produced by the executive's disassembly cache)
+into annotated disassembly, per-source-line heat and lcov tracefiles.
+"""
+
+from __future__ import annotations
+
+from array import array
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple
+
+BRANCH_OPCODES = frozenset({0x22, 0x23})  # JZ, JNZ
+
+_TYPECODES = {16: "H", 32: "I"}
+
+
+class PCCounters:
+    """Saturating per-instruction hit counters (and branch-taken counters)."""
+
+    def __init__(self, code_len: int, *, width: int = 32, edges: bool = True) -> None:
+        if width not in _TYPECODES:
+            raise ValueError("counter width must be 16 or 32")
+        self.width = width
+        self.limit = (1 << width) - 1
+        self.slots = max((int(code_len) + 3) // 4, 1)
+        typecode = _TYPECODES[width]
+        self.hits = array(typecode, bytes(self.slots * array(typecode).itemsize))
+        self.taken: Optional[array] = array(typecode, bytes(self.slots * array(typecode).itemsize)) if edges else None
+
+    @property
+    def nbytes(self) -> int:
+        total = self.hits.itemsize * len(self.hits)
+        if self.taken is not None:
+            total += self.taken.itemsize * len(self.taken)
+        return total
+
+    def reset(self) -> None:
+        zero = bytes(self.hits.itemsize * self.slots)
+        self.hits = array(self.hits.typecode, zero)
+        if self.taken is not None:
+            self.taken = array(self.taken.typecode, zero)
+
+    def export(self) -> Dict[str, Any]:
+        """Non-zero counters as ``[[pc, hits], ...]`` and ``{pc: [taken, not_taken]}``."""
+
+        hits = self.hits
+        limit = self.limit
+        counts = [[idx << 2, value] for idx, value in enumerate(hits) if value]
+        saturated = any(value == limit for _pc, value in counts)
+        info: Dict[str, Any] = {
+            "width": self.width,
+            "slots": self.slots,
+            "bytes": self.nbytes,
+            "saturated": saturated,
+            "counts": counts,
+        }
+        if self.taken is not None:
+            taken = self.taken
+            info["edges"] = {
+                str(idx << 2): [value, max(hits[idx] - value, 0)] for idx, value in enumerate(taken) if value
+            }
+        return info
+
+
+# ----------------------------------------------------------------------
+# Reports
+# ----------------------------------------------------------------------
+def _line_key(entry: Dict[str, Any]) -> Optional[Tuple[str, int]]:
+    line = entry.get("line")
+    if not isinstance(line, dict) or line.get("line") is None:
+        return None
+    return str(line.get("file") or "?"), int(line["line"])
+
+
+def _branch_counts(entry: Dict[str, Any], hits: int, edges: Dict[int, Sequence[int]]) -> Optional[Tuple[int, int]]:
+    if entry.get("mnemonic") not in {"JZ", "JNZ"}:
+        return None
+    pair = edges.get(int(entry["pc"]))
+    if pair is None:
+        return (0, hits)
+    return int(pair[0]), int(pair[1])
+
+
+def normalise(export: Dict[str, Any]) -> Tuple[Dict[int, int], Dict[int, Sequence[int]]]:
+    hits = {int(pc): int(count) for pc, count in export.get("counts") or []}
+    edges = {int(pc): pair for pc, pair in (export.get("edges") or {}).items()}
+    return hits, edges
+
+
+def annotate(
+    instructions: Iterable[Dict[str, Any]],
+    hits: Dict[int, int],
+    edges: Dict[int, Sequence[int]],
+) -> str:
+    """Disassembly listing prefixed with each instruction's execution count."""
+
+    out: List[str] = []
+    for entry in instructions:
+        pc = int(entry["pc"])
+        if entry.get("label"):
+            out.append(f"{entry['label']}:")
+        count = hits.get(pc, 0)
+        text = f"{entry['mnemonic']} {entry.get('operands') or ''}".rstrip()
+        marker = f"{count:>10}" if count else f"{'#####':>10}"
+        row = f"{marker}  0x{pc:04X}  {text}"
+        notes = []
+        branch = _branch_counts(entry, count, edges)
+        if branch is not None and count:
+            notes.append(f"taken {branch[0]} / not {branch[1]}")
+        key = _line_key(entry)
+        if key is not None:
+            notes.append(f"{key[0]}:{key[1]}")
+        if notes:
+            row = f"{row:<48} ; {'  '.join(notes)}"
+        out.append(row)
+    return "\n".join(out) + ("\n" if out else "")
+
+
+def line_heat(instructions: Iterable[Dict[str, Any]], hits: Dict[int, int]) -> List[Dict[str, Any]]:
+    """Per source line: instructions executed on it and times it was entered."""
+
+    heat: Dict[Tuple[str, int], Dict[str, Any]] = {}
+    for entry in instructions:
+        key = _line_key(entry)
+        if key is None:
+            continue
+        slot = heat.setdefault(key, {"file": key[0], "line": key[1], "instructions": 0, "count": 0, "executed": 0})
+        count = hits.get(int(entry["pc"]), 0)
+        slot["instructions"] += count
+        slot["count"] = max(slot["count"], count)
+        slot["executed"] += 1 if count else 0
+    return sorted(heat.values(), key=lambda item: (-item["instructions"], item["file"], item["line"]))
+
+
+def lcov(
+    instructions: Sequence[Dict[str, Any]],
+    hits: Dict[int, int],
+    edges: Dict[int, Sequence[int]],
+    *,
+    test_name: str = "",
+) -> str:
+    """Render an lcov tracefile (``DA``/``FN``/``BRDA`` records per source file)."""
+
+    files: Dict[str, Dict[str, Any]] = {}
+
+    def _file(name: str) -> Dict[str, Any]:
+        return files.setdefault(name, {"lines": {}, "functions": {}, "branches": []})
+
+    for entry in instructions:
+        key = _line_key(entry)
+        if key is None:
+            continue
+        record = _file(key[0])
+        pc = int(entry["pc"])
+        count = hits.get(pc, 0)
+        record["lines"][key[1]] = max(record["lines"].get(key[1], 0), count)
+        symbol = entry.get("symbol")
+        if isinstance(symbol, dict) and symbol.get("name") and not symbol.get("offset"):
+            record["functions"].setdefault(symbol["name"], (key[1], count))
+        branch = _branch_counts(entry, count, edges)
+        if branch is not None:
+            record["branches"].append((key[1], pc, branch if count else None))
+
+    out: List[str] = []
+    for name in sorted(files):
+        record = files[name]
+        out.append(f"TN:{test_name}")
+        out.append(f"SF:{name}")
+        functions = sorted(record["functions"].items(), key=lambda item: item[1][0])
+        for func, (line, _count) in functions:
+            out.append(f"FN:{line},{func}")
+        for func, (_line, count) in functions:
+            out.append(f"FNDA:{count},{func}")
+        out.append(f"FNF:{len(functions)}")
+        out.append(f"FNH:{sum(1 for _func, (_line, count) in functions if count)}")
+        branches_hit = 0
+        for line, pc, branch in record["branches"]:
+            if branch is None:
+                out.append(f"BRDA:{line},{pc},0,-")
+                out.append(f"BRDA:{line},{pc},1,-")
+                continue
+            out.append(f"BRDA:{line},{pc},0,{branch[0]}")
+            out.append(f"BRDA:{line},{pc},1,{branch[1]}")
+            branches_hit += (1 if branch[0] else 0) + (1 if branch[1] else 0)
+        out.append(f"BRF:{2 * len(record['branches'])}")
+        out.append(f"BRH:{branches_hit}")
+        lines = sorted(record["lines"].items())
+        for line, count in lines:
+            out.append(f"DA:{line},{count}")
+        out.append(f"LF:{len(lines)}")
+        out.append(f"LH:{sum(1 for _line, count in lines if count)}")
+        out.append("end_of_record")
+    return "\n".join(out) + ("\n" if out else "")
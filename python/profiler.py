@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""Statistical sampling profiler for HSX tasks.
+
+The VM controller owns one :class:`SampleProfiler` while profiling is on and
+calls :meth:`SampleProfiler.observe` after every retired instruction.  Two
+sampling clocks are available:
+
+``instructions``
+    every task is sampled once per ``period`` of *its own* retired
+    instructions, so each task's profile has the same density regardless of
+    how the scheduler shares the CPU.
+``timer``
+    a virtual-time timer driven by the controller's global instruction clock
+    (``clock_hz`` instructions per virtual second) fires every ``timer_ms``
+    and samples whichever task is running, so sample counts also show how
+    the CPU is split between tasks.
+
+A sample is the task's PC plus the VM's shadow call stack (the return
+addresses pushed by ``CALL``), stored raw in a fixed-size ring buffer; the
+oldest samples are overwritten once it fills.  Symbolisation happens off the
+hot path: :func:`aggregate` folds the ring into unique stacks and
+:func:`collapse_stacks` / :func:`function_profile` turn them into
+collapsed-stack text (for ``flamegraph.pl`` / speedscope) and per-function
+self/total counts using a caller-supplied resolver backed by the ``.sym``
+function and line tables.
+"""
+
+from __future__ import annotations
+
+import time
+from collections import Counter, deque
+from typing import Any, Callable, Dict, Iterable, List, Optional, Sequence, Tuple
+
+DEFAULT_PERIOD = 1000
+DEFAULT_TIMER_MS = 1.0
+DEFAULT_CLOCK_HZ = 1_000_000
+DEFAULT_CAPACITY = 65536
+DEFAULT_MAX_DEPTH = 64
+
+MODE_INSTRUCTIONS = "instructions"
+MODE_TIMER = "timer"
+
+# (pid, pc, call stack outermost-first as return addresses)
+Sample = Tuple[int, int, Tuple[int, ...]]
+# pc -> (function, file, line); any element may be None
+Resolver = Callable[[int, int], Tuple[Optional[str], Optional[str], Optional[int]]]
+
+
+class SampleProfiler:
+    """Fixed-size ring of PC + call-stack samples taken every N instructions."""
+
+    def __init__(
+        self,
+        *,
+        period: Optional[int] = None,
+        timer_ms: Optional[float] = None,
+        clock_hz: Optional[int] = None,
+        capacity: Optional[int] = None,
+        max_depth: Optional[int] = None,
+        pids: Optional[Iterable[int]] = None,
+    ) -> None:
+        self.clock_hz = max(int(clock_hz or DEFAULT_CLOCK_HZ), 1)
+        if timer_ms is not None:
+            self.mode = MODE_TIMER
+            self.timer_ms = max(float(timer_ms), 0.001)
+            self.period = max(int(self.clock_hz * self.timer_ms / 1000.0), 1)
+        else:
+            self.mode = MODE_INSTRUCTIONS
+            self.timer_ms = None
+            self.period = max(int(period or DEFAULT_PERIOD), 1)
+        self.capacity = max(int(capacity or DEFAULT_CAPACITY), 1)
+        self.max_depth = max(int(max_depth or DEFAULT_MAX_DEPTH), 0)
+        self.pids = frozenset(int(pid) for pid in pids) if pids else None
+        self.samples: deque[Sample] = deque(maxlen=self.capacity)
+        self.active = True
+        self.retired = 0
+        self.taken = 0
+        self.dropped = 0
+        self.sample_seconds = 0.0
+        self.started_at = time.perf_counter()
+        self.stopped_at: Optional[float] = None
+        self._countdown = self.period
+        self._task_due: Dict[int, int] = {}
+
+    def observe(self, vm: Any, pid: int) -> None:
+        """Account one retired instruction of ``pid``; sample when due."""
+
+        if self.mode == MODE_TIMER:
+            self.retired += 1
+            self._countdown -= 1
+            if self._countdown > 0:
+                return
+            self._countdown = self.period
+        else:
+            steps = vm.steps
+            due = self._task_due.get(pid)
+            if due is None:
+                self._task_due[pid] = steps + self.period
+                return
+            if steps < due:
+                return
+            self._task_due[pid] = steps + self.period
+        if self.pids is not None and pid not in self.pids:
+            return
+        self.sample(vm, pid)
+
+    def sample(self, vm: Any, pid: int) -> None:
+        began = time.perf_counter()
+        stack = vm.call_stack
+        if len(stack) > self.max_depth:
+            stack = stack[len(stack) - self.max_depth :] if self.max_depth else ()
+        if len(self.samples) == self.capacity:
+            self.dropped += 1
+        self.samples.append((pid, vm.pc & 0xFFFFFFFF, tuple(stack)))
+        self.taken += 1
+        self.sample_seconds += time.perf_counter() - began
+
+    def stop(self) -> None:
+        if self.active:
+            self.active = False
+            self.stopped_at = time.perf_counter()
+
+    def clear(self) -> None:
+        self.samples.clear()
+        self.dropped = 0
+
+    def elapsed(self) -> float:
+        end = self.stopped_at if self.stopped_at is not None else time.perf_counter()
+        return max(end - self.started_at, 0.0)
+
+    def stats(self) -> Dict[str, Any]:
+        elapsed = self.elapsed()
+        info: Dict[str, Any] = {
+            "active": self.active,
+            "mode": self.mode,
+            "period": self.period,
+            "capacity": self.capacity,
+            "max_depth": self.max_depth,
+            "samples": len(self.samples),
+            "taken": self.taken,
+            "dropped": self.dropped,
+            "elapsed": round(elapsed, 6),
+            "sample_overhead_pct": round(100.0 * self.sample_seconds / elapsed, 3) if elapsed > 0 else 0.0,
+        }
+        if self.mode == MODE_TIMER:
+            info["timer_ms"] = self.timer_ms
+            info["clock_hz"] = self.clock_hz
+            info["retired"] = self.retired
+        if self.pids is not None:
+            info["pids"] = sorted(self.pids)
+        return info
+
+
+def aggregate(samples: Iterable[Sample]) -> List[Dict[str, Any]]:
+    """Fold raw samples into unique ``{"pid", "pcs", "count"}`` stacks.
+
+    ``pcs`` runs outermost-first and ends with the sampled PC; caller frames
+    are the call sites (return address - 4), not the return addresses.
+    """
+
+    counts: Counter = Counter(samples)
+    stacks = []
+    for (pid, pc, returns), count in counts.most_common():
+        pcs = [(ret - 4) & 0xFFFFFFFF for ret in returns]
+        pcs.append(pc)
+        stacks.append({"pid": pid, "pcs": pcs, "count": count})
+    return stacks
+
+
+def _frame_label(resolved: Tuple[Optional[str], Optional[str], Optional[int]], pc: int, *, lines: bool) -> str:
+    function, file, line = resolved
+    label = function or f"0x{pc:04X}"
+    if lines and line is not None:
+        label = f"{label}:{line}"
+    # ';' separates frames and ' ' the count in collapsed-stack text.
+    return label.replace(";", ":").replace(" ", "_")
+
+
+def _memo(resolve: Resolver) -> Resolver:
+    cache: Dict[Tuple[int, int], Tuple[Optional[str], Optional[str], Optional[int]]] = {}
+
+    def lookup(pid: int, pc: int) -> Tuple[Optional[str], Optional[str], Optional[int]]:
+        key = (pid, pc)
+        hit = cache.get(key)
+        if hit is None:
+            hit = cache[key] = resolve(pid, pc)
+        return hit
+
+    return lookup
+
+
+def collapse_stacks(
+    stacks: Sequence[Dict[str, Any]],
+    resolve: Resolver,
+    *,
+    task_label: Optional[Callable[[int], str]] = None,
+    lines: bool = False,
+) -> str:
+    """Render aggregated stacks as collapsed-stack text, one stack per line."""
+
+    resolve = _memo(resolve)
+    folded: Counter = Counter()
+    for entry in stacks:
+        pid = int(entry["pid"])
+        frames = [task_label(pid) if task_label else f"pid{pid}"]
+        frames.extend(_frame_label(resolve(pid, pc), pc, lines=lines) for pc in entry["pcs"])
+        folded[";".join(frames)] += int(entry["count"])
+    return "".join(f"{stack} {count}\n" for stack, count in sorted(folded.items()))
+
+
+def function_profile(
+    stacks: Sequence[Dict[str, Any]],
+    resolve: Resolver,
+    *,
+    weight: int = 1,
+) -> Dict[str, Any]:
+    """Per-function self/total sample and estimated instruction counts.
+
+    ``self`` counts samples whose leaf is in the function, ``total`` samples
+    with the function anywhere on the stack (recursion counted once); each
+    sample stands for ``weight`` instructions.  Leaf source lines are
+    tallied as well.
+    """
+
+    resolve = _memo(resolve)
+    self_counts: Counter = Counter()
+    total_counts: Counter = Counter()
+    line_counts: Counter = Counter()
+    samples = 0
+    for entry in stacks:
+        pid = int(entry["pid"])
+        count = int(entry["count"])
+        samples += count
+        names = [_frame_label(resolve(pid, pc), pc, lines=False) for pc in entry["pcs"]]
+        if not names:
+            continue
+        self_counts[names[-1]] += count
+        for name in set(names):
+            total_counts[name] += count
+        leaf_pc = entry["pcs"][-1]
+        _function, file, line = resolve(pid, leaf_pc)
+        if line is not None:
+            line_counts[(file or "?", int(line))] += count
+
+    def _pct(value: int) -> float:
+        return round(100.0 * value / samples, 2) if samples else 0.0
+
+    functions = [
+        {
+            "function": name,
+            "self": self_counts.get(name, 0),
+            "total": total,
+            "self_pct": _pct(self_counts.get(name, 0)),
+            "total_pct": _pct(total),
+            "self_instructions": self_counts.get(name, 0) * weight,
+            "total_instructions": total * weight,
+        }
+        for name, total in total_counts.items()
+    ]
+    functions.sort(key=lambda item: (-item["self"], -item["total"], item["function"]))
+    hot_lines = [
+        {"file": file, "line": line, "samples": count, "pct": _pct(count)}
+        for (file, line), count in line_counts.most_common()
+    ]
+    return {"samples": samples, "weight": weight, "functions": functions, "lines": hot_lines}
@@ -38,8 +38,10 @@ COMMAND_NAMES = sorted(
     [
         "attach",
         "bp",
+        "can",
         "cd",
         "clock",
+        "coverage",
         "cmd.call",
         "cmd.list",
         "detach",
@@ -49,6 +51,8 @@ COMMAND_NAMES = sorted(
         "events",
         "exec",
         "exit",
+        "fs",
+        "gpio",
         "help",
         "info",
         "kill",
@@ -60,6 +64,7 @@ COMMAND_NAMES = sorted(
         "pause",
         "peek",
         "poke",
+        "profile",
         "ps",
         "pwd",
         "quit",
@@ -74,12 +79,15 @@ COMMAND_NAMES = sorted(
         "stdio",
         "disasm",
         "stack",
+        "stats",
         "memory",
         "watch",
         "symbols",
         "sym",
+        "timer",
         "trace",
         "step",
+        "uart",
         "val.get",
         "val.list",
         "val.set",
@@ -1249,6 +1257,252 @@ def _pretty_clock(payload: dict) -> None:
                 print(f"    {key:<10}: {result.get(key)}")
 
 
+def _pretty_coverage(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("coverage", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    pid = info.get("pid")
+    if not info.get("enabled"):
+        print(f"coverage pid={pid}: disabled")
+        return
+    print(
+        f"coverage pid={pid}: {info.get('width')}-bit counters, {info.get('slots')} slots"
+        f" ({info.get('bytes')} bytes)"
+    )
+    if "instructions" in info:
+        print(
+            f"  executed={info.get('executed')} covered={info.get('covered')}/{info.get('instructions')}"
+            f" ({info.get('coverage_pct')}%) branches={info.get('branches')}"
+        )
+        if info.get("saturated"):
+            print("  warning: some counters saturated")
+        lines = info.get("lines")
+        if isinstance(lines, list) and lines:
+            print("  hot lines:")
+            for entry in lines[:10]:
+                print(f"    {entry.get('instructions'):>10}  {entry.get('file')}:{entry.get('line')}  (x{entry.get('count')})")
+    if info.get("annotated"):
+        print(str(info["annotated"]).rstrip())
+    if info.get("path"):
+        print(f"  lcov written to {info['path']}")
+
+
+def _pretty_profile(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("profile", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    header = f"profile {info.get('op', 'status')}: active={info.get('active')}"
+    mode = info.get("mode")
+    if mode == "timer":
+        header += f" every {info.get('timer_ms')} ms @ {info.get('clock_hz')} Hz"
+    elif mode:
+        header += f" every {info.get('period')} instructions"
+    print(header)
+    if "samples" in info:
+        print(
+            f"  samples={info.get('samples')} taken={info.get('taken', 0)} dropped={info.get('dropped', 0)}"
+            f" capacity={info.get('capacity')} overhead={info.get('sample_overhead_pct', 0)}%"
+        )
+    functions = info.get("functions")
+    if isinstance(functions, list):
+        print(f"  {'self%':>6} {'total%':>6} {'self':>7} {'total':>7}  function")
+        for entry in functions[:20]:
+            print(
+                f"  {entry.get('self_pct', 0):>6.2f} {entry.get('total_pct', 0):>6.2f}"
+                f" {entry.get('self', 0):>7} {entry.get('total', 0):>7}  {entry.get('function')}"
+            )
+        if len(functions) > 20:
+            print(f"  ... {len(functions) - 20} more")
+    lines = info.get("lines")
+    if isinstance(lines, list) and lines:
+        print("  hot lines:")
+        for entry in lines[:10]:
+            print(f"    {entry.get('pct', 0):>6.2f}%  {entry.get('file')}:{entry.get('line')}")
+    if info.get("path"):
+        print(f"  collapsed stacks written to {info['path']}")
+    elif info.get("collapsed"):
+        print(str(info["collapsed"]).rstrip())
+
+
+def _pretty_fs(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("fs", {})
+    if not isinstance(info, dict) or info.get("backend") != "flash":
+        print(f"fs {info.get('op', 'stats') if isinstance(info, dict) else ''}: in-memory stub backend".rstrip())
+        return
+    geometry = info.get("geometry", {})
+    pages = info.get("pages", {})
+    flash = info.get("flash", {})
+    wear = flash.get("wear", {})
+    gc = info.get("gc", {})
+    cache = info.get("cache", {})
+    image = f" image={info['image']}" if info.get("image") else ""
+    print(
+        f"fs {info.get('op', 'stats')}: {info.get('type')} flash {geometry.get('blocks')}x"
+        f"{geometry.get('pages_per_block')}x{geometry.get('page_size')}B{image}"
+    )
+    print(f"  files={info.get('files')} dirs={info.get('dirs')} open={info.get('open_fds')}")
+    print(
+        f"  pages live={pages.get('live')} obsolete={pages.get('obsolete')} free={pages.get('free')}"
+        f" free_blocks={pages.get('free_blocks')}"
+    )
+    print(
+        f"  flash reads={flash.get('reads')} programs={flash.get('programs')} erases={flash.get('erases')}"
+        f" busy={flash.get('busy_us', 0) / 1000.0:.1f} ms"
+    )
+    print(
+        f"  wear min={wear.get('min')} max={wear.get('max')} mean={wear.get('mean')}"
+        f"  gc runs={gc.get('runs')} moved={gc.get('pages_moved')} wear_moves={gc.get('wear_moves')}"
+    )
+    print(
+        f"  cache hits={cache.get('hits')} misses={cache.get('misses')} hit_rate={cache.get('hit_rate')}"
+        f" readahead={cache.get('readahead_hits')}/{cache.get('readahead_pages')}"
+        f"  write_amp={info.get('write_amplification')}"
+    )
+    queue = info.get("io_queue")
+    if isinstance(queue, dict):
+        print(
+            f"  io_queue pending={queue.get('pending')} backlog={queue.get('backlog')} submitted={queue.get('submitted')}"
+            f" completed={queue.get('completed')} merged={queue.get('merged')} device_ops={queue.get('device_ops')}"
+            f" rejected={queue.get('rejected')}"
+        )
+
+
+def _pretty_can(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("can", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    socket_text = f" socket={info['socket']}" if info.get("socket") else ""
+    print(
+        f"can {info.get('op', 'stats')}: {info.get('bitrate')} bit/s t={info.get('time_us')} us"
+        f" frames={info.get('frames')} load={float(info.get('load') or 0.0) * 100:.1f}%{socket_text}"
+    )
+    for name, node in sorted((info.get("nodes") or {}).items()):
+        marker = "*" if name == info.get("node") else " "
+        print(
+            f" {marker}{name:<16} tx={node.get('tx_frames')} pending={node.get('tx_pending')}"
+            f" lost_arb={node.get('arbitration_lost')} rx={node.get('rx_frames')} filtered={node.get('rx_filtered')}"
+            f" batches={node.get('rx_batches')} dropped={node.get('rx_dropped')} max_lat={node.get('max_latency_us')}us"
+        )
+    loader = info.get("loader")
+    if isinstance(loader, dict):
+        print(
+            f"  isotp loader rx=0x{loader.get('rx_id', 0):X} tx=0x{loader.get('tx_id', 0):X} bs={loader.get('block_size')}"
+            f" stmin={loader.get('st_min_us')}us messages={loader.get('rx_messages')} bytes={loader.get('bytes')}"
+            f" aborted={loader.get('rx_aborted')} overflows={loader.get('overflows')} pid={loader.get('pid')}"
+        )
+
+
+def _pretty_uart(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("uart", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    ports = info.get("ports") or {}
+    if not ports:
+        print(f"uart {info.get('op', 'stats')}: no ports attached")
+        return
+    subscribers = info.get("subscribers") or {}
+    print(f"uart {info.get('op', 'stats')}:")
+    for index, port in sorted(ports.items(), key=lambda item: int(item[0])):
+        parity = "NEO"[int(port.get("parity") or 0)]
+        backend = port.get("backend") or {}
+        where = backend.get("path") or backend.get("address") or "sim"
+        sub = subscribers.get(index) or subscribers.get(str(index))
+        sub_text = f" mbox=pid{sub.get('pid')}:{sub.get('handle')}" if isinstance(sub, dict) else ""
+        print(f"  uart{index} {port.get('baud')} 8{parity}{port.get('stop_bits')} on {where}{sub_text}")
+        print(
+            f"    tx={port.get('tx_bytes')} in {port.get('tx_chunks')} chunks pending={port.get('tx_pending')}"
+            f" full={port.get('tx_rejected')}  rx={port.get('rx_bytes')} pending={port.get('rx_pending')}"
+            f" idle_events={port.get('rx_idle_events')} half_events={port.get('rx_half_events')} overruns={port.get('rx_overruns')}"
+        )
+
+
+def _pretty_gpio(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("gpio", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    replay_text = f" replayed={info['replayed']}" if "replayed" in info else ""
+    print(f"gpio {info.get('op', 'stats')}: t={info.get('time_us')} us pins={info.get('pins')} queued={info.get('queued')}{replay_text}")
+    subscribers = info.get("subscribers") or {}
+    edges = {0: "-", 1: "rise", 2: "fall", 3: "both"}
+    for pin in info.get("active") or []:
+        sub = subscribers.get(pin.get("pin")) or subscribers.get(str(pin.get("pin")))
+        sub_text = f" mbox=pid{sub.get('pid')}:{sub.get('handle')}" if isinstance(sub, dict) else ""
+        print(
+            f"  pin{pin.get('pin'):<3} value={pin.get('value')} edge={edges.get(pin.get('edge'), pin.get('edge'))}"
+            f" debounce={pin.get('debounce_us')}us coalesce={pin.get('coalesce_us')}us raw={pin.get('raw_edges')}"
+            f" filtered={pin.get('filtered')} edges={pin.get('edges')} events={pin.get('events')}"
+            f" pending={pin.get('pending')}{sub_text}"
+        )
+
+
+def _pretty_timer(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("timer", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    print(
+        f"timer {info.get('op', 'stats')}: clock={info.get('clock')} t={info.get('time_us')} us tick={info.get('tick_us')} us"
+        f" active={info.get('active')} fires={info.get('fires')} missed={info.get('missed')}"
+        f" dropped={info.get('dropped')} cascades={info.get('cascades')} jitter_max={info.get('jitter_max_us')}us"
+    )
+    for timer in info.get("timers") or []:
+        period = f"every {timer.get('period_us')}us" if timer.get("period_us") else "one-shot"
+        print(
+            f"  timer{timer.get('id'):<5} pid={timer.get('owner')} {period} due={timer.get('due_us')}us"
+            f" fires={timer.get('fires')} missed={timer.get('missed')} dropped={timer.get('dropped')}"
+            f" jitter min/mean/max={timer.get('jitter_min_us')}/{timer.get('jitter_mean_us')}/{timer.get('jitter_max_us')}us"
+        )
+
+
+def _pretty_stats(payload: dict) -> None:
+    if payload.get("status") != "ok":
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    info = payload.get("stats", {})
+    if not isinstance(info, dict):
+        print(json.dumps(payload, indent=2, sort_keys=True))
+        return
+    path_text = f" -> {info['path']}" if info.get("path") else ""
+    print(
+        f"svc stats {info.get('op', 'show')}{path_text}: calls={info.get('calls')} errors={info.get('errors')}"
+        f" instructions={info.get('instructions')} elapsed={info.get('elapsed_s')}s blocked_now={info.get('blocked_now')}"
+    )
+    for svc in info.get("svcs") or []:
+        wall = svc.get("wall_ns") or {}
+        instr = svc.get("instructions") or {}
+        print(
+            f"  {svc.get('name', '?'):<12} calls={svc.get('calls'):<8} errors={svc.get('errors'):<6} blocked={svc.get('blocked'):<6}"
+            f" wall_ns p50/p99/max={wall.get('p50')}/{wall.get('p99')}/{wall.get('max')}"
+            f" instr p50/p99/max={instr.get('p50')}/{instr.get('p99')}/{instr.get('max')}"
+        )
+
+
 def _pretty_trace(payload: dict) -> None:
     if payload.get("status") != "ok":
         print(json.dumps(payload, indent=2, sort_keys=True))
@@ -1312,6 +1566,21 @@ def _pretty_trace(payload: dict) -> None:
             print(line)
         return
 
+    spill = info.get("spill")
+    if isinstance(spill, dict):
+        state = "active" if spill.get("active") else "inactive"
+        print(f"trace spill: pid={spill.get('pid')} {state}")
+        if "path" in spill:
+            ratio = ""
+            raw_bytes = spill.get("raw_bytes") or 0
+            file_bytes = spill.get("bytes") or 0
+            if raw_bytes and file_bytes:
+                ratio = f" ({raw_bytes / file_bytes:.1f}x)"
+            print(f"  path    : {spill.get('path')}")
+            print(f"  records : {spill.get('records')} in {spill.get('chunks')} chunk(s) of {spill.get('chunk_records')}")
+            print(f"  bytes   : {file_bytes}{ratio} compress={spill.get('compress')}")
+        return
+
     print("trace:")
     if "pid" in info:
         print(f"  pid     : {info.get('pid')}")
@@ -2041,6 +2310,14 @@ PRETTY_HANDLERS = {
     'clock': _pretty_clock,
     'step': _pretty_clock,
     'trace': _pretty_trace,
+    'profile': _pretty_profile,
+    'coverage': _pretty_coverage,
+    'fs': _pretty_fs,
+    'can': _pretty_can,
+    'uart': _pretty_uart,
+    'gpio': _pretty_gpio,
+    'timer': _pretty_timer,
+    'stats': _pretty_stats,
     'listen': _pretty_listen,
     'send': _pretty_send,
     'dbg': _pretty_dbg,
@@ -2183,7 +2460,7 @@ def _build_payload(
                     raise ValueError("disasm usage: disasm <pid> [addr] [count] [--mode on-demand|cached]")
             i += 1
         if not mode_set:
-            payload.setdefault("mode", "on-demand")
+            payload.setdefault("mode", "cached")
         return payload
     if cmd == "stack":
         if not args:
@@ -2266,6 +2543,333 @@ def _build_payload(
             return payload
         raise ValueError(f"dbg unknown subcommand '{subcmd}'")
 
+    if cmd == "coverage":
+        usage = "coverage usage: coverage <pid> on [--width 16|32] [--no-edges] | off | reset | status | dump [file] [--annotate]"
+        if not args:
+            raise ValueError(usage)
+        try:
+            payload["pid"] = int(args[0], 0)
+        except ValueError as exc:
+            raise ValueError("coverage requires integer pid") from exc
+        action = args[1].lower() if len(args) > 1 else "status"
+        tokens = args[2:]
+        ops = {"on": "enable", "enable": "enable", "off": "disable", "disable": "disable", "reset": "reset", "status": "status", "dump": "dump"}
+        if action not in ops:
+            raise ValueError(usage)
+        payload["op"] = ops[action]
+        i = 0
+        while i < len(tokens):
+            token = tokens[i]
+            if payload["op"] == "enable" and token == "--width" and i + 1 < len(tokens):
+                i += 1
+                try:
+                    payload["width"] = int(tokens[i], 0)
+                except ValueError as exc:
+                    raise ValueError("coverage --width requires 16 or 32") from exc
+            elif payload["op"] == "enable" and token == "--no-edges":
+                payload["edges"] = False
+            elif payload["op"] == "dump" and token == "--annotate":
+                payload["annotate"] = True
+            elif payload["op"] == "dump" and not token.startswith("--") and "path" not in payload:
+                file_path = Path(token)
+                if current_dir is not None and not file_path.is_absolute():
+                    file_path = current_dir / file_path
+                payload["path"] = str(file_path.resolve(strict=False))
+            else:
+                raise ValueError(usage)
+            i += 1
+        return payload
+
+    if cmd == "profile":
+        usage = (
+            "profile usage: profile start [period <n>|timer <ms>] [pid <pid>] [capacity <n>] [depth <n>]"
+            " | stop | status | dump [file] [--lines] [--clear]"
+        )
+        op = args[0].lower() if args else "status"
+        payload["op"] = op
+        tokens = args[1:]
+        if op == "start":
+            keys = {"period": "period", "timer": "timer_ms", "pid": "pid", "capacity": "capacity", "depth": "max_depth"}
+            if len(tokens) % 2:
+                raise ValueError(usage)
+            for name, value in zip(tokens[::2], tokens[1::2]):
+                key = keys.get(name.lower())
+                if key is None:
+                    raise ValueError(usage)
+                try:
+                    payload[key] = float(value) if key == "timer_ms" else int(value, 0)
+                except ValueError as exc:
+                    raise ValueError(f"profile start {name} requires a number") from exc
+            return payload
+        if op in {"stop", "status"}:
+            if tokens:
+                raise ValueError(usage)
+            return payload
+        if op == "dump":
+            for token in tokens:
+                if token == "--lines":
+                    payload["lines"] = True
+                elif token == "--clear":
+                    payload["clear"] = True
+                elif token.startswith("--") or "path" in payload:
+                    raise ValueError(usage)
+                else:
+                    file_path = Path(token)
+                    if current_dir is not None and not file_path.is_absolute():
+                        file_path = current_dir / file_path
+                    payload["path"] = str(file_path.resolve(strict=False))
+            return payload
+        raise ValueError(usage)
+
+    if cmd == "fs":
+        usage = "fs usage: fs [stats] | mount <nor|nand|stub> [image <file>] [blocks <n>] | format | sync"
+        op = args[0].lower() if args else "stats"
+        payload["op"] = op
+        tokens = args[1:]
+        if op == "mount":
+            if not tokens:
+                raise ValueError(usage)
+            kind = tokens[0].lower()
+            if kind == "stub":
+                payload["backend"] = "stub"
+            elif kind in {"nor", "nand"}:
+                payload["backend"] = "flash"
+                payload["type"] = kind
+            else:
+                raise ValueError(usage)
+            options = tokens[1:]
+            if len(options) % 2:
+                raise ValueError(usage)
+            for name, value in zip(options[::2], options[1::2]):
+                key = name.lower()
+                if key == "image":
+                    file_path = Path(value)
+                    if current_dir is not None and not file_path.is_absolute():
+                        file_path = current_dir / file_path
+                    payload["image"] = str(file_path.resolve(strict=False))
+                elif key in {"blocks", "cache"}:
+                    try:
+                        payload["blocks" if key == "blocks" else "cache_pages"] = int(value, 0)
+                    except ValueError as exc:
+                        raise ValueError(f"fs mount {name} requires a number") from exc
+                else:
+                    raise ValueError(usage)
+            return payload
+        if op in {"stats", "format", "sync"} and not tokens:
+            return payload
+        raise ValueError(usage)
+
+    if cmd == "can":
+        usage = (
+            "can usage: can [stats] | attach [bitrate <n>] [port <n>] [node <name>] | send <id> [hexdata] [ext] [rtr]"
+            " | loader [rx <id>] [tx <id>] [bs <n>] [stmin <us>]"
+        )
+        op = args[0].lower() if args else "stats"
+        payload["op"] = op
+        tokens = args[1:]
+        if op == "stats" and not tokens:
+            return payload
+        if op == "attach":
+            if len(tokens) % 2:
+                raise ValueError(usage)
+            for name, value in zip(tokens[::2], tokens[1::2]):
+                key = name.lower()
+                if key == "node":
+                    payload["node"] = value
+                elif key in {"bitrate", "port"}:
+                    try:
+                        payload[key] = int(value, 0)
+                    except ValueError as exc:
+                        raise ValueError(f"can attach {name} requires a number") from exc
+                else:
+                    raise ValueError(usage)
+            return payload
+        if op == "loader":
+            if len(tokens) % 2:
+                raise ValueError(usage)
+            keys = {"rx": "rx_id", "tx": "tx_id", "bs": "block_size", "stmin": "st_min_us"}
+            for name, value in zip(tokens[::2], tokens[1::2]):
+                key = keys.get(name.lower())
+                if key is None:
+                    raise ValueError(usage)
+                try:
+                    payload[key] = int(value, 0)
+                except ValueError as exc:
+                    raise ValueError(f"can loader {name} requires a number") from exc
+            return payload
+        if op == "send" and tokens:
+            try:
+                payload["id"] = int(tokens[0], 0)
+            except ValueError as exc:
+                raise ValueError(usage) from exc
+            flags = 0
+            for token in tokens[1:]:
+                lowered = token.lower()
+                if lowered == "ext":
+                    flags |= 0x01
+                elif lowered == "rtr":
+                    flags |= 0x02
+                elif "data" not in payload:
+                    try:
+                        bytes.fromhex(token)
+                    except ValueError as exc:
+                        raise ValueError(f"can send data must be hex bytes: {token}") from exc
+                    payload["data"] = token
+                else:
+                    raise ValueError(usage)
+            if flags:
+                payload["flags"] = flags
+            return payload
+        raise ValueError(usage)
+
+    if cmd == "gpio":
+        usage = (
+            "gpio usage: gpio [stats] | attach [pins <n>] | drive <pin> <0|1> | replay <file>"
+            " | debounce <pin> <us> [coalesce <us>] [edge none|rising|falling|both]"
+        )
+        op = args[0].lower() if args else "stats"
+        payload["op"] = op
+        tokens = args[1:]
+        if op == "stats" and not tokens:
+            return payload
+        try:
+            if op == "attach" and len(tokens) in (0, 2) and (not tokens or tokens[0].lower() == "pins"):
+                if tokens:
+                    payload["pins"] = int(tokens[1], 0)
+                return payload
+            if op == "drive" and len(tokens) == 2 and tokens[1] in {"0", "1"}:
+                payload["pin"] = int(tokens[0], 0)
+                payload["value"] = int(tokens[1])
+                return payload
+            if op == "debounce" and len(tokens) >= 2 and len(tokens) % 2 == 0:
+                payload["pin"] = int(tokens[0], 0)
+                payload["debounce_us"] = int(tokens[1], 0)
+                for name, value in zip(tokens[2::2], tokens[3::2]):
+                    key = name.lower()
+                    if key == "coalesce":
+                        payload["coalesce_us"] = int(value, 0)
+                    elif key == "edge" and value.lower() in {"none", "rising", "falling", "both"}:
+                        payload["edge"] = ("none", "rising", "falling", "both").index(value.lower())
+                    else:
+                        raise ValueError(usage)
+                return payload
+        except ValueError as exc:
+            raise ValueError(usage) from exc
+        if op == "replay" and len(tokens) == 1:
+            file_path = Path(tokens[0])
+            if current_dir is not None and not file_path.is_absolute():
+                file_path = current_dir / file_path
+            payload["path"] = str(file_path.resolve(strict=False))
+            return payload
+        raise ValueError(usage)
+
+    if cmd == "stats":
+        usage = "stats usage: stats [show] [top <n>] | reset | snapshot [file]"
+        op = args[0].lower() if args else "show"
+        tokens = args[1:]
+        if op == "top":
+            op, tokens = "show", list(args)
+        payload["op"] = op
+        if op == "show" and len(tokens) in (0, 2) and (not tokens or tokens[0].lower() == "top"):
+            if tokens:
+                try:
+                    payload["top"] = int(tokens[1], 0)
+                except ValueError as exc:
+                    raise ValueError(usage) from exc
+            payload["buckets"] = False
+            return payload
+        if op == "reset" and not tokens:
+            return payload
+        if op == "snapshot" and len(tokens) <= 1:
+            if tokens:
+                file_path = Path(tokens[0])
+                if current_dir is not None and not file_path.is_absolute():
+                    file_path = current_dir / file_path
+                payload["path"] = str(file_path.resolve(strict=False))
+            return payload
+        raise ValueError(usage)
+
+    if cmd == "timer":
+        usage = "timer usage: timer [stats [limit <n>]] | cancel <id> | advance <us>"
+        op = args[0].lower() if args else "stats"
+        payload["op"] = op
+        tokens = args[1:]
+        try:
+            if op == "stats" and len(tokens) in (0, 2) and (not tokens or tokens[0].lower() == "limit"):
+                if tokens:
+                    payload["limit"] = int(tokens[1], 0)
+                return payload
+            if op == "cancel" and len(tokens) == 1:
+                payload["timer"] = int(tokens[0], 0)
+                return payload
+            if op == "advance" and len(tokens) == 1:
+                payload["us"] = int(tokens[0], 0)
+                return payload
+        except ValueError as exc:
+            raise ValueError(usage) from exc
+        raise ValueError(usage)
+
+    if cmd == "uart":
+        usage = (
+            "uart usage: uart [stats] | attach <port> [pty|socket|none] [baud <n>] [listen <n>]"
+            " | config <port> <baud> [none|even|odd] [1|2] | feed|send <port> <hexdata> | detach <port>"
+        )
+        op = args[0].lower() if args else "stats"
+        payload["op"] = op
+        tokens = args[1:]
+        if op == "stats" and not tokens:
+            return payload
+        if op not in {"attach", "config", "feed", "send", "detach"} or not tokens:
+            raise ValueError(usage)
+        try:
+            payload["port"] = int(tokens[0], 0)
+        except ValueError as exc:
+            raise ValueError(usage) from exc
+        tokens = tokens[1:]
+        if op == "attach":
+            if tokens and tokens[0].lower() in {"pty", "socket", "none"}:
+                payload["backend"] = tokens[0].lower()
+                tokens = tokens[1:]
+            if len(tokens) % 2:
+                raise ValueError(usage)
+            for name, value in zip(tokens[::2], tokens[1::2]):
+                key = name.lower()
+                if key not in {"baud", "listen"}:
+                    raise ValueError(usage)
+                try:
+                    payload[key] = int(value, 0)
+                except ValueError as exc:
+                    raise ValueError(f"uart attach {name} requires a number") from exc
+            return payload
+        if op == "config":
+            if not 1 <= len(tokens) <= 3:
+                raise ValueError(usage)
+            try:
+                payload["baud"] = int(tokens[0], 0)
+            except ValueError as exc:
+                raise ValueError(usage) from exc
+            for token in tokens[1:]:
+                lowered = token.lower()
+                if lowered in {"none", "even", "odd"}:
+                    payload["parity"] = ("none", "even", "odd").index(lowered)
+                elif lowered in {"1", "2"}:
+                    payload["stop_bits"] = int(lowered)
+                else:
+                    raise ValueError(usage)
+            return payload
+        if op in {"feed", "send"}:
+            if len(tokens) != 1:
+                raise ValueError(usage)
+            try:
+                bytes.fromhex(tokens[0])
+            except ValueError as exc:
+                raise ValueError(f"uart {op} data must be hex bytes: {tokens[0]}") from exc
+            payload["data"] = tokens[0]
+            return payload
+        if tokens:
+            raise ValueError(usage)
+        return payload
+
     if cmd == "trace":
         if not args:
             raise ValueError("trace requires <pid> [on|off|records <limit>] or 'config <option>'")
@@ -2300,6 +2904,37 @@ def _build_payload(
                 except ValueError as exc:
                     raise ValueError("trace records/export limit must be integer") from exc
             return payload
+        if subcmd == "spill":
+            payload["op"] = "spill"
+            tokens = args[2:]
+            if not tokens or tokens[0].lower() == "status":
+                payload["action"] = "status"
+                return payload
+            if tokens[0].lower() in {"off", "stop"}:
+                payload["action"] = "stop"
+                return payload
+            file_path = Path(tokens[0])
+            if current_dir is not None and not file_path.is_absolute():
+                file_path = (current_dir / file_path).resolve(strict=False)
+            else:
+                file_path = file_path.resolve(strict=False)
+            payload["action"] = "start"
+            payload["path"] = str(file_path)
+            i = 1
+            while i < len(tokens):
+                token = tokens[i]
+                if token == "--raw":
+                    payload["compress"] = False
+                elif token == "--chunk" and i + 1 < len(tokens):
+                    i += 1
+                    try:
+                        payload["chunk"] = int(tokens[i], 0)
+                    except ValueError as exc:
+                        raise ValueError("trace spill --chunk requires integer record count") from exc
+                else:
+                    raise ValueError("trace spill usage: trace <pid> spill <file> [--raw] [--chunk <records>] | off | status")
+                i += 1
+            return payload
         if subcmd == "import":
             if len(args) < 3:
                 raise ValueError("trace import requires <file>")
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Always-on SVC instrumentation for the Python executive.
+
+Every SVC a task traps into is counted per ``(module, fn)`` together with
+its errors and two latency histograms: wall-clock nanoseconds and guest
+instructions, both measured from the trap until the caller runs again.  A
+call that completes inside its handler therefore costs one instruction and
+the handler's run time; a call that blocks (a mailbox receive, a sleep) also
+includes the time until the executive next schedules the caller, and the
+instructions every other task retired meanwhile.
+
+Histograms use log-linear buckets (as in HdrHistogram): values below
+``2**SUB_BITS`` get one bucket each, and every power of two above that is
+split into ``2**SUB_BITS`` equal buckets, so a bucket's width is at most a
+quarter of its lower bound.  Recording is a ``bit_length`` and a list
+increment; nothing is allocated on the hot path after the first call of a
+given SVC.
+
+An SVC is an error when R0 is negative as a signed 32-bit value (the
+``HSX_HAL_*`` and ``HSX_ERR_*`` codes); modules that return status codes,
+such as the mailbox module, count every non-zero status.
+"""
+
+from __future__ import annotations
+
+import json
+import os
+import time
+from typing import Any, Dict, Optional, Tuple
+
+SUB_BITS = 2
+SUB_COUNT = 1 << SUB_BITS
+BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS
+
+MODULE_NAMES = {
+    0x0: "core",
+    0x1: "uart",
+    0x2: "can",
+    0x3: "timer",
+    0x4: "fs",
+    0x5: "mailbox",
+    0x6: "exec",
+    0x7: "value",
+    0x8: "command",
+    0x9: "gpio",
+    0xE: "libm",
+}
+STATUS_MODULES = frozenset({0x5})  # R0 is a status code; anything but 0 is an error
+
+
+def bucket_index(value: int) -> int:
+    if value < SUB_COUNT:
+        return max(value, 0)
+    shift = value.bit_length() - SUB_BITS - 1
+    return ((shift + 1) << SUB_BITS) | ((value >> shift) & (SUB_COUNT - 1))
+
+
+def bucket_bounds(index: int) -> Tuple[int, int]:
+    """Inclusive lower and exclusive upper bound of a bucket."""
+
+    if index < SUB_COUNT:
+        return index, index + 1
+    shift = (index >> SUB_BITS) - 1
+    low = (SUB_COUNT | (index & (SUB_COUNT - 1))) << shift
+    return low, low + (1 << shift)
+
+
+class Histogram:
+    __slots__ = ("counts", "count", "total", "max")
+
+    def __init__(self) -> None:
+        self.counts = [0] * BUCKETS
+        self.count = 0
+        self.total = 0
+        self.max = 0
+
+    def record(self, value: int) -> None:
+        self.counts[bucket_index(value)] += 1
+        self.count += 1
+        self.total += value
+        if value > self.max:
+            self.max = value
+
+    def percentile(self, fraction: float) -> int:
+        """Upper bound of the bucket holding the given fraction of samples."""
+
+        if not self.count:
+            return 0
+        rank = max(1, int(fraction * self.count + 0.999999))
+        seen = 0
+        for index, count in enumerate(self.counts):
+            seen += count
+            if seen >= rank:
+                return min(bucket_bounds(index)[1] - 1, self.max)
+        return self.max
+
+    def summary(self) -> Dict[str, Any]:
+        return {
+            "count": self.count,
+            "mean": round(self.total / self.count, 1) if self.count else 0.0,
+            "p50": self.percentile(0.50),
+            "p90": self.percentile(0.90),
+            "p99": self.percentile(0.99),
+            "max": self.max,
+            "buckets": [[bucket_bounds(index)[0], count] for index, count in enumerate(self.counts) if count],
+        }
+
+
+class SVCCounter:
+    __slots__ = ("module", "fn", "calls", "errors", "blocked", "wall_ns", "instructions")
+
+    def __init__(self, module: int, fn: int) -> None:
+        self.module = module
+        self.fn = fn
+        self.calls = 0
+        self.errors = 0
+        self.blocked = 0
+        self.wall_ns = Histogram()
+        self.instructions = Histogram()
+
+    @property
+    def name(self) -> str:
+        return f"{MODULE_NAMES.get(self.module, f'mod{self.module:X}')}.{self.fn}"
+
+    def summary(self, *, buckets: bool = True) -> Dict[str, Any]:
+        wall = self.wall_ns.summary()
+        instructions = self.instructions.summary()
+        if not buckets:
+            wall.pop("buckets")
+            instructions.pop("buckets")
+        return {
+            "module": self.module,
+            "fn": self.fn,
+            "name": self.name,
+            "calls": self.calls,
+            "errors": self.errors,
+            "blocked": self.blocked,
+            "wall_ns_total": self.wall_ns.total,
+            "wall_ns": wall,
+            "instructions": instructions,
+        }
+
+
+class SVCStats:
+    """Counters shared by every task of one executive."""
+
+    def __init__(self) -> None:
+        self.counters: Dict[Tuple[int, int], SVCCounter] = {}
+        self.pending: Dict[int, Tuple[SVCCounter, int, int]] = {}  # pid -> blocked call
+        self.instructions = 0  # guest instructions retired, advanced by the controller
+        self.started = time.time()
+
+    def record(self, pid: Optional[int], module: int, fn: int, start_ns: int, end_ns: int, r0: int, blocked: bool) -> None:
+        counter = self.counters.get((module, fn))
+        if counter is None:
+            counter = self.counters[(module, fn)] = SVCCounter(module, fn)
+        counter.calls += 1
+        if blocked and pid is not None:
+            counter.blocked += 1
+            self.pending[pid] = (counter, start_ns, self.instructions)
+            return
+        self._check(counter, r0)
+        counter.wall_ns.record(end_ns - start_ns)
+        counter.instructions.record(1)
+
+    def resume(self, pid: int, r0: int) -> None:
+        """Close a blocked call as its task runs again; ``r0`` is its final result."""
+
+        entry = self.pending.pop(pid, None)
+        if entry is None:
+            return
+        counter, start_ns, start_instructions = entry
+        self._check(counter, r0)
+        counter.wall_ns.record(time.perf_counter_ns() - start_ns)
+        counter.instructions.record(self.instructions - start_instructions)  # includes the SVC
+
+    @staticmethod
+    def _check(counter: SVCCounter, r0: int) -> None:
+        r0 &= 0xFFFFFFFF
+        if r0 & 0x80000000 or (r0 and counter.module in STATUS_MODULES):
+            counter.errors += 1
+
+    def drop(self, pid: int) -> None:
+        self.pending.pop(pid, None)
+
+    def reset(self) -> None:
+        self.counters.clear()
+        self.pending.clear()
+        self.instructions = 0
+        self.started = time.time()
+
+    def snapshot(self, *, top: int = 0, buckets: bool = True) -> Dict[str, Any]:
+        counters = sorted(self.counters.values(), key=lambda item: (-item.calls, item.module, item.fn))
+        if top > 0:
+            counters = counters[:top]
+        return {
+            "since": round(self.started, 3),
+            "elapsed_s": round(time.time() - self.started, 3),
+            "instructions": self.instructions,
+            "calls": sum(item.calls for item in self.counters.values()),
+            "errors": sum(item.errors for item in self.counters.values()),
+            "blocked_now": len(self.pending),
+            "svcs": [item.summary(buckets=buckets) for item in counters],
+        }
+
+    def write_snapshot(self, path: str) -> Dict[str, Any]:
+        """Write the full snapshot as JSON, atomically replacing ``path``."""
+
+        snapshot = self.snapshot()
+        snapshot["written"] = round(time.time(), 3)
+        directory = os.path.dirname(os.path.abspath(path))
+        os.makedirs(directory, exist_ok=True)
+        tmp_path = f"{path}.tmp"
+        with open(tmp_path, "w", encoding="utf-8") as handle:
+            json.dump(snapshot, handle, indent=1, sort_keys=True)
+        os.replace(tmp_path, path)
+        return snapshot
+
+
+class SnapshotWriter:
+    """Writes :meth:`SVCStats.write_snapshot` to a file every ``interval`` seconds."""
+
+    def __init__(self, stats: SVCStats, path: str, interval: float = 10.0) -> None:
+        self.stats = stats
+        self.path = path
+        self.interval = max(float(interval), 0.1)
+        self.next_due = time.monotonic() + self.interval
+        self.written = 0
+
+    def poll(self, now: Optional[float] = None) -> bool:
+        now = time.monotonic() if now is None else now
+        if now < self.next_due:
+            return False
+        self.write()
+        self.next_due = now + self.interval
+        return True
+
+    def write(self) -> None:
+        self.stats.write_snapshot(self.path)
+        self.written += 1
+
+    def info(self) -> Dict[str, Any]:
+        return {"path": self.path, "interval_s": self.interval, "written": self.written}
+
@@ -4,6 +4,7 @@ Pytest configuration and fixtures for HSX tests.
 import subprocess
 import sys
 from pathlib import Path
+from typing import Any, Callable, List
 import pytest
 
 
@@ -36,3 +37,42 @@ def build_demo_files():
                 )
         except (subprocess.TimeoutExpired, FileNotFoundError) as e:
             pytest.fail(f"Failed to build demo files: {e}")
+
+
+@pytest.fixture
+def task_controller() -> Callable[..., Any]:
+    """
+    Factory for a VMController running one hand-built task as pid 1.
+
+    Call it with the task's assembler source, an optional program path and any
+    VMController keyword arguments (HAL services, CAN bus, ...).  The stack is
+    left for the controller to place and the task is activated, as load() does.
+    """
+
+    def make(source: List[str], *, program: str = "/apps/test.hxe", **controller_kwargs: Any):
+        from python import asm as hsx_asm
+        from platforms.python.host_vm import MiniVM, VMController
+
+        code_words, entry, *_rest = hsx_asm.assemble(source)
+        code = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+        controller = VMController(**controller_kwargs)
+        state = MiniVM(code, entry=entry or 0).snapshot_state()
+        ctx = state["context"]
+        ctx["pid"] = 1
+        ctx.pop("sp", None)
+        controller.task_states[1] = state
+        controller.tasks[1] = {
+            "pid": 1,
+            "program": program,
+            "state": "running",
+            "priority": ctx.get("priority", 10),
+            "quantum": ctx.get("time_slice_steps", 1),
+            "pc": ctx.get("pc", entry or 0),
+            "sleep_pending": False,
+            "vm_state": state,
+            "trace": False,
+        }
+        controller._activate_task(1)
+        return controller
+
+    return make
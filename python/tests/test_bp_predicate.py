@@ -0,0 +1,62 @@
+from types import SimpleNamespace
+
+import pytest
+
+from python.bp_predicate import BreakpointSpec, LOG, STOP, compile_breakpoint, compile_condition, evaluate
+
+
+def _vm(regs=None, *, pc=0x100, sp=0x8000, mem=None):
+    return SimpleNamespace(regs=regs or [0] * 16, pc=pc, sp=sp, mem=mem if mem is not None else bytearray(0x10000))
+
+
+def test_condition_precedence_and_registers():
+    vm = _vm([0, 3, 0, 0, 17] + [0] * 11)
+    assert evaluate(compile_condition("R4 == 17"), vm) == 1
+    assert evaluate(compile_condition("R1 + 2 * 3 == 9"), vm) == 1
+    assert evaluate(compile_condition("(R1 + 2) * 3"), vm) == 15
+    assert evaluate(compile_condition("R4 == 17 && !(R1 > 3) || 0"), vm) == 1
+    assert evaluate(compile_condition("R1 - 4 == -1"), vm) == 1
+    assert evaluate(compile_condition("pc == 0x100 && sp >= 0x8000"), vm) == 1
+
+
+def test_condition_memory_loads_are_little_endian():
+    mem = bytearray(0x10000)
+    mem[0x2000:0x2004] = (0x11223344).to_bytes(4, "little")
+    vm = _vm([0, 0x1FFC] + [0] * 14, mem=mem)
+    assert evaluate(compile_condition("[R1+4]"), vm) == 0x11223344
+    assert evaluate(compile_condition("mem16[0x2000]"), vm) == 0x3344
+    assert evaluate(compile_condition("mem8[0x2003] == 0x11"), vm) == 1
+
+
+@pytest.mark.parametrize("text", ["", "R16 == 1", "R1 ==", "foo", "(R1", "R1 $ 2"])
+def test_condition_syntax_errors(text):
+    with pytest.raises(ValueError):
+        compile_condition(text)
+
+
+def test_spec_counts_hits_only_when_condition_holds():
+    spec = compile_breakpoint(condition="R2 & 1", hit_condition=">=2")
+    assert isinstance(spec, BreakpointSpec)
+    vm = _vm()
+    results = []
+    for value in range(6):
+        vm.regs[2] = value
+        results.append(spec.evaluate(vm))
+    assert results == [None, None, None, STOP, None, STOP]
+    assert spec.hits == 3
+    assert spec.describe() == {"hits": 3, "condition": "R2 & 1", "hit_condition": ">=2"}
+
+
+def test_log_message_formats_expressions():
+    spec = compile_breakpoint(log_message="r4={R4:x} [{mem8[0x10]}] #{hits}")
+    vm = _vm([0, 0, 0, 0, 255] + [0] * 11)
+    vm.mem[0x10] = 7
+    assert spec.evaluate(vm) == LOG
+    assert spec.format_log(vm) == "r4=0xff [7] #1"
+
+
+def test_plain_breakpoint_compiles_to_none():
+    assert compile_breakpoint() is None
+    assert compile_breakpoint(condition="  ", hit_condition="") is None
+    with pytest.raises(ValueError):
+        compile_breakpoint(hit_condition="%0")
@@ -0,0 +1,198 @@
+import json
+import socket
+import sys
+import threading
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import can_benchmark
+from python.can_bus import (
+    HSX_CAN_EXT_FRAME,
+    HSX_CAN_RTR_FRAME,
+    HSX_CAN_STATUS_RX_OVERFLOW,
+    HSX_HAL_BUSY,
+    HSX_HAL_INVALID_PARAM,
+    RX_EVENT,
+    CANBus,
+    CANFrame,
+    CANSocketServer,
+    _CANSocketHandler,
+    live_bus,
+)
+from platforms.python.host_vm import MiniVM
+
+
+def test_frame_time_counts_stuff_bits_and_scales_with_bitrate():
+    alternating = CANFrame(0x555, b"\x55" * 8)
+    zeros = CANFrame(0x000, bytes(8))
+    assert alternating.bit_length() == 112  # 111 unstuffed + one stuff bit
+    assert zeros.bit_length() == 127
+    assert CANFrame(0x123, b"ignored", HSX_CAN_RTR_FRAME).bit_length() == 48
+    assert CANFrame(0x1ABCDE, bytes(8), HSX_CAN_EXT_FRAME).bit_length() == 145
+    assert CANBus(500_000).frame_time_ns(alternating) == 112 * 2000
+
+
+def test_lowest_arbitration_field_wins_each_idle_point():
+    bus = CANBus(1_000_000)
+    log = []
+    listener = bus.attach("listener", deliver=lambda batch: log.extend((frame.can_id, ts) for frame, ts in batch))
+    a, b, c = bus.attach("a"), bus.attach("b"), bus.attach("c")
+    assert a.send(CANFrame(0x200, b"\x01")) == 0
+    assert b.send(CANFrame(0x100 << 18, b"\x02", HSX_CAN_EXT_FRAME)) == 0
+    assert c.send(CANFrame(0x100, b"\x03")) == 0
+    c.send(CANFrame(0x100, b"\x04"))  # same id: FIFO within the node
+
+    bus.run_until(1_000_000)
+    order = [can_id for can_id, _ts in log]
+    assert order == [0x100, 0x100, 0x100 << 18, 0x200]
+    assert a.arbitration_lost == 3 and b.arbitration_lost == 2 and c.arbitration_lost == 0
+    # Back-to-back on the wire: each timestamp is the previous one plus the frame time.
+    ends = [ts for _id, ts in log]
+    assert ends[0] == CANFrame(0x100, b"\x03").bit_length()
+    assert ends[1] - ends[0] == CANFrame(0x100, b"\x04").bit_length()
+    assert bus.stats()["frames"] == 4 and listener.rx_batches == 1
+
+
+def test_filter_banks_match_by_mask_and_batches_are_bounded():
+    bus = CANBus(1_000_000)
+    batches = []
+    rx = bus.attach("rx", rx_batch=3, deliver=lambda batch: batches.append([f.can_id for f, _ts in batch]))
+    tx = bus.attach("tx", tx_depth=16)
+    assert rx.set_filter(0, 0x7F0, 0x120) == 0  # 0x120..0x12F
+    assert rx.set_filter(1, 0x7FF, 0x300) == 0
+    assert rx.set_filter(16, 0, 0) == HSX_HAL_INVALID_PARAM
+    for can_id in (0x120, 0x12F, 0x130, 0x300, 0x301, 0x121, 0x300):
+        tx.send(CANFrame(can_id))
+    bus.run_for(10_000_000)
+    # The node's transmit queue is priority ordered, so 0x121 overtakes 0x12F.
+    assert batches == [[0x120, 0x121, 0x12F], [0x300, 0x300]]
+    assert rx.rx_filtered == 2
+
+    rx.filter.clear()  # no banks: accept everything (memo dropped too)
+    tx.send(CANFrame(0x130))
+    bus.run_for(1_000_000)
+    assert batches[-1] == [0x130]
+
+    for _ in range(16):
+        tx.send(CANFrame(0x7FF))
+    assert tx.send(CANFrame(0x7FF)) == HSX_HAL_BUSY
+
+
+def test_fifty_plus_nodes_at_one_megabit():
+    row = can_benchmark.run_scenario(nodes=60, period_us=10_000, duration_ms=100)
+    # 60 frames of ~114 bits every 10 ms on a 1 Mbit/s bus is ~68% load.
+    assert 0.6 < row["load"] < 0.75
+    assert row["frames"] >= row["offered"] - 60 and row["tx_rejected"] == 0
+    assert row["late_nodes"] == 0
+    assert row["max_latency_us_first"] <= row["max_latency_us_last"]
+    assert row["rx_delivered"] >= 2 * (row["frames"] - 2)  # each frame reaches its two neighbours
+
+    overloaded = can_benchmark.run_scenario(nodes=60, period_us=5_000, duration_ms=50)
+    assert overloaded["load"] > 0.99 and overloaded["late_nodes"] > 0
+
+
+PROGRAM = [".text", ".entry start", "start:", "JMP start"]
+
+
+def test_executives_exchange_frames_through_task_svcs_and_mailboxes(task_controller):
+    bus = CANBus(500_000)
+    sender = task_controller(PROGRAM, program="/apps/ecu1.hxe", can_bus=bus, can_node="ecu1")
+    receiver = task_controller(PROGRAM, program="/apps/ecu2.hxe", can_bus=bus, can_node="ecu2")
+    receiver.mailboxes.bind_target(pid=1, target="app:canrx", capacity=128)
+    handle = receiver.mailboxes.open(pid=1, target="app:canrx")
+    rvm = receiver.vm
+    rvm.regs[1] = handle
+    rvm._svc_can(2)
+    assert rvm.regs[0] == 0
+    rvm.regs[1], rvm.regs[2], rvm.regs[3] = 0, 0x7FF, 0x321
+    rvm._svc_can(1)
+
+    svm = sender.vm
+    svm.mem[0x100:0x104] = b"\xde\xad\xbe\xef"
+    for can_id in (0x321, 0x322, 0x321, 0x321):
+        svm.regs[1], svm.regs[2], svm.regs[3], svm.regs[4] = can_id, 0x100, 4, 0
+        svm._svc_can(0)
+        assert svm.regs[0] == 0
+    svm._svc_can(3)
+    assert svm.regs[0] & 0xFF == 4
+
+    bus.run_for(5_000_000)
+    records = []
+    while True:
+        message = receiver.mailboxes.recv(pid=1, handle=handle)
+        if message is None:
+            break
+        records += [CANFrame.unpack_rx_event(message.payload[i : i + RX_EVENT.size]) for i in range(0, message.length, RX_EVENT.size)]
+    assert [(frame.can_id, frame.data) for frame, _ts in records] == [(0x321, b"\xde\xad\xbe\xef")] * 3
+    assert records[0][1] < records[1][1] < records[2][1]
+    info = receiver.handle_command({"cmd": "can"})["can"]
+    assert info["node"] == "ecu2" and info["nodes"]["ecu2"]["rx_filtered"] == 1
+    assert info["subscribers"] == {1: handle}
+
+    # A full mailbox drops the batch and latches the overflow flag.
+    for _ in range(40):
+        sender.can_node.send(CANFrame(0x321, bytes(8)))
+        bus.run_for(200_000)
+    rvm._svc_can(3)
+    assert rvm.regs[0] & HSX_CAN_STATUS_RX_OVERFLOW
+    standalone = MiniVM(b"")
+    standalone._svc_can(1)
+    assert standalone.regs[0] == (-6 & 0xFFFFFFFF)  # no bus attached
+
+
+def test_socket_harness_joins_a_live_bus():
+    bus = live_bus(1_000_000)
+    server = CANSocketServer(bus)
+    server.start()
+    try:
+        host, port = server.server_address[:2]
+        with socket.create_connection((host, port), timeout=5) as rx_sock, socket.create_connection((host, port), timeout=5) as tx_sock:
+            deadline = time.monotonic() + 5
+            while len(bus.nodes) < 2 and time.monotonic() < deadline:
+                time.sleep(0.01)
+            rx_sock.sendall(b'{"filter": [0, 2047, 291]}\n')
+            time.sleep(0.05)
+            tx_sock.sendall(b'{"id": 290, "data": "00"}\n{"id": 291, "data": "0102"}\n{"id": 4096}\n')
+            received = json.loads(rx_sock.makefile("r").readline())
+            assert received["id"] == 291 and received["data"] == "0102" and received["ts_us"] > 0
+            error = json.loads(tx_sock.makefile("r").readline())
+            assert "error" in error
+    finally:
+        server.shutdown()
+        server.server_close()
+
+
+def test_slow_socket_harness_does_not_stall_the_bus(monkeypatch):
+    release = threading.Event()
+    original_write = _CANSocketHandler._write
+
+    def stalled_write(self, message):
+        release.wait(5)
+        original_write(self, message)
+
+    monkeypatch.setattr(_CANSocketHandler, "_write", stalled_write)
+    bus = live_bus(1_000_000)
+    server = CANSocketServer(bus)
+    server.start()
+    try:
+        host, port = server.server_address[:2]
+        with socket.create_connection((host, port), timeout=5) as harness:
+            deadline = time.monotonic() + 5
+            while not bus.nodes and time.monotonic() < deadline:
+                time.sleep(0.01)
+            local = bus.attach("local")
+            started = time.monotonic()
+            for ident in (0x100, 0x101):
+                local.send(CANFrame(ident, b"\x01"))
+                bus.run_until(bus.now_ns + 1_000_000)
+            assert time.monotonic() - started < 1.0
+            assert local.tx_frames == 2
+            release.set()
+            lines = harness.makefile("r")
+            assert [json.loads(lines.readline())["id"] for _ in range(2)] == [0x100, 0x101]
+    finally:
+        release.set()
+        server.shutdown()
+        server.server_close()
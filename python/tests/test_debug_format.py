@@ -0,0 +1,121 @@
+import json
+
+import pytest
+
+from python import debug_format
+
+
+def _payload():
+    return {
+        "version": 1,
+        "hxe_path": "app.hxe",
+        "hxe_crc": 0x1234ABCD,
+        "memory_regions": [{"name": "code", "type": "text", "start": 0, "end": 0x3F}],
+        "symbols": {
+            "functions": [
+                {"name": "main", "linkage_name": "main", "address": 0x00, "size": 0x20, "file": "main.c", "line": 3},
+                {"name": "helper", "linkage_name": None, "address": 0x20, "size": 0x20, "file": "util.c", "line": None},
+            ],
+            "variables": [{"name": "counter", "address": 0x4000, "size": 4, "scope": "global", "type": None}],
+            "locals": [
+                {
+                    "name": "tmp",
+                    "function": "main",
+                    "file": "main.c",
+                    "directory": "/src",
+                    "line": 4,
+                    "scope": None,
+                    "locations": [
+                        {"start": 0x04, "end": 0x10, "location": {"kind": "stack", "offset": -4, "size": 4}},
+                        {"start": 0x10, "end": 0x1C, "location": {"kind": "register", "name": "R3"}},
+                    ],
+                }
+            ],
+            "labels": {"0x00000000": ["main"], "0x00000020": ["helper", "helper_alias"]},
+        },
+        "instructions": [
+            {"pc": 0x00, "word": 0xFFFFFFFF, "mvasm_line": 10, "ordinal": 0, "function": "main", "file": "main.c", "line": 3, "column": 1, "source_kind": "source"},
+            {"pc": 0x04, "word": 0x21000001, "mvasm_line": 11, "ordinal": 1, "function": "main", "file": "main.c", "line": 5, "column": 3, "source_kind": "source"},
+            {"pc": 0x08, "word": 0x10000000, "mvasm_line": 12, "ordinal": 2, "function": "main", "file": "main.c", "line": 4, "source_kind": "compiler"},
+            {"pc": 0x20, "word": 0x00000000, "mvasm_line": None, "ordinal": 8, "function": "helper", "file": "util.c", "directory": "/src", "file_id": 2, "line": 40},
+        ],
+    }
+
+
+def _strip_none(value):
+    if isinstance(value, dict):
+        return {key: _strip_none(item) for key, item in value.items() if item is not None}
+    if isinstance(value, list):
+        return [_strip_none(item) for item in value]
+    return value
+
+
+def test_debug_info_round_trip(tmp_path):
+    path = tmp_path / "app.sym"
+    size = debug_format.write_debug_info(path, _payload())
+    assert size == path.stat().st_size
+    assert size < len(json.dumps(_payload(), indent=2))
+    assert _strip_none(debug_format.load_symbol_payload(path)) == _strip_none(_payload())
+
+
+def test_debug_info_decodes_sections_lazily(tmp_path):
+    path = tmp_path / "app.sym"
+    debug_format.write_debug_info(path, _payload())
+    with debug_format.DebugInfo.open(path) as info:
+        assert info.function_at(0x24)["name"] == "helper"
+        assert info.function_at(0x40) is None
+        assert info.instruction_count() == 4
+        assert "FUNC" not in info._cache and "LINE" not in info._cache
+        rows = info.instructions()
+        assert [row["line"] for row in rows] == [3, 5, 4, 40]
+        assert rows[2].get("column") is None
+        assert info.locals()[0]["locations"][1]["location"] == {"kind": "register", "name": "R3"}
+        assert "FUNC" not in info._cache
+
+
+def test_json_sym_files_still_load(tmp_path):
+    path = tmp_path / "legacy.sym"
+    path.write_text(json.dumps(_payload()))
+    assert not debug_format.is_debug_info(path)
+    assert debug_format.load_symbol_payload(path) == _payload()
+
+
+def test_rejects_bad_magic():
+    with pytest.raises(ValueError):
+        debug_format.DebugInfo(b"NOPE" + bytes(16))
+
+
+def test_cli_exports_json(tmp_path):
+    src = tmp_path / "app.sym"
+    out = tmp_path / "app.json"
+    debug_format.write_debug_info(src, _payload())
+    assert debug_format.main([str(src), "--json", str(out)]) == 0
+    assert _strip_none(json.loads(out.read_text())) == _strip_none(_payload())
+
+
+def test_function_lookup_with_unsorted_symbol_table():
+    payload = _payload()
+    payload["symbols"]["functions"] = [
+        {"name": "late", "address": 0x40, "size": 0x10, "unwind": {"frame_size": 8, "rows": []}},
+        {"name": "early", "address": 0x00, "size": 0x10},
+        {"name": "middle", "address": 0x20, "size": 0x10},
+    ]
+    info = debug_format.DebugInfo(debug_format.encode_debug_info(payload))
+    assert [fn["name"] for fn in info.functions()] == ["early", "middle", "late"]
+    assert info.function_at(0x04)["name"] == "early"
+    assert info.function_at(0x24)["name"] == "middle"
+    late = info.function_at(0x48)
+    assert late["name"] == "late" and late["unwind"]["frame_size"] == 8
+    assert info.function_at(0x14) is None
+
+
+def test_line_program_keeps_negative_scalars():
+    payload = _payload()
+    payload["instructions"] = [
+        {"pc": 0x00, "line": 1, "column": -1, "file_id": -7},
+        {"pc": 0x04, "line": 2, "column": 4, "file_id": -7},
+        {"pc": 0x08, "line": 3, "column": "synthetic"},
+    ]
+    info = debug_format.DebugInfo(debug_format.encode_debug_info(payload))
+    rows = info.instructions()
+    assert [(row.get("column"), row.get("file_id")) for row in rows] == [(-1, -7), (4, -7), ("synthetic", None)]
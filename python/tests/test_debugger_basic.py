@@ -96,3 +96,52 @@ def test_debugger_async_break(tmp_path: Path) -> None:
     assert event and event.get("reason") == "async_break"
     assert controller.debug_sessions[1].last_stop == event
     assert controller.paused is True
+
+
+COUNTER_LOOP = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI R1, 1",
+    "loop:",
+    "ADD R2, R2, R1",
+    "JMP loop",
+]
+
+
+def test_conditional_breakpoint_stops_only_when_predicate_fires() -> None:
+    code, entry, rodata = _assemble(COUNTER_LOOP)
+    controller, _vm = _setup_controller(code, entry, rodata)
+    controller.debug_attach(1)
+    loop_addr = entry + 4
+
+    info = controller.debug_add_breakpoint(1, loop_addr, condition="R2 == 5")
+    assert info["conditions"] == [{"addr": loop_addr, "condition": "R2 == 5", "hits": 0}]
+
+    result = controller.debug_continue(1, max_cycles=200)["result"]
+    debug_event = result.get("debug_event")
+    assert debug_event and debug_event["reason"] == "breakpoint"
+    assert debug_event["conditional"] is True and debug_event["hits"] == 1
+    assert controller.debug_registers(1)["registers"]["regs"][2] == 5
+
+
+def test_hit_condition_and_log_point_run_inside_vm() -> None:
+    code, entry, rodata = _assemble(COUNTER_LOOP)
+    controller, _vm = _setup_controller(code, entry, rodata)
+    controller.debug_attach(1)
+    loop_addr = entry + 4
+    controller.debug_add_breakpoint(1, loop_addr, log_message="R2={R2} hit {hits}", hit_condition="%2")
+
+    result = controller.step(20, pid=1)
+    assert result["debug_event"] is None
+    logs = [event["message"] for event in result["events"] if event.get("type") == "debug_log"]
+    assert logs[:2] == ["R2=1 hit 2", "R2=3 hit 4"]
+
+    controller.debug_add_breakpoint(1, loop_addr, hit_condition=">=3")
+    spec = controller.debug_sessions[1].conditions[loop_addr]
+    result = controller.debug_continue(1, max_cycles=200)["result"]
+    assert result["debug_event"]["reason"] == "breakpoint"
+    assert spec.hits == 3
+
+    controller.debug_remove_breakpoint(1, loop_addr)
+    assert "conditions" not in controller.debug_list_breakpoints(1)
@@ -0,0 +1,134 @@
+import json
+import socket
+import threading
+import time
+
+import pytest
+
+from python.execd import ExecutiveState, SelectorExecutiveServer
+
+
+class DummyVM:
+    def attach(self):
+        return {}
+
+    def detach(self):
+        return {}
+
+    def info(self, pid=None):
+        return {}
+
+    def ps(self):
+        return {"tasks": {"tasks": [], "current_pid": None}}
+
+
+@pytest.fixture
+def server():
+    state = ExecutiveState(DummyVM(), step_batch=1)
+    srv = SelectorExecutiveServer(("127.0.0.1", 0), state, workers=2)
+    thread = threading.Thread(target=srv.serve_forever, kwargs={"poll_interval": 0.05}, daemon=True)
+    thread.start()
+    yield srv
+    srv.shutdown()
+    srv.server_close()
+    thread.join(timeout=2.0)
+
+
+def _connect(srv):
+    sock = socket.create_connection(srv.server_address, timeout=5.0)
+    return sock, sock.makefile("rwb")
+
+
+def _request(stream, payload):
+    stream.write(json.dumps(payload).encode("utf-8") + b"\n")
+    stream.flush()
+    return json.loads(stream.readline())
+
+
+def _wait_for(predicate, timeout=5.0):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        if predicate():
+            return True
+        time.sleep(0.01)
+    return predicate()
+
+
+def test_requests_are_answered_in_order_on_one_connection(server):
+    sock, stream = _connect(server)
+    try:
+        stream.write(b'{"cmd":"session.open","client":"a"}\n{"cmd":"bogus"}\nnot json\n')
+        stream.flush()
+        opened = json.loads(stream.readline())
+        assert opened["status"] == "ok" and opened["session"]["id"]
+        assert json.loads(stream.readline())["status"] == "error"
+        assert json.loads(stream.readline())["error"] == "invalid_json"
+    finally:
+        stream.close()
+        sock.close()
+
+
+def test_many_idle_sessions_share_one_loop_and_streams_are_encoded_once(server):
+    threads_before = threading.active_count()
+    idle = [socket.create_connection(server.server_address, timeout=5.0) for _ in range(200)]
+    try:
+        assert _wait_for(lambda: len(server.connections) >= 200)
+        assert threading.active_count() <= threads_before + 2
+
+        streams = []
+        for index in range(3):
+            sock, stream = _connect(server)
+            session = _request(stream, {"cmd": "session.open", "client": f"s{index}"})["session"]["id"]
+            ack = _request(stream, {"cmd": "events.subscribe", "session": session})
+            assert ack["status"] == "ok" and ack["events"]["token"]
+            streams.append((sock, stream))
+
+        server.state.emit_event("debug_break", pid=1, data={"pc": 0x40})
+        for _sock, stream in streams:
+            event = json.loads(stream.readline())
+            assert event["type"] == "debug_break" and event["data"]["pc"] == 0x40
+        assert server.stats["encode_hits"] >= 2
+        info = server.state.info()
+        assert info["server"]["kind"] == "selector"
+        assert info["server"]["streaming"] == 3
+
+        sock, stream = streams.pop()
+        stream.close()
+        sock.close()
+        assert _wait_for(lambda: len(server.state.event_subscriptions) == 2)
+        for sock, stream in streams:
+            stream.close()
+            sock.close()
+    finally:
+        for sock in idle:
+            sock.close()
+    assert _wait_for(lambda: not server.connections)
+
+
+def test_slow_stream_stalls_at_high_water_without_buffering_everything(server):
+    server.write_high_water = 4096
+    server.write_low_water = 1024
+    sock, stream = _connect(server)
+    session = _request(stream, {"cmd": "session.open", "client": "slow", "capabilities": {"max_events": 2048}})["session"]["id"]
+    _request(stream, {"cmd": "events.subscribe", "session": session})
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+    for conn in tuple(server.connections):
+        conn.sock.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 4096)
+    try:
+        payload = "x" * 512
+        for index in range(300):
+            server.state.emit_event("stdout", pid=1, data={"text": payload, "index": index})
+        assert _wait_for(lambda: server.stats["write_stalls"] > 0)
+        conn = next(conn for conn in tuple(server.connections) if conn.subscription is not None)
+        assert conn.wbytes < server.write_high_water + 1024
+        assert conn.subscription.queue
+
+        received = []
+        while len(received) < 300:
+            event = json.loads(stream.readline())
+            if event.get("type") == "stdout":
+                received.append(event["data"]["index"])
+        assert received == list(range(300))
+    finally:
+        stream.close()
+        sock.close()
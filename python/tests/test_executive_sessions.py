@@ -1,11 +1,13 @@
 import json
+import threading
 import time
 from pathlib import Path
 from typing import Dict, List, Optional
 
 import pytest
 
-from python.execd import ExecutiveState, SessionError
+from python.execd import ExecutiveState, SessionError, SymbolIndex
+from python import debug_format
 from python import trace_format
 from python.valcmd import float_to_f16
 from python import hsx_value_constants as val_const
@@ -490,6 +492,121 @@ def test_events_metrics_track_pending_and_reset_after_ack():
     assert metrics_after["pending"] == 0
 
 
+def test_events_credit_window_holds_events_and_summarises_trace_steps():
+    state = make_state()
+    state.event_backpressure_grace = 0.0
+    session_id = state.session_open(capabilities={"features": ["events"]})["id"]
+    subscription = state.events_subscribe(session_id, credits=2)
+    state.emit_event("debug_break", pid=1, data={"pc": 0x10})
+    second = state.emit_event("debug_break", pid=1, data={"pc": 0x14})
+    state.emit_event("debug_break", pid=1, data={"pc": 0x18})
+    for _ in range(50):
+        assert not state.events_wanted("trace_step", 1)
+    state._emit_trace_snapshot(1, {"pc": 0x20, "opcode": 0, "regs": [0] * 16})
+
+    delivered = []
+    while (evt := state.events_next(subscription, timeout=0.01)) is not None:
+        delivered.append(evt)
+    assert [evt["data"]["pc"] for evt in delivered] == [0x10, 0x14]
+    metrics = state.events_metrics(session_id)
+    assert metrics["inflight"] == 2 and metrics["held"] == 1
+    assert metrics["suppressed"] == {"trace_step": 51}
+    assert subscription.active
+    assert not any(evt["type"] == "trace_step" for evt in state.event_history)
+
+    state.events_ack(session_id, second["seq"])
+    delivered = []
+    while (evt := state.events_next(subscription, timeout=0.01)) is not None:
+        delivered.append(evt)
+    assert delivered[0]["data"]["pc"] == 0x18
+    assert delivered[1]["type"] == "warning"
+    assert delivered[1]["data"]["reason"] == "events_suppressed"
+    assert delivered[1]["data"]["counts"] == {"trace_step": 51}
+    assert state.events_metrics(session_id)["suppressed"] == {}
+
+
+def test_suppression_warning_reaches_a_session_without_credits():
+    state = make_state()
+    session_id = state.session_open(capabilities={"features": ["events"]})["id"]
+    subscription = state.events_subscribe(session_id, credits=1)
+    first = state.emit_event("debug_break", pid=1, data={"pc": 0x10})
+    state.emit_event("debug_break", pid=1, data={"pc": 0x14})
+    assert not state.events_wanted("trace_step", 1)
+    assert state.events_next(subscription, timeout=0.01)["seq"] == first["seq"]
+
+    # The ack releases the held event, which takes the only credit again.
+    state.events_ack(session_id, first["seq"])
+    delivered = []
+    while (evt := state.events_next(subscription, timeout=0.01)) is not None:
+        delivered.append(evt)
+    assert [evt["type"] for evt in delivered] == ["debug_break", "warning"]
+    assert delivered[1]["data"]["reason"] == "events_suppressed"
+    assert state.events_metrics(session_id)["inflight"] == 1
+
+
+def test_events_credit_command_resizes_window_and_legacy_subscribers_still_get_events():
+    from python.execd import ExecutiveServer
+
+    state = make_state()
+    owner = state.session_open(capabilities={"features": ["events"]})["id"]
+    observer = state.session_open(capabilities={"features": ["events"]})["id"]
+    starved = state.events_subscribe(owner, credits=1)
+    legacy = state.events_subscribe(observer)
+    state.emit_event("debug_break", pid=1, data={"pc": 0})
+    assert state.events_wanted("trace_step", 1)
+    state.emit_event("trace_step", pid=1, data={"pc": 4})
+    assert [evt["type"] for evt in list(legacy.queue)] == ["debug_break", "trace_step"]
+    assert [evt["type"] for evt in list(starved.queue)] == ["debug_break"]
+
+    dispatcher = ExecutiveServer.__new__(ExecutiveServer)
+    dispatcher.state = state
+    resp = dispatcher.exec_state_handle({"version": 1, "cmd": "events.credit", "session": owner, "credits": 8})
+    assert resp["status"] == "ok"
+    assert resp["events"]["credits"] == 8
+    assert starved.queue[-1]["data"]["reason"] == "events_suppressed"
+    assert starved.queue[-1]["data"]["counts"] == {"trace_step": 1}
+    bad = dispatcher.exec_state_handle({"version": 1, "cmd": "events.credit", "session": owner, "credits": 0})
+    assert bad["status"] == "error"
+
+
+def test_subscription_filters_are_pushed_to_vm_as_union():
+    class FilterVM(DummyVM):
+        def __init__(self):
+            self.filters = []
+
+        def event_filter(self, spec):
+            self.filters.append(spec)
+            return {}
+
+        def trace(self, pid, enable):
+            return {"pid": pid, "enabled": bool(enable)}
+
+    vm = FilterVM()
+    state = ExecutiveState(vm, step_batch=1)
+    first = state.session_open(capabilities={"features": ["events"]})["id"]
+    second = state.session_open(capabilities={"features": ["events"]})["id"]
+    state.events_subscribe(first, filters={"pid": [1], "categories": ["mailbox_send", "debug_break"]})
+    assert vm.filters[-1] == {"mailbox_send": [1], "debug_break": [1]}
+
+    state.events_subscribe(second, filters={"pid": [3], "categories": ["mailbox_send"]})
+    assert vm.filters[-1]["mailbox_send"] == [1, 3]
+
+    # Only traced tasks keep trace_step unmuted for the trace ring.
+    state.tasks = {2: {"pid": 2, "trace": False}, 4: {"pid": 4, "trace": False}}
+    state.trace_task(4, True)
+    assert vm.filters[-1]["trace_step"] == [4]
+    pushes = len(vm.filters)
+    state.set_trace_buffer_size(128)
+    assert len(vm.filters) == pushes
+
+    state.set_trace_buffer_size(0)
+    assert "trace_step" not in vm.filters[-1]
+    state.events_unsubscribe(session_id=first)
+    assert vm.filters[-1] == {"mailbox_send": [3]}
+    state.events_subscribe(first)
+    assert vm.filters[-1]["*"] is None
+
+
 def test_trace_step_changed_regs_tracks_diffs():
     state = make_state()
     state.event_history.clear()
@@ -697,6 +814,62 @@ def test_trace_import_append_extends_buffer():
     assert appended["records"][-1]["seq"] == 21
 
 
+def test_trace_spill_writes_trace_file(tmp_path):
+    state = make_state()
+    state.set_trace_buffer_size(0)
+    path = tmp_path / "spill.hxt"
+    started = state.trace_spill_start(1, str(path), chunk_records=2)
+    assert started["active"] is True
+    for offset in range(5):
+        state._process_vm_events(
+            [
+                {
+                    "type": "trace_step",
+                    "pid": 1,
+                    "pc": 0x100 + offset * 4,
+                    "regs": [offset] * 16,
+                    "flags": 0,
+                    "opcode": 0x1000 + offset,
+                }
+            ]
+        )
+    assert state.trace_records(1)["count"] == 0
+    stopped = state.trace_spill_stop(1)
+    assert stopped["records"] == 5
+    assert state.trace_spill_status(1)["active"] is False
+    records = trace_format.read_trace_file(path)
+    assert [rec["pc"] for rec in records] == [0x100, 0x104, 0x108, 0x10C, 0x110]
+    assert records[-1]["regs"] == [4] * 16
+
+
+def test_trace_spill_enables_tracing_and_closes_on_shutdown(tmp_path):
+    class TraceVM(DummyVM):
+        def __init__(self):
+            self.trace_calls = []
+
+        def trace(self, pid, enable):
+            self.trace_calls.append((pid, enable))
+            return {"pid": pid, "enabled": bool(enable)}
+
+    vm = TraceVM()
+    state = ExecutiveState(vm, step_batch=1)
+    state.tasks = {1: {"pid": 1, "trace": False}, 2: {"pid": 2, "trace": True}}
+    state.trace_spill_start(1, str(tmp_path / "one.hxt"))
+    state.trace_spill_start(2, str(tmp_path / "two.hxt"))
+    assert vm.trace_calls == [(1, True)]
+    assert state.tasks[1]["trace"] is True
+    state.trace_spill_stop(1)
+    assert vm.trace_calls == [(1, True), (1, False)]
+
+    state.trace_spill_start(1, str(tmp_path / "one.hxt"))
+    for pid in (1, 2):
+        state._process_vm_events([{"type": "trace_step", "pid": pid, "pc": 0x40, "regs": [0] * 16, "flags": 0, "opcode": 0x1000}])
+    state.trace_spill_close_all()
+    assert state.trace_spills == {}
+    for name in ("one.hxt", "two.hxt"):
+        assert [rec["pc"] for rec in trace_format.read_trace_file(tmp_path / name)] == [0x40]
+
+
 def _task_state_events(state: ExecutiveState) -> List[dict]:
     return [evt for evt in state.event_history if evt.get("type") == "task_state"]
 
@@ -857,6 +1030,109 @@ def test_task_state_killed_reason():
     assert data["reason"] == "killed"
     assert data["new_state"] == "terminated"
 
+def _task_delta(seq: int, pid: int, old: str, new: str, **task_fields) -> dict:
+    task = {"pid": pid, "state": new, "program": "app.hxe", "sleep_pending": False}
+    task.update(task_fields)
+    return {"seq": seq, "pid": pid, "old": old, "new": new, "reason": "state", "pc": 0, "task": task}
+
+
+def _count_ps(state: ExecutiveState, vm: TaskStateVM, task_seq: int = 0) -> list[int]:
+    calls: list[int] = []
+    original_ps = vm.ps
+
+    def ps() -> dict:
+        calls.append(1)
+        snapshot = original_ps()
+        snapshot["tasks"]["task_seq"] = task_seq
+        return snapshot
+
+    vm.ps = ps  # type: ignore[assignment]
+    return calls
+
+
+def test_task_deltas_apply_without_ps_refresh():
+    state, vm = make_task_state_env()
+    ps_calls = _count_ps(state, vm)
+    state._refresh_tasks()
+    assert state.task_delta_seq == 0
+    state.event_history.clear()
+
+    state._apply_task_deltas(
+        {
+            "base_seq": 0,
+            "seq": 1,
+            "current_pid": None,
+            "deltas": [_task_delta(1, 1, "running", "paused")],
+            "active": {"pid": 1, "pc": 0x40, "accounted_steps": 9},
+        }
+    )
+    assert len(ps_calls) == 1
+    assert state.task_delta_seq == 1
+    assert state.tasks[1]["state"] == "paused"
+    assert state.tasks[1]["pc"] == 0x40
+    assert state.tasks[1]["accounted_steps"] == 9
+    data = _task_state_events(state)[-1]["data"]
+    assert (data["prev_state"], data["new_state"]) == ("running", "paused")
+
+    state._apply_task_deltas(
+        {"base_seq": 1, "seq": 2, "current_pid": None, "deltas": [{"seq": 2, "pid": 1, "removed": True}]}
+    )
+    assert len(ps_calls) == 1
+    assert 1 not in state.tasks and 1 not in state.task_states
+    assert _task_state_events(state)[-1]["data"]["new_state"] == "terminated"
+    assert state.task_delta_stats["batches"] == 2
+
+
+def test_task_deltas_give_scheduler_events_the_full_previous_table():
+    state, vm = make_task_state_env()
+    _count_ps(state, vm)
+    state._refresh_tasks()
+    state.current_pid = None  # idle before the batch; the switch source comes from the table
+    state.event_history.clear()
+    state._apply_task_deltas(
+        {
+            "base_seq": 0,
+            "seq": 2,
+            "current_pid": 2,
+            "deltas": [_task_delta(1, 1, "running", "ready"), _task_delta(2, 2, None, "running")],
+        }
+    )
+    switches = [evt["data"] for evt in state.event_history if evt.get("type") == "scheduler"]
+    assert switches
+    assert (switches[-1]["prev_pid"], switches[-1]["next_pid"], switches[-1]["prev_state"]) == (1, 2, "running")
+
+
+def test_removed_delta_after_kill_emits_one_termination():
+    state, vm = make_task_state_env()
+    _count_ps(state, vm, task_seq=3)
+    state._refresh_tasks()
+    state.event_history.clear()
+    state.kill_task(1)
+    state._apply_task_deltas(
+        {"base_seq": 3, "seq": 4, "current_pid": None, "deltas": [{"seq": 4, "pid": 1, "removed": True}]}
+    )
+    terminated = [event for event in _task_state_events(state) if event["data"]["new_state"] == "terminated"]
+    assert len(terminated) == 1
+    assert terminated[0]["data"]["reason"] == "killed"
+    assert state.task_delta_seq == 4
+
+
+def test_task_deltas_resync_on_sequence_gap():
+    state, vm = make_task_state_env()
+    ps_calls = _count_ps(state, vm, task_seq=7)
+    state._refresh_tasks()
+    vm.state = "paused"
+
+    state._apply_task_deltas({"base_seq": 3, "seq": 4, "deltas": []})
+    assert len(ps_calls) == 2
+    assert state.task_delta_stats["resyncs"] == 1
+    assert state.tasks[1]["state"] == "paused"
+    assert state.task_delta_seq == 7
+
+    state._apply_task_deltas(None)
+    assert len(ps_calls) == 3
+
+
 class DebugVM:
     def __init__(self) -> None:
         self.breakpoints: set[int] = set()
@@ -993,6 +1269,52 @@ def test_breakpoint_clear_all():
     assert vm.breakpoints == set()
 
 
+def test_conditional_breakpoints_are_left_to_the_vm():
+    state, vm = make_debug_state()
+    state.breakpoint_add(1, 0x200)
+    state._extract_breakpoints(
+        1,
+        {"breakpoints": [0x200, 0x300], "conditions": [{"addr": 0x300, "condition": "R4 == 17", "hits": 0}]},
+    )
+    assert state._unconditional_breakpoints(1) == {0x200}
+    assert state._breakpoint_response(1, [0x200, 0x300])["conditions"][0]["condition"] == "R4 == 17"
+
+    vm.pc = 0x300
+    assert state._check_breakpoint_before_step(1) is None
+    assert state._check_breakpoint_after_step(1, {"events": []}) is None
+
+    stop = {"type": "debug_stop", "reason": "breakpoint", "pc": 0x300, "pid": 1, "conditional": True, "hits": 4}
+    event = state._check_breakpoint_after_step(1, {"events": [stop]})
+    assert event is not None and event["type"] == "debug_break"
+    assert event["data"]["phase"] == "condition"
+
+
+def test_reverse_last_write_pauses_and_emits_debug_break():
+    state, vm = make_debug_state()
+    reverse_calls = []
+
+    def reverse(pid, op, **options):
+        reverse_calls.append((pid, op, options))
+        if op == "stats":
+            return {"enabled": True, "checkpoints": 3}
+        vm.paused = True
+        return {"stop": {"reason": "last_write", "pc": 0x40, "steps": 12, "write_pc": 0x40, "watch_addr": 0x2004}}
+
+    vm.reverse = reverse  # type: ignore[attr-defined]
+    state._refresh_tasks()
+    assert state.reverse(1, "stats")["checkpoints"] == 3
+    assert vm.attach_calls == 0
+
+    state.event_history.clear()
+    info = state.reverse(1, "last_write", addr=0x2004, width=4)
+    assert reverse_calls[-1] == (1, "last_write", {"addr": 0x2004, "width": 4})
+    assert info["stop"]["reason"] == "last_write"
+    assert vm.attach_calls == 1
+    breaks = [evt for evt in state.event_history if evt["type"] == "debug_break"]
+    assert breaks[-1]["data"]["phase"] == "reverse"
+    assert breaks[-1]["data"]["write_pc"] == 0x40
+    assert state.tasks[1]["state"] == "paused"
+
 def test_load_symbols_for_pid(tmp_path):
     state, vm = make_debug_state()
     program_path = tmp_path / "app.hxe"
@@ -1024,6 +1346,88 @@ def test_load_symbols_for_pid(tmp_path):
     assert line and line['line'] == 10
 
 
+def test_symbol_index_compiles_function_intervals():
+    index = SymbolIndex.build(
+        [
+            {"name": "main", "address": 0x100, "size": 0x10, "type": "function"},
+            {"name": "counter", "address": 0x108, "type": "variable"},
+            {"name": "helper", "address": 0x120, "type": "function"},
+            {"name": "tail", "address": 0x140, "type": "function"},
+        ],
+        [{"address": 0x100, "line": 3}, {"address": 0x120, "line": 9}],
+        [{"pc": 0x104, "line": 4}, {"pc": 0x100, "line": 3}],
+    )
+    assert index.function_at(0x10C)["name"] == "main"
+    assert index.function_at(0x112) is None
+    assert index.symbol_at(0x112)["name"] == "counter"
+    assert index.function_at(0x13C)["name"] == "helper"
+    assert index.function_at(0xFFFF)["name"] == "tail"
+    assert index.function_at(0x80) is None
+    assert index.line_at(0x11F)["line"] == 3
+    assert index.instruction_at(0x104)["line"] == 4
+    assert index.instruction_at(0x108) is None
+    with pytest.raises(TypeError):
+        index.instr_by_pc[0x108] = {}  # type: ignore[index]
+
+
+def test_symbol_lookup_uses_compiled_index(tmp_path):
+    state, _vm = make_debug_state()
+    sym_path = tmp_path / "app.sym"
+    sym_path.write_text(
+        json.dumps(
+            {
+                "symbols": [
+                    {"name": "main", "address": 0x100, "size": 8, "type": "function"},
+                    {"name": "buf", "address": 0x104, "type": "variable"},
+                ],
+                "instructions": [{"pc": 0x100, "line": 7, "source_kind": "compiler"}],
+            }
+        ),
+        encoding="utf-8",
+    )
+    assert state.load_symbols_for_pid(1, override=str(sym_path))["loaded"] is True
+    table = state.symbol_tables[1]
+    assert isinstance(table["index"], SymbolIndex)
+    lookup = state.symbol_lookup_addr(1, 0x106)
+    assert lookup["name"] == "main" and lookup["offset"] == 6
+    assert state._is_compiler_instruction(1, 0x100) is True
+    assert state.symbol_lookup_line(1, 0x104)["line"] == 7
+
+
+
+def test_load_symbols_accepts_binary_debug_info(tmp_path):
+    state, _vm = make_debug_state()
+    sym_path = tmp_path / "app.sym"
+    debug_format.write_debug_info(
+        sym_path,
+        {
+            "version": 1,
+            "symbols": {
+                "functions": [{"name": "main", "address": 0x100, "size": 8, "file": "main.c", "line": 2}],
+                "variables": [],
+                "locals": [],
+                "labels": {},
+            },
+            "instructions": [{"pc": 0x100, "word": 0, "line": 2, "file": "main.c", "function": "main"}],
+        },
+    )
+    decoded: list[str] = []
+    original = debug_format.DebugInfo.to_payload
+
+    def to_payload(self):
+        decoded.append("payload")
+        return original(self)
+
+    debug_format.DebugInfo.to_payload = to_payload  # type: ignore[assignment]
+    try:
+        result = state.load_symbols_for_pid(1, override=str(sym_path))
+    finally:
+        debug_format.DebugInfo.to_payload = original  # type: ignore[assignment]
+    assert result["loaded"] is True and decoded == []
+    assert state.symbol_lookup_addr(1, 0x104)["name"] == "main"
+    assert state.symbol_lookup_line(1, 0x100)["line"] == 2
+
+
 def test_step_hits_breakpoint_pre_phase():
     state, vm = make_debug_state()
     vm.pc = 0x200
@@ -1081,6 +1485,7 @@ def _seed_symbol_table(state: ExecutiveState, pid: int, entries: list[tuple[str,
             "address": item["address"],
             "size": item["size"],
             "type": item.get("type", "function"),
+            **({"unwind": item["unwind"]} if "unwind" in item else {}),
         }
         for item in symbols
     ]
@@ -1123,6 +1528,7 @@ def _seed_instruction_table(state: ExecutiveState, pid: int, entries: list[dict]
         instructions.sort(key=lambda item: item["pc"])
         table["instructions"] = instructions
         table["instructions_by_pc"] = lookup
+        table.pop("index", None)
         state.symbol_tables[pid] = table
 
 
@@ -1444,6 +1850,89 @@ def test_stack_info_reports_read_error():
     assert frames[1]["return_pc"] is None
 
 
+def _standard_unwind(start: int, size: int) -> dict:
+    return {
+        "frame_size": 0,
+        "saved_registers": ["R7"],
+        "return_address": "cfa-4",
+        "rows": [
+            {"start": start, "end": start + 4, "cfa_reg": "sp", "cfa_offset": 4, "ra_offset": -4, "saved": {}},
+            {"start": start + 4, "end": start + 8, "cfa_reg": "sp", "cfa_offset": 8, "ra_offset": -4, "saved": {"R7": -8}},
+            {"start": start + 8, "end": start + size - 4, "cfa_reg": "fp", "cfa_offset": 8, "ra_offset": -4, "saved": {"R7": -8}},
+            {"start": start + size - 4, "end": start + size, "cfa_reg": "sp", "cfa_offset": 4, "ra_offset": -4, "saved": {}},
+        ],
+    }
+
+
+def test_stack_info_uses_unwind_tables_with_single_read():
+    state, vm = make_debug_state()
+    _seed_symbol_table(
+        state,
+        1,
+        [
+            {"name": "main", "address": 0x100, "size": 0x40, "unwind": _standard_unwind(0x100, 0x40)},
+            {"name": "fact", "address": 0x200, "size": 0x40, "unwind": _standard_unwind(0x200, 0x40)},
+        ],
+    )
+    # main framed at 0x8FFC with one local, called fact (ra 0x124), which
+    # recursed (ra 0x224) and has only pushed R7 so far: R7 still holds the
+    # caller's frame pointer.
+    _write_word(vm, 0x8FFC, 0)
+    _write_word(vm, 0x8FF4, 0x124)
+    _write_word(vm, 0x8FF0, 0x8FFC)
+    _write_word(vm, 0x8FEC, 0x224)
+    _write_word(vm, 0x8FE8, 0x8FF0)
+    vm.pc = 0x204
+    vm.sp = 0x8FE8
+    vm.fp = 0x8FF0
+    vm.regs_list[7] = vm.fp
+
+    reads: list[tuple[int, int]] = []
+    original_read = vm.read_mem
+
+    def counting_read(addr: int, length: int, pid: int | None = None) -> bytes:
+        reads.append((addr, length))
+        return original_read(addr, length, pid)
+
+    vm.read_mem = counting_read  # type: ignore[assignment]
+
+    stack = state.stack_info(1, max_frames=8)
+    assert stack["method"] == "cfi"
+    assert stack["errors"] == []
+    assert stack["truncated"] is False
+    assert reads == [(0x8FE8, 0x9000 - 0x8FE8)]
+    assert stack["stack_reads"] == 1
+    summary = [(f["func_name"], f["pc"], f["sp"], f["fp"], f["return_pc"]) for f in stack["frames"]]
+    assert summary == [
+        ("fact", 0x204, 0x8FE8, 0x8FF0, 0x224),
+        ("fact", 0x224, 0x8FF0, 0x8FF0, 0x124),
+        ("main", 0x124, 0x8FF8, 0x8FFC, None),
+    ]
+    assert all(frame["unwind"] == "cfi" for frame in stack["frames"])
+    assert "unwind" not in stack["frames"][0]["symbol"]
+
+
+def test_stack_info_reports_missing_unwind_row():
+    state, vm = make_debug_state()
+    _seed_symbol_table(
+        state,
+        1,
+        [{"name": "fact", "address": 0x200, "size": 0x40, "unwind": _standard_unwind(0x200, 0x40)}],
+    )
+    _write_word(vm, 0x8FF4, 0x500)
+    _write_word(vm, 0x8FF0, 0x8FFC)
+    vm.pc = 0x210
+    vm.sp = 0x8FF0
+    vm.fp = 0x8FF0
+    vm.regs_list[7] = vm.fp
+
+    stack = state.stack_info(1, max_frames=4)
+    assert stack["method"] == "cfi"
+    assert stack["truncated"] is True
+    assert stack["errors"] == ["no_unwind:0x00000500"]
+    assert [frame["pc"] for frame in stack["frames"]] == [0x210, 0x500]
+
+
 def test_disasm_read_basic():
     state, vm = make_debug_state()
     base = 0x9000
@@ -1470,3 +1959,104 @@ def test_disasm_read_basic():
     assert cached_first["cached"] is False
     cached_second = state.disasm_read(1, address=base, count=3, mode="cached")
     assert cached_second["cached"] is True
+
+
+def test_disasm_cache_serves_scrolling_and_invalidates_on_code_write():
+    state, vm = make_debug_state()
+    base = 0x9000
+    word_ldi = (0x01 << 24) | (1 << 20) | 0x123
+    word_add = (0x10 << 24) | (2 << 20) | (1 << 16) | (1 << 12)
+    for index in range(6):
+        _write_bytes(vm, base + 4 * index, (word_ldi if index % 2 == 0 else word_add).to_bytes(4, "big"))
+    vm.pc = base
+    _seed_symbol_table(state, 1, [("func_start", base, 24)])
+
+    reads = []
+    original_read = vm.read_mem
+
+    def counting_read(addr: int, length: int, pid: int | None = None) -> bytes:
+        reads.append((addr, length))
+        return original_read(addr, length, pid)
+
+    dirty_reports = []
+
+    def fake_mem_dirty(pid, clear=False):
+        return dirty_reports.pop(0) if dirty_reports else {"granule": 64, "ranges": []}
+
+    vm.read_mem = counting_read  # type: ignore[assignment]
+    vm.mem_dirty = fake_mem_dirty  # type: ignore[attr-defined]
+
+    first = state.disasm_read(1, address=base, count=4)
+    assert first["mode"] == "cached" and first["cached"] is False
+    assert first["instructions"][0]["label"] == "func_start"
+    assert len(reads) == 1
+
+    vm.regs_list[1] = 5
+    scrolled = state.disasm_read(1, address=base + 4, count=3)
+    assert scrolled["cached"] is True
+    assert len(reads) == 1
+    assert "R1=0x00000005" in scrolled["instructions"][0]["operands"]
+    assert [entry["index"] for entry in scrolled["instructions"]] == [0, 1, 2]
+
+    tail = state.disasm_read(1, address=base + 8, count=4)
+    assert tail["decoded"] == 2
+    assert reads[-1] == (base + 16, 16)
+
+    _write_bytes(vm, base + 4, word_ldi.to_bytes(4, "big"))
+    dirty_reports.append({"granule": 64, "ranges": [[base, 64]]})
+    refreshed = state.disasm_read(1, address=base, count=2)
+    assert refreshed["cached"] is False
+    assert [entry["mnemonic"] for entry in refreshed["instructions"]] == ["LDI", "LDI"]
+    assert refreshed["cache"]["invalidated"] == 6
+
+def test_mem_dirty_stamps_allow_independent_sync():
+    state = make_state()
+    state.tasks[1] = {"pid": 1, "state": "running"}
+    reports = [
+        {"granule": 64, "ranges": [[0x100, 128]]},
+        {"granule": 64, "ranges": []},
+        {"granule": 64, "ranges": [[0x140, 64], [0x400, 64]]},
+        {"granule": 64, "ranges": []},
+    ]
+    clears = []
+
+    def fake_mem_dirty(pid, clear=False):
+        clears.append(clear)
+        return reports.pop(0)
+
+    state.vm.mem_dirty = fake_mem_dirty
+
+    first = state.mem_dirty(1)
+    assert first["seq"] == 1
+    assert first["ranges"] == [[0x100, 128]]
+
+    idle = state.mem_dirty(1, since=first["seq"])
+    assert idle["seq"] == 1
+    assert idle["ranges"] == []
+
+    later = state.mem_dirty(1, since=first["seq"])
+    assert later["seq"] == 2
+    assert later["ranges"] == [[0x140, 64], [0x400, 64]]
+    # A session that never synced still sees every written granule.
+    assert state.mem_dirty(1, since=0)["ranges"] == [[0x100, 128], [0x400, 64]]
+    assert all(clears)
+
+
+def test_mem_dirty_drains_and_stamps_under_the_state_lock():
+    state = make_state()
+    state.tasks[1] = {"pid": 1, "state": "running"}
+    drains = []
+
+    def fake_mem_dirty(pid, clear=False):
+        drains.append(state.lock.locked())
+        return {"granule": 64, "ranges": [[0x1000 + 64 * len(drains), 64]]}
+
+    state.vm.mem_dirty = fake_mem_dirty
+    workers = [threading.Thread(target=state.mem_dirty, args=(1,)) for _ in range(8)]
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+    assert drains == [True] * 8
+    assert state.mem_dirty_seq[1] == 8
+    assert sorted(state.mem_dirty_stamps[1].values()) == list(range(1, 9))
@@ -0,0 +1,212 @@
+import pytest
+
+from python import bench_report, fs_benchmark
+from python.flash_fs import (
+    HSX_FS_O_APPEND,
+    HSX_FS_O_CREAT,
+    HSX_FS_O_RDONLY,
+    HSX_FS_O_RDWR,
+    HSX_FS_O_TRUNC,
+    HSX_FS_O_WRONLY,
+    HSX_HAL_BUSY,
+    HSX_HAL_ERROR,
+    HSX_HAL_INVALID_PARAM,
+    FlashDevice,
+    FlashError,
+    FlashFS,
+)
+from platforms.python.host_vm import FSStub, MiniVM, VMController
+
+W = HSX_FS_O_WRONLY | HSX_FS_O_CREAT
+
+
+def _small_fs(**options):
+    return FlashFS(FlashDevice(page_size=256, pages_per_block=8, blocks=8), **options)
+
+
+def _put(fs, path, data, flags=W | HSX_FS_O_TRUNC):
+    fd = fs.open(path, flags)
+    assert fd >= 3
+    assert fs.write(fd, data) == len(data)
+    assert fs.close(fd) == 0
+
+
+def _get(fs, path):
+    fd = fs.open(path, HSX_FS_O_RDONLY)
+    assert fd >= 3
+    data = fs.read(fd, 1 << 20)
+    fs.close(fd)
+    return data
+
+
+def test_open_flags_directories_and_errors_follow_hsx_fs_h():
+    fs = _small_fs()
+    assert fs.open("missing.txt", HSX_FS_O_RDONLY) == HSX_HAL_ERROR
+    assert fs.open("../etc/passwd", W) == fs.err_invalid_path == HSX_HAL_INVALID_PARAM
+    assert fs.open("C:/boot.ini", W) == HSX_HAL_INVALID_PARAM
+    assert fs.open("nodir/a.txt", W) == HSX_HAL_ERROR
+
+    assert fs.mkdir("/logs") == 0 and fs.mkdir("logs") == HSX_HAL_ERROR
+    assert fs.mkdir("logs/old") == 0
+    _put(fs, "/logs/b.txt", b"hello ")
+    _put(fs, "logs/b.txt", b"world", flags=HSX_FS_O_WRONLY | HSX_FS_O_APPEND)
+    _put(fs, "/a.txt", b"x" * 600)
+    assert _get(fs, "logs/b.txt") == b"hello world"
+    assert fs.listdir("/") == b"a.txt\nlogs/"
+    assert fs.listdir("/logs") == b"b.txt\nold/"
+    assert fs.listdir("/a.txt") == HSX_HAL_ERROR
+
+    fd = fs.open("a.txt", HSX_FS_O_RDONLY)
+    assert fs.write(fd, b"nope") == HSX_HAL_ERROR
+    assert fs.delete("a.txt") == HSX_HAL_BUSY
+    fs.close(fd)
+    fd = fs.open("a.txt", HSX_FS_O_RDWR | HSX_FS_O_TRUNC)
+    assert fs.read(fd, 10) == b""
+    fs.close(fd)
+
+    assert fs.delete("logs") == HSX_HAL_ERROR  # not empty
+    assert fs.rename("logs", "logs/old/inner") == HSX_HAL_INVALID_PARAM
+    assert fs.rename("logs/b.txt", "b.txt") == 0
+    assert fs.rename("a.txt", "b.txt") == HSX_HAL_ERROR
+    assert fs.delete("logs/old") == 0 and fs.delete("logs") == 0
+    assert fs.listdir("") == b"a.txt\nb.txt"
+
+
+def test_remount_replays_log_including_truncates_renames_and_deletes():
+    fs = _small_fs()
+    _put(fs, "keep.bin", bytes(range(256)) * 3)
+    _put(fs, "trunc.txt", b"long original contents" * 20)
+    _put(fs, "trunc.txt", b"short")
+    _put(fs, "gone.txt", b"bye")
+    assert fs.delete("gone.txt") == 0
+    fs.mkdir("d")
+    assert fs.rename("keep.bin", "d/keep.bin") == 0
+    fd = fs.open("pending.txt", W)
+    fs.write(fd, b"buffered")  # never closed: lost on power cut
+
+    again = FlashFS(FlashDevice(page_size=256, pages_per_block=8, blocks=8, image=bytes(fs.device.data)))
+    assert again.listdir("/") == b"d/\npending.txt\ntrunc.txt"
+    assert _get(again, "d/keep.bin") == bytes(range(256)) * 3
+    assert _get(again, "trunc.txt") == b"short"
+    assert _get(again, "pending.txt") == b""
+    stats = again.stats()
+    assert stats["pages"]["live"] == fs.stats()["pages"]["live"]
+    assert stats["gc"]["tombstones"] == 1
+
+    with pytest.raises(FlashError):
+        again.device.program_page(0, b"\x00")
+
+
+def test_churn_triggers_gc_and_wear_levelling_without_losing_data():
+    fs = _small_fs()
+    _put(fs, "cold.bin", b"c" * 700)
+    expected = {}
+    for round_no in range(700):
+        name = f"hot{round_no % 3}"
+        data = bytes([round_no & 0xFF]) * (100 + round_no % 400)
+        _put(fs, name, data)
+        expected[name] = data
+    stats = fs.stats()
+    assert stats["gc"]["runs"] > 0 and stats["flash"]["erases"] == stats["gc"]["runs"]
+    assert stats["gc"]["wear_moves"] > 0
+    wear = stats["flash"]["wear"]
+    assert wear["max"] - wear["min"] <= 17
+    assert stats["write_amplification"] > 1.0
+
+    image = bytes(fs.device.data)
+    for candidate in (fs, FlashFS(FlashDevice(page_size=256, pages_per_block=8, blocks=8, image=image))):
+        assert _get(candidate, "cold.bin") == b"c" * 700
+        for name, data in expected.items():
+            assert _get(candidate, name) == data
+
+
+def test_page_cache_and_readahead_serve_sequential_reads():
+    fs = _small_fs(cache_pages=8, readahead=2)
+    _put(fs, "seq.bin", bytes(range(256)) * 4)
+    fd = fs.open("seq.bin", HSX_FS_O_RDONLY)
+    out = b""
+    while True:
+        piece = fs.read(fd, 32)
+        if not piece:
+            break
+        out += piece
+    assert out == bytes(range(256)) * 4
+    cache = fs.stats()["cache"]
+    assert cache["readahead_pages"] >= 2 and cache["readahead_hits"] >= 2
+    assert cache["hit_rate"] > 0.9
+
+
+def test_readinto_and_view_writes_move_data_directly_to_and_from_task_memory():
+    fs = _small_fs()
+    vm = MiniVM(b"")
+    vm.fs = fs
+    blob = bytes(range(256)) * 20  # spans many flash pages
+    vm.mem[0x1000 : 0x1000 + len(blob)] = blob
+    fd = fs.open("blob.bin", W)
+    vm.regs[1], vm.regs[2], vm.regs[3] = fd, 0x1000, len(blob)
+    vm._svc_fs(2)
+    assert vm.regs[0] == len(blob)
+    fs.close(fd)
+
+    fd = fs.open("blob.bin", HSX_FS_O_RDONLY)
+    vm.regs[1], vm.regs[2], vm.regs[3] = fd, 0x4000, 4096
+    vm._svc_fs(1)
+    assert vm.regs[0] == 4096 and bytes(vm.mem[0x4000:0x5000]) == blob[:4096]
+    tail = bytearray(4096)
+    assert fs.readinto(fd, memoryview(tail)[:100]) == 100 and tail[:100] == blob[4096:4196]
+    assert fs.read(fd, 4096) == blob[4196:]
+    assert fs.readinto(fd, tail) == 0
+    assert fs.readinto(99, tail) == HSX_HAL_INVALID_PARAM
+    vm.mem.extend(b"\x00")  # no task-memory view is left exported
+    del vm.mem[-1]
+
+    stub = FSStub()
+    fd = stub.open("hello.txt")
+    stub.write(fd, memoryview(b"abcdef")[1:4])
+    stub.close(fd)
+    fd = stub.open("hello.txt")
+    assert stub.readinto(fd, tail) == 3 and tail[:3] == b"bcd"
+
+
+def test_vm_svcs_and_controller_rpc_use_the_flash_backend(tmp_path):
+    image = tmp_path / "flash.img"
+    controller = VMController()
+    info = controller.handle_command({"cmd": "fs", "op": "mount", "type": "nor", "image": str(image), "blocks": 8})["fs"]
+    assert info["backend"] == "flash" and info["geometry"]["blocks"] == 8
+
+    vm = MiniVM(b"")
+    vm.fs = controller.filesystem
+    vm.mem[0x200:0x20B] = b"/notes.txt\x00"
+    vm.mem[0x300:0x305] = b"hello"
+    vm.regs[1], vm.regs[2] = 0x200, W
+    vm._svc_fs(0)
+    fd = vm.regs[0]
+    vm.regs[1], vm.regs[2], vm.regs[3] = fd, 0x300, 5
+    vm._svc_fs(2)
+    assert vm.regs[0] == 5
+    vm.regs[1] = fd
+    vm._svc_fs(3)
+    vm.mem[0x210:0x216] = b"/nope\x00"
+    vm.regs[1], vm.regs[2], vm.regs[3] = 0x210, 0x400, 64
+    vm._svc_fs(10)
+    assert vm.regs[0] == HSX_HAL_ERROR & 0xFFFFFFFF
+
+    assert controller.fs_control("sync")["files"] == 1
+    remounted = controller.handle_command({"cmd": "fs", "op": "mount", "type": "nor", "image": str(image), "blocks": 8})
+    assert remounted["fs"]["files"] == 1
+    assert _get(controller.filesystem, "notes.txt") == b"hello"
+    assert controller.handle_command({"cmd": "fs", "op": "mount", "backend": "stub"})["fs"]["backend"] == "stub"
+    assert controller.fs_control("stats")["backend"] == "stub"
+    assert isinstance(FSStub().listdir("/"), bytes)
+
+
+def test_benchmark_pattern_reports_gc_and_throughput():
+    row = fs_benchmark.run_pattern("overwrite_hot", kind="nor", size=32 * 1024, blocks=8)
+    assert row["gc_runs"] > 0 and row["write_amp"] >= 1.0 and row["kib_per_s"] > 0
+    row = fs_benchmark.run_pattern("large_block", kind="nand", size=16 * 1024, blocks=8)
+    assert row["user_read"] == 4 * row["user_written"] == 4 * 16 * 1024 and row["cpu_ms"] >= 0
+    header, rule, line = bench_report.format_table([row], fs_benchmark.TABLE_COLUMNS).splitlines()
+    assert header.split() == fs_benchmark.TABLE_COLUMNS and len(rule) == len(header)
+    assert line.split()[:2] == ["large_block", "nand"]
+    assert bench_report.format_table([]) == ""
+    assert bench_report.format_table([], ["pattern", "kind"]).splitlines() == ["pattern  kind", "-------  ----"]
@@ -0,0 +1,101 @@
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python.flash_fs import HSX_FS_O_CREAT, HSX_FS_O_RDWR, FlashDevice, FlashFS
+from python.fs_ioqueue import COMPLETION, HSX_HAL_BUSY, OP_READ, OP_WRITE, FSIOQueue
+
+
+def _flash():
+    return FlashFS(FlashDevice(page_size=256, pages_per_block=8, blocks=8))
+
+
+def test_adjacent_writes_merge_into_one_device_op_with_per_request_completions():
+    fs = _flash()
+    fd = fs.open("log.txt", HSX_FS_O_RDWR | HSX_FS_O_CREAT)
+    other = fs.open("other.txt", HSX_FS_O_RDWR | HSX_FS_O_CREAT)
+    posted = []
+    queue = FSIOQueue(lambda request: posted.append(COMPLETION.unpack(request.record())) or True)
+
+    ids = [queue.submit(pid=1, op=OP_WRITE, fd=fd, length=4, handle=7, tag=n, data=b"ab%02d" % n) for n in range(3)]
+    queue.submit(pid=1, op=OP_WRITE, fd=other, length=1, handle=7, data=b"x")
+    queue.submit(pid=1, op=OP_WRITE, fd=fd, length=2, handle=7, tag=9, data=b"!!")
+    assert queue.stats()["queued_bytes"] == 15
+    assert queue.service(fs) == 5
+
+    stats = queue.stats()
+    assert stats["device_ops"] == 2 and stats["merged"] == 3 and stats["batches"] == 1
+    assert [entry[0] for entry in posted[:3]] == ids
+    assert posted[0] == (ids[0], 0, 4, fd, OP_WRITE, 4)
+    assert posted[3][1:3] == (9, 2)
+    assert posted[4][3] == other and posted[4][5] == 1
+    fs.close(fd)
+    check = fs.open("log.txt", HSX_FS_O_RDWR)
+    assert fs.read(check, 64) == b"ab00ab01ab02!!"
+
+
+def test_batch_limit_keeps_descriptor_order_and_full_mailboxes_retry():
+    fs = _flash()
+    fds = [fs.open(f"f{n}", HSX_FS_O_RDWR | HSX_FS_O_CREAT) for n in range(3)]
+    accept = {"ok": False}
+    posted = []
+
+    def deliver(request):
+        if not accept["ok"]:
+            return False
+        posted.append(request.request_id)
+        return True
+
+    queue = FSIOQueue(deliver, batch=2, depth=5)
+    for fd in fds:
+        queue.submit(pid=1, op=OP_WRITE, fd=fd, length=1, handle=1, data=b"a")
+    read_id = queue.submit(pid=1, op=OP_READ, fd=fds[0], length=8, handle=1)
+    queue.submit(pid=1, op=OP_WRITE, fd=fds[2], length=1, handle=1, data=b"b")
+    assert queue.submit(pid=1, op=OP_WRITE, fd=fds[1], length=1, handle=1, data=b"c") == HSX_HAL_BUSY
+
+    assert queue.service(fs) == 2  # f0 and f1 writes; f2 and the f0 read wait
+    assert len(queue.backlog) == 2 and len(queue) == 3
+    accept["ok"] = True
+    assert queue.service(fs) == 3  # f2's two writes merge, then the read
+    assert posted[-1] == read_id and len(posted) == 5
+    assert queue.stats()["merged"] == 1 and queue.stats()["rejected"] == 1
+
+
+PROGRAM = [".text", ".entry start", "start:", "JMP start"]
+
+
+def test_async_svcs_complete_through_the_task_mailbox(task_controller):
+    controller = task_controller(PROGRAM, program="/apps/logger.hxe")
+    controller.fs_control("mount", type="nor", blocks=8)
+    vm = controller.vm
+    handle = controller.mailboxes.open(pid=1, target="app:fsdone")
+    fd = controller.filesystem.open("log.txt", HSX_FS_O_RDWR | HSX_FS_O_CREAT)
+
+    vm.mem[0x4000:0x4008] = b"line-1\nX"
+    for tag in (1, 2):
+        vm.regs[1], vm.regs[2], vm.regs[3], vm.regs[4], vm.regs[5] = fd, 0x4000, 7, handle, tag
+        vm._svc_fs(5)
+        assert 0 < vm.regs[0] < 0x80000000
+    vm.mem[0x4000:0x4008] = bytes(8)  # buffer reusable once queued
+    assert controller.fs_queue.stats()["pending"] == 2
+    assert controller.filesystem.stats()["user"]["bytes_written"] == 0
+
+    controller.step(0)
+    records = [COMPLETION.unpack(controller.mailboxes.recv(pid=1, handle=handle).payload) for _ in range(2)]
+    assert [(tag, result, merged) for _rid, tag, result, _fd, _op, merged in records] == [(1, 7, 2), (2, 7, 2)]
+
+    reader = controller.filesystem.open("log.txt", HSX_FS_O_RDWR)
+    vm.regs[1], vm.regs[2], vm.regs[3], vm.regs[4], vm.regs[5] = reader, 0x4100, 32, handle, 3
+    vm._svc_fs(4)
+    # A synchronous write on the descriptor first completes its queued read.
+    vm.regs[1], vm.regs[2], vm.regs[3] = reader, 0x4000, 1
+    vm._svc_fs(2)
+    assert bytes(vm.mem[0x4100:0x410E]) == b"line-1\nline-1\n"
+    record = COMPLETION.unpack(controller.mailboxes.recv(pid=1, handle=handle).payload)
+    assert record[1:5] == (3, 14, reader, OP_READ)
+
+    vm.regs[1], vm.regs[4] = reader, 0x7777
+    vm._svc_fs(5)
+    assert vm.regs[0] == (-4 & 0xFFFFFFFF)  # unknown mailbox handle
+    assert controller.fs_control("stats")["io_queue"]["completed"] == 3
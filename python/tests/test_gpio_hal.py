@@ -0,0 +1,160 @@
+from python.gpio_hal import (
+    EDGE_EVENT,
+    HSX_GPIO_EDGE_BOTH,
+    HSX_GPIO_EDGE_FALLING,
+    HSX_GPIO_EDGE_RISING,
+    HSX_GPIO_MODE_OUTPUT,
+    HSX_GPIO_PULL_UP,
+    GPIOBank,
+    bouncy_press,
+    load_waveform,
+    quadrature,
+)
+from platforms.python.host_vm import MiniVM
+
+
+def _collect(bank):
+    events = []
+    bank.deliver = lambda pin, record: events.append(EDGE_EVENT.unpack(record)) or True
+    return events
+
+
+def test_debounce_filters_contact_chatter():
+    bank = GPIOBank(4)
+    events = _collect(bank)
+    bank.set_interrupt(0, HSX_GPIO_EDGE_BOTH)
+    bank.set_debounce(0, 2000)  # 2 ms
+    waveform = []
+    for press in range(10):
+        waveform += bouncy_press(0, press * 50_000, level=1, bounces=20)
+        waveform += bouncy_press(0, press * 50_000 + 20_000, level=0, bounces=20)
+    bank.replay(waveform, start_ns=0)
+    bank.run_until(600_000_000)
+
+    assert bank.edge_count(0) == 20 and len(events) == 20
+    assert [edges for _pin, edges, *_rest in events] == [HSX_GPIO_EDGE_RISING, HSX_GPIO_EDGE_FALLING] * 10
+    stats = bank.pins[0].stats()
+    assert stats["raw_edges"] == len(waveform) and stats["filtered"] > 300
+    # The first press settles on its last bounce; the event is stamped with it.
+    _pin, _edges, value, count, first_us, last_us = events[0]
+    assert value == 1 and count == 1 and first_us == last_us == waveform[40][0] // 1000
+
+    # Without a debounce window every raw edge is an edge.
+    raw = GPIOBank(1)
+    raw.set_interrupt(0, HSX_GPIO_EDGE_BOTH)
+    raw.replay(bouncy_press(0, 0, bounces=5), start_ns=0)
+    raw.run_until(10_000_000)
+    assert raw.edge_count(0) == 11
+
+
+def test_coalescing_bounds_the_event_rate_of_a_fast_encoder():
+    bank = GPIOBank(2)
+    events = _collect(bank)
+    for pin in (0, 1):
+        bank.set_interrupt(pin, HSX_GPIO_EDGE_BOTH)
+        bank.set_debounce(pin, 5, 10_000)  # 5 us debounce, one event per 10 ms
+    steps = 20_000  # one edge every 50 us for one second
+    bank.replay(quadrature(0, 1, steps, step_us=50), start_ns=0)
+    bank.run_until(1_100_000_000)
+
+    assert bank.edge_count(0) + bank.edge_count(1) == steps
+    per_pin = {pin: [event for event in events if event[0] == pin] for pin in (0, 1)}
+    for pin, pin_events in per_pin.items():
+        assert sum(event[3] for event in pin_events) == steps // 2  # no edge lost
+        assert len(pin_events) <= 102  # ~100 events/s instead of 10 000
+        times = [event[4] for event in pin_events]
+        assert all(later - earlier >= 9_900 for earlier, later in zip(times[1:], times[2:]))
+    first = per_pin[0][0]
+    assert first[3] == 1 and first[4] == 0  # a quiet pin reports its first edge at once
+
+
+def test_full_mailbox_keeps_counting_into_the_pending_event():
+    bank = GPIOBank(1)
+    accept = [False]
+    events = []
+
+    def deliver(pin, record):
+        if not accept[0]:
+            return False
+        events.append(EDGE_EVENT.unpack(record))
+        return True
+
+    bank.deliver = deliver
+    bank.set_interrupt(0, HSX_GPIO_EDGE_RISING)
+    for index in range(10):
+        bank.drive(0, 1, at_ns=index * 2000)
+        bank.drive(0, 0, at_ns=index * 2000 + 1000)
+    bank.run_until(100_000)
+    assert bank.pins[0].retries >= 1 and not events
+    accept[0] = True
+    bank.run_for(1000)
+    assert [(event[1], event[3]) for event in events] == [(HSX_GPIO_EDGE_RISING, 10)]
+    assert events[0][4] == 0 and events[0][5] == 18  # first and last rising edge, us
+
+
+def test_waveform_files_csv_and_vcd(tmp_path):
+    csv_path = tmp_path / "button.csv"
+    csv_path.write_text("time_us,pin,value\n# pressed\n0,3,1\n10.5,3,0\n2000,3,1\n", encoding="utf-8")
+    assert load_waveform(csv_path) == [(0, 3, 1), (10_500, 3, 0), (2_000_000, 3, 1)]
+
+    vcd_path = tmp_path / "capture.vcd"
+    vcd_path.write_text(
+        "$timescale 10 us $end\n"
+        "$scope module top $end\n$var wire 1 ! D5 $end\n$var wire 1 \" CLK $end\n$var wire 8 # BUS $end\n$upscope $end\n"
+        "$enddefinitions $end\n#0\n$dumpvars\n0!\n1\"\n$end\n#3\n1!\nb1010 #\n#7\n0!\n",
+        encoding="utf-8",
+    )
+    assert load_waveform(vcd_path) == [(0, 5, 0), (30_000, 5, 1), (70_000, 5, 0)]
+    assert load_waveform(vcd_path, pin_map={"CLK": 1}) == [(0, 1, 1)]
+
+
+PROGRAM = [".text", ".entry start", "start:", "JMP start"]
+
+
+def test_task_svcs_configure_subscribe_and_count(tmp_path, task_controller):
+    bank = GPIOBank(8)
+    controller = task_controller(PROGRAM, program="/apps/encoder.hxe", gpio=bank)
+    vm = controller.vm
+
+    def svc(fn, *args):
+        for index, value in enumerate(args, start=1):
+            vm.regs[index] = value
+        vm._svc_gpio(fn)
+        return vm.regs[0]
+
+    assert svc(0, 2, 0, HSX_GPIO_PULL_UP) == 0 and svc(1, 2) == 1  # pulled-up input idles high
+    assert svc(0, 4, HSX_GPIO_MODE_OUTPUT, 0) == 0
+    assert svc(2, 4, 1) == 0 and svc(3, 4) == 0 and svc(1, 4) == 0
+    assert svc(2, 2, 1) == (-4 & 0xFFFFFFFF)  # inputs cannot be written
+    assert svc(4, 2, HSX_GPIO_EDGE_FALLING, 1) == 0
+    assert svc(6, 2, 1000, 5000) == 0
+
+    controller.mailboxes.bind_target(pid=1, target="app:button", capacity=256)
+    handle = controller.mailboxes.open(pid=1, target="app:button")
+    assert svc(5, 2, handle) == 0
+    assert svc(5, 99, handle) == (-4 & 0xFFFFFFFF)
+
+    path = tmp_path / "presses.csv"
+    rows = [(t_ns // 1000, pin, value) for t_ns, pin, value in bouncy_press(2, 100, level=0, bounces=8)]
+    rows += [(t_ns // 1000, pin, value) for t_ns, pin, value in bouncy_press(2, 3000, level=1, bounces=8)]
+    rows += [(t_ns // 1000, pin, value) for t_ns, pin, value in bouncy_press(2, 6000, level=0, bounces=8)]
+    path.write_text("".join(f"{t},{pin},{value}\n" for t, pin, value in rows), encoding="utf-8")
+    info = controller.gpio_control("replay", path=str(path))
+    assert info["replayed"] == len(rows)
+    bank.run_for(20_000_000)
+
+    first = EDGE_EVENT.unpack(controller.mailboxes.recv(pid=1, handle=handle).payload)
+    second = EDGE_EVENT.unpack(controller.mailboxes.recv(pid=1, handle=handle).payload)
+    assert (first[0], first[1], first[3]) == (2, HSX_GPIO_EDGE_FALLING, 1)
+    assert second[3] == 1 and second[4] - first[4] >= 5000  # second press waited out the window
+    assert controller.mailboxes.recv(pid=1, handle=handle) is None
+    assert svc(7, 2) == 2
+    stats = controller.handle_command({"cmd": "gpio"})["gpio"]
+    assert stats["subscribers"] == {2: {"pid": 1, "handle": handle}}
+    assert next(pin for pin in stats["active"] if pin["pin"] == 2)["events"] == 2
+
+    controller.kill_task(1)
+    assert controller.gpio_subscribers == {}
+    standalone = MiniVM(b"")
+    standalone._svc_gpio(1)
+    assert standalone.regs[0] == (-6 & 0xFFFFFFFF)  # no bank attached
@@ -0,0 +1,102 @@
+import struct
+
+import pytest
+
+from python import asm as hsx_asm
+from python.gpio_hal import HSX_GPIO_MODE_OUTPUT, GPIOBank
+from python.hal_batch import (
+    HSX_HAL_INVALID_PARAM,
+    HSX_HAL_REQ_STOP_ON_ERROR,
+    HSX_HAL_UNSUPPORTED,
+    REQUEST,
+    RING_HEADER,
+    drain,
+)
+from platforms.python.host_vm import MiniVM
+
+RING = 0x4000
+
+
+def _ring(mem, entries, requests, *, head=0):
+    tail = head
+    for module, fn, flags, *args in requests:
+        slot = RING + RING_HEADER.size + (tail & (entries - 1)) * REQUEST.size
+        REQUEST.pack_into(mem, slot, module, fn, flags, *(list(args) + [0] * 4)[:4], 0)
+        tail = (tail + 1) & 0xFFFF
+    RING_HEADER.pack_into(mem, RING, head, tail, entries, 0)
+
+
+def _results(mem, entries, head, count):
+    return [
+        REQUEST.unpack_from(mem, RING + RING_HEADER.size + ((head + index) & (entries - 1)) * REQUEST.size)[-1]
+        for index in range(count)
+    ]
+
+
+def test_drain_wraps_stops_on_error_and_rejects_bad_rings():
+    mem = bytearray(0x10000)
+    calls = []
+
+    def execute(module, fn, args):
+        calls.append((module, fn, args[0]))
+        return -4 & 0xFFFFFFFF if args[0] == 99 else args[0]
+
+    head = 0xFFFE  # indices wrap through zero and around the 4-slot ring
+    _ring(mem, 4, [(0x9, 2, 0, 1), (0x6, 0, 0, 5), (0x9, 2, HSX_HAL_REQ_STOP_ON_ERROR, 99), (0x2, 0, 0, 7)], head=head)
+    assert drain(mem, RING, execute) == (3, 2)
+    assert calls == [(0x9, 2, 1), (0x9, 2, 99)]  # sleep is not batchable and never runs
+    assert _results(mem, 4, head, 3) == [1, HSX_HAL_UNSUPPORTED, -4]
+    assert RING_HEADER.unpack_from(mem, RING)[:2] == (1, 2)  # the CAN request is still queued
+    assert drain(mem, RING, execute, limit=8) == (1, 0) and calls[-1] == (0x2, 0, 7)
+    assert drain(mem, RING, execute) == (0, 0)
+
+    RING_HEADER.pack_into(mem, RING, 0, 0, 6, 0)
+    with pytest.raises(ValueError):
+        drain(mem, RING, execute)
+    RING_HEADER.pack_into(mem, RING, 0, 9, 8, 0)
+    with pytest.raises(ValueError):
+        drain(mem, RING, execute)
+
+
+def _assemble(lines):
+    code_words, entry, *_rest = hsx_asm.assemble([line + "\n" for line in lines])
+    return b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words), entry or 0
+
+
+def test_one_trap_per_cycle_drives_a_bank_of_pins():
+    code, entry = _assemble(
+        [
+            ".text",
+            ".entry start",
+            "start:",
+            f"    LDI32 R1, {RING}",
+            "    LDI R2, 0",
+            "    LDI R7, 1234",
+            "    SVC MOD=0x6 FN=0x1",
+            "    RET",
+        ]
+    )
+    vm = MiniVM(code, entry=entry)
+    bank = GPIOBank(32)
+    vm.gpio = bank
+    requests = [(0x9, 0, 0, pin, HSX_GPIO_MODE_OUTPUT, 0) for pin in range(24)]
+    requests += [(0x9, 2, 0, pin, pin & 1) for pin in range(24)]
+    requests += [(0x9, 1, 0, 5), (0x9, 2, 0, 40, 1), (0x2, 0, 0, 0x123, 0, 0, 0), (0x1, 0, 0, 7)]
+    _ring(vm.mem, 64, requests)
+
+    for _ in range(4):  # up to and including the doorbell
+        vm.step()
+    assert vm.regs[0] == len(requests) and vm.regs[1] == 2
+    assert vm.regs[7] == 1234 and vm.regs[2] == 0  # argument registers are restored
+    assert [bank.read(pin) for pin in range(24)] == [pin & 1 for pin in range(24)]
+    results = _results(vm.mem, 64, 0, len(requests))
+    assert results[:48] == [0] * 48
+    assert results[48:] == [1, -4, 0, HSX_HAL_UNSUPPORTED]  # exit is never batched
+    assert vm.running
+    assert struct.unpack_from("<HH", vm.mem, RING) == (len(requests), len(requests))
+
+    vm.regs[1], vm.regs[2] = RING + 1, 0  # misaligned ring: entries read as garbage
+    struct.pack_into("<HHHH", vm.mem, RING + 1, 0, 1, 3, 0)
+    vm.regs[3] = 0x55  # restored; R1 reports no failed requests
+    vm._svc_exec(1)
+    assert vm.regs[0] == (HSX_HAL_INVALID_PARAM & 0xFFFFFFFF) and vm.regs[1] == 0 and vm.regs[3] == 0x55
@@ -55,3 +55,28 @@ def test_symbol_mapper_handles_windows_paths(tmp_path):
     mapper = SymbolMapper(sym_path)
     assert mapper.lookup(r"C:\projects\hsx\src\main.c", 7) == [4]
     assert mapper.lookup("src/main.c", 7) == [4]
+
+
+def test_symbol_mapper_reads_binary_line_program_only(tmp_path, monkeypatch):
+    from python import debug_format
+
+    sym_path = tmp_path / "bin.sym"
+    debug_format.write_debug_info(
+        sym_path,
+        {
+            "symbols": {"functions": [], "variables": [], "locals": [], "labels": {}},
+            "instructions": [
+                {"pc": 8, "word": 0, "file": "src/foo.c", "directory": "/work/tree", "line": 12},
+                {"pc": 12, "word": 0, "file": "src/foo.c", "directory": "/work/tree", "line": 12},
+            ],
+        },
+    )
+
+    def fail(self):
+        raise AssertionError("full decode on the line-map path")
+
+    monkeypatch.setattr(debug_format.DebugInfo, "instructions", fail)
+    monkeypatch.setattr(debug_format.DebugInfo, "to_payload", fail)
+    mapper = SymbolMapper(sym_path)
+    assert mapper.lookup("/work/tree/src/foo.c", 12) == [8, 12]
+    assert mapper.lookup("foo.c", 12) == [8, 12]
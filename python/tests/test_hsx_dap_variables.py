@@ -0,0 +1,83 @@
+import io
+
+from python.hsx_dap import DAPProtocol, HSXDebugAdapter, _FrameRecord
+from python.hsxdbg.cache import RuntimeCache, WatchValue
+from python.hsxdbg.events import DebugBreakEvent
+
+
+class FakeClient:
+    def __init__(self):
+        self.memory = bytes(range(256)) * 4
+        self.calls = {"regions": 0, "watches": 0, "reads": 0, "sync": 0}
+
+    def memory_regions(self, pid):
+        self.calls["regions"] += 1
+        return [{"name": "data", "type": "data", "start": 0x100, "end": 0x300, "length": 0x200}]
+
+    def list_watches(self, pid, refresh=False):
+        self.calls["watches"] += 1
+        return [WatchValue(watch_id=1, expr="buf", length=16, value="00 01", address=0x120)]
+
+    def sync_memory(self, pid):
+        self.calls["sync"] += 1
+        return 0
+
+    def read_memory(self, addr, length, *, pid=None, refresh=False):
+        self.calls["reads"] += 1
+        return self.memory[addr : addr + length]
+
+
+def _adapter():
+    adapter = HSXDebugAdapter(DAPProtocol(io.BytesIO(), io.BytesIO()))
+    adapter.client = FakeClient()
+    adapter.runtime_cache = RuntimeCache()
+    adapter.current_pid = 1
+    adapter._frames[1] = _FrameRecord(pid=1, name="main", line=1, column=1, file=None, pc=0)
+    adapter._handle_exec_event(DebugBreakEvent(seq=10, ts=0.0, type="debug_break", pid=1, pc=0))
+    return adapter
+
+
+def _scopes(adapter):
+    return {scope["name"]: scope for scope in adapter._handle_scopes({"frameId": 1})["scopes"]}
+
+
+def test_memory_scope_pages_lazily_and_reuses_cache_within_a_stop():
+    adapter = _adapter()
+    scopes = _scopes(adapter)
+    assert scopes["Memory"]["expensive"] is True
+    assert adapter.client.calls == {"regions": 0, "watches": 0, "reads": 0, "sync": 0}
+
+    regions = adapter._handle_variables({"variablesReference": scopes["Memory"]["variablesReference"]})["variables"]
+    assert regions[0]["name"] == "data" and regions[0]["indexedVariables"] == 0x80
+    page = adapter._handle_variables({"variablesReference": regions[0]["variablesReference"], "start": 4, "count": 2})["variables"]
+    assert [item["name"] for item in page] == ["[4]", "[5]"]
+    assert page[0]["value"] == "0x13121110"
+    assert page[1]["memoryReference"] == "0x00000114"
+
+    again = _scopes(adapter)
+    assert again["Memory"]["variablesReference"] == scopes["Memory"]["variablesReference"]
+    adapter._handle_variables({"variablesReference": again["Memory"]["variablesReference"]})
+    assert adapter.client.calls["regions"] == 1
+    assert adapter.client.calls["sync"] == 1
+
+
+def test_watch_children_page_and_new_stop_invalidates_cache():
+    adapter = _adapter()
+    watches_ref = _scopes(adapter)["Watches"]["variablesReference"]
+    watches = adapter._handle_variables({"variablesReference": watches_ref})["variables"]
+    assert watches[0]["indexedVariables"] == 4
+    children = adapter._handle_variables({"variablesReference": watches[0]["variablesReference"]})["variables"]
+    assert [item["value"] for item in children][:1] == ["0x23222120"]
+    adapter._handle_variables({"variablesReference": watches_ref})
+    assert adapter.client.calls["watches"] == 1
+
+    # A replayed event with the same sequence number is the same stop.
+    adapter._handle_exec_event(DebugBreakEvent(seq=10, ts=0.0, type="debug_break", pid=1, pc=0))
+    adapter._handle_variables({"variablesReference": watches_ref})
+    assert adapter.client.calls["watches"] == 1
+
+    adapter._handle_exec_event(DebugBreakEvent(seq=11, ts=0.0, type="debug_break", pid=1, pc=4))
+    assert adapter._handle_variables({"variablesReference": watches_ref})["variables"] == []
+    watches_ref = _scopes(adapter)["Watches"]["variablesReference"]
+    adapter._handle_variables({"variablesReference": watches_ref})
+    assert adapter.client.calls["watches"] == 2
@@ -186,3 +186,40 @@ def test_cache_controller_receives_events_from_bus():
     state = cache.get_registers(4)
     assert state is not None
     assert state.pc == 0x10
+
+
+def test_apply_memory_dirty_refetches_only_cached_overlap():
+    cache = RuntimeCache()
+    cache.cache_memory(1, base=0x100, data=bytes(range(16)))
+    fetches = []
+
+    def fetch(addr, length):
+        fetches.append((addr, length))
+        return b"\xEE" * length
+
+    refreshed = cache.apply_memory_dirty(1, {"seq": 4, "ranges": [[0xC0, 0x48], [0x400, 64]]}, fetch)
+    assert fetches == [(0x100, 8)]
+    assert refreshed == 8
+    assert cache.read_memory(1, 0x100, 16) == b"\xEE" * 8 + bytes(range(8, 16))
+    assert cache.memory_sync[1] == 4
+
+    cache.apply_memory_dirty(1, {"seq": 5, "ranges": [[0x100, 64]]}, lambda a, l: None)
+    assert cache.read_memory(1, 0x100, 4) is None
+
+
+def test_query_variables_caches_falsy_values_for_the_stop():
+    cache = RuntimeCache()
+    calls = []
+
+    def fallback():
+        calls.append(1)
+        return 0
+
+    assert cache.query_variables(1, "memory_sync", fallback=fallback) == 0
+    assert cache.query_variables(1, "memory_sync", fallback=fallback) == 0
+    assert cache.query_variables(1, "none", fallback=lambda: None) is None
+    assert cache.query_variables(1, "none", fallback=lambda: calls.append(2)) is None
+    assert calls == [1]
+    cache.begin_stop(1)
+    assert cache.query_variables(1, "memory_sync", fallback=fallback) == 0
+    assert calls == [1, 1]
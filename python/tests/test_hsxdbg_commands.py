@@ -91,3 +91,27 @@ def test_list_watches_uses_cache_when_not_refreshing():
     client._request = second_request  # type: ignore[attr-defined]
     watches_cached = client.list_watches()
     assert watches_cached[0].watch_id == 3
+
+
+def test_step_syncs_dirty_memory_granules():
+    session = DummySession()
+    client = CommandClient(session=session)
+    session.runtime_cache.cache_memory(1, 0x200, b"\x00" * 8)
+    session.runtime_cache.memory_sync[1] = 3
+    calls = []
+
+    def fake_request(payload):
+        calls.append(payload)
+        if payload["cmd"] == "mem_dirty":
+            return {"status": "ok", "dirty": {"seq": 4, "granule": 64, "ranges": [[0x200, 64]]}}
+        if payload["cmd"] == "peek":
+            return {"status": "ok", "data": "11" * payload["length"]}
+        return {"status": "ok"}
+
+    client._request = fake_request  # type: ignore[attr-defined]
+    client.step()
+    assert [c["cmd"] for c in calls] == ["step", "mem_dirty", "peek"]
+    assert calls[1]["since"] == 3
+    assert calls[2]["addr"] == 0x200 and calls[2]["length"] == 8
+    assert client.read_memory(0x200, 8) == b"\x11" * 8
+    assert session.runtime_cache.memory_sync[1] == 4
@@ -0,0 +1,127 @@
+import struct
+from pathlib import Path
+
+from python import asm as hsx_asm
+from python import hld as hsx_linker
+from python import isotp, isotp_benchmark
+from python.can_bus import CANBus
+from python.isotp import BufferPool, ISOTPEndpoint, decode_st_min, encode_st_min
+from platforms.python.host_vm import VMController
+
+
+def _pair(bus, *, block_size=8, st_min_us=0, pool=None):
+    got = []
+    tester = ISOTPEndpoint(bus, "tester", tx_id=0x7E0, rx_id=0x7E8)
+    device = ISOTPEndpoint(
+        bus, "device", tx_id=0x7E8, rx_id=0x7E0, block_size=block_size, st_min_us=st_min_us, pool=pool, on_message=got.append
+    )
+    return tester, device, got
+
+
+def test_st_min_encoding_follows_iso_15765_2():
+    assert [encode_st_min(us) for us in (0, 100, 900, 1000, 1500, 200_000)] == [0x00, 0xF1, 0xF9, 0x01, 0x02, 0x7F]
+    assert [decode_st_min(value) for value in (0x00, 0x05, 0xF3, 0x80, 0xFA)] == [0, 5000, 300, 127_000, 127_000]
+
+
+def test_single_multi_frame_and_escaped_lengths_reassemble():
+    bus = CANBus(500_000)
+    tester, device, got = _pair(bus, block_size=4, pool=BufferPool(buffers=2, size=6000))
+    messages = [b"ping", bytes(range(256)) * 3, bytes(5000)]
+    for message in messages:
+        assert tester.send(message) == 0
+    bus.run_for(1_000_000_000)
+    assert got == messages
+
+    stats = device.stats()
+    # 768 bytes: FF + 109 CFs, 5000 bytes (escaped FF): FF + 714 CFs, one FC per FF and per 4 CFs.
+    assert stats["fc_sent"] == (1 + 109 // 4) + (1 + 714 // 4)
+    assert tester.stats()["tx_messages"] == 3 and not tester.busy
+    assert stats["pool"]["in_use"] == 0 and stats["pool"]["high_water"] == 1
+
+
+def test_separation_time_spaces_consecutive_frames():
+    fast, slow = CANBus(500_000), CANBus(500_000)
+    for bus, st_min in ((fast, 0), (slow, 2000)):
+        tester, device, got = _pair(bus, block_size=0, st_min_us=st_min)
+        tester.send(bytes(700))  # FF + 100 CFs
+        bus.run_for(2_000_000_000)
+        assert got == [bytes(700)]
+    fast_ns, slow_ns = fast.idle_ns, slow.idle_ns
+    # Each CF after the first waits 2 ms after the previous one ends (the
+    # flow-control frames differ by a couple of stuff bits).
+    assert abs((slow_ns - fast_ns) - 99 * 2_000_000) <= 10 * 2000
+
+
+def test_pool_exhaustion_answers_overflow_and_sender_moves_on():
+    bus = CANBus(500_000)
+    tester, device, got = _pair(bus, pool=BufferPool(buffers=1, size=64))
+    tester.send(bytes(100))  # longer than any buffer
+    tester.send(b"x" * 20)
+    bus.run_for(100_000_000)
+    assert got == [b"x" * 20]
+    assert tester.stats()["tx_aborted"] == 1 and device.stats()["overflows"] == 1
+    assert device.pool.stats()["exhausted"] == 1
+
+
+def _image(tmp_path: Path) -> bytes:
+    lines = [".text", ".entry"] + ["BRK"] * 1500
+    code, entry, externs, imports_decl, rodata, relocs, exports, entry_symbol, local_symbols = hsx_asm.assemble(lines, for_object=True)
+    hxo_path = tmp_path / "big.hxo"
+    hsx_asm.write_hxo_object(
+        hxo_path,
+        code_words=code,
+        rodata=rodata,
+        entry=entry or 0,
+        entry_symbol=entry_symbol,
+        externs=externs,
+        imports_decl=imports_decl,
+        relocs=relocs,
+        exports=exports,
+        local_symbols=local_symbols,
+        metadata=hsx_asm.LAST_METADATA,
+    )
+    hxe_path = tmp_path / "big.hxe"
+    hsx_linker.link_objects([hxo_path], hxe_path)
+    return hxe_path.read_bytes()
+
+
+def test_loader_bridge_streams_an_image_into_the_controller(tmp_path):
+    image = _image(tmp_path)
+    assert len(image) > isotp.LOADER_CHUNK  # several DATA messages
+    bus = CANBus(500_000)
+    controller = VMController(can_bus=bus, can_node="ecu")
+    info = controller.can_control("loader", rx_id=0x7E0, tx_id=0x7E8, block_size=16)
+    assert info["loader"]["rx_id"] == 0x7E0
+
+    replies = []
+    tester = ISOTPEndpoint(bus, "tester", tx_id=0x7E0, rx_id=0x7E8, on_message=replies.append)
+    for message in isotp.image_messages(image, label="can-app"):
+        tester.send(message)
+    bus.run_for(5_000_000_000)
+
+    assert len(replies) == 1
+    opcode, status, pid = struct.unpack("<BBI", replies[0])
+    assert opcode == isotp.LOADER_REPLY | isotp.LOADER_END and status == 0
+    assert controller.tasks[pid]["program"] == "can-app"
+    loader = controller.handle_command({"cmd": "can"})["can"]["loader"]
+    assert loader["bytes"] == len(image) and loader["pid"] is None
+
+
+def test_mailbox_sink_posts_reassembled_messages():
+    bus = CANBus(500_000)
+    controller = VMController(can_bus=bus)
+    controller.mailboxes.bind_target(pid=1, target="app:diag", capacity=512)
+    handle = controller.mailboxes.open(pid=1, target="app:diag")
+    tester = ISOTPEndpoint(bus, "tester", tx_id=0x600, rx_id=0x601)
+    ISOTPEndpoint(bus, "diag", tx_id=0x601, rx_id=0x600, on_message=isotp.mailbox_sink(controller, 1, handle))
+    tester.send(bytes(range(200)))
+    bus.run_for(100_000_000)
+    assert controller.mailboxes.recv(pid=1, handle=handle).payload == bytes(range(200))
+
+
+def test_benchmark_full_window_beats_stop_and_wait():
+    stop_and_wait = isotp_benchmark.run_download(size=4096, block_size=1)
+    windowed = isotp_benchmark.run_download(size=4096, block_size=0)
+    assert stop_and_wait["ok"] and windowed["ok"]
+    assert windowed["seconds"] < stop_and_wait["seconds"] * 0.6
+    assert 0.4 < windowed["bus_efficiency"] < 0.6
@@ -4,6 +4,7 @@ from pathlib import Path
 
 from python import asm as hsx_asm
 from python import hld as hsx_linker
+from python import debug_format
 from platforms.python.host_vm import MiniVM, load_hxe
 
 
@@ -83,8 +84,7 @@ def test_link_two_objects(tmp_path):
     assert vm.regs[0] == 7
 
 
-def test_emit_sym_generates_symbol_file(tmp_path):
-    ir = """
+DEBUG_IR = """
     declare void @llvm.dbg.declare(metadata, metadata, metadata)
     declare void @llvm.dbg.value(metadata, metadata, metadata)
 
@@ -109,6 +109,17 @@ def test_emit_sym_generates_symbol_file(tmp_path):
     !17 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
     """.strip()
 
+
+def _strip_none(value):
+    if isinstance(value, dict):
+        return {key: _strip_none(item) for key, item in value.items() if item is not None}
+    if isinstance(value, list):
+        return [_strip_none(item) for item in value]
+    return value
+
+
+def test_emit_sym_generates_symbol_file(tmp_path):
+    ir = DEBUG_IR
     hxo_path, dbg_path = compile_to_hxo_with_debug(ir, "dbg", tmp_path)
     hxe_path = tmp_path / "app.hxe"
     sym_path = tmp_path / "app.sym"
@@ -131,6 +142,13 @@ def test_emit_sym_generates_symbol_file(tmp_path):
     assert fn_entry["name"] == "main"
     assert fn_entry["file"] == "test.c"
     assert "address" in fn_entry and "size" in fn_entry
+    unwind = fn_entry["unwind"]
+    assert unwind["saved_registers"] == ["R7"]
+    rows = unwind["rows"]
+    assert rows[0]["start"] == fn_entry["address"]
+    assert rows[-1]["end"] == fn_entry["address"] + fn_entry["size"]
+    assert all(prev["end"] == row["start"] for prev, row in zip(rows, rows[1:]))
+    assert any(row["cfa_reg"] == "fp" and row["saved"] == {"R7": -8} for row in rows)
     instructions = sym_data.get("instructions", [])
     assert any(inst.get("line") == 5 and inst.get("ordinal") is not None for inst in instructions)
     assert any(inst.get("source_kind") == "source" for inst in instructions)
@@ -142,3 +160,23 @@ def test_emit_sym_generates_symbol_file(tmp_path):
     assert local_entry.get("name") == "tmp"
     assert local_entry.get("locations"), "expected local variable ranges"
     assert sym_data["memory_regions"], "expected memory region metadata"
+
+
+def test_emit_sym_binary_matches_json_export(tmp_path):
+    hxo_path, dbg_path = compile_to_hxo_with_debug(DEBUG_IR, "dbg", tmp_path)
+    json_sym = tmp_path / "app.sym"
+    bin_sym = tmp_path / "app_bin.sym"
+    hsx_linker.link_objects([hxo_path], tmp_path / "app.hxe", debug_infos=[dbg_path], emit_sym=json_sym)
+    hsx_linker.link_objects(
+        [hxo_path],
+        tmp_path / "app.hxe",
+        debug_infos=[dbg_path],
+        emit_sym=bin_sym,
+        sym_format="binary",
+    )
+
+    assert debug_format.is_debug_info(bin_sym)
+    assert bin_sym.stat().st_size < json_sym.stat().st_size
+    expected = json.loads(json_sym.read_text())
+    decoded = debug_format.load_symbol_payload(bin_sym)
+    assert _strip_none(decoded) == _strip_none(expected)
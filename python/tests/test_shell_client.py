@@ -162,6 +162,17 @@ def test_trace_config_buffer_payload(tmp_path: Path) -> None:
     assert payload["buffer_size"] == 256
 
 
+def test_trace_spill_payload_resolves_path(tmp_path: Path) -> None:
+    payload = shell_client._build_payload("trace", ["7", "spill", "soak.hxt", "--chunk", "1024", "--raw"], tmp_path)
+    assert payload["op"] == "spill"
+    assert payload["action"] == "start"
+    assert payload["path"] == str((tmp_path / "soak.hxt").resolve())
+    assert payload["chunk"] == 1024
+    assert payload["compress"] is False
+    stop = shell_client._build_payload("trace", ["7", "spill", "off"], tmp_path)
+    assert stop["action"] == "stop"
+
+
 def test_val_get_payload_resolves_identifier(monkeypatch: pytest.MonkeyPatch, tmp_path: Path) -> None:
     entry = {"oid": 0x205, "name": "speed", "group_name": "telemetry"}
 
@@ -442,3 +453,100 @@ def test_pretty_trace_records_with_format(capsys: pytest.CaptureFixture[str]) ->
     assert "seq=1" in output and "pc=0x1020" in output
     assert "changed=R0,R2" in output
     assert "seq=2" in output
+
+
+def test_can_payloads() -> None:
+    assert shell_client._build_payload("can", ["attach", "bitrate", "500000", "port", "7400"], None) == {
+        "cmd": "can",
+        "op": "attach",
+        "bitrate": 500000,
+        "port": 7400,
+    }
+    assert shell_client._build_payload("can", ["send", "0x123", "0102", "ext"], None) == {
+        "cmd": "can",
+        "op": "send",
+        "id": 0x123,
+        "data": "0102",
+        "flags": 0x01,
+    }
+    with pytest.raises(ValueError):
+        shell_client._build_payload("can", ["send", "0x123", "zz"], None)
+    assert shell_client._build_payload("can", ["loader", "rx", "0x7E0", "bs", "0"], None) == {
+        "cmd": "can",
+        "op": "loader",
+        "rx_id": 0x7E0,
+        "block_size": 0,
+    }
+
+
+def test_uart_payloads() -> None:
+    assert shell_client._build_payload("uart", ["attach", "0", "pty", "baud", "1000000"], None) == {
+        "cmd": "uart",
+        "op": "attach",
+        "port": 0,
+        "backend": "pty",
+        "baud": 1000000,
+    }
+    assert shell_client._build_payload("uart", ["config", "1", "9600", "even", "2"], None) == {
+        "cmd": "uart",
+        "op": "config",
+        "port": 1,
+        "baud": 9600,
+        "parity": 1,
+        "stop_bits": 2,
+    }
+    assert shell_client._build_payload("uart", ["feed", "2", "68690d"], None)["data"] == "68690d"
+    with pytest.raises(ValueError):
+        shell_client._build_payload("uart", ["send", "0", "zz"], None)
+    with pytest.raises(ValueError):
+        shell_client._build_payload("uart", ["attach"], None)
+
+
+def test_gpio_payloads(tmp_path: Path) -> None:
+    assert shell_client._build_payload("gpio", ["debounce", "3", "1000", "coalesce", "10000", "edge", "both"], None) == {
+        "cmd": "gpio",
+        "op": "debounce",
+        "pin": 3,
+        "debounce_us": 1000,
+        "coalesce_us": 10000,
+        "edge": 3,
+    }
+    assert shell_client._build_payload("gpio", ["drive", "2", "1"], None) == {"cmd": "gpio", "op": "drive", "pin": 2, "value": 1}
+    payload = shell_client._build_payload("gpio", ["replay", "enc.vcd"], tmp_path)
+    assert payload["path"] == str((tmp_path / "enc.vcd").resolve())
+    with pytest.raises(ValueError):
+        shell_client._build_payload("gpio", ["drive", "2", "high"], None)
+
+
+def test_timer_payloads() -> None:
+    assert shell_client._build_payload("timer", [], None) == {"cmd": "timer", "op": "stats"}
+    assert shell_client._build_payload("timer", ["stats", "limit", "8"], None) == {"cmd": "timer", "op": "stats", "limit": 8}
+    assert shell_client._build_payload("timer", ["cancel", "0x10"], None) == {"cmd": "timer", "op": "cancel", "timer": 16}
+    assert shell_client._build_payload("timer", ["advance", "5000"], None) == {"cmd": "timer", "op": "advance", "us": 5000}
+    with pytest.raises(ValueError):
+        shell_client._build_payload("timer", ["cancel"], None)
+
+
+def test_stats_payloads(tmp_path: Path) -> None:
+    assert shell_client._build_payload("stats", [], None) == {"cmd": "stats", "op": "show", "buckets": False}
+    assert shell_client._build_payload("stats", ["top", "5"], None) == {"cmd": "stats", "op": "show", "top": 5, "buckets": False}
+    assert shell_client._build_payload("stats", ["reset"], None) == {"cmd": "stats", "op": "reset"}
+    payload = shell_client._build_payload("stats", ["snapshot", "svc.json"], tmp_path)
+    assert payload == {"cmd": "stats", "op": "snapshot", "path": str((tmp_path / "svc.json").resolve())}
+    with pytest.raises(ValueError):
+        shell_client._build_payload("stats", ["top", "many"], None)
+
+
+def test_fs_mount_payload_resolves_image_path(tmp_path: Path) -> None:
+    payload = shell_client._build_payload("fs", ["mount", "nand", "image", "flash.img", "blocks", "16"], tmp_path)
+    assert payload == {
+        "cmd": "fs",
+        "op": "mount",
+        "backend": "flash",
+        "type": "nand",
+        "image": str((tmp_path / "flash.img").resolve()),
+        "blocks": 16,
+    }
+    assert shell_client._build_payload("fs", [], tmp_path) == {"cmd": "fs", "op": "stats"}
+    with pytest.raises(ValueError):
+        shell_client._build_payload("fs", ["mount", "eeprom"], tmp_path)
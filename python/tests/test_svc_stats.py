@@ -0,0 +1,114 @@
+import json
+import time
+
+from python import asm as hsx_asm
+from python.svc_stats import BUCKETS, Histogram, SnapshotWriter, SVCStats, bucket_bounds, bucket_index
+from platforms.python.host_vm import MiniVM, VMController
+
+
+def test_log_linear_buckets_are_contiguous_and_tight():
+    previous_high = 0
+    for index in range(BUCKETS):
+        low, high = bucket_bounds(index)
+        assert low == previous_high and high > low
+        assert (high - low) * 4 <= max(low, 4)  # at most a quarter of the lower bound
+        assert bucket_index(low) == index and bucket_index(high - 1) == index
+        previous_high = high
+    assert previous_high == 1 << 64
+
+    hist = Histogram()
+    for value in range(1, 1001):
+        hist.record(value)
+    summary = hist.summary()
+    assert summary["count"] == 1000 and summary["max"] == 1000 and summary["mean"] == 500.5
+    assert 500 <= summary["p50"] < 640 and 990 <= summary["p99"] <= 1000
+    assert sum(count for _low, count in summary["buckets"]) == 1000
+
+
+def test_blocked_calls_span_until_the_task_resumes():
+    stats = SVCStats()
+    stats.record(1, 0x5, 3, 0, 100, 0x7, True)  # mailbox receive parks pid 1
+    stats.instructions += 500  # other tasks run
+    stats.record(2, 0x9, 2, 0, 40, -6 & 0xFFFFFFFF, False)
+    stats.record(2, 0x5, 2, 0, 30, 1, False)  # WOULDBLOCK is a mailbox error status
+    assert stats.snapshot()["blocked_now"] == 1
+    stats.resume(1, 0)  # ...and completes with a message
+    receive, gpio, send = (stats.counters[key] for key in ((0x5, 3), (0x9, 2), (0x5, 2)))
+    assert receive.blocked == 1 and receive.instructions.max == 500 and receive.errors == 0
+    assert gpio.errors == 1 and gpio.instructions.max == 1 and gpio.wall_ns.max == 40
+    assert send.errors == 1
+    snapshot = stats.snapshot(top=1, buckets=False)
+    assert [svc["name"] for svc in snapshot["svcs"]] == ["mailbox.2"]
+    assert "buckets" not in snapshot["svcs"][0]["wall_ns"] and snapshot["calls"] == 3 and snapshot["errors"] == 2
+
+
+def _controller(**options):
+    controller = VMController(**options)
+    controller.mailboxes.register_task(1)
+    handle = controller.mailboxes.open(pid=1, target="pid:1")
+    program = [
+        ".text",
+        ".entry start",
+        "start:",
+        f"    LDI R1, {handle}",
+        "    LDI R2, 0x200",
+        "    LDI R3, 16",
+        "    LDI R4, 2",  # receive with a 2 ms timeout; nothing is ever sent
+        "    LDI R5, 0",
+        "    SVC MOD=0x5 FN=0x3",
+        "    SVC MOD=0x9 FN=0x1",  # GPIO read without a bank: HSX_HAL_UNSUPPORTED
+        "    SVC MOD=0x0 FN=0x0",
+        "    JMP start",
+    ]
+    code_words, entry, *_rest = hsx_asm.assemble([line + "\n" for line in program])
+    code = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+    state = MiniVM(code, entry=entry or 0).snapshot_state()
+    state["context"]["pid"] = 1
+    state["context"].pop("sp", None)
+    controller.task_states[1] = state
+    controller.tasks[1] = {
+        "pid": 1,
+        "program": "/apps/poller.hxe",
+        "state": "running",
+        "priority": 10,
+        "quantum": 1,
+        "pc": entry,
+        "sleep_pending": False,
+        "vm_state": state,
+        "trace": False,
+    }
+    controller._activate_task(1)
+    return controller
+
+
+def test_controller_counts_svcs_and_writes_snapshots(tmp_path):
+    path = tmp_path / "svc" / "stats.json"
+    controller = _controller(svc_stats_path=str(path), svc_stats_interval=3600)
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        controller.step(50)
+        time.sleep(0.002)
+        counters = controller.svc_stats.counters
+        if (0x0, 0) in counters and counters[(0x0, 0)].calls >= 3:
+            break
+
+    info = controller.handle_command({"cmd": "stats", "op": "show", "buckets": False})["stats"]
+    by_name = {svc["name"]: svc for svc in info["svcs"]}
+    recv, gpio, core = by_name["mailbox.3"], by_name["gpio.1"], by_name["core.0"]
+    assert recv["blocked"] == recv["calls"] >= 3 and recv["errors"] >= 3  # every wait times out
+    assert recv["wall_ns"]["count"] >= 3 and recv["wall_ns"]["p50"] >= 2_000_000  # includes the wait
+    assert gpio["errors"] == gpio["calls"] >= 3 and gpio["instructions"]["max"] == 1
+    assert core["errors"] == 0 and info["instructions"] >= 5 * core["calls"]
+    assert info["snapshot_file"]["path"] == str(path)
+
+    written = controller.stats_control("snapshot")
+    data = json.loads(path.read_text(encoding="utf-8"))
+    assert written["path"] == str(path) and data["calls"] >= info["calls"]
+    assert any(svc["wall_ns"]["buckets"] for svc in data["svcs"])
+
+    writer = SnapshotWriter(controller.svc_stats, str(tmp_path / "periodic.json"), interval=1.0)
+    assert not writer.poll(now=writer.next_due - 0.5)
+    assert writer.poll(now=writer.next_due) and (tmp_path / "periodic.json").exists()
+
+    controller.stats_control("reset")
+    assert controller.stats_control("show")["calls"] == 0
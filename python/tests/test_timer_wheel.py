@@ -0,0 +1,132 @@
+import random
+import struct
+
+from python.timer_wheel import (
+    HSX_TIMER_ONE_SHOT,
+    HSX_TIMER_PERIODIC,
+    TIMER_EVENT,
+    TimerService,
+)
+from platforms.python.host_vm import MiniVM
+
+
+def _collect(service):
+    events = []
+    service.deliver = lambda timer, record: events.append((service.now_ns, TIMER_EVENT.unpack(record))) or True
+    return events
+
+
+def test_thousands_of_timers_fire_on_time_and_never_early():
+    service = TimerService(tick_ns=10_000)
+    fired = {}
+    due = {}
+
+    def deliver(timer, record):
+        timer_id, tick_us, _overruns = TIMER_EVENT.unpack(record)
+        fired[timer_id] = tick_us
+        return True
+
+    service.deliver = deliver
+    rng = random.Random(98)
+    for _ in range(5000):  # spread over every wheel level, up to ~20 minutes out
+        period_us = rng.choice([rng.randrange(1, 2_000), rng.randrange(2_000, 10_000_000), rng.randrange(10_000_000, 1_200_000_000)])
+        timer_id = service.create(period_us, HSX_TIMER_ONE_SHOT)
+        due[timer_id] = period_us
+    assert service.stats()["active"] == 5000
+    service.run_until(1_300_000_000_000)
+
+    assert fired.keys() == due.keys() and service.stats()["active"] == 0
+    for timer_id, period_us in due.items():
+        assert period_us <= fired[timer_id] < period_us + 10  # within one tick, never early
+    assert service.wheel.cascades > 0 and service.fires == 5000
+
+
+def test_periodic_timers_do_not_drift():
+    service = TimerService(tick_ns=10_000)
+    events = _collect(service)
+    timer_id = service.create(333, HSX_TIMER_PERIODIC)  # not a multiple of the tick
+    step = 0
+    while service.now_ns < 9_900_000_000:  # poll in uneven steps for ten seconds
+        step += 1
+        service.run_for(7_919_000 if step % 3 else 104_729)
+    service.run_until(10_000_000_000)
+    ticks = [record[1] for _t, record in events]
+    assert len(ticks) == 10_000_000_000 // 333_000
+    for index, tick_us in enumerate(ticks, start=1):
+        assert 333 * index <= tick_us < 333 * index + 10  # n-th expiry stays at n * period
+    stats = service.timer_stats(timer_id)
+    assert stats["missed"] == 0 and stats["jitter_max_us"] < 10 and stats["fires"] == len(ticks)
+
+
+def test_late_poll_counts_missed_periods_and_keeps_phase():
+    clock = [0.0]
+    service = TimerService(tick_ns=10_000, clock=lambda: clock[0])
+    events = _collect(service)
+    timer_id = service.create(1000, HSX_TIMER_PERIODIC)
+    clock[0] = 0.0015
+    service.poll()
+    clock[0] = 0.0105  # the executive stalls for 9 ms
+    service.poll()
+    clock[0] = 0.0112
+    service.poll()
+    assert [record for _t, record in events] == [(timer_id, 1500, 0), (timer_id, 10500, 8), (timer_id, 11200, 0)]
+    stats = service.timer_stats(timer_id)
+    assert stats["missed"] == 8 and stats["jitter_max_us"] == 500.0 and stats["jitter_min_us"] == 200.0
+    assert service.timers[timer_id].due_ns == 12_000_000  # still on the 1 ms grid
+
+    # A refused event folds into the next one.
+    service.deliver = lambda timer, record: False
+    clock[0] = 0.0121
+    service.poll()
+    events_before = len(events)
+    service.deliver = lambda timer, record: events.append((0, TIMER_EVENT.unpack(record))) or True
+    clock[0] = 0.0131
+    service.poll()
+    assert len(events) == events_before + 1 and events[-1][1][2] == 1
+    assert service.timer_stats(timer_id)["dropped"] == 1
+    assert service.cancel(timer_id) == 0 and service.cancel(timer_id) == -4
+
+
+PROGRAM = [".text", ".entry start", "start:", "JMP start"]
+
+
+def test_task_svcs_create_subscribe_and_read_stats(task_controller):
+    service = TimerService(tick_ns=10_000)
+    controller = task_controller(PROGRAM, program="/apps/ticker.hxe", timers=service)
+    vm = controller.vm
+
+    def svc(fn, *args):
+        for index, value in enumerate(args, start=1):
+            vm.regs[index] = value
+        vm._svc_timer(fn)
+        return vm.regs[0]
+
+    assert svc(1) == 1_000_000
+    timer_id = svc(2, 2000, HSX_TIMER_PERIODIC)
+    assert timer_id == 1 and svc(2, 0, HSX_TIMER_ONE_SHOT) == (-4 & 0xFFFFFFFF)
+    controller.mailboxes.bind_target(pid=1, target="app:tick", capacity=64)
+    handle = controller.mailboxes.open(pid=1, target="app:tick")
+    assert svc(3, timer_id, handle) == 0
+    assert svc(3, 77, handle) == (-4 & 0xFFFFFFFF)
+
+    info = controller.handle_command({"cmd": "timer", "op": "advance", "us": 7000})["timer"]
+    assert info["time_us"] == 7000 and info["fires"] == 3
+    first = controller.mailboxes.recv(pid=1, handle=handle)
+    assert TIMER_EVENT.unpack(first.payload) == (timer_id, 2000, 0)
+    # 64 bytes hold three 20-byte messages; the fourth expiry waits in overruns.
+    controller.timer_control("advance", us=4000)
+    records = [TIMER_EVENT.unpack(message.payload) for message in iter(lambda: controller.mailboxes.recv(pid=1, handle=handle), None)]
+    assert records == [(timer_id, 4000, 0), (timer_id, 6000, 0), (timer_id, 8000, 0)]
+    controller.timer_control("advance", us=1000)
+    assert TIMER_EVENT.unpack(controller.mailboxes.recv(pid=1, handle=handle).payload) == (timer_id, 12000, 1)
+
+    assert svc(5, timer_id, 0x400) == 0
+    fires, missed, dropped, jmin, jmax, jmean = struct.unpack_from("<6I", vm.mem, 0x400)
+    assert (fires, missed, dropped, jmin, jmax, jmean) == (6, 0, 1, 0, 0, 0)
+    assert svc(0) == 12000 and vm.regs[1] == 0
+
+    controller.kill_task(1)
+    assert controller.timer_control("stats")["active"] == 0
+    standalone = MiniVM(b"")
+    standalone._svc_timer(1)
+    assert standalone.regs[0] == (-6 & 0xFFFFFFFF)  # no timer service
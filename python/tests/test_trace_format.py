@@ -49,3 +49,83 @@ def test_decode_converts_sequences_to_tuples() -> None:
 def test_decode_missing_required_field_raises() -> None:
     with pytest.raises(ValueError):
         trace_format.decode_trace_records([{"pid": 1, "pc": 0x100, "opcode": 0x200}])
+
+
+def _sample_records(count: int, *, pids=(1,)) -> list:
+    records = []
+    regs = [0] * 16
+    for idx in range(count):
+        regs[idx % 4] = (idx * 0x01010101) & 0xFFFFFFFF
+        record = {
+            "seq": idx + 1,
+            "pid": pids[idx % len(pids)],
+            "pc": 0x100 + (idx % 8) * 4,
+            "opcode": 0x10000000 | (idx % 3),
+            "next_pc": 0x104 + (idx % 8) * 4,
+            "flags": idx & 0xF,
+            "steps": idx,
+            "ts": 1000.0 + idx * 0.001,
+            "regs": list(regs),
+            "changed_regs": [f"R{idx % 4}", "PSW"],
+        }
+        if idx % 5 == 0:
+            record["mem_access"] = {"op": "write", "address": 0x2000 + idx, "width": 4, "value": idx}
+        if idx == 3:
+            record["source"] = "import"
+        records.append(record)
+    return records
+
+
+def _strip_ts(records):
+    return [{k: v for k, v in rec.items() if k != "ts"} for rec in records]
+
+
+@pytest.mark.parametrize("compress", [True, False])
+def test_trace_file_round_trip(tmp_path, compress) -> None:
+    records = _sample_records(50, pids=(1, 2))
+    path = tmp_path / "capture.hxt"
+    with trace_format.TraceFileWriter(path, chunk_records=16, compress=compress) as writer:
+        writer.extend(records)
+    assert writer.stats()["chunks"] == 4
+    with trace_format.TraceFileReader(path) as reader:
+        assert reader.complete
+        assert len(reader) == 50
+        decoded = list(reader)
+    expected = trace_format.encode_trace_records(records)
+    assert _strip_ts(decoded) == _strip_ts(expected)
+    for got, want in zip(decoded, expected):
+        assert got["ts"] == pytest.approx(want["ts"], abs=1e-6)
+
+
+def test_trace_file_seek_by_seq_and_pid_filter(tmp_path) -> None:
+    path = tmp_path / "capture.hxt"
+    with trace_format.TraceFileWriter(path, chunk_records=10) as writer:
+        writer.extend(_sample_records(40, pids=(1, 2)))
+    with trace_format.TraceFileReader(path) as reader:
+        assert reader.find_chunk(25) == 2
+        tail = list(reader.iter_records(start_seq=25, pid=2))
+    assert [rec["seq"] for rec in tail] == [26, 28, 30, 32, 34, 36, 38, 40]
+
+
+def test_trace_file_readable_while_writing(tmp_path) -> None:
+    path = tmp_path / "live.hxt"
+    writer = trace_format.TraceFileWriter(path, chunk_records=8)
+    writer.extend(_sample_records(20))
+    reader = trace_format.TraceFileReader(path)
+    assert not reader.complete
+    assert len(reader) == 16
+    writer.close()
+    reader.refresh()
+    assert reader.complete
+    assert [rec["seq"] for rec in reader][-1] == 20
+    reader.close()
+
+
+def test_trace_file_is_smaller_than_json(tmp_path) -> None:
+    import json
+
+    records = _sample_records(2000)
+    path = tmp_path / "capture.hxt"
+    with trace_format.TraceFileWriter(path) as writer:
+        writer.extend(records)
+    assert path.stat().st_size * 10 < len(json.dumps(records))
@@ -0,0 +1,229 @@
+import os
+import socket
+import time
+
+from python.uart_hal import (
+    HSX_UART_RX_IDLE,
+    HSX_UART_RX_OVERRUN,
+    HSX_UART_STATUS_OVERRUN,
+    HSX_UART_STATUS_OVERRUN_SHIFT,
+    HSX_UART_STATUS_RX_READY,
+    HSX_UART_STATUS_TX_READY,
+    RX_BURST,
+    RingBuffer,
+    SocketBackend,
+    UARTPort,
+    live_port,
+    make_backend,
+)
+from platforms.python.host_vm import MiniVM, VMController
+
+
+def test_ring_buffer_wraps_with_two_slice_copies():
+    ring = RingBuffer(8)
+    assert ring.write(b"abcdef") == 6
+    assert ring.read(4) == b"abcd"
+    assert ring.write(b"0123456789") == 6  # wraps; only the free space is taken
+    out = bytearray(16)
+    assert ring.peekinto(out) == 8 and bytes(out[:8]) == b"ef012345"
+    assert ring.used == 8 and ring.high_water == 8
+    ring.discard(3)
+    assert ring.read(10) == b"12345" and ring.used == 0 and ring.head == 0
+
+
+def test_bursts_end_on_idle_line_not_per_byte():
+    events = []
+    port = UARTPort(0, baud=115_200, on_rx=lambda p, flags: events.append((flags, p.rx.read(p.rx.used))))
+    char_ns = port.char_ns
+    assert char_ns == 10 * 1_000_000_000 // 115_200
+    for burst in range(5):
+        port.feed(bytes([burst]) * 40, at_ns=burst * 5_000_000)  # 3.5 ms of data, 1.5 ms gap
+    # A gap of one character time does not split a burst.
+    port.feed(b"xy", at_ns=30_000_000)
+    port.feed(b"z", at_ns=30_000_000 + 3 * char_ns)
+    port.run_until(40_000_000)
+    assert events == [(HSX_UART_RX_IDLE, bytes([burst]) * 40) for burst in range(5)] + [(HSX_UART_RX_IDLE, b"xyz")]
+    assert port.stats()["rx_idle_events"] == 6 and port.rx_bytes == 203
+
+    # Nothing is reported until the idle time has actually passed.
+    port.feed(b"late")
+    port.run_for(5 * char_ns)
+    assert len(events) == 6 and port.rx.used == 4
+    port.run_for(2 * char_ns)
+    assert events[-1] == (HSX_UART_RX_IDLE, b"late")
+
+
+def test_overrun_is_counted_and_reported_once_by_status():
+    port = UARTPort(1, rx_size=64)
+    assert port.status() == HSX_UART_STATUS_TX_READY
+    port.feed(bytes(100))
+    port.run_for(100 * port.char_ns)
+    status = port.status()
+    assert status & HSX_UART_STATUS_OVERRUN and status & HSX_UART_STATUS_RX_READY
+    assert status >> HSX_UART_STATUS_OVERRUN_SHIFT == 36
+    assert port.status() == HSX_UART_STATUS_TX_READY | HSX_UART_STATUS_RX_READY
+    assert port.stats()["rx_overruns"] == 36 and port.read(bytearray(100)) == 64
+
+
+def test_one_megabaud_console_without_mailbox_floods():
+    chunks = []
+    port = UARTPort(0, baud=1_000_000, rx_size=1024, tx_size=2048, on_tx=chunks.append)
+    controller = VMController(uart_ports=[port])
+    controller.mailboxes.bind_target(pid=1, target="app:console", capacity=4096)
+    handle = controller.mailboxes.open(pid=1, target="app:console")
+    controller.uart_subscribers[0] = (1, handle)
+
+    incoming = os.urandom(100_000)  # one second of input at 1 Mbaud, no gaps
+    port.feed(incoming)
+    outgoing = os.urandom(100_000)
+    sent = 0
+    received = bytearray()
+    messages = 0
+    for _ in range(1100):  # a task that drains its mailbox and refills TX every millisecond
+        sent += port.write(memoryview(outgoing)[sent:])
+        port.run_for(1_000_000)
+        while True:
+            message = controller.mailboxes.recv(pid=1, handle=handle)
+            if message is None:
+                break
+            _port, flags, length, _ts = RX_BURST.unpack_from(message.payload)
+            assert not flags & HSX_UART_RX_OVERRUN
+            received += message.payload[RX_BURST.size : RX_BURST.size + length]
+            messages += 1
+
+    assert bytes(received) == incoming and b"".join(chunks) == outgoing
+    stats = port.stats()
+    assert stats["rx_overruns"] == 0 and stats["rx_half_events"] >= 190
+    assert messages <= 210  # ~512 bytes per message, not one per byte
+    assert len(chunks) <= 1100 and stats["tx_high_water"] <= 2048
+
+
+PROGRAM = [".text", ".entry start", "start:", "JMP start"]
+
+
+def test_task_svcs_write_poll_subscribe_and_status(task_controller):
+    wire = []
+    port = UARTPort(0, tx_size=16, on_tx=wire.append)
+    controller = task_controller(PROGRAM, program="/apps/console.hxe", uart_ports=[port])
+    vm = controller.vm
+    vm.mem[0x200:0x214] = b"hello, uart console!"
+    vm.regs[1], vm.regs[2] = 0x200, 20
+    vm._svc_uart(1)  # console write: bulk copy, short count when the ring fills
+    assert vm.regs[0] == 16
+    port.run_for(16 * port.char_ns)
+    assert wire == [b"hello, uart cons"]
+    vm.regs[1], vm.regs[2], vm.regs[3], vm.regs[4] = 0, 0x207, 4, 0x7777  # port write ignores R4
+    vm._svc_uart(3)
+    assert vm.regs[0] == 4
+    port.run_for(4 * port.char_ns)
+    assert wire[-1] == b"uart"
+
+    vm.regs[1], vm.regs[2], vm.regs[3], vm.regs[4] = 0, 9600, 1, 2
+    vm._svc_uart(2)
+    assert vm.regs[0] == 0 and port.bits_per_char == 12
+    vm.regs[1], vm.regs[3] = 0, 5  # no such parity
+    vm._svc_uart(2)
+    assert vm.regs[0] == (-4 & 0xFFFFFFFF)
+
+    port.feed(b"abc")
+    port.run_for(10 * port.char_ns)
+    vm.regs[1], vm.regs[2], vm.regs[3] = 0, 0x300, 2
+    vm._svc_uart(4)
+    assert vm.regs[0] == 2 and bytes(vm.mem[0x300:0x302]) == b"ab"
+    vm.regs[1] = 0
+    vm._svc_uart(6)
+    assert vm.regs[0] == HSX_UART_STATUS_TX_READY | HSX_UART_STATUS_RX_READY
+
+    controller.mailboxes.bind_target(pid=1, target="app:uart0", capacity=256)
+    handle = controller.mailboxes.open(pid=1, target="app:uart0")
+    vm.regs[1], vm.regs[2] = 0, handle
+    vm._svc_uart(5)
+    assert vm.regs[0] == 0
+    port.feed(b"more")
+    port.run_for(10 * port.char_ns)
+    message = controller.mailboxes.recv(pid=1, handle=handle)
+    header = RX_BURST.unpack_from(message.payload)
+    assert header[:3] == (0, HSX_UART_RX_IDLE, 5) and message.payload[RX_BURST.size :] == b"cmore"
+    info = controller.handle_command({"cmd": "uart"})["uart"]
+    assert info["subscribers"] == {0: {"pid": 1, "handle": handle}} and info["ports"][0]["rx_idle_events"] == 2
+
+    controller.kill_task(1)
+    assert controller.uart_subscribers == {}
+    standalone = MiniVM(b"")
+    standalone.regs[1] = 2
+    standalone._svc_uart(6)
+    assert standalone.regs[0] == (-6 & 0xFFFFFFFF)  # port not attached
+
+
+def test_pty_and_socket_backends_carry_the_line():
+    port = live_port(0, baud=1_000_000, backend=make_backend("pty"))
+    try:
+        slave = os.open(port.backend.path, os.O_RDWR | os.O_NOCTTY)
+        try:
+            os.write(slave, b"typed")
+            deadline = time.monotonic() + 5
+            while port.rx.used < 5 and time.monotonic() < deadline:
+                time.sleep(0.01)
+                port.poll()
+            assert port.read(bytearray(8)) == 5
+            port.write(b"echo")
+            time.sleep(0.01)
+            port.poll()
+            assert os.read(slave, 16) == b"echo"
+        finally:
+            os.close(slave)
+    finally:
+        port.close()
+
+    port = live_port(1, baud=1_000_000, backend=make_backend("socket"))
+    try:
+        host, tcp_port = port.backend.address
+        with socket.create_connection((host, tcp_port), timeout=5) as client:
+            client.sendall(b"ping")
+            deadline = time.monotonic() + 5
+            while port.rx.used < 4 and time.monotonic() < deadline:
+                time.sleep(0.01)
+                port.poll()
+            assert port.read(bytearray(8)) == 4
+            port.write(b"pong")
+            time.sleep(0.01)
+            port.poll()
+            assert client.recv(16) == b"pong"
+        assert port.stats()["backend"]["type"] == "socket"
+    finally:
+        port.close()
+
+
+def test_socket_backend_buffers_for_a_slow_reader():
+    backend = SocketBackend(pending_limit=8 * 1024 * 1024)
+    try:
+        with socket.create_connection(backend.address, timeout=5) as client:
+            client.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 65536)
+            deadline = time.monotonic() + 5
+            while backend.client is None and time.monotonic() < deadline:
+                backend.receive()
+            backend.client.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 65536)
+            payload = bytes(range(256)) * 4096  # 1 MiB: far more than the socket buffers hold
+            for offset in range(0, len(payload), 4096):
+                backend.send(payload[offset : offset + 4096])
+            assert backend.client is not None and backend.pending and backend.dropped == 0
+
+            received = bytearray()
+            deadline = time.monotonic() + 10
+            while len(received) < len(payload) and time.monotonic() < deadline:
+                backend.receive()  # the port's poll flushes pending output
+                received += client.recv(65536)
+            assert bytes(received) == payload and not backend.pending
+            assert backend.describe()["connected"]
+    finally:
+        backend.close()
+
+    small = SocketBackend(pending_limit=16)
+    try:
+        with socket.create_connection(small.address, timeout=5):
+            small._accept()
+            small.client.close()  # a hard error on the next send drops the client
+            small.send(b"x" * 40)
+            assert small.client is None and small.dropped == 40
+    finally:
+        small.close()
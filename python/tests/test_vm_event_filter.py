@@ -0,0 +1,81 @@
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import asm as hsx_asm
+from platforms.python.host_vm import MiniVM, VMController
+
+
+def _assemble(lines: list[str]) -> tuple[bytes, int, bytes]:
+    code_words, entry, externs, imports_decl, rodata, relocs, exports, entry_symbol, _locals = hsx_asm.assemble(lines)
+    assert not relocs
+    code_bytes = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+    return code_bytes, entry or 0, rodata
+
+
+def _setup_controller(code: bytes, entry: int, rodata: bytes) -> VMController:
+    controller = VMController()
+    for pid in (1, 2):
+        state = MiniVM(code, entry=entry, rodata=rodata).snapshot_state()
+        ctx = state["context"]
+        ctx["pid"] = pid
+        controller.task_states[pid] = state
+        controller.tasks[pid] = {
+            "pid": pid,
+            "program": "<inline>",
+            "state": "running",
+            "priority": ctx.get("priority", 10),
+            "quantum": ctx.get("time_slice_steps", 1),
+            "pc": ctx.get("pc", entry),
+            "sleep_pending": False,
+            "vm_state": state,
+            "trace": False,
+        }
+    return controller
+
+
+LOOP_PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI R1, 1",
+    "ADD R2, R2, R1",
+    "JMP start",
+]
+
+
+def _trace_pids(result: dict) -> set:
+    return {event.get("pid") for event in result["events"] if event.get("type") == "trace_step"}
+
+
+def test_event_filter_mutes_trace_steps_per_pid() -> None:
+    controller = _setup_controller(*_assemble(LOOP_PROGRAM))
+    controller.trace_task(1, True)
+    controller.trace_task(2, True)
+    assert _trace_pids(controller.step(4)) == {1, 2}
+
+    resp = controller.handle_command({"cmd": "event_filter", "filter": {"trace_step": [2], "task_state": None}})
+    assert resp["status"] == "ok"
+    info = resp["event_filter"]
+    assert "trace_step" in info["filterable"]
+    assert "trace_step" in info["muted"][1]
+    assert info["muted"][2] == ["mailbox_recv", "mailbox_send"]
+    assert _trace_pids(controller.step(4)) == {2}
+
+    controller.event_filter({"*": [1]}, update=True)
+    assert _trace_pids(controller.step(4)) == {1}
+
+    controller.handle_command({"cmd": "event_filter", "filter": None})
+    assert controller.handle_command({"cmd": "event_filter"})["event_filter"]["filter"] is None
+    assert _trace_pids(controller.step(4)) == {1, 2}
+
+
+def test_muted_vm_still_emits_control_events() -> None:
+    code, entry, rodata = _assemble(LOOP_PROGRAM)
+    vm = MiniVM(code, entry=entry, rodata=rodata)
+    vm.muted_events = frozenset({"trace_step", "mailbox_send"})
+    vm.emit_event({"type": "mailbox_send", "pid": 1})
+    vm.emit_event({"type": "mailbox_wait", "pid": 1})
+    vm.emit_event({"type": "debug_stop", "pid": 1})
+    assert [event["type"] for event in vm.consume_events()] == ["mailbox_wait", "debug_stop"]
@@ -0,0 +1,94 @@
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import asm as hsx_asm
+from platforms.python.host_vm import MEM_DIRTY_GRANULE, MiniVM, VMController, _dirty_ranges
+
+
+def _assemble(lines: list[str]) -> tuple[bytes, int, bytes]:
+    code_words, entry, externs, imports_decl, rodata, relocs, exports, entry_symbol, _locals = hsx_asm.assemble(lines)
+    assert not relocs
+    code_bytes = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+    return code_bytes, entry or 0, rodata
+
+
+def _setup_controller(code: bytes, entry: int, rodata: bytes) -> tuple[VMController, MiniVM]:
+    controller = VMController()
+    vm = MiniVM(code, entry=entry, rodata=rodata)
+    controller.vm = vm
+    state = vm.snapshot_state()
+    ctx = state["context"]
+    ctx["pid"] = 1
+    controller.task_states[1] = state
+    controller.tasks[1] = {
+        "pid": 1,
+        "program": "<inline>",
+        "state": "running",
+        "priority": ctx.get("priority", 10),
+        "quantum": ctx.get("time_slice_steps", 1),
+        "pc": ctx.get("pc", entry),
+        "sleep_pending": False,
+        "vm_state": state,
+        "trace": False,
+    }
+    controller.current_pid = 1
+    return controller, vm
+
+
+STORE_PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI32 R1, 0x2000",
+    "LDI R2, 7",
+    "ST [R1+0], R2",
+    "LDI32 R1, 0x2FFE",
+    "STH [R1+0], R2",
+    "BRK 0",
+]
+
+
+def test_minivm_marks_stored_granules_dirty() -> None:
+    code, entry, rodata = _assemble(STORE_PROGRAM)
+    vm = MiniVM(code, entry=entry, rodata=rodata)
+    for _ in range(5):
+        vm.step()
+    ranges = _dirty_ranges(vm.mem_dirty)
+    assert [0x2000, MEM_DIRTY_GRANULE] in ranges
+    assert [0x2FC0, MEM_DIRTY_GRANULE] in ranges
+    assert all(addr % MEM_DIRTY_GRANULE == 0 for addr, _ in ranges)
+
+
+def test_controller_mem_dirty_query_and_clear() -> None:
+    code, entry, rodata = _assemble(STORE_PROGRAM)
+    controller, _vm = _setup_controller(code, entry, rodata)
+    controller.mem_dirty(1, clear=True)
+    controller.step(5, pid=1)
+
+    resp = controller.handle_command({"cmd": "mem_dirty", "pid": 1, "clear": True})
+    assert resp["status"] == "ok"
+    dirty = resp["dirty"]
+    assert dirty["granule"] == MEM_DIRTY_GRANULE
+    assert [0x2000, MEM_DIRTY_GRANULE] in dirty["ranges"]
+    assert dirty["granules"] >= 2
+
+    assert controller.mem_dirty(1)["ranges"] == []
+
+    controller.request_poke(1, 0x3010, b"\x01" * 0x50)
+    assert controller.mem_dirty(1)["ranges"] == [[0x3000, 2 * MEM_DIRTY_GRANULE]]
+
+
+def test_mem_dirty_survives_task_switch() -> None:
+    code, entry, rodata = _assemble(STORE_PROGRAM)
+    controller, _vm = _setup_controller(code, entry, rodata)
+    controller.mem_dirty(1, clear=True)
+    controller.write_mem(0x4000, b"\xAA")
+    controller._store_active_state()
+    controller.vm = None
+    controller.current_pid = None
+    assert [0x4000, MEM_DIRTY_GRANULE] in controller.mem_dirty(1)["ranges"]
+    controller._activate_task(1)
+    assert [0x4000, MEM_DIRTY_GRANULE] in controller.mem_dirty(1, clear=True)["ranges"]
+    assert controller.mem_dirty(1)["ranges"] == []
@@ -0,0 +1,102 @@
+import sys
+from pathlib import Path
+
+import pytest
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import asm as hsx_asm
+from python.execd import ExecutiveState, SymbolIndex
+from python.pc_counters import PCCounters
+
+# Counts R1 down from 3; the JNZ at 0x10 is taken twice and falls through once.
+PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI R1, 3",
+    "LDI R2, 1",
+    "loop:",
+    "SUB R1, R1, R2",
+    "CMP R1, R0",
+    "JNZ loop",
+    "BRK 0",
+]
+BRANCH_PC = 0x10
+
+
+def _code() -> bytes:
+    code_words, *_rest = hsx_asm.assemble(PROGRAM)
+    return b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+
+
+def test_counters_count_every_dispatch_and_branch_edges(task_controller):
+    controller = task_controller(PROGRAM, program="/apps/count.hxe")
+    info = controller.handle_command({"cmd": "coverage", "pid": 1, "op": "enable"})["coverage"]
+    assert info["enabled"] and info["slots"] == 6 and info["edge_counters"]
+    controller.step(11, pid=1)
+
+    dump = controller.coverage_control(1, "dump")
+    assert dict(map(tuple, dump["counts"])) == {0x0: 1, 0x4: 1, 0x8: 3, 0xC: 3, 0x10: 3}
+    assert dump["edges"] == {str(BRANCH_PC): [2, 1]}
+    assert dump["saturated"] is False
+
+    controller.coverage_control(1, "reset")
+    assert controller.coverage_control(1, "dump")["counts"] == []
+    assert controller.coverage_control(1, "disable")["enabled"] is False
+    assert controller.vm.pc_counters is None
+
+
+def test_sixteen_bit_counters_saturate():
+    counters = PCCounters(8, width=16, edges=False)
+    counters.hits[1] = counters.limit
+    export = counters.export()
+    assert export["bytes"] == 4 and "edges" not in export
+    assert export["saturated"] is True
+    with pytest.raises(ValueError):
+        PCCounters(8, width=8)
+
+
+class CoverageVM:
+    def __init__(self, code: bytes):
+        self.code = code
+
+    def coverage(self, pid, op, **options):
+        return {
+            "pid": pid,
+            "op": op,
+            "enabled": True,
+            "width": 32,
+            "slots": len(self.code) // 4,
+            "counts": [[0x0, 1], [0x4, 1], [0x8, 3], [0xC, 3], [0x10, 3]],
+            "edges": {str(BRANCH_PC): [2, 1]},
+        }
+
+    def read_mem(self, addr, length, pid=None):
+        return self.code[addr : addr + length]
+
+
+def test_executive_exports_annotated_listing_line_heat_and_lcov(tmp_path):
+    state = ExecutiveState(CoverageVM(_code()), step_batch=1)
+    state.tasks[1] = {"pid": 1, "program": "/apps/count.hxe"}
+    functions = [{"name": "main", "address": 0, "size": 24, "type": "function"}]
+    lines = [
+        {"address": 0x0, "file": "count.c", "line": 2},
+        {"address": 0x8, "file": "count.c", "line": 4},
+        {"address": 0x14, "file": "count.c", "line": 6},
+    ]
+    state.symbol_tables[1] = {"index": SymbolIndex.build(functions, lines, [])}
+
+    out = tmp_path / "count.info"
+    info = state.coverage(1, "dump", path=str(out), annotate=True)
+    assert info["instructions"] == 6 and info["covered"] == 5 and info["executed"] == 11
+    assert info["lines"][0] == {"file": "count.c", "line": 4, "instructions": 9, "count": 3, "executed": 3}
+    annotated = info["annotated"].splitlines()
+    assert annotated[0] == "main:"
+    assert "taken 2 / not 1" in annotated[5]
+    assert annotated[6].lstrip().startswith("#####")
+
+    report = out.read_text()
+    assert report.startswith("TN:count\nSF:count.c\nFN:2,main\nFNDA:1,main\n")
+    assert "BRDA:4,16,0,2\nBRDA:4,16,1,1\n" in report
+    assert "DA:2,1\nDA:4,3\nDA:6,0\nLF:3\nLH:2\nend_of_record\n" in report
@@ -0,0 +1,116 @@
+import sys
+from pathlib import Path
+
+import pytest
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import profiler
+from python.execd import ExecutiveState, SymbolIndex
+
+PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI R1, 0",
+    "LDI R2, 1",
+    "loop:",
+    "CALL work",
+    "JMP loop",
+    "work:",
+    "ADD R1, R1, R2",
+    "ADD R1, R1, R2",
+    "ADD R1, R1, R2",
+    "ADD R1, R1, R2",
+    "RET",
+]
+CALL_PC = 8
+WORK_PC = 16
+
+
+def _resolve(pid, pc):
+    if pc >= WORK_PC:
+        return "work", "loop.c", 10 + (pc - WORK_PC) // 4
+    return "main", "loop.c", 3
+
+
+def test_controller_samples_pc_and_call_stack_into_ring(task_controller):
+    # The loop body is 7 instructions; a period of 5 walks every PC in it.
+    controller = task_controller(PROGRAM, program="/apps/loop.hxe")
+    info = controller.handle_command({"cmd": "profile", "op": "start", "period": 5, "capacity": 64})["profile"]
+    assert info["active"] and info["mode"] == "instructions"
+    controller.step(5 * 100, pid=1)
+
+    dump = controller.handle_command({"cmd": "profile", "op": "dump"})["profile"]
+    assert dump["taken"] == 99
+    assert dump["samples"] == 64 and dump["dropped"] == 35
+    assert sum(entry["count"] for entry in dump["stacks"]) == 64
+    in_work = [entry for entry in dump["stacks"] if entry["pcs"][-1] >= WORK_PC]
+    assert in_work and all(entry["pcs"][:-1] == [CALL_PC] for entry in in_work)
+
+    report = profiler.function_profile(dump["stacks"], _resolve, weight=dump["period"])
+    by_name = {entry["function"]: entry for entry in report["functions"]}
+    assert by_name["main"]["total"] == 64
+    assert by_name["work"]["self"] == by_name["work"]["total"] > by_name["main"]["self"]
+    assert by_name["work"]["self_instructions"] == by_name["work"]["self"] * 5
+    assert report["lines"][0]["file"] == "loop.c"
+
+    folded = profiler.collapse_stacks(dump["stacks"], _resolve)
+    assert f"pid1;main;work {by_name['work']['self']}\n" in folded
+
+    stopped = controller.handle_command({"cmd": "profile", "op": "stop"})["profile"]
+    assert stopped["active"] is False
+    controller.step(100, pid=1)
+    assert controller.profile_control("status")["taken"] == 99
+
+
+def test_timer_mode_uses_virtual_clock_and_pid_filter(task_controller):
+    controller = task_controller(PROGRAM, program="/apps/loop.hxe")
+    controller.profile_control("start", timer_ms=0.01, clock_hz=1_000_000, pid=1)
+    controller.step(1000, pid=1)
+    status = controller.profile_control("status")
+    assert status["mode"] == "timer" and status["period"] == 10
+    assert status["retired"] == 1000 and status["taken"] == 100
+
+    controller.profile_control("start", period=5, pids=[2])
+    controller.step(100, pid=1)
+    assert controller.profile_control("dump", clear=True)["samples"] == 0
+
+    with pytest.raises(ValueError):
+        controller.profile_control("bogus")
+
+
+class ProfileVM:
+    def __init__(self):
+        self.calls = []
+
+    def profile(self, op, **options):
+        self.calls.append((op, options))
+        return {
+            "op": op,
+            "active": False,
+            "period": 10,
+            "samples": 3,
+            "stacks": [{"pid": 1, "pcs": [CALL_PC, WORK_PC + 4], "count": 2}, {"pid": 1, "pcs": [CALL_PC + 4], "count": 1}],
+        }
+
+
+def test_executive_symbolises_dump_and_writes_collapsed_stacks(tmp_path):
+    state = ExecutiveState(ProfileVM(), step_batch=1)
+    state.tasks[1] = {"pid": 1, "program": "/apps/loop.hxe"}
+    functions = [
+        {"name": "main", "address": 0, "size": WORK_PC, "type": "function"},
+        {"name": "work", "address": WORK_PC, "size": 20, "type": "function"},
+    ]
+    lines = [{"address": WORK_PC + 4, "file": "loop.c", "line": 11}]
+    state.symbol_tables[1] = {"index": SymbolIndex.build(functions, lines, [])}
+
+    out = tmp_path / "loop.folded"
+    info = state.profile("dump", path=str(out), lines=True, clear=True)
+    assert state.vm.calls[-1] == ("dump", {"clear": True})
+    assert info["path"] == str(out)
+    assert out.read_text() == "loop[1];main 1\nloop[1];main;work:11 2\n"
+    functions_out = {entry["function"]: entry for entry in info["functions"]}
+    assert functions_out["work"]["self"] == 2 and functions_out["work"]["self_instructions"] == 20
+    assert functions_out["main"]["total"] == 3
+    assert info["lines"] == [{"file": "loop.c", "line": 11, "samples": 2, "pct": 66.67}]
@@ -0,0 +1,99 @@
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import asm as hsx_asm
+from platforms.python.host_vm import MiniVM, VMController
+
+
+def _assemble(lines: list[str]) -> tuple[bytes, int, bytes]:
+    code_words, entry, externs, imports_decl, rodata, relocs, exports, entry_symbol, _locals = hsx_asm.assemble(lines)
+    assert not relocs
+    code_bytes = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+    return code_bytes, entry or 0, rodata
+
+
+def _setup_controller(code: bytes, entry: int, rodata: bytes) -> VMController:
+    controller = VMController()
+    state = MiniVM(code, entry=entry, rodata=rodata).snapshot_state()
+    ctx = state["context"]
+    ctx["pid"] = 1
+    controller.task_states[1] = state
+    controller.tasks[1] = {
+        "pid": 1,
+        "program": "<inline>",
+        "state": "running",
+        "priority": ctx.get("priority", 10),
+        "quantum": ctx.get("time_slice_steps", 1),
+        "pc": ctx.get("pc", entry),
+        "sleep_pending": False,
+        "vm_state": state,
+        "trace": False,
+    }
+    controller._task_dirty.add(1)  # load() marks new tasks for publication
+    return controller
+
+
+LOOP_PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI R1, 1",
+    "ADD R2, R2, R1",
+    "JMP start",
+]
+
+
+def test_step_publishes_only_changed_tasks():
+    code, entry, rodata = _assemble(LOOP_PROGRAM)
+    controller = _setup_controller(code, entry, rodata)
+
+    first = controller.step(1)["task_deltas"]
+    assert first["base_seq"] == 0
+    assert [(d["pid"], d["reason"], d["old"]) for d in first["deltas"]] == [(1, "created", None)]
+    stepped_state = first["deltas"][0]["new"]
+    assert first["active"]["pid"] == 1
+
+    second = controller.step(2)["task_deltas"]
+    assert second["base_seq"] == first["seq"]
+    assert second["deltas"] == []
+    assert second["active"]["pc"] is not None
+
+    controller.pause_task(1)
+    paused = controller.handle_command({"cmd": "task_deltas"})["task_deltas"]
+    assert [(d["old"], d["new"], d["reason"]) for d in paused["deltas"]] == [(stepped_state, "paused", "state")]
+    assert controller.task_list()["task_seq"] == paused["seq"]
+
+
+def test_task_removal_is_published():
+    code, entry, rodata = _assemble(LOOP_PROGRAM)
+    controller = _setup_controller(code, entry, rodata)
+    controller.task_deltas()
+    controller.kill_task(1)
+    block = controller.task_deltas()
+    assert block["deltas"][-1]["removed"] is True
+    assert block["deltas"][-1]["new"] == "terminated"
+    assert controller.task_deltas()["deltas"] == []
+
+
+def test_task_deltas_only_examine_marked_tasks(monkeypatch):
+    code, entry, rodata = _assemble(LOOP_PROGRAM)
+    controller = _setup_controller(code, entry, rodata)
+    controller.step(1)
+    summarised = []
+    original = VMController._task_summary
+
+    def counting_summary(self, pid):
+        summarised.append(pid)
+        return original(self, pid)
+
+    monkeypatch.setattr(VMController, "_task_summary", counting_summary)
+    for _ in range(5):
+        controller.step(1)
+    assert summarised == []
+    controller.set_task_attrs(1, priority=3)
+    summarised.clear()
+    block = controller.task_deltas()
+    assert summarised == [1]
+    assert [(d["pid"], d["reason"], d["task"]["priority"]) for d in block["deltas"]] == [(1, "update", 3)]
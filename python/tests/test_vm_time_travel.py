@@ -0,0 +1,266 @@
+import sys
+from pathlib import Path
+
+import pytest
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from python import asm as hsx_asm
+from python.time_travel import DIRTY_GRANULE_SHIFT, TaskTimeline
+from platforms.python.host_vm import MEM_DIRTY_GRANULE_SHIFT, MiniVM, VMController
+
+
+def _assemble(lines: list[str]) -> tuple[bytes, int, bytes]:
+    code_words, entry, externs, imports_decl, rodata, relocs, exports, entry_symbol, _locals = hsx_asm.assemble(lines)
+    assert not relocs
+    code_bytes = b"".join((word & 0xFFFFFFFF).to_bytes(4, "big") for word in code_words)
+    return code_bytes, entry or 0, rodata
+
+
+def _setup_controller(code: bytes, entry: int, rodata: bytes) -> VMController:
+    controller = VMController()
+    state = MiniVM(code, entry=entry, rodata=rodata).snapshot_state()
+    ctx = state["context"]
+    ctx["pid"] = 1
+    controller.task_states[1] = state
+    controller.tasks[1] = {
+        "pid": 1,
+        "program": "<inline>",
+        "state": "running",
+        "priority": ctx.get("priority", 10),
+        "quantum": ctx.get("time_slice_steps", 1),
+        "pc": ctx.get("pc", entry),
+        "sleep_pending": False,
+        "vm_state": state,
+        "trace": False,
+    }
+    return controller
+
+
+# Each pass asks the host for a value (SVC), stores it at 0x2000 and bumps a
+# counter at 0x2004.
+SVC_LOOP_PROGRAM = [
+    ".text",
+    ".entry start",
+    "start:",
+    "LDI32 R1, 0x2000",
+    "LDI R3, 0",
+    "LDI R2, 1",
+    "loop:",
+    "SVC MOD=0 FN=0",
+    "ST [R1+0], R0",
+    "ADD R3, R3, R2",
+    "ST [R1+4], R3",
+    "JMP loop",
+]
+LOOP_PC = 16
+STORE_COUNTER_PC = 28
+
+
+@pytest.fixture
+def svc_calls(monkeypatch):
+    calls = []
+
+    def fake_svc(self, mod, fn):
+        calls.append((mod, fn))
+        self.regs[0] = 0x1000 + len(calls)
+
+    monkeypatch.setattr(MiniVM, "handle_svc", fake_svc)
+    return calls
+
+
+def _recording_controller(**config) -> VMController:
+    code, entry, rodata = _assemble(SVC_LOOP_PROGRAM)
+    controller = _setup_controller(code, entry, rodata)
+    controller.debug_attach(1)
+    info = controller.time_travel_config(1, enable=True, **config)
+    assert info["enabled"] and info["checkpoints"] == 1
+    return controller
+
+
+def _observe(controller: VMController) -> tuple[int, int, bytes]:
+    regs = controller.read_regs(1)
+    return regs["pc"], controller.vm.steps, controller.request_peek(1, 0x2000, 8)
+
+
+def test_reverse_step_replays_recorded_svc_results(svc_calls):
+    controller = _recording_controller(interval=8)
+    history = {}
+    for _ in range(60):
+        controller.step(1, pid=1)
+        pc, steps, mem = _observe(controller)
+        history[steps] = (pc, mem)
+    live = _observe(controller)
+    calls_before = len(svc_calls)
+
+    resp = controller.handle_command({"cmd": "reverse", "pid": 1, "op": "step", "count": 13})
+    assert resp["status"] == "ok"
+    stop = resp["reverse"]["stop"]
+    assert stop["reason"] == "reverse_step"
+    pc, steps, mem = _observe(controller)
+    assert steps == live[1] - 13
+    assert (pc, mem) == history[steps]
+    assert len(svc_calls) == calls_before
+
+    controller.debug_step(1, count=13)
+    assert _observe(controller) == live
+    assert len(svc_calls) == calls_before
+
+    controller.debug_step(1, count=5)
+    assert len(svc_calls) > calls_before
+
+
+def test_replay_does_not_count_coverage_again(svc_calls):
+    controller = _recording_controller(interval=8)
+    controller.coverage_control(1, "enable")
+    for _ in range(60):
+        controller.step(1, pid=1)
+    counts = controller.coverage_control(1, "dump")["counts"]
+
+    controller.reverse_step(1, count=13)
+    assert controller.coverage_control(1, "dump")["counts"] == counts
+    controller.debug_step(1, count=1)
+    assert controller.vm.pc_counters is controller.pc_counters[1]
+
+
+def test_replay_does_not_count_svcs_again(svc_calls):
+    controller = _recording_controller(interval=8)
+    for _ in range(60):
+        controller.step(1, pid=1)
+    calls = controller.stats_control("show")["calls"]
+    assert calls == len(svc_calls)
+
+    controller.reverse_step(1, count=13)
+    assert controller.stats_control("show")["calls"] == calls
+    assert controller.vm.svc_stats is controller.svc_stats
+
+
+def test_reverse_continue_stops_at_previous_breakpoint_hit(svc_calls):
+    controller = _recording_controller(interval=16)
+    for _ in range(50):
+        controller.step(1, pid=1)
+    controller.debug_add_breakpoint(1, STORE_COUNTER_PC)
+    current = controller.vm.steps
+
+    info = controller.reverse_continue(1)
+    assert info["stop"]["reason"] == "breakpoint"
+    assert info["stop"]["pc"] == STORE_COUNTER_PC
+    first_steps = controller.vm.steps
+    assert current - 5 <= first_steps < current
+
+    info = controller.reverse_continue(1)
+    assert info["stop"]["pc"] == STORE_COUNTER_PC
+    assert controller.vm.steps == first_steps - 5
+
+
+def test_reverse_continue_rejects_hit_count_breakpoints(svc_calls):
+    controller = _recording_controller(interval=16)
+    for _ in range(30):
+        controller.step(1, pid=1)
+    controller.debug_add_breakpoint(1, STORE_COUNTER_PC, hit_condition="2")
+    with pytest.raises(ValueError, match="hit-count"):
+        controller.reverse_continue(1)
+    controller.debug_add_breakpoint(1, STORE_COUNTER_PC, condition="hits >= 1")
+    with pytest.raises(ValueError, match="hit-count"):
+        controller.reverse_continue(1)
+    controller.debug_add_breakpoint(1, STORE_COUNTER_PC, condition="R3 == 2")
+    assert controller.reverse_continue(1)["stop"]["reason"] == "breakpoint"
+
+
+def test_svc_effects_record_only_pages_the_handler_dirtied(monkeypatch):
+    assert DIRTY_GRANULE_SHIFT == MEM_DIRTY_GRANULE_SHIFT
+
+    def fake_svc(self, mod, fn):
+        self.write_mem(0x2130, b"\xAA" * 8)
+        self.regs[0] = 7
+
+    monkeypatch.setattr(MiniVM, "handle_svc", fake_svc)
+    vm = MiniVM(b"")
+    vm.write_mem(0x3000, b"\x01")  # dirty before the SVC; must stay dirty
+    timeline = TaskTimeline()
+    timeline.svc(vm, 0, 0)
+    effect = timeline.inputs[vm.steps]
+    assert list(effect["pages"]) == [0x2100] and effect["pages"][0x2100][0x30:0x38] == b"\xAA" * 8
+    assert vm.mem_dirty[0x3000 >> MEM_DIRTY_GRANULE_SHIFT] == 1
+    assert vm.mem_dirty[0x2130 >> MEM_DIRTY_GRANULE_SHIFT] == 1
+
+
+def test_checkpoints_and_debugger_share_the_dirty_map(svc_calls):
+    controller = _recording_controller(interval=4, keyframe_every=64)
+    timeline = controller.time_travel[1]
+    for _ in range(6):
+        controller.step(1, pid=1)
+    # A debugger drain between checkpoints must not hide writes from the next delta.
+    assert [0x2000, 64] in controller.mem_dirty(1, clear=True)["ranges"]
+    for _ in range(30):
+        controller.step(1, pid=1)
+    controller._tt_checkpoint(1, timeline)
+    deltas = [ckpt for ckpt in timeline.checkpoints if ckpt.keyframe is None]
+    assert deltas and all(len(ckpt.pages) <= 2 for ckpt in deltas)
+    assert timeline.materialise(len(timeline.checkpoints) - 1) == controller.task_states[1]["mem"]
+    # Checkpoints consumed the map, yet the debugger still sees those writes.
+    assert [0x2000, 64] in controller.mem_dirty(1)["ranges"]
+    controller.mem_dirty(1, clear=True)
+    assert controller.mem_dirty(1)["granules"] == 0
+
+
+def test_checkpoint_keeps_pages_the_debugger_drained():
+    vm = MiniVM(b"")
+    timeline = TaskTimeline()
+    timeline.checkpoint(vm.snapshot_state(), 0, "start")
+    vm.write_mem(0x3010, b"\x55")
+    assert vm.mem_dirty[0x3010 >> MEM_DIRTY_GRANULE_SHIFT] == 1
+    timeline.report_dirty(vm.mem_dirty, clear=True)
+    vm.write_mem(0x4000, b"\x66")
+    ckpt = timeline.checkpoint(vm.snapshot_state(), 10)
+    assert sorted(ckpt.pages) == [0x3000, 0x4000]
+    assert not any(vm.mem_dirty)
+    assert timeline.report_dirty(vm.mem_dirty)[0x4000 >> MEM_DIRTY_GRANULE_SHIFT] == 1
+
+
+def test_reverse_to_last_write_finds_store(svc_calls):
+    controller = _recording_controller(interval=10)
+    for _ in range(42):
+        controller.step(1, pid=1)
+    counter = int.from_bytes(controller.request_peek(1, 0x2004, 4), "little")
+
+    resp = controller.handle_command({"cmd": "reverse", "pid": 1, "op": "last_write", "addr": 0x2004})
+    stop = resp["reverse"]["stop"]
+    assert stop["reason"] == "last_write"
+    assert stop["write_pc"] == STORE_COUNTER_PC
+    assert stop["new_value"] == counter
+    assert stop["old_value"] == counter - 1
+    assert controller.read_regs(1)["pc"] == STORE_COUNTER_PC
+
+
+def test_checkpoint_budget_evicts_and_reports_stats(svc_calls):
+    controller = _recording_controller(interval=4, keyframe_every=4, max_bytes=200 * 1024)
+    for _ in range(200):
+        controller.step(1, pid=1)
+    stats = controller.handle_command({"cmd": "reverse", "pid": 1, "op": "stats"})["reverse"]
+    assert stats["evicted"] > 0
+    assert stats["checkpoint_bytes"] + stats["input_bytes"] <= 200 * 1024
+    assert stats["inputs"]["svc"] == len(svc_calls)
+    assert stats["start_step"] > 0
+
+    controller.reverse_step(1, count=1000)
+    assert controller.vm.steps == stats["start_step"]
+    stats = controller.time_travel_config(1)
+    assert stats["replayed_steps"] >= 0
+    assert stats["last_replay"]["target"] == stats["start_step"]
+
+
+def test_poke_in_the_past_truncates_history(svc_calls):
+    controller = _recording_controller(interval=8)
+    for _ in range(40):
+        controller.step(1, pid=1)
+    controller.reverse_step(1, count=20)
+    position = controller.vm.steps
+    controller.request_poke(1, 0x2004, b"\x00\x00\x00\x00")
+    stats = controller.time_travel_config(1)
+    assert stats["head_step"] == position
+    assert stats["inputs"]["poke"] == 1
+
+    calls_before = len(svc_calls)
+    controller.debug_step(1, count=10)
+    assert len(svc_calls) > calls_before
@@ -0,0 +1,384 @@
+#!/usr/bin/env python3
+"""Checkpoint and replay timeline backing reverse execution.
+
+Each recorded task owns a :class:`TaskTimeline`.  Every ``interval``
+instructions the controller hands it a task state snapshot; memory is stored
+as the 256-byte pages holding granules flagged in the VM's dirty-granule map
+since the previous checkpoint, with a full keyframe every ``keyframe_every``
+checkpoints so restores never walk a long delta chain.  The timeline clears the
+map as it consumes it and keeps those granules in reserve for the debugger's
+``mem_dirty`` view (:meth:`TaskTimeline.report_dirty`), so neither consumer
+hides writes from the other.  Everything the instruction stream cannot reproduce on its own is
+logged as an input: SVC results (register file, memory pages the handler
+flagged in the VM's dirty-granule map, run and sleep state) are captured by
+:meth:`TaskTimeline.svc`, which ``MiniVM.step`` calls in place of
+``handle_svc``, while mailbox deliveries, timer expirations and debugger pokes
+force an extra checkpoint so the replay resumes from the externally modified
+state.
+
+Reverse operations restore the nearest checkpoint at or before the target
+instruction count and re-execute forward; while a task sits behind
+``head_step`` its SVCs are answered from the log instead of being executed
+again, so replay is deterministic and free of side effects.
+"""
+
+from __future__ import annotations
+
+import bisect
+import copy
+import time
+from collections import defaultdict
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional
+
+PAGE_SIZE = 256
+DIRTY_GRANULE_SHIFT = 6  # granule of MiniVM.mem_dirty (MEM_DIRTY_GRANULE_SHIFT in host_vm)
+DEFAULT_INTERVAL = 1000
+DEFAULT_KEYFRAME_EVERY = 16
+DEFAULT_MAX_BYTES = 4 * 1024 * 1024
+
+_STATE_SKIP = frozenset({"mem", "code", "mem_dirty", "pending_events"})
+
+
+def _changed_pages(current: bytes, previous: bytes) -> Dict[int, bytes]:
+    if current == previous:
+        return {}
+    pages: Dict[int, bytes] = {}
+    for offset in range(0, len(current), PAGE_SIZE):
+        end = offset + PAGE_SIZE
+        page = current[offset:end]
+        if page != previous[offset:end]:
+            pages[offset] = bytes(page)
+    return pages
+
+
+def _dirty_pages(mem: bytes, dirty: bytes) -> Dict[int, bytes]:
+    """Copy out every page holding a granule flagged in ``dirty``."""
+
+    pages: Dict[int, bytes] = {}
+    per_page = PAGE_SIZE >> DIRTY_GRANULE_SHIFT
+    idx = dirty.find(1)
+    while idx != -1:
+        offset = (idx // per_page) * PAGE_SIZE
+        pages[offset] = bytes(mem[offset : offset + PAGE_SIZE])
+        idx = dirty.find(1, (offset + PAGE_SIZE) >> DIRTY_GRANULE_SHIFT)
+    return pages
+
+
+@dataclass
+class Checkpoint:
+    step: int
+    reason: str
+    state: Dict[str, Any]
+    keyframe: Optional[bytes] = None
+    pages: Dict[int, bytes] = field(default_factory=dict)
+
+    @property
+    def nbytes(self) -> int:
+        if self.keyframe is not None:
+            return len(self.keyframe)
+        return len(self.pages) * PAGE_SIZE
+
+
+class TaskTimeline:
+    """Checkpoints plus the nondeterministic input log for one task."""
+
+    def __init__(
+        self,
+        *,
+        interval: int = DEFAULT_INTERVAL,
+        keyframe_every: int = DEFAULT_KEYFRAME_EVERY,
+        max_bytes: int = DEFAULT_MAX_BYTES,
+    ) -> None:
+        self.interval = DEFAULT_INTERVAL
+        self.keyframe_every = DEFAULT_KEYFRAME_EVERY
+        self.max_bytes = DEFAULT_MAX_BYTES
+        self.configure(interval=interval, keyframe_every=keyframe_every, max_bytes=max_bytes)
+        self.checkpoints: List[Checkpoint] = []
+        self.inputs: Dict[int, Dict[str, Any]] = {}
+        self.input_counts: Dict[str, int] = defaultdict(int)
+        self.head_step = 0
+        self.pending_external: Optional[str] = None
+        self.checkpoint_bytes = 0
+        self.input_bytes = 0
+        self.evicted = 0
+        self.replayed_steps = 0
+        self.replay_seconds = 0.0
+        self.last_replay: Optional[Dict[str, Any]] = None
+        self._since_keyframe = 0
+        self._mem_len: Optional[int] = None
+        # Granule bitmaps (one byte per granule, folded into ints): bits the
+        # debugger drained since the last checkpoint, and bits a checkpoint
+        # consumed that the debugger has not drained yet.
+        self._carry = 0
+        self._unreported = 0
+
+    def configure(
+        self,
+        *,
+        interval: Optional[int] = None,
+        keyframe_every: Optional[int] = None,
+        max_bytes: Optional[int] = None,
+    ) -> None:
+        if interval is not None:
+            self.interval = max(int(interval), 1)
+        if keyframe_every is not None:
+            self.keyframe_every = max(int(keyframe_every), 1)
+        if max_bytes is not None:
+            self.max_bytes = max(int(max_bytes), PAGE_SIZE)
+
+    # ------------------------------------------------------------------
+    # Recording
+    # ------------------------------------------------------------------
+    @property
+    def start_step(self) -> Optional[int]:
+        return self.checkpoints[0].step if self.checkpoints else None
+
+    def in_past(self, step: int) -> bool:
+        return step < self.head_step
+
+    def due(self, step: int) -> bool:
+        if step < self.head_step:
+            return False
+        if self.pending_external is not None or not self.checkpoints:
+            return True
+        return step - self.checkpoints[-1].step >= self.interval
+
+    def advance(self, step: int) -> None:
+        if step > self.head_step:
+            self.head_step = step
+
+    def checkpoint(self, state: Dict[str, Any], step: int, reason: str = "interval") -> Checkpoint:
+        mem = state.get("mem") or b""
+        if self.pending_external is not None and reason == "interval":
+            reason = self.pending_external
+        self.pending_external = None
+        saved = {key: copy.deepcopy(value) for key, value in state.items() if key not in _STATE_SKIP}
+        ckpt = Checkpoint(step=step, reason=reason, state=saved)
+        dirty = state.get("mem_dirty")
+        if dirty is not None and len(dirty) != (len(mem) + (1 << DIRTY_GRANULE_SHIFT) - 1) >> DIRTY_GRANULE_SHIFT:
+            dirty = None
+        changed = self._take_dirty(dirty) if dirty is not None else None
+        if (
+            changed is None
+            or self._mem_len != len(mem)
+            or not self.checkpoints
+            or self._since_keyframe + 1 >= self.keyframe_every
+        ):
+            ckpt.keyframe = bytes(mem)
+            self._since_keyframe = 0
+        else:
+            ckpt.pages = _dirty_pages(mem, changed)
+            self._since_keyframe += 1
+        self._mem_len = len(mem)
+        self.checkpoints.append(ckpt)
+        self.checkpoint_bytes += ckpt.nbytes
+        self.advance(step)
+        self._evict()
+        return ckpt
+
+    def _take_dirty(self, dirty: bytearray) -> bytes:
+        """Consume ``dirty`` for a checkpoint, returning the granules changed since the last one."""
+
+        touched = int.from_bytes(dirty, "little")
+        changed = (touched | self._carry).to_bytes(len(dirty), "little")
+        self._unreported |= touched
+        self._carry = 0
+        dirty[:] = bytes(len(dirty))
+        return changed
+
+    def report_dirty(self, dirty: bytearray, *, clear: bool = False) -> bytes:
+        """Debugger view of ``dirty``, including granules checkpoints already consumed."""
+
+        touched = int.from_bytes(dirty, "little")
+        view = (touched | self._unreported).to_bytes(len(dirty), "little")
+        if clear:
+            self._carry |= touched
+            self._unreported = 0
+            dirty[:] = bytes(len(dirty))
+        return view
+
+    def release_dirty(self, dirty: bytearray) -> None:
+        """Hand unreported granules back to ``dirty`` when recording stops."""
+
+        if self._unreported:
+            merged = int.from_bytes(dirty, "little") | self._unreported
+            dirty[:] = merged.to_bytes(len(dirty), "little")
+        self._unreported = 0
+
+    def note_external(self, kind: str) -> None:
+        """Force a checkpoint before the task's next instruction."""
+
+        self.pending_external = kind
+        self.input_counts[kind] += 1
+
+    def note_timer(self, step: int) -> None:
+        if step >= self.head_step:
+            self.input_counts["timer"] += 1
+
+    def svc(self, vm: Any, mod: int, fn: int) -> None:
+        """Execute (or replay) one SVC on ``vm``; installed as ``vm.svc_tape``."""
+
+        step = vm.steps
+        if step < self.head_step:
+            effect = self.inputs.get(step)
+            if effect is not None:
+                self._apply_effect(vm, effect)
+                return
+        dirty = getattr(vm, "mem_dirty", None)
+        if dirty is None:
+            before = bytes(vm.mem)
+            vm.handle_svc(mod, fn)
+            pages = _changed_pages(vm.mem, before)
+        else:
+            # Clear the dirty map in place so the handler's writes show up on
+            # their own, then fold the earlier bits back in.
+            prior = bytes(dirty)
+            dirty[:] = bytes(len(prior))
+            try:
+                vm.handle_svc(mod, fn)
+            finally:
+                touched = bytes(dirty)
+                merged = int.from_bytes(prior, "little") | int.from_bytes(touched, "little")
+                dirty[:] = merged.to_bytes(len(prior), "little")
+            pages = _dirty_pages(vm.mem, touched)
+        ctx = vm.context
+        effect = {
+            "mod": mod,
+            "fn": fn,
+            "pages": pages,
+            "regs": [vm.regs[idx] & 0xFFFFFFFF for idx in range(16)],
+            "pc": vm.pc & 0xFFFFFFFF,
+            "sp": vm.sp & 0xFFFFFFFF,
+            "flags": vm.flags & 0xFF,
+            "running": bool(vm.running),
+            "sleep_ms": vm.sleep_pending_ms if vm.sleep_until is not None else None,
+            "state": getattr(ctx, "state", None),
+            "exit_status": getattr(ctx, "exit_status", None),
+        }
+        self.inputs[step] = effect
+        self.input_counts["svc"] += 1
+        self.input_bytes += len(effect["pages"]) * PAGE_SIZE + 96
+
+    @staticmethod
+    def _apply_effect(vm: Any, effect: Dict[str, Any]) -> None:
+        for offset, page in effect["pages"].items():
+            vm.write_mem(offset, page)
+        for idx, value in enumerate(effect["regs"]):
+            vm.regs[idx] = value
+        vm.pc = effect["pc"]
+        vm.sp = effect["sp"]
+        vm.flags = effect["flags"]
+        vm.running = effect["running"]
+        sleep_ms = effect.get("sleep_ms")
+        # Recorded sleeps already elapsed; let the replayed task wake at once.
+        vm.sleep_until = time.monotonic() if sleep_ms is not None else None
+        vm.sleep_pending_ms = sleep_ms
+        ctx = vm.context
+        if ctx is not None:
+            if effect.get("state") is not None:
+                ctx.state = effect["state"]
+            ctx.exit_status = effect.get("exit_status")
+        vm.save_context()
+
+    # ------------------------------------------------------------------
+    # Restoring
+    # ------------------------------------------------------------------
+    def nearest(self, step: int) -> Optional[int]:
+        """Index of the last checkpoint taken at or before ``step``."""
+
+        steps = [ckpt.step for ckpt in self.checkpoints]
+        index = bisect.bisect_right(steps, step) - 1
+        return index if index >= 0 else None
+
+    def external_at(self, step: int) -> Optional[int]:
+        """Index of a forced checkpoint recorded exactly at ``step``."""
+
+        index = self.nearest(step)
+        if index is None:
+            return None
+        ckpt = self.checkpoints[index]
+        if ckpt.step != step or ckpt.reason == "interval":
+            return None
+        return index
+
+    def materialise(self, index: int) -> bytearray:
+        base = index
+        while self.checkpoints[base].keyframe is None:
+            base -= 1
+        mem = bytearray(self.checkpoints[base].keyframe or b"")
+        for ckpt in self.checkpoints[base + 1 : index + 1]:
+            for offset, page in ckpt.pages.items():
+                mem[offset : offset + PAGE_SIZE] = page
+        return mem
+
+    def state_at(self, index: int) -> Dict[str, Any]:
+        ckpt = self.checkpoints[index]
+        state = copy.deepcopy(ckpt.state)
+        state["mem"] = self.materialise(index)
+        state["pending_events"] = []
+        return state
+
+    def segment_end(self, index: int, limit: int) -> int:
+        if index + 1 < len(self.checkpoints):
+            return min(self.checkpoints[index + 1].step, limit)
+        return limit
+
+    def note_replay(self, steps: int, seconds: float, *, target: int) -> None:
+        self.replayed_steps += steps
+        self.replay_seconds += seconds
+        self.last_replay = {
+            "target": target,
+            "steps": steps,
+            "seconds": round(seconds, 6),
+            "steps_per_sec": int(steps / seconds) if seconds > 0 else None,
+        }
+
+    def truncate(self, step: int) -> None:
+        """Drop history after ``step`` once the task diverges from it."""
+
+        while len(self.checkpoints) > 1 and self.checkpoints[-1].step > step:
+            self.checkpoint_bytes -= self.checkpoints.pop().nbytes
+        for key in [key for key in self.inputs if key >= step]:
+            effect = self.inputs.pop(key)
+            self.input_bytes -= len(effect["pages"]) * PAGE_SIZE + 96
+        self.head_step = step
+        # Restoring and replaying up to ``step`` flagged every granule that
+        # differs from the last surviving checkpoint, so the next delta holds.
+        if self.checkpoints:
+            last_key = max(idx for idx, ckpt in enumerate(self.checkpoints) if ckpt.keyframe is not None)
+            self._since_keyframe = len(self.checkpoints) - 1 - last_key
+
+    def _evict(self) -> None:
+        while self.checkpoint_bytes + self.input_bytes > self.max_bytes and len(self.checkpoints) > 1:
+            successor = self.checkpoints[1]
+            if successor.keyframe is None:
+                self.checkpoint_bytes -= successor.nbytes
+                successor.keyframe = bytes(self.materialise(1))
+                successor.pages = {}
+                self.checkpoint_bytes += successor.nbytes
+            self.checkpoint_bytes -= self.checkpoints.pop(0).nbytes
+            self.evicted += 1
+            floor = self.checkpoints[0].step
+            for key in [key for key in self.inputs if key < floor]:
+                effect = self.inputs.pop(key)
+                self.input_bytes -= len(effect["pages"]) * PAGE_SIZE + 96
+
+    def stats(self) -> Dict[str, Any]:
+        keyframes = sum(1 for ckpt in self.checkpoints if ckpt.keyframe is not None)
+        return {
+            "interval": self.interval,
+            "keyframe_every": self.keyframe_every,
+            "max_bytes": self.max_bytes,
+            "checkpoints": len(self.checkpoints),
+            "keyframes": keyframes,
+            "checkpoint_bytes": self.checkpoint_bytes,
+            "input_bytes": self.input_bytes,
+            "evicted": self.evicted,
+            "start_step": self.start_step,
+            "head_step": self.head_step,
+            "inputs": dict(self.input_counts),
+            "replayed_steps": self.replayed_steps,
+            "replay_steps_per_sec": int(self.replayed_steps / self.replay_seconds) if self.replay_seconds > 0 else None,
+            "last_replay": self.last_replay,
+        }
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+"""Executive timer service behind the ``include/hsx_timer.h`` SVCs.
+
+Timers live in a hierarchical timing wheel (Varghese & Lauck, the layout of
+the classic Linux timer wheel): level 0 has 256 slots of one tick each and
+levels 1-4 have 64 slots, each covering 64 times the span of the level
+below, for a 2^32-tick horizon.  Adding or cancelling a timer is O(1); a
+timer is moved down a level (cascaded) at most four times before it expires,
+and the wheel skips straight to the next occupied level-0 slot, so idle
+stretches cost nothing.  Timers beyond the horizon park in the top level and
+are re-placed as it turns.
+
+Expiry is never early: a timer due at ``due_ns`` sits in the slot of tick
+``ceil(due_ns / tick_ns)``.  Periodic timers are rescheduled from their
+previous *due* time, not from when they fired, so they do not drift; when
+the executive polls late, the periods that went by unseen are counted as
+missed and reported in the next event's ``overruns`` field (an event the
+consumer cannot take is counted too).  Every firing records its lateness
+for per-timer jitter statistics.
+
+A service with a ``clock`` follows it from :meth:`TimerService.poll` and
+fires timers at the poll time; without one it is a virtual clock advanced by
+:meth:`TimerService.run_until`, which fires each timer at its own tick.
+"""
+
+from __future__ import annotations
+
+import struct
+import threading
+import time
+from typing import Any, Callable, Dict, List, Optional, Set
+
+HSX_HAL_OK = 0
+HSX_HAL_INVALID_PARAM = -4
+HSX_HAL_NO_MEMORY = -5
+
+HSX_TIMER_ONE_SHOT = 0
+HSX_TIMER_PERIODIC = 1
+
+# hsx_timer_event_t: timer_id, (pad), tick in us, overruns, (pad)
+TIMER_EVENT = struct.Struct("<H2xIB3x")
+
+LEVEL0_BITS = 8
+LEVELN_BITS = 6
+LEVELS = 5
+LEVEL0_SLOTS = 1 << LEVEL0_BITS
+LEVELN_SLOTS = 1 << LEVELN_BITS
+HORIZON = 1 << (LEVEL0_BITS + LEVELN_BITS * (LEVELS - 1))
+
+DEFAULT_TICK_NS = 10_000  # 10 us
+MAX_TIMERS = 0xFFFF
+
+Deliver = Callable[["Timer", bytes], bool]
+
+
+class Timer:
+    __slots__ = (
+        "id",
+        "owner",
+        "target",
+        "period_ns",
+        "due_ns",
+        "expires",
+        "level",
+        "slot",
+        "active",
+        "fires",
+        "missed",
+        "dropped",
+        "pending_overruns",
+        "late_min_ns",
+        "late_max_ns",
+        "late_total_ns",
+    )
+
+    def __init__(self, timer_id: int, owner: Any, period_ns: int, due_ns: int, periodic: bool) -> None:
+        self.id = timer_id
+        self.owner = owner
+        self.target: Any = None
+        self.period_ns = period_ns if periodic else 0
+        self.due_ns = due_ns
+        self.expires = 0
+        self.level: Optional[int] = None
+        self.slot = 0
+        self.active = True
+        self.fires = 0
+        self.missed = 0
+        self.dropped = 0
+        self.pending_overruns = 0
+        self.late_min_ns: Optional[int] = None
+        self.late_max_ns = 0
+        self.late_total_ns = 0
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "id": self.id,
+            "owner": self.owner,
+            "period_us": self.period_ns // 1000,
+            "due_us": self.due_ns // 1000,
+            "fires": self.fires,
+            "missed": self.missed,
+            "dropped": self.dropped,
+            "jitter_min_us": round((self.late_min_ns or 0) / 1000.0, 3),
+            "jitter_max_us": round(self.late_max_ns / 1000.0, 3),
+            "jitter_mean_us": round(self.late_total_ns / 1000.0 / self.fires, 3) if self.fires else 0.0,
+        }
+
+
+class TimingWheel:
+    """Hierarchical wheel of timer slots; ``tick`` is the next tick to process."""
+
+    def __init__(self) -> None:
+        self.slots: List[List[Set[Timer]]] = [[set() for _ in range(LEVEL0_SLOTS)]]
+        self.slots += [[set() for _ in range(LEVELN_SLOTS)] for _ in range(LEVELS - 1)]
+        self.occupied = 0  # bitmap of non-empty level-0 slots
+        self.tick = 0
+        self.count = 0
+        self.cascades = 0
+
+    def add(self, timer: Timer) -> None:
+        self._place(timer)
+        self.count += 1
+
+    def remove(self, timer: Timer) -> None:
+        if timer.level is None:
+            return
+        bucket = self.slots[timer.level][timer.slot]
+        bucket.discard(timer)
+        if timer.level == 0 and not bucket:
+            self.occupied &= ~(1 << timer.slot)
+        timer.level = None
+        self.count -= 1
+
+    def _place(self, timer: Timer) -> None:
+        expires = max(timer.expires, self.tick)
+        delta = expires - self.tick
+        if delta < LEVEL0_SLOTS:
+            level, slot = 0, expires & (LEVEL0_SLOTS - 1)
+            self.occupied |= 1 << slot
+        else:
+            if delta >= HORIZON:
+                expires = self.tick + HORIZON - 1  # parked; re-placed as the top level turns
+            level = 1
+            while delta >= 1 << (LEVEL0_BITS + LEVELN_BITS * level) and level < LEVELS - 1:
+                level += 1
+            slot = (expires >> (LEVEL0_BITS + LEVELN_BITS * (level - 1))) & (LEVELN_SLOTS - 1)
+        timer.level, timer.slot = level, slot
+        self.slots[level][slot].add(timer)
+
+    def _cascade(self, level: int) -> int:
+        slot = (self.tick >> (LEVEL0_BITS + LEVELN_BITS * (level - 1))) & (LEVELN_SLOTS - 1)
+        bucket = self.slots[level][slot]
+        if bucket:
+            self.slots[level][slot] = set()
+            self.cascades += 1
+            for timer in bucket:
+                self._place(timer)
+        return slot
+
+    def expire_until(self, target_tick: int, fire: Callable[[Timer, int], None]) -> None:
+        while self.tick <= target_tick:
+            if not self.count:
+                self.tick = target_tick + 1
+                break
+            index = self.tick & (LEVEL0_SLOTS - 1)
+            if index == 0:
+                level = 1
+                while level < LEVELS and self._cascade(level) == 0:
+                    level += 1
+            bucket = self.slots[0][index]
+            if bucket:
+                self.slots[0][index] = set()
+                self.occupied &= ~(1 << index)
+                tick = self.tick
+                self.tick += 1
+                for timer in sorted(bucket, key=lambda item: (item.due_ns, item.id)):
+                    timer.level = None
+                    self.count -= 1
+                    fire(timer, tick)
+                continue
+            rest = self.occupied >> index
+            if rest:
+                next_tick = self.tick + (rest & -rest).bit_length() - 1
+            else:
+                next_tick = (self.tick | (LEVEL0_SLOTS - 1)) + 1  # next turn: cascade first
+            self.tick = min(next_tick, target_tick + 1)
+
+
+class TimerService:
+    """Periodic and one-shot timers for every task of one executive."""
+
+    def __init__(
+        self,
+        *,
+        tick_ns: int = DEFAULT_TICK_NS,
+        clock: Optional[Callable[[], float]] = None,
+        deliver: Optional[Deliver] = None,
+        max_timers: int = MAX_TIMERS,
+    ) -> None:
+        self.tick_ns = max(int(tick_ns), 1)
+        self.clock = clock
+        self._epoch = clock() if clock is not None else 0.0
+        self.deliver = deliver
+        self.max_timers = min(max(int(max_timers), 1), MAX_TIMERS)
+        self.lock = threading.RLock()
+        self.wheel = TimingWheel()
+        self.timers: Dict[int, Timer] = {}
+        self.now_ns = 0
+        self._next_id = 1
+        self._free_ids: List[int] = []
+        self._fire_at_poll = False
+        self.fires = 0
+        self.missed = 0
+        self.dropped = 0
+
+    @property
+    def virtual(self) -> bool:
+        return self.clock is None
+
+    def current_ns(self) -> int:
+        if self.clock is None:
+            return self.now_ns
+        return max(self.now_ns, int((self.clock() - self._epoch) * 1e9))
+
+    def _allocate_id(self) -> Optional[int]:
+        if self._free_ids:
+            return self._free_ids.pop()
+        if self._next_id > self.max_timers:
+            return None
+        self._next_id += 1
+        return self._next_id - 1
+
+    def _arm(self, timer: Timer) -> None:
+        timer.expires = -(-timer.due_ns // self.tick_ns)
+        self.wheel.add(timer)
+
+    def create(self, period_us: int, kind: int = HSX_TIMER_ONE_SHOT, *, owner: Any = None, target: Any = None) -> int:
+        """Start a timer due ``period_us`` from now; returns its id or an error."""
+
+        period_ns = int(period_us) * 1000
+        if period_ns <= 0 or kind not in (HSX_TIMER_ONE_SHOT, HSX_TIMER_PERIODIC):
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            timer_id = self._allocate_id()
+            if timer_id is None:
+                return HSX_HAL_NO_MEMORY
+            timer = Timer(timer_id, owner, period_ns, self.current_ns() + period_ns, kind == HSX_TIMER_PERIODIC)
+            timer.target = target
+            self.timers[timer_id] = timer
+            self._arm(timer)
+            return timer_id
+
+    def set_target(self, timer_id: int, target: Any, *, owner: Any = None) -> int:
+        with self.lock:
+            timer = self.timers.get(timer_id)
+            if timer is None or (owner is not None and timer.owner != owner):
+                return HSX_HAL_INVALID_PARAM
+            timer.target = target
+            return HSX_HAL_OK
+
+    def cancel(self, timer_id: int, *, owner: Any = None) -> int:
+        with self.lock:
+            timer = self.timers.get(timer_id)
+            if timer is None or (owner is not None and timer.owner != owner):
+                return HSX_HAL_INVALID_PARAM
+            self._release(timer)
+            return HSX_HAL_OK
+
+    def cancel_owner(self, owner: Any) -> int:
+        with self.lock:
+            doomed = [timer for timer in self.timers.values() if timer.owner == owner]
+            for timer in doomed:
+                self._release(timer)
+            return len(doomed)
+
+    def _release(self, timer: Timer) -> None:
+        self.wheel.remove(timer)
+        timer.active = False
+        if self.timers.pop(timer.id, None) is not None:
+            self._free_ids.append(timer.id)
+
+    def _fire(self, timer: Timer, tick: int) -> None:
+        fire_ns = max(self.now_ns if self._fire_at_poll else tick * self.tick_ns, timer.due_ns)
+        missed = 0
+        if timer.period_ns:
+            missed = (fire_ns - timer.due_ns) // timer.period_ns
+            timer.missed += missed
+            self.missed += missed
+        # Jitter is measured against the latest period boundary, not the first missed one.
+        late = fire_ns - timer.due_ns - missed * timer.period_ns
+        timer.late_min_ns = late if timer.late_min_ns is None else min(timer.late_min_ns, late)
+        timer.late_max_ns = max(timer.late_max_ns, late)
+        timer.late_total_ns += late
+        timer.fires += 1
+        self.fires += 1
+        if timer.period_ns:
+            timer.due_ns += (missed + 1) * timer.period_ns
+        overruns = timer.pending_overruns + missed
+        record = TIMER_EVENT.pack(timer.id, (fire_ns // 1000) & 0xFFFFFFFF, min(overruns, 0xFF))
+        if self.deliver is not None and self.deliver(timer, record) is False:
+            timer.dropped += 1
+            self.dropped += 1
+            timer.pending_overruns = overruns + 1
+        else:
+            timer.pending_overruns = 0
+        if not timer.active:
+            return
+        if timer.period_ns:
+            self._arm(timer)
+        else:
+            self._release(timer)
+
+    def run_until(self, t_ns: int) -> None:
+        """Fire every timer due by ``t_ns``; each fires at its own tick."""
+
+        with self.lock:
+            t_ns = max(int(t_ns), self.now_ns)
+            self.now_ns = t_ns
+            self.wheel.expire_until(t_ns // self.tick_ns, self._fire)
+
+    def run_for(self, duration_ns: int) -> None:
+        self.run_until(self.now_ns + int(duration_ns))
+
+    def poll(self) -> None:
+        """Fire everything due by the clock (live services only), stamped now."""
+
+        if self.clock is None:
+            return
+        with self.lock:
+            self._fire_at_poll = True
+            try:
+                self.run_until(self.current_ns())
+            finally:
+                self._fire_at_poll = False
+
+    def timer_stats(self, timer_id: int) -> Optional[Dict[str, Any]]:
+        with self.lock:
+            timer = self.timers.get(timer_id)
+            return None if timer is None else timer.stats()
+
+    def stats(self, *, limit: int = 64) -> Dict[str, Any]:
+        with self.lock:
+            timers = sorted(self.timers.values(), key=lambda item: item.id)
+            late_max = max((timer.late_max_ns for timer in timers), default=0)
+            return {
+                "clock": "virtual" if self.clock is None else "monotonic",
+                "tick_us": self.tick_ns / 1000.0,
+                "time_us": self.now_ns // 1000,
+                "active": len(timers),
+                "fires": self.fires,
+                "missed": self.missed,
+                "dropped": self.dropped,
+                "cascades": self.wheel.cascades,
+                "jitter_max_us": round(late_max / 1000.0, 3),
+                "timers": [timer.stats() for timer in timers[: max(int(limit), 0)]],
+            }
+
+
+def live_service(**options: Any) -> TimerService:
+    return TimerService(clock=time.monotonic, **options)
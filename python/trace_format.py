@@ -7,11 +7,21 @@ and sanitises optional payloads such as register snapshots and memory access
 metadata.  It is deliberately opinionated so downstream tools can rely on a
 stable schema regardless of whether the trace originated inside the executive
 or was imported from an offline capture.
+
+Long captures can also be spilled to ``hsx.tracefile/1`` files: a chunked,
+columnar binary encoding written by :class:`TraceFileWriter` and streamed back
+by :class:`TraceFileReader`.
 """
 
 from __future__ import annotations
 
-from typing import Any, Dict, Iterable, List, Mapping
+import bisect
+import json
+import struct
+import zlib
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, BinaryIO, Dict, Iterable, Iterator, List, Mapping, Optional, Tuple, Union
 
 TRACE_FORMAT_VERSION = "hsx.trace/1"
 
@@ -167,3 +177,611 @@ def decode_trace_records(
             internal["mem_access"] = dict(internal["mem_access"])
         parsed.append(internal)
     return parsed
+
+
+# ---------------------------------------------------------------------------
+# Streaming trace files (``hsx.tracefile/1``)
+#
+# Long captures are spilled to disk as a sequence of self-contained chunks.
+# Each chunk stores its records column by column: PCs, opcodes and PIDs are
+# dictionary coded, sequence numbers/steps/timestamps are delta coded, and
+# register snapshots only carry the registers that changed relative to the
+# previous record of the same PID inside the chunk.  Chunks can optionally be
+# zlib compressed.  ``TraceFileWriter.close`` appends a chunk index and footer
+# so readers can seek by sequence number; files without an index (still being
+# written, or truncated by a crash) are recovered by scanning chunk headers.
+
+TRACE_FILE_FORMAT_VERSION = "hsx.tracefile/1"
+TRACE_FILE_MAGIC = b"HSXT"
+TRACE_FILE_VERSION = 1
+TRACE_FILE_FLAG_ZLIB = 0x0001
+TRACE_FILE_DEFAULT_CHUNK_RECORDS = 4096
+
+_FILE_HEADER = struct.Struct(">4sHHI")
+_CHUNK_MAGIC = b"TRCK"
+_CHUNK_HEADER = struct.Struct(">4sIIIQQI")
+_INDEX_MAGIC = b"TRIX"
+_INDEX_HEADER = struct.Struct(">4sI")
+_INDEX_ENTRY = struct.Struct(">QQQId")
+_FOOTER_MAGIC = b"TRFT"
+_FOOTER = struct.Struct(">4sQ")
+
+_HAS_NEXT_PC = 0x01
+_HAS_FLAGS = 0x02
+_HAS_STEPS = 0x04
+_HAS_TS = 0x08
+_HAS_REGS = 0x10
+_HAS_CHANGED = 0x20
+_HAS_MEM = 0x40
+_HAS_EXTRA = 0x80
+
+_MEM_WRITE = 0x01
+_MEM_HAS_WIDTH = 0x02
+_MEM_HAS_VALUE = 0x04
+_MEM_HAS_MASK = 0x08
+
+_CHANGED_PSW_BIT = 16
+_TS_SCALE = 1_000_000  # timestamps are stored as microsecond deltas
+_COLUMN_COUNT = 14
+
+
+def _put_uvarint(out: bytearray, value: int) -> None:
+    if value < 0:
+        raise ValueError("uvarint cannot encode negative values")
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _put_svarint(out: bytearray, value: int) -> None:
+    _put_uvarint(out, (value << 1) if value >= 0 else ((-value << 1) - 1))
+
+
+class _ColumnReader:
+    __slots__ = ("data", "pos")
+
+    def __init__(self, data: bytes) -> None:
+        self.data = data
+        self.pos = 0
+
+    def uvarint(self) -> int:
+        data = self.data
+        shift = 0
+        result = 0
+        while True:
+            byte = data[self.pos]
+            self.pos += 1
+            result |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return result
+            shift += 7
+
+    def svarint(self) -> int:
+        raw = self.uvarint()
+        return (raw >> 1) if not (raw & 1) else -((raw + 1) >> 1)
+
+    def byte(self) -> int:
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def take(self, length: int) -> bytes:
+        chunk = self.data[self.pos : self.pos + length]
+        self.pos += length
+        return bytes(chunk)
+
+
+def _changed_mask(names: Iterable[str]) -> Tuple[int, List[str]]:
+    mask = 0
+    other: List[str] = []
+    for name in names:
+        if name == "PSW":
+            mask |= 1 << _CHANGED_PSW_BIT
+        elif len(name) > 1 and name[0] == "R" and name[1:].isdigit() and int(name[1:]) < 16:
+            mask |= 1 << int(name[1:])
+        else:
+            other.append(name)
+    return mask, other
+
+
+def _changed_names(mask: int) -> List[str]:
+    names = [f"R{idx}" for idx in range(16) if mask & (1 << idx)]
+    if mask & (1 << _CHANGED_PSW_BIT):
+        names.append("PSW")
+    return names
+
+
+def _dictionary(values: List[int]) -> Tuple[List[int], Dict[int, int]]:
+    table = sorted(set(values))
+    return table, {value: idx for idx, value in enumerate(table)}
+
+
+def encode_trace_chunk(records: List[Mapping[str, Any]]) -> bytes:
+    """Encode already-normalised ``records`` into an uncompressed columnar chunk."""
+
+    if not records:
+        return b""
+    columns = [bytearray() for _ in range(_COLUMN_COUNT)]
+    (
+        col_present,
+        col_seq,
+        col_pid,
+        col_pc,
+        col_op,
+        col_next,
+        col_flags,
+        col_steps,
+        col_ts,
+        col_regs,
+        col_changed,
+        col_mem,
+        col_extra,
+        col_dicts,
+    ) = columns
+
+    pid_table, pid_index = _dictionary([int(rec["pid"]) for rec in records])
+    pc_table, pc_index = _dictionary([int(rec["pc"]) & 0xFFFFFFFF for rec in records])
+    op_table, op_index = _dictionary([int(rec["opcode"]) & 0xFFFFFFFF for rec in records])
+    for table in (pid_table, pc_table, op_table):
+        _put_uvarint(col_dicts, len(table))
+        prev = 0
+        for value in table:
+            _put_uvarint(col_dicts, value - prev)
+            prev = value
+
+    base_ts: Optional[float] = None
+    for rec in records:
+        if rec.get("ts") is not None:
+            base_ts = float(rec["ts"])
+            break
+    col_dicts.extend(struct.pack(">d", base_ts if base_ts is not None else 0.0))
+
+    prev_seq = int(records[0]["seq"])
+    prev_steps = 0
+    prev_ts_us = 0
+    last_regs: Dict[int, List[int]] = {}
+    for rec in records:
+        present = 0
+        pid = int(rec["pid"])
+        pc = int(rec["pc"]) & 0xFFFFFFFF
+        seq = int(rec["seq"])
+        _put_svarint(col_seq, seq - prev_seq)
+        prev_seq = seq
+        _put_uvarint(col_pid, pid_index[pid])
+        _put_uvarint(col_pc, pc_index[pc])
+        _put_uvarint(col_op, op_index[int(rec["opcode"]) & 0xFFFFFFFF])
+        if rec.get("next_pc") is not None:
+            present |= _HAS_NEXT_PC
+            _put_svarint(col_next, (int(rec["next_pc"]) & 0xFFFFFFFF) - pc)
+        if rec.get("flags") is not None:
+            present |= _HAS_FLAGS
+            _put_uvarint(col_flags, int(rec["flags"]) & 0xFFFFFFFF)
+        if rec.get("steps") is not None:
+            present |= _HAS_STEPS
+            steps = int(rec["steps"])
+            _put_svarint(col_steps, steps - prev_steps)
+            prev_steps = steps
+        if rec.get("ts") is not None:
+            present |= _HAS_TS
+            ts_us = int(round((float(rec["ts"]) - (base_ts or 0.0)) * _TS_SCALE))
+            _put_svarint(col_ts, ts_us - prev_ts_us)
+            prev_ts_us = ts_us
+        regs = rec.get("regs")
+        if regs:
+            present |= _HAS_REGS
+            values = [int(v) & 0xFFFFFFFF for v in regs]
+            previous = last_regs.get(pid)
+            mask = 0
+            for idx, value in enumerate(values):
+                if previous is None or idx >= len(previous) or previous[idx] != value:
+                    mask |= 1 << idx
+            _put_uvarint(col_regs, len(values))
+            _put_uvarint(col_regs, mask)
+            for idx, value in enumerate(values):
+                if mask & (1 << idx):
+                    _put_uvarint(col_regs, value)
+            last_regs[pid] = values
+        extra: Dict[str, Any] = {}
+        changed = rec.get("changed_regs")
+        if changed:
+            present |= _HAS_CHANGED
+            mask, other = _changed_mask(changed)
+            _put_uvarint(col_changed, mask)
+            if other:
+                extra["changed_regs"] = list(changed)
+        mem = rec.get("mem_access")
+        if mem:
+            present |= _HAS_MEM
+            mem_flags = _MEM_WRITE if mem.get("op") == "write" else 0
+            if mem.get("width") is not None:
+                mem_flags |= _MEM_HAS_WIDTH
+            if mem.get("value") is not None:
+                mem_flags |= _MEM_HAS_VALUE
+            if mem.get("mask") is not None:
+                mem_flags |= _MEM_HAS_MASK
+            col_mem.append(mem_flags)
+            _put_uvarint(col_mem, int(mem["address"]) & 0xFFFFFFFF)
+            for key, bit in (("width", _MEM_HAS_WIDTH), ("value", _MEM_HAS_VALUE), ("mask", _MEM_HAS_MASK)):
+                if mem_flags & bit:
+                    _put_uvarint(col_mem, int(mem[key]) & 0xFFFFFFFF)
+        for key, value in rec.items():
+            if key in _REQUIRED_FIELDS or key in _OPTIONAL_INT_FIELDS:
+                continue
+            if key in {"ts", "regs", "changed_regs", "mem_access"}:
+                continue
+            extra[key] = value
+        if extra:
+            present |= _HAS_EXTRA
+            blob = json.dumps(extra, separators=(",", ":"), sort_keys=True).encode("utf-8")
+            _put_uvarint(col_extra, len(blob))
+            col_extra.extend(blob)
+        col_present.append(present)
+
+    out = bytearray()
+    for column in columns:
+        _put_uvarint(out, len(column))
+    for column in columns:
+        out.extend(column)
+    return bytes(out)
+
+
+def decode_trace_chunk(payload: bytes, count: int, first_seq: int) -> List[Dict[str, Any]]:
+    """Inverse of :func:`encode_trace_chunk`; returns JSON-friendly records."""
+
+    if count <= 0:
+        return []
+    header = _ColumnReader(payload)
+    lengths = [header.uvarint() for _ in range(_COLUMN_COUNT)]
+    readers: List[_ColumnReader] = []
+    offset = header.pos
+    for length in lengths:
+        readers.append(_ColumnReader(payload[offset : offset + length]))
+        offset += length
+    (
+        col_present,
+        col_seq,
+        col_pid,
+        col_pc,
+        col_op,
+        col_next,
+        col_flags,
+        col_steps,
+        col_ts,
+        col_regs,
+        col_changed,
+        col_mem,
+        col_extra,
+        col_dicts,
+    ) = readers
+
+    tables: List[List[int]] = []
+    for _ in range(3):
+        size = col_dicts.uvarint()
+        table: List[int] = []
+        value = 0
+        for _ in range(size):
+            value += col_dicts.uvarint()
+            table.append(value)
+        tables.append(table)
+    pid_table, pc_table, op_table = tables
+    (base_ts,) = struct.unpack(">d", col_dicts.take(8))
+
+    records: List[Dict[str, Any]] = []
+    seq = first_seq
+    steps = 0
+    ts_us = 0
+    last_regs: Dict[int, List[int]] = {}
+    for _ in range(count):
+        present = col_present.byte()
+        seq += col_seq.svarint()
+        pid = pid_table[col_pid.uvarint()]
+        pc = pc_table[col_pc.uvarint()]
+        record: Dict[str, Any] = {
+            "seq": seq,
+            "pid": pid,
+            "pc": pc,
+            "opcode": op_table[col_op.uvarint()],
+        }
+        if present & _HAS_NEXT_PC:
+            record["next_pc"] = (pc + col_next.svarint()) & 0xFFFFFFFF
+        if present & _HAS_FLAGS:
+            record["flags"] = col_flags.uvarint()
+        if present & _HAS_STEPS:
+            steps += col_steps.svarint()
+            record["steps"] = steps
+        if present & _HAS_TS:
+            ts_us += col_ts.svarint()
+            record["ts"] = base_ts + ts_us / _TS_SCALE
+        if present & _HAS_REGS:
+            width = col_regs.uvarint()
+            mask = col_regs.uvarint()
+            previous = last_regs.get(pid) or []
+            regs: List[int] = []
+            for idx in range(width):
+                if mask & (1 << idx):
+                    regs.append(col_regs.uvarint())
+                else:
+                    regs.append(previous[idx] if idx < len(previous) else 0)
+            last_regs[pid] = regs
+            record["regs"] = regs
+        if present & _HAS_CHANGED:
+            record["changed_regs"] = _changed_names(col_changed.uvarint())
+        if present & _HAS_MEM:
+            mem_flags = col_mem.byte()
+            mem: Dict[str, Any] = {
+                "op": "write" if mem_flags & _MEM_WRITE else "read",
+                "address": col_mem.uvarint(),
+            }
+            for key, bit in (("width", _MEM_HAS_WIDTH), ("value", _MEM_HAS_VALUE), ("mask", _MEM_HAS_MASK)):
+                if mem_flags & bit:
+                    mem[key] = col_mem.uvarint()
+            record["mem_access"] = mem
+        if present & _HAS_EXTRA:
+            blob = col_extra.take(col_extra.uvarint())
+            record.update(json.loads(blob.decode("utf-8")))
+        records.append(record)
+    return records
+
+
+@dataclass(frozen=True)
+class TraceChunkInfo:
+    """Location and coverage of one chunk inside a trace file."""
+
+    offset: int
+    first_seq: int
+    last_seq: int
+    count: int
+    first_ts: float
+
+
+class TraceFileWriter:
+    """Append trace records to an ``hsx.tracefile/1`` file chunk by chunk.
+
+    Records are normalised on :meth:`append` and buffered until
+    ``chunk_records`` have accumulated, at which point the chunk is encoded and
+    written.  The file is always readable up to the last flushed chunk.
+    """
+
+    def __init__(
+        self,
+        path: Union[str, Path],
+        *,
+        chunk_records: int = TRACE_FILE_DEFAULT_CHUNK_RECORDS,
+        compress: bool = True,
+    ) -> None:
+        if chunk_records <= 0:
+            raise ValueError("chunk_records must be positive")
+        self.path = Path(path)
+        self.chunk_records = int(chunk_records)
+        self.compress = bool(compress)
+        self._fp: Optional[BinaryIO] = open(self.path, "wb")
+        flags = TRACE_FILE_FLAG_ZLIB if self.compress else 0
+        self._fp.write(_FILE_HEADER.pack(TRACE_FILE_MAGIC, TRACE_FILE_VERSION, flags, self.chunk_records))
+        self._pending: List[Dict[str, Any]] = []
+        self.index: List[TraceChunkInfo] = []
+        self.records_written = 0
+        self.raw_bytes = 0
+        self.bytes_written = _FILE_HEADER.size
+
+    @property
+    def closed(self) -> bool:
+        return self._fp is None
+
+    def append(self, record: Mapping[str, Any]) -> None:
+        if self._fp is None:
+            raise ValueError("trace file is closed")
+        self._pending.append(normalise_trace_record(record))
+        if len(self._pending) >= self.chunk_records:
+            self.flush()
+
+    def extend(self, records: Iterable[Mapping[str, Any]]) -> None:
+        for record in records:
+            self.append(record)
+
+    def flush(self) -> None:
+        fp = self._fp
+        if fp is None or not self._pending:
+            return
+        records = self._pending
+        self._pending = []
+        raw = encode_trace_chunk(records)
+        payload = zlib.compress(raw, 6) if self.compress else raw
+        first_seq = int(records[0]["seq"])
+        last_seq = int(records[-1]["seq"])
+        first_ts = records[0].get("ts")
+        offset = fp.tell()
+        fp.write(
+            _CHUNK_HEADER.pack(
+                _CHUNK_MAGIC,
+                len(payload),
+                len(raw),
+                len(records),
+                first_seq,
+                last_seq,
+                zlib.crc32(payload) & 0xFFFFFFFF,
+            )
+        )
+        fp.write(payload)
+        fp.flush()
+        self.index.append(
+            TraceChunkInfo(offset, first_seq, last_seq, len(records), float(first_ts) if first_ts is not None else 0.0)
+        )
+        self.records_written += len(records)
+        self.raw_bytes += len(raw)
+        self.bytes_written += _CHUNK_HEADER.size + len(payload)
+
+    def close(self) -> None:
+        fp = self._fp
+        if fp is None:
+            return
+        self.flush()
+        index_offset = fp.tell()
+        fp.write(_INDEX_HEADER.pack(_INDEX_MAGIC, len(self.index)))
+        for entry in self.index:
+            fp.write(_INDEX_ENTRY.pack(entry.offset, entry.first_seq, entry.last_seq, entry.count, entry.first_ts))
+        fp.write(_FOOTER.pack(_FOOTER_MAGIC, index_offset))
+        fp.close()
+        self._fp = None
+        self.bytes_written = index_offset + _INDEX_HEADER.size + _INDEX_ENTRY.size * len(self.index) + _FOOTER.size
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "path": str(self.path),
+            "format": TRACE_FILE_FORMAT_VERSION,
+            "records": self.records_written + len(self._pending),
+            "pending": len(self._pending),
+            "chunks": len(self.index),
+            "chunk_records": self.chunk_records,
+            "compress": self.compress,
+            "raw_bytes": self.raw_bytes,
+            "bytes": self.bytes_written,
+            "closed": self.closed,
+        }
+
+    def __enter__(self) -> "TraceFileWriter":
+        return self
+
+    def __exit__(self, *_exc: Any) -> None:
+        self.close()
+
+
+class TraceFileReader:
+    """Random-access and streaming reader for ``hsx.tracefile/1`` files.
+
+    The chunk index is taken from the footer when present; otherwise chunk
+    headers are scanned, which also works on files that are still being
+    written.  Call :meth:`refresh` to pick up chunks appended since opening.
+    """
+
+    def __init__(self, path: Union[str, Path]) -> None:
+        self.path = Path(path)
+        self._fp: BinaryIO = open(self.path, "rb")
+        header = self._fp.read(_FILE_HEADER.size)
+        if len(header) < _FILE_HEADER.size:
+            raise ValueError("trace file truncated")
+        magic, version, flags, chunk_records = _FILE_HEADER.unpack(header)
+        if magic != TRACE_FILE_MAGIC:
+            raise ValueError("not an HSX trace file")
+        if version != TRACE_FILE_VERSION:
+            raise ValueError(f"unsupported trace file version {version}")
+        self.compressed = bool(flags & TRACE_FILE_FLAG_ZLIB)
+        self.chunk_records = chunk_records
+        self.chunks: List[TraceChunkInfo] = []
+        self.complete = False
+        self._scan_offset = _FILE_HEADER.size
+        if not self._load_footer_index():
+            self.refresh()
+
+    def close(self) -> None:
+        self._fp.close()
+
+    def __enter__(self) -> "TraceFileReader":
+        return self
+
+    def __exit__(self, *_exc: Any) -> None:
+        self.close()
+
+    def __len__(self) -> int:
+        return sum(chunk.count for chunk in self.chunks)
+
+    def _load_footer_index(self) -> bool:
+        fp = self._fp
+        fp.seek(0, 2)
+        size = fp.tell()
+        if size < _FILE_HEADER.size + _FOOTER.size:
+            return False
+        fp.seek(size - _FOOTER.size)
+        magic, index_offset = _FOOTER.unpack(fp.read(_FOOTER.size))
+        if magic != _FOOTER_MAGIC:
+            return False
+        fp.seek(index_offset)
+        index_magic, count = _INDEX_HEADER.unpack(fp.read(_INDEX_HEADER.size))
+        if index_magic != _INDEX_MAGIC:
+            return False
+        chunks = []
+        for _ in range(count):
+            offset, first_seq, last_seq, n, first_ts = _INDEX_ENTRY.unpack(fp.read(_INDEX_ENTRY.size))
+            chunks.append(TraceChunkInfo(offset, first_seq, last_seq, n, first_ts))
+        self.chunks = chunks
+        self.complete = True
+        self._scan_offset = index_offset
+        return True
+
+    def refresh(self) -> int:
+        """Scan for chunks appended after the last known one; returns how many were found."""
+
+        if self.complete:
+            return 0
+        fp = self._fp
+        found = 0
+        while True:
+            fp.seek(self._scan_offset)
+            header = fp.read(_CHUNK_HEADER.size)
+            if header.startswith(_INDEX_MAGIC):
+                self._load_footer_index()
+                break
+            if len(header) < _CHUNK_HEADER.size:
+                break
+            magic, stored_len, _raw_len, count, first_seq, last_seq, _crc = _CHUNK_HEADER.unpack(header)
+            if magic != _CHUNK_MAGIC:
+                break
+            payload_end = self._scan_offset + _CHUNK_HEADER.size + stored_len
+            fp.seek(0, 2)
+            if fp.tell() < payload_end:
+                break
+            self.chunks.append(TraceChunkInfo(self._scan_offset, first_seq, last_seq, count, 0.0))
+            self._scan_offset = payload_end
+            found += 1
+        return found
+
+    def read_chunk(self, index: int) -> List[Dict[str, Any]]:
+        info = self.chunks[index]
+        fp = self._fp
+        fp.seek(info.offset)
+        magic, stored_len, raw_len, count, first_seq, _last_seq, crc = _CHUNK_HEADER.unpack(fp.read(_CHUNK_HEADER.size))
+        if magic != _CHUNK_MAGIC:
+            raise ValueError(f"corrupt trace chunk at offset {info.offset}")
+        payload = fp.read(stored_len)
+        if zlib.crc32(payload) & 0xFFFFFFFF != crc:
+            raise ValueError(f"trace chunk CRC mismatch at offset {info.offset}")
+        raw = zlib.decompress(payload) if self.compressed else payload
+        if len(raw) != raw_len:
+            raise ValueError(f"trace chunk length mismatch at offset {info.offset}")
+        return decode_trace_chunk(raw, count, first_seq)
+
+    def find_chunk(self, seq: int) -> int:
+        """Return the index of the first chunk whose range ends at or after ``seq``."""
+
+        last_seqs = [chunk.last_seq for chunk in self.chunks]
+        return bisect.bisect_left(last_seqs, int(seq))
+
+    def iter_records(
+        self,
+        *,
+        start_seq: Optional[int] = None,
+        pid: Optional[int] = None,
+    ) -> Iterator[Dict[str, Any]]:
+        """Yield records in file order, decoding one chunk at a time."""
+
+        first = self.find_chunk(start_seq) if start_seq is not None else 0
+        for idx in range(first, len(self.chunks)):
+            for record in self.read_chunk(idx):
+                if start_seq is not None and record["seq"] < start_seq:
+                    continue
+                if pid is not None and record["pid"] != pid:
+                    continue
+                yield record
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        return self.iter_records()
+
+
+def read_trace_file(path: Union[str, Path], *, limit: Optional[int] = None) -> List[Dict[str, Any]]:
+    """Convenience helper returning (the last ``limit``) records from a trace file."""
+
+    with TraceFileReader(path) as reader:
+        records = list(reader.iter_records())
+    if limit is not None:
+        records = records[-int(limit):] if limit > 0 else []
+    return records
@@ -0,0 +1,483 @@
+#!/usr/bin/env python3
+"""Host-simulated UART ports behind the ``include/hsx_uart.h`` SVCs.
+
+Each :class:`UARTPort` has a transmit and a receive :class:`RingBuffer` and
+models the line at its configured baud rate (start bit, 8 data bits, optional
+parity, 1 or 2 stop bits per character):
+
+* ``write`` copies a whole buffer into the TX ring in one go (at most two
+  slice copies, like a DMA descriptor pair) and returns how much fitted; the
+  ring drains at line rate and each drain hands the backend one chunk, not
+  one byte at a time;
+* bytes arriving on the line fill the RX ring.  Instead of an event per
+  byte, the port raises one RX event per burst: when the line has been idle
+  for ``idle_chars`` character times (the idle-line interrupt), or when the
+  ring reaches half full during a long burst (the DMA half-transfer
+  interrupt), so a consumer that keeps up never overruns;
+* bytes that find the RX ring full are dropped and counted; the overrun is
+  reported through ``hsx_uart_get_status`` (flag plus dropped-byte count).
+
+Timing is simulated: :meth:`UARTPort.run_until` advances the line, and a
+port created with a ``clock`` follows it from :meth:`UARTPort.poll`.
+Backends connect the line to the host: :class:`PtyBackend` (a pseudo
+terminal for ``screen``/``minicom``) and :class:`SocketBackend` (a raw
+local TCP socket).
+"""
+
+from __future__ import annotations
+
+import os
+import socket
+import struct
+import threading
+import time
+from collections import deque
+from typing import Any, Callable, Deque, Dict, List, Optional
+
+HSX_HAL_OK = 0
+HSX_HAL_BUSY = -3
+HSX_HAL_INVALID_PARAM = -4
+
+HSX_UART_PARITY_NONE = 0
+HSX_UART_PARITY_EVEN = 1
+HSX_UART_PARITY_ODD = 2
+
+# hsx_uart_get_status() bits
+HSX_UART_STATUS_TX_READY = 0x01
+HSX_UART_STATUS_RX_READY = 0x02
+HSX_UART_STATUS_OVERRUN = 0x04
+HSX_UART_STATUS_PARITY_ERR = 0x08
+HSX_UART_STATUS_OVERRUN_SHIFT = 16  # bytes dropped since the last status read
+
+# hsx_uart_rx_burst_t flags
+HSX_UART_RX_IDLE = 0x01  # burst ended by an idle line (otherwise ring half full)
+HSX_UART_RX_OVERRUN = HSX_UART_STATUS_OVERRUN  # bytes were dropped before this data
+
+# hsx_uart_rx_burst_t header: port, flags, length, timestamp of the last byte in us
+RX_BURST = struct.Struct("<BBHI")
+
+PORTS = 3
+DEFAULT_BAUD = 115_200
+MAX_BAUD = 4_000_000
+DEFAULT_RING_SIZE = 4096
+DEFAULT_IDLE_CHARS = 2
+
+OnRx = Callable[["UARTPort", int], bool]
+OnTx = Callable[[bytes], None]
+
+
+class RingBuffer:
+    """Fixed-size byte ring; bulk transfers copy at most two slices."""
+
+    def __init__(self, size: int = DEFAULT_RING_SIZE) -> None:
+        self.size = max(int(size), 1)
+        self.buf = bytearray(self.size)
+        self.head = 0
+        self.used = 0
+        self.high_water = 0
+
+    @property
+    def free(self) -> int:
+        return self.size - self.used
+
+    def write(self, data: Any) -> int:
+        with memoryview(data) as view, view.cast("B") as src:
+            count = min(len(src), self.size - self.used)
+            tail = (self.head + self.used) % self.size
+            first = min(count, self.size - tail)
+            self.buf[tail : tail + first] = src[:first]
+            if count > first:
+                self.buf[: count - first] = src[first:count]
+        self.used += count
+        self.high_water = max(self.high_water, self.used)
+        return count
+
+    def peekinto(self, dest: Any) -> int:
+        with memoryview(dest) as view, view.cast("B") as out:
+            count = min(len(out), self.used)
+            first = min(count, self.size - self.head)
+            out[:first] = self.buf[self.head : self.head + first]
+            if count > first:
+                out[first:count] = self.buf[: count - first]
+        return count
+
+    def discard(self, count: int) -> None:
+        count = min(max(int(count), 0), self.used)
+        self.head = (self.head + count) % self.size
+        self.used -= count
+        if not self.used:
+            self.head = 0
+
+    def readinto(self, dest: Any) -> int:
+        count = self.peekinto(dest)
+        self.discard(count)
+        return count
+
+    def read(self, count: int) -> bytes:
+        out = bytearray(min(max(int(count), 0), self.used))
+        self.readinto(out)
+        return bytes(out)
+
+    def clear(self) -> None:
+        self.head = 0
+        self.used = 0
+
+
+class UARTPort:
+    """One UART: TX/RX rings, line timing, burst detection and statistics."""
+
+    def __init__(
+        self,
+        index: int = 0,
+        *,
+        baud: int = DEFAULT_BAUD,
+        parity: int = HSX_UART_PARITY_NONE,
+        stop_bits: int = 1,
+        tx_size: int = DEFAULT_RING_SIZE,
+        rx_size: int = DEFAULT_RING_SIZE,
+        idle_chars: int = DEFAULT_IDLE_CHARS,
+        on_rx: Optional[OnRx] = None,
+        on_tx: Optional[OnTx] = None,
+        backend: Any = None,
+        clock: Optional[Callable[[], float]] = None,
+    ) -> None:
+        self.index = int(index)
+        self.tx = RingBuffer(tx_size)
+        self.rx = RingBuffer(rx_size)
+        self.rx_threshold = max(self.rx.size // 2, 1)
+        self.idle_chars = max(int(idle_chars), 1)
+        self.on_rx = on_rx
+        self.on_tx = on_tx
+        self.backend = backend
+        self.clock = clock
+        self._epoch = clock() if clock is not None else 0.0
+        self.lock = threading.RLock()
+        self.now_ns = 0
+        self.tx_line_ns = 0  # end of the last character shifted out
+        self.rx_wire: Deque[List[Any]] = deque()  # [start_ns, data, received]
+        self.rx_wire_ns = 0  # end of the last queued incoming character
+        self.rx_last_ns = 0
+        self._burst_open = False
+        self._rx_retry = False
+        self._overrun_latched = False
+        self._overrun_since_status = 0
+        self._overruns_reported = 0
+        self.tx_bytes = 0
+        self.tx_chunks = 0
+        self.tx_rejected = 0
+        self.rx_bytes = 0
+        self.rx_overruns = 0
+        self.rx_idle_events = 0
+        self.rx_half_events = 0
+        if self.configure(baud, parity, stop_bits) != HSX_HAL_OK:
+            raise ValueError(f"unsupported UART configuration {baud}/{parity}/{stop_bits}")
+
+    def configure(self, baud: int, parity: int = HSX_UART_PARITY_NONE, stop_bits: int = 1) -> int:
+        baud, parity, stop_bits = int(baud), int(parity), int(stop_bits)
+        if not 0 < baud <= MAX_BAUD or parity not in (0, 1, 2) or stop_bits not in (1, 2):
+            return HSX_HAL_INVALID_PARAM
+        with self.lock:
+            self.baud, self.parity, self.stop_bits = baud, parity, stop_bits
+            self.bits_per_char = 1 + 8 + (1 if parity else 0) + stop_bits
+            self.char_ns = self.bits_per_char * 1_000_000_000 // baud
+            self.idle_ns = self.idle_chars * self.char_ns
+        return HSX_HAL_OK
+
+    # -- task side ---------------------------------------------------------
+
+    def write(self, data: Any) -> int:
+        """Queue as much of ``data`` as fits in the TX ring; returns the count."""
+
+        with self.lock:
+            if not self.tx.used:
+                self.tx_line_ns = max(self.tx_line_ns, self.now_ns)
+            count = self.tx.write(data)
+            if count < len(data):
+                self.tx_rejected += 1
+            return count
+
+    def read(self, dest: Any) -> int:
+        with self.lock:
+            return self.rx.readinto(dest)
+
+    def status(self) -> int:
+        with self.lock:
+            flags = HSX_UART_STATUS_TX_READY if self.tx.free else 0
+            if self.rx.used:
+                flags |= HSX_UART_STATUS_RX_READY
+            if self._overrun_latched:
+                flags |= HSX_UART_STATUS_OVERRUN
+                flags |= min(self._overrun_since_status, 0xFFFF) << HSX_UART_STATUS_OVERRUN_SHIFT
+                self._overrun_latched = False  # reported once, like a latched error flag
+                self._overrun_since_status = 0
+            return flags
+
+    # -- line side ---------------------------------------------------------
+
+    def feed(self, data: bytes, *, at_ns: Optional[int] = None) -> None:
+        """Queue ``data`` on the RX line, back to back from ``at_ns`` (default: now)."""
+
+        if not data:
+            return
+        with self.lock:
+            start = max(self.now_ns if at_ns is None else int(at_ns), self.rx_wire_ns)
+            self.rx_wire.append([start, bytes(data), 0])
+            self.rx_wire_ns = start + len(data) * self.char_ns
+
+    def _drain_tx(self, t_ns: int) -> None:
+        if not self.tx.used or t_ns <= self.tx_line_ns:
+            return
+        count = min(self.tx.used, (t_ns - self.tx_line_ns) // self.char_ns)
+        if not count:
+            return
+        chunk = self.tx.read(count)
+        self.tx_line_ns += count * self.char_ns
+        self.tx_bytes += count
+        self.tx_chunks += 1
+        if self.backend is not None:
+            self.backend.send(chunk)
+        if self.on_tx is not None:
+            self.on_tx(chunk)
+
+    def _receive(self, data: bytes, end_ns: int) -> None:
+        accepted = self.rx.write(data)
+        dropped = len(data) - accepted
+        if dropped:
+            self.rx_overruns += dropped
+            self._overrun_since_status += dropped
+            self._overrun_latched = True
+        self.rx_bytes += len(data)
+        self.rx_last_ns = end_ns
+        self._burst_open = True
+        if self.rx.used >= self.rx_threshold:
+            self.rx_half_events += 1
+            self._rx_event(0)
+
+    def _rx_event(self, flags: int) -> None:
+        if flags & HSX_UART_RX_IDLE:
+            self._burst_open = False
+        self._rx_retry = False
+        if self.on_rx is not None and self.rx.used:
+            if self.rx_overruns != self._overruns_reported:
+                flags |= HSX_UART_RX_OVERRUN
+            self._rx_retry = self.on_rx(self, flags) is False
+            if not self._rx_retry:
+                self._overruns_reported = self.rx_overruns
+
+    def _idle_reached(self, t_ns: int) -> bool:
+        idle_at = self.rx_last_ns + self.idle_ns
+        return t_ns >= idle_at and (not self.rx_wire or self.rx_wire[0][0] >= idle_at)
+
+    def run_until(self, t_ns: int) -> None:
+        """Advance both directions of the line to ``t_ns``."""
+
+        with self.lock:
+            t_ns = int(t_ns)
+            self._drain_tx(t_ns)
+            if self._rx_retry and self.rx.used:
+                self._rx_event(HSX_UART_RX_IDLE if not self._burst_open else 0)
+            while self.rx_wire:
+                if self._burst_open and self._idle_reached(t_ns):
+                    self.rx_idle_events += 1
+                    self._rx_event(HSX_UART_RX_IDLE)
+                entry = self.rx_wire[0]
+                start, data, received = entry
+                arrived = min(len(data), max(t_ns - start, 0) // self.char_ns)
+                while received < arrived:
+                    room = self.rx_threshold - self.rx.used
+                    count = min(arrived - received, room if room > 0 else self.rx_threshold)
+                    self._receive(data[received : received + count], start + (received + count) * self.char_ns)
+                    received += count
+                entry[2] = received
+                if received < len(data):
+                    break
+                self.rx_wire.popleft()
+            if self._burst_open and self._idle_reached(t_ns):
+                self.rx_idle_events += 1
+                self._rx_event(HSX_UART_RX_IDLE)
+            self.now_ns = max(self.now_ns, t_ns)
+
+    def run_for(self, duration_ns: int) -> None:
+        self.run_until(self.now_ns + int(duration_ns))
+
+    def poll(self) -> None:
+        """Pull host input from the backend and advance to the port clock."""
+
+        if self.clock is None:
+            return
+        with self.lock:
+            self.now_ns = max(self.now_ns, int((self.clock() - self._epoch) * 1e9))
+            if self.backend is not None:
+                data = self.backend.receive()
+                if data:
+                    # Host reads return whatever arrived since the last poll,
+                    # so place it on the line ending now.
+                    self.feed(data, at_ns=self.now_ns - len(data) * self.char_ns)
+            self.run_until(self.now_ns)
+
+    def close(self) -> None:
+        if self.backend is not None:
+            self.backend.close()
+
+    def stats(self) -> Dict[str, Any]:
+        with self.lock:
+            info = {
+                "port": self.index,
+                "baud": self.baud,
+                "parity": self.parity,
+                "stop_bits": self.stop_bits,
+                "tx_bytes": self.tx_bytes,
+                "tx_chunks": self.tx_chunks,
+                "tx_pending": self.tx.used,
+                "tx_rejected": self.tx_rejected,
+                "tx_high_water": self.tx.high_water,
+                "rx_bytes": self.rx_bytes,
+                "rx_pending": self.rx.used,
+                "rx_high_water": self.rx.high_water,
+                "rx_overruns": self.rx_overruns,
+                "rx_idle_events": self.rx_idle_events,
+                "rx_half_events": self.rx_half_events,
+            }
+            if self.backend is not None:
+                info["backend"] = self.backend.describe()
+            return info
+
+
+class PtyBackend:
+    """Pseudo terminal: the slave path can be opened by any terminal program."""
+
+    def __init__(self) -> None:
+        import tty  # POSIX only; keep the module importable everywhere else
+
+        self.master, self.slave = os.openpty()
+        tty.setraw(self.slave)
+        os.set_blocking(self.master, False)
+        self.path = os.ttyname(self.slave)
+        self.dropped = 0
+
+    def send(self, data: bytes) -> None:
+        try:
+            written = os.write(self.master, data)
+        except (BlockingIOError, OSError):
+            written = 0
+        self.dropped += len(data) - written
+
+    def receive(self) -> bytes:
+        try:
+            return os.read(self.master, 65536)
+        except (BlockingIOError, OSError):
+            return b""
+
+    def describe(self) -> Dict[str, Any]:
+        return {"type": "pty", "path": self.path, "dropped": self.dropped}
+
+    def close(self) -> None:
+        for fd in (self.master, self.slave):
+            try:
+                os.close(fd)
+            except OSError:
+                pass
+
+
+class SocketBackend:
+    """Raw local TCP socket; one client at a time gets the line.
+
+    Output the client has not read yet waits in a pending buffer (up to
+    ``pending_limit`` bytes) and is flushed as the socket drains, so a slow
+    reader is never disconnected for being slow; bytes beyond the limit are
+    dropped and counted.
+    """
+
+    def __init__(self, address: tuple = ("127.0.0.1", 0), *, pending_limit: int = 64 * 1024) -> None:
+        self.listener = socket.create_server(address)
+        self.listener.setblocking(False)
+        self.address = self.listener.getsockname()[:2]
+        self.client: Optional[socket.socket] = None
+        self.pending = bytearray()
+        self.pending_limit = max(int(pending_limit), 1)
+        self.dropped = 0
+
+    def _accept(self) -> None:
+        if self.client is not None:
+            return
+        try:
+            client, _addr = self.listener.accept()
+        except (BlockingIOError, OSError):
+            return
+        client.setblocking(False)
+        self.client = client
+
+    def send(self, data: bytes) -> None:
+        self._accept()
+        if self.client is None:
+            self.dropped += len(data)  # nobody listening: the line just idles
+            return
+        room = self.pending_limit - len(self.pending)
+        if len(data) > room:
+            self.dropped += len(data) - room
+            data = data[:room]
+        self.pending += data
+        self._flush()
+
+    def _flush(self) -> None:
+        while self.pending and self.client is not None:
+            try:
+                sent = self.client.send(self.pending)
+            except (BlockingIOError, InterruptedError):
+                return  # send buffer full; retried on the next poll
+            except OSError:
+                self._drop_client()
+                return
+            del self.pending[:sent]
+
+    def receive(self) -> bytes:
+        self._accept()
+        if self.client is None:
+            return b""
+        self._flush()
+        if self.client is None:
+            return b""
+        try:
+            data = self.client.recv(65536)
+        except BlockingIOError:
+            return b""
+        except OSError:
+            data = b""
+        if not data:
+            self._drop_client()
+        return data
+
+    def _drop_client(self) -> None:
+        if self.client is not None:
+            self.client.close()
+            self.client = None
+        self.dropped += len(self.pending)
+        self.pending.clear()
+
+    def describe(self) -> Dict[str, Any]:
+        return {
+            "type": "socket",
+            "address": "%s:%d" % self.address,
+            "connected": self.client is not None,
+            "pending": len(self.pending),
+            "dropped": self.dropped,
+        }
+
+    def close(self) -> None:
+        self._drop_client()
+        self.listener.close()
+
+
+def make_backend(kind: Optional[str], *, host: str = "127.0.0.1", port: int = 0) -> Any:
+    kind = str(kind or "none").lower()
+    if kind == "pty":
+        return PtyBackend()
+    if kind == "socket":
+        return SocketBackend((host, int(port)))
+    if kind == "none":
+        return None
+    raise ValueError(f"unknown UART backend '{kind}'")
+
+
+def live_port(index: int, **options: Any) -> UARTPort:
+    return UARTPort(index, clock=time.monotonic, **options)
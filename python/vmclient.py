@@ -108,6 +108,66 @@ class VMClient:
             payload["pid"] = pid
         _check_ok(self.request(payload))
 
+    def mem_dirty(self, pid: int, *, clear: bool = False) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "mem_dirty", "pid": pid}
+        if clear:
+            payload["clear"] = True
+        return _check_ok(self.request(payload)).get("dirty", {})
+
+    def event_filter(self, spec: Optional[Dict[str, Any]] = None, *, update: bool = True) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "event_filter"}
+        if update:
+            payload["filter"] = spec
+        return _check_ok(self.request(payload)).get("event_filter", {})
+
+    def task_deltas(self) -> Dict[str, Any]:
+        return _check_ok(self.request({"cmd": "task_deltas"})).get("task_deltas", {})
+
+    def reverse(self, pid: int, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "reverse", "pid": pid, "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("reverse", {})
+
+    def coverage(self, pid: int, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "coverage", "pid": pid, "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("coverage", {})
+
+    def profile(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "profile", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("profile", {})
+
+    def fs(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "fs", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("fs", {})
+
+    def can(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "can", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("can", {})
+
+    def uart(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "uart", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("uart", {})
+
+    def gpio(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "gpio", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("gpio", {})
+
+    def timer(self, op: str, **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "timer", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("timer", {})
+
+    def svc_stats(self, op: str = "show", **options: Any) -> Dict[str, Any]:
+        payload: Dict[str, Any] = {"cmd": "stats", "op": op}
+        payload.update({key: value for key, value in options.items() if value is not None})
+        return _check_ok(self.request(payload)).get("stats", {})
+
     def attach(self) -> Dict[str, Any]:
         return _check_ok(self.request({"cmd": "attach"})).get("info", {})
 